@@ -87,13 +87,79 @@ namespace
         throw std::runtime_error{ msg };
     }
 
+    // Memory source and destination managers (jpeg_mem_src/jpeg_mem_dest are missing from older libjpeg releases)
+    void OnJPEGInitSource(j_decompress_ptr)
+    {
+        // the whole buffer is handed over in `UseInput` ...
+    }
+
+    boolean OnJPEGFillInput(j_decompress_ptr dec)
+    {
+        // out of data: insert a fake EOI marker like jpeg_stdio_src does for truncated files
+        static const JOCTET s_eoi[2] = { 0xFF, JPEG_EOI };
+        WARNMS(dec, JWRN_JPEG_EOF);
+        dec->src->next_input_byte = s_eoi;
+        dec->src->bytes_in_buffer = sizeof(s_eoi);
+        return TRUE;
+    }
+
+    void OnJPEGSkipInput(j_decompress_ptr dec, long count)
+    {
+        if (count <= 0)
+            return;
+        auto src = dec->src;
+        auto bytes = static_cast<size_t>(count);
+        while (bytes > src->bytes_in_buffer)
+        {
+            bytes -= src->bytes_in_buffer;
+            std::ignore = (*src->fill_input_buffer)(dec);
+        }
+        src->next_input_byte += bytes;
+        src->bytes_in_buffer -= bytes;
+    }
+
+    void OnJPEGTermSource(j_decompress_ptr)
+    {
+    }
+
+    /// @note `blob` is grown geometrically as needed
+    struct JPEGBlobDestination
+    {
+        jpeg_destination_mgr mgr;
+        Blob* blob;
+    };
+
+    void OnJPEGInitDestination(j_compress_ptr enc)
+    {
+        auto dest = reinterpret_cast<JPEGBlobDestination*>(enc->dest);
+        dest->mgr.next_output_byte = static_cast<JOCTET*>(dest->blob->GetBufferPointer());
+        dest->mgr.free_in_buffer = dest->blob->GetBufferSize();
+    }
+
+    boolean OnJPEGEmptyOutput(j_compress_ptr enc)
+    {
+        // called only once the buffer is completely full
+        auto dest = reinterpret_cast<JPEGBlobDestination*>(enc->dest);
+        const size_t size = dest->blob->GetBufferSize();
+        if (FAILED(dest->blob->Resize(size * 2)))
+            throw std::bad_alloc{};
+        dest->mgr.next_output_byte = static_cast<JOCTET*>(dest->blob->GetBufferPointer()) + size;
+        dest->mgr.free_in_buffer = size;
+        return TRUE;
+    }
+
+    void OnJPEGTermDestination(j_compress_ptr)
+    {
+    }
+
     class JPEGDecompress final
     {
         jpeg_error_mgr err;
         jpeg_decompress_struct dec;
+        jpeg_source_mgr src;
 
     public:
-        JPEGDecompress() : err{}, dec{}
+        JPEGDecompress() : err{}, dec{}, src{}
         {
             jpeg_std_error(&err);
             err.error_exit = &OnJPEGError;
@@ -110,6 +176,19 @@ namespace
             jpeg_stdio_src(&dec, fin);
         }
 
+        /// @note `pSource` must outlive the decode
+        void UseInput(const void* pSource, size_t size) noexcept
+        {
+            src.init_source = &OnJPEGInitSource;
+            src.fill_input_buffer = &OnJPEGFillInput;
+            src.skip_input_data = &OnJPEGSkipInput;
+            src.resync_to_restart = &jpeg_resync_to_restart;
+            src.term_source = &OnJPEGTermSource;
+            src.next_input_byte = static_cast<const JOCTET*>(pSource);
+            src.bytes_in_buffer = size;
+            dec.src = &src;
+        }
+
         static DXGI_FORMAT TranslateColor(J_COLOR_SPACE colorspace) noexcept
         {
             switch (colorspace)
@@ -185,7 +264,7 @@ namespace
         }
     #endif
 
-        HRESULT GetImage(TexMetadata& metadata, ScratchImage& image) noexcept(false)
+        HRESULT GetImage(TexMetadata& metadata, ScratchImage& image, JPEG_FLAGS flags) noexcept(false)
         {
             metadata = {};
             switch (jpeg_read_header(&dec, true))
@@ -207,15 +286,29 @@ namespace
                     return HRESULT_E_NOT_SUPPORTED;
             }
 
-            if (auto hr = image.Initialize2D(metadata.format, metadata.width, metadata.height, metadata.arraySize, metadata.mipLevels); FAILED(hr))
-                return hr;
-
         #ifdef LIBJPEG_TURBO_VERSION
             // grayscale is the only color space which uses 1 component
             if (dec.out_color_space != JCS_GRAYSCALE)
                 // if there is no proper conversion to 4 component, E_FAIL...
                 dec.out_color_space = JCS_EXT_RGBX;
         #endif
+
+            // scaling is done in the IDCT, so most of the decode work is skipped
+            dec.scale_num = 1;
+            switch (flags & JPEG_FLAGS_SCALE_MASK)
+            {
+            case JPEG_FLAGS_SCALE_1_2: dec.scale_denom = 2; break;
+            case JPEG_FLAGS_SCALE_1_4: dec.scale_denom = 4; break;
+            case JPEG_FLAGS_SCALE_1_8: dec.scale_denom = 8; break;
+            default: dec.scale_denom = 1; break;
+            }
+            jpeg_calc_output_dimensions(&dec);
+            metadata.width = dec.output_width;
+            metadata.height = dec.output_height;
+
+            if (auto hr = image.Initialize2D(metadata.format, metadata.width, metadata.height, metadata.arraySize, metadata.mipLevels); FAILED(hr))
+                return hr;
+
             if (jpeg_start_decompress(&dec) == false)
                 return E_FAIL;
 
@@ -242,10 +335,10 @@ namespace
             return S_OK;
         }
 
-        HRESULT GetImage(ScratchImage& image) noexcept(false)
+        HRESULT GetImage(ScratchImage& image, JPEG_FLAGS flags) noexcept(false)
         {
             TexMetadata metadata{};
-            return GetImage(metadata, image);
+            return GetImage(metadata, image, flags);
         }
     };
 
@@ -253,9 +346,12 @@ namespace
     {
         jpeg_error_mgr err{};
         jpeg_compress_struct enc{};
+        JPEGBlobDestination dest{};
+        JPEG_FLAGS flags;
+        int quality;
 
     public:
-        JPEGCompress() : err{}, enc{}
+        JPEGCompress() : err{}, enc{}, dest{}, flags(JPEG_FLAGS_NONE), quality(100)
         {
             jpeg_std_error(&err);
             err.error_exit = &OnJPEGError;
@@ -272,6 +368,31 @@ namespace
             jpeg_stdio_dest(&enc, fout);
         }
 
+        /// @note `blob` must already hold a buffer, and outlive the encode
+        void UseOutput(Blob& blob) noexcept
+        {
+            dest.mgr.init_destination = &OnJPEGInitDestination;
+            dest.mgr.empty_output_buffer = &OnJPEGEmptyOutput;
+            dest.mgr.term_destination = &OnJPEGTermDestination;
+            dest.blob = &blob;
+            enc.dest = &dest.mgr;
+        }
+
+        /// @note number of bytes written by `WriteImage` to the `Blob` output
+        size_t GetOutputSize() const noexcept
+        {
+            return dest.blob->GetBufferSize() - dest.mgr.free_in_buffer;
+        }
+
+        HRESULT SetOptions(JPEG_FLAGS optionFlags, int optionQuality) noexcept
+        {
+            if (optionQuality < 1 || optionQuality > 100)
+                return E_INVALIDARG;
+            flags = optionFlags;
+            quality = optionQuality;
+            return S_OK;
+        }
+
         /// @todo More correct DXGI_FORMAT mapping
         HRESULT WriteImage(const Image& image) noexcept(false)
         {
@@ -302,13 +423,29 @@ namespace
             enc.image_width = static_cast<JDIMENSION>(image.width);
             enc.image_height = static_cast<JDIMENSION>(image.height);
             jpeg_set_defaults(&enc);
-            jpeg_set_quality(&enc, 100, true);
+            jpeg_set_quality(&enc, quality, true);
+            // jpeg_set_defaults picks 4:2:0 for color images
+            if (enc.num_components == 3)
+            {
+                switch (flags & JPEG_FLAGS_SUBSAMPLING_MASK)
+                {
+                case JPEG_FLAGS_SUBSAMPLING_444:
+                    enc.comp_info[0].h_samp_factor = 1;
+                    enc.comp_info[0].v_samp_factor = 1;
+                    break;
+                case JPEG_FLAGS_SUBSAMPLING_422:
+                    enc.comp_info[0].h_samp_factor = 2;
+                    enc.comp_info[0].v_samp_factor = 1;
+                    break;
+                default:
+                    break;
+                }
+            }
             // we will write a row each time ...
             jpeg_start_compress(&enc, true);
-            const size_t stride = enc.image_width * static_cast<size_t>(enc.input_components);
             while (enc.next_scanline < enc.image_height)
             {
-                JSAMPROW rows[1]{ image.pixels + stride * enc.next_scanline };
+                JSAMPROW rows[1]{ image.pixels + image.rowPitch * enc.next_scanline };
                 jpeg_write_scanlines(&enc, rows, 1);
             }
             jpeg_finish_compress(&enc);
@@ -317,6 +454,31 @@ namespace
     };
 }
 
+_Use_decl_annotations_
+HRESULT DirectX::GetMetadataFromJPEGMemory(
+    const void* pSource,
+    size_t size,
+    TexMetadata& metadata)
+{
+    if (!pSource || !size)
+        return E_INVALIDARG;
+
+    try
+    {
+        JPEGDecompress decoder{};
+        decoder.UseInput(pSource, size);
+        return decoder.GetHeader(metadata);
+    }
+    catch (const std::bad_alloc&)
+    {
+        return E_OUTOFMEMORY;
+    }
+    catch (const std::exception&)
+    {
+        return E_FAIL;
+    }
+}
+
 _Use_decl_annotations_
 HRESULT DirectX::GetMetadataFromJPEGFile(
     const wchar_t* file,
@@ -350,9 +512,43 @@ HRESULT DirectX::GetMetadataFromJPEGFile(
     }
 }
 
+_Use_decl_annotations_
+HRESULT DirectX::LoadFromJPEGMemory(
+    const void* pSource,
+    size_t size,
+    JPEG_FLAGS flags,
+    TexMetadata* metadata,
+    ScratchImage& image)
+{
+    if (!pSource || !size)
+        return E_INVALIDARG;
+
+    image.Release();
+
+    try
+    {
+        JPEGDecompress decoder{};
+        decoder.UseInput(pSource, size);
+        if (!metadata)
+            return decoder.GetImage(image, flags);
+        return decoder.GetImage(*metadata, image, flags);
+    }
+    catch (const std::bad_alloc&)
+    {
+        image.Release();
+        return E_OUTOFMEMORY;
+    }
+    catch (const std::exception&)
+    {
+        image.Release();
+        return E_FAIL;
+    }
+}
+
 _Use_decl_annotations_
 HRESULT DirectX::LoadFromJPEGFile(
     const wchar_t* file,
+    JPEG_FLAGS flags,
     TexMetadata* metadata,
     ScratchImage&image)
 {
@@ -367,8 +563,8 @@ HRESULT DirectX::LoadFromJPEGFile(
         JPEGDecompress decoder{};
         decoder.UseInput(fin.get());
         if (!metadata)
-            return decoder.GetImage(image);
-        return decoder.GetImage(*metadata, image);
+            return decoder.GetImage(image, flags);
+        return decoder.GetImage(*metadata, image, flags);
     }
     catch (const std::bad_alloc&)
     {
@@ -391,19 +587,81 @@ HRESULT DirectX::LoadFromJPEGFile(
     }
 }
 
+_Use_decl_annotations_
+HRESULT DirectX::LoadFromJPEGFile(
+    const wchar_t* file,
+    TexMetadata* metadata,
+    ScratchImage&image)
+{
+    return LoadFromJPEGFile(file, JPEG_FLAGS_NONE, metadata, image);
+}
+
+_Use_decl_annotations_
+HRESULT DirectX::SaveToJPEGMemory(
+    const Image& image,
+    JPEG_FLAGS flags,
+    int quality,
+    Blob& blob)
+{
+    if (!image.pixels)
+        return E_POINTER;
+
+    blob.Release();
+
+    // Typical output is well under a quarter of the pixel data; the buffer doubles if not
+    const uint64_t initialSize = (uint64_t(image.rowPitch) * uint64_t(image.height)) / 4 + 16384;
+    if (initialSize > SIZE_MAX)
+        return HRESULT_E_ARITHMETIC_OVERFLOW;
+
+    HRESULT hr = blob.Initialize(static_cast<size_t>(initialSize));
+    if (FAILED(hr))
+        return hr;
+
+    try
+    {
+        JPEGCompress encoder{};
+        encoder.UseOutput(blob);
+        hr = encoder.SetOptions(flags, quality);
+        if (SUCCEEDED(hr))
+            hr = encoder.WriteImage(image);
+        if (SUCCEEDED(hr))
+            hr = blob.Trim(encoder.GetOutputSize());
+    }
+    catch (const std::bad_alloc&)
+    {
+        hr = E_OUTOFMEMORY;
+    }
+    catch (const std::exception&)
+    {
+        hr = E_FAIL;
+    }
+
+    if (FAILED(hr))
+        blob.Release();
+
+    return hr;
+}
+
 _Use_decl_annotations_
 HRESULT DirectX::SaveToJPEGFile(
     const Image& image,
+    JPEG_FLAGS flags,
+    int quality,
     const wchar_t* file)
 {
     if (!file)
         return E_INVALIDARG;
 
+    if (!image.pixels)
+        return E_POINTER;
+
     try
     {
         auto fout = CreateFILE(file);
         JPEGCompress encoder{};
         encoder.UseOutput(fout.get());
+        if (auto hr = encoder.SetOptions(flags, quality); FAILED(hr))
+            return hr;
         return encoder.WriteImage(image);
     }
     catch (const std::bad_alloc&)
@@ -423,3 +681,11 @@ HRESULT DirectX::SaveToJPEGFile(
         return E_FAIL;
     }
 }
+
+_Use_decl_annotations_
+HRESULT DirectX::SaveToJPEGFile(
+    const Image& image,
+    const wchar_t* file)
+{
+    return SaveToJPEGFile(image, JPEG_FLAGS_NONE, 100, file);
+}
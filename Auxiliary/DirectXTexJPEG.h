@@ -18,15 +18,61 @@
 
 namespace DirectX
 {
+    enum JPEG_FLAGS : unsigned long
+    {
+        JPEG_FLAGS_NONE = 0x0,
+
+        JPEG_FLAGS_SCALE_1_2 = 0x1,
+        JPEG_FLAGS_SCALE_1_4 = 0x2,
+        JPEG_FLAGS_SCALE_1_8 = 0x3,
+        JPEG_FLAGS_SCALE_MASK = 0x3,
+        // Decodes at 1/2, 1/4, or 1/8 size by reducing the IDCT (dimensions round up)
+
+        JPEG_FLAGS_SUBSAMPLING_444 = 0x10,
+        JPEG_FLAGS_SUBSAMPLING_422 = 0x20,
+        JPEG_FLAGS_SUBSAMPLING_420 = 0x30,
+        JPEG_FLAGS_SUBSAMPLING_MASK = 0x30,
+        // Chroma subsampling used when writing color images (defaults to 4:2:0)
+    };
+
+    DEFINE_ENUM_FLAG_OPERATORS(JPEG_FLAGS);
+
+    HRESULT __cdecl GetMetadataFromJPEGMemory(
+        _In_reads_bytes_(size) const void* pSource, _In_ size_t size,
+        _Out_ TexMetadata& metadata);
+
     HRESULT __cdecl GetMetadataFromJPEGFile(
         _In_z_ const wchar_t* szFile,
         _Out_ TexMetadata& metadata);
 
+    HRESULT __cdecl LoadFromJPEGMemory(
+        _In_reads_bytes_(size) const void* pSource, _In_ size_t size,
+        _In_ JPEG_FLAGS flags,
+        _Out_opt_ TexMetadata* metadata,
+        _Out_ ScratchImage& image);
+
+    HRESULT __cdecl LoadFromJPEGFile(
+        _In_z_ const wchar_t* szFile,
+        _In_ JPEG_FLAGS flags,
+        _Out_opt_ TexMetadata* metadata,
+        _Out_ ScratchImage& image);
+
     HRESULT __cdecl LoadFromJPEGFile(
         _In_z_ const wchar_t* szFile,
         _Out_opt_ TexMetadata* metadata,
         _Out_ ScratchImage& image);
 
+    HRESULT __cdecl SaveToJPEGMemory(
+        _In_ const Image& image,
+        _In_ JPEG_FLAGS flags, _In_ int quality,
+        _Out_ Blob& blob);
+
+    HRESULT __cdecl SaveToJPEGFile(
+        _In_ const Image& image,
+        _In_ JPEG_FLAGS flags, _In_ int quality,
+        _In_z_ const wchar_t* szFile);
+        // quality is 1 (smallest) to 100 (best)
+
     HRESULT __cdecl SaveToJPEGFile(
         _In_ const Image& image,
         _In_z_ const wchar_t* szFile);
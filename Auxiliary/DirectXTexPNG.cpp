@@ -18,8 +18,10 @@
 #error Requires C++17 (and /Zc:__cplusplus with MSVC)
 #endif
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <exception>
 #include <filesystem>
 #include <stdexcept>
@@ -28,6 +30,7 @@
 #include <vector>
 
 #include <png.h>
+#include <zlib.h>
 
 
 using namespace DirectX;
@@ -86,7 +89,50 @@ namespace
     void OnPNGRead(png_structp st, png_bytep ptr, size_t len)
     {
         FILE* fin = reinterpret_cast<FILE*>(png_get_io_ptr(st));
-        std::ignore = fread(ptr, len, 1, fin);
+        if (fread(ptr, len, 1, fin) != 1)
+            png_error(st, "unexpected end of file");
+    }
+
+    struct PNGMemorySource
+    {
+        const uint8_t* data;
+        size_t remaining;
+    };
+
+    void OnPNGReadMemory(png_structp st, png_bytep ptr, size_t len)
+    {
+        auto src = reinterpret_cast<PNGMemorySource*>(png_get_io_ptr(st));
+        if (len > src->remaining)
+            png_error(st, "unexpected end of data");
+        memcpy(ptr, src->data, len);
+        src->data += len;
+        src->remaining -= len;
+    }
+
+    /// @note `blob` is grown geometrically as needed; `offset` is the number of bytes written
+    struct PNGMemoryDest
+    {
+        Blob* blob;
+        size_t offset;
+    };
+
+    void OnPNGWriteMemory(png_structp st, png_bytep ptr, size_t len)
+    {
+        auto dest = reinterpret_cast<PNGMemoryDest*>(png_get_io_ptr(st));
+        const size_t size = dest->blob->GetBufferSize();
+        if (len > size - dest->offset)
+        {
+            const size_t newSize = std::max(size * 2, dest->offset + len);
+            if (FAILED(dest->blob->Resize(newSize)))
+                throw std::bad_alloc{};
+        }
+        memcpy(static_cast<uint8_t*>(dest->blob->GetBufferPointer()) + dest->offset, ptr, len);
+        dest->offset += len;
+    }
+
+    void OnPNGFlush(png_structp)
+    {
+        // nothing is buffered ...
     }
 
 
@@ -123,6 +169,12 @@ namespace
             png_set_read_fn(st, fin, &OnPNGRead);
         }
 
+        /// @note `src` must outlive the decode
+        void UseInput(PNGMemorySource& src) noexcept
+        {
+            png_set_read_fn(st, &src, &OnPNGReadMemory);
+        }
+
         void Update() noexcept(false)
         {
             png_read_info(st, info);
@@ -149,6 +201,9 @@ namespace
             }
             // Here we don't know if the pixel data is in BGR/RGB order
             // png_set_bgr(st);
+            // PNG stores 16-bit samples as big-endian
+            if (png_get_bit_depth(st, info) == 16)
+                png_set_swap(st);
             png_set_alpha_mode(st, PNG_ALPHA_STANDARD, PNG_DEFAULT_sRGB);
             // make 4 component
             // using `png_set_add_alpha` here may confuse `TEX_ALPHA_MODE_OPAQUE` estimation
@@ -213,11 +268,16 @@ namespace
 
             if (auto hr = image.Initialize2D(metadata.format, metadata.width, metadata.height, metadata.arraySize, metadata.mipLevels); FAILED(hr))
                 return hr;
-            auto* dest = image.GetPixels();
-            const auto stride = metadata.width * png_get_channels(st, info);
+
+            // libpng decodes straight into the image rows
+            const Image* img = image.GetImage(0, 0, 0);
+            if (!img)
+                return E_POINTER;
+            if (png_get_rowbytes(st, info) > img->rowPitch)
+                throw std::runtime_error{ "unexpected info from libpng" };
             std::vector<png_byte*> rows(metadata.height);
-            for (auto i = 0u; i < metadata.height; ++i)
-                rows[i] = dest + (stride * i);
+            for (size_t i = 0u; i < metadata.height; ++i)
+                rows[i] = img->pixels + img->rowPitch * i;
 
             png_read_rows(st, rows.data(), nullptr, static_cast<uint32_t>(rows.size()));
             png_read_end(st, info);
@@ -250,7 +310,6 @@ namespace
                 png_destroy_write_struct(&st, nullptr);
                 throw std::runtime_error{ "png_create_info_struct" };
             }
-            png_set_compression_level(st, 0);
         }
 
         ~PNGCompress() noexcept
@@ -263,6 +322,50 @@ namespace
             png_init_io(st, fout);
         }
 
+        /// @note `dest` must outlive the encode
+        void UseOutput(PNGMemoryDest& dest) noexcept
+        {
+            png_set_write_fn(st, &dest, &OnPNGWriteMemory, &OnPNGFlush);
+        }
+
+        /// @note must call before `WriteImage`
+        HRESULT SetOptions(PNG_FLAGS flags, int compressionLevel) noexcept(false)
+        {
+            if (compressionLevel < PNG_DEFAULT_COMPRESSION || compressionLevel > Z_BEST_COMPRESSION)
+                return E_INVALIDARG;
+            png_set_compression_level(st, (compressionLevel < 0) ? Z_DEFAULT_COMPRESSION : compressionLevel);
+
+            // without a strategy, libpng picks Z_FILTERED or Z_DEFAULT_STRATEGY from the row filters
+            switch (flags & PNG_FLAGS_STRATEGY_MASK)
+            {
+            case PNG_FLAGS_NONE: break;
+            case PNG_FLAGS_STRATEGY_FILTERED: png_set_compression_strategy(st, Z_FILTERED); break;
+            case PNG_FLAGS_STRATEGY_HUFFMAN_ONLY: png_set_compression_strategy(st, Z_HUFFMAN_ONLY); break;
+            case PNG_FLAGS_STRATEGY_RLE: png_set_compression_strategy(st, Z_RLE); break;
+            case PNG_FLAGS_STRATEGY_FIXED: png_set_compression_strategy(st, Z_FIXED); break;
+            default:
+                return E_INVALIDARG;
+            }
+
+            // libpng tries each allowed filter per row and keeps the one with the smallest sum of absolute differences
+            if (flags & PNG_FLAGS_FILTER_MASK)
+            {
+                int filters = 0;
+                if (flags & PNG_FLAGS_FILTER_NONE)
+                    filters |= PNG_FILTER_NONE;
+                if (flags & PNG_FLAGS_FILTER_SUB)
+                    filters |= PNG_FILTER_SUB;
+                if (flags & PNG_FLAGS_FILTER_UP)
+                    filters |= PNG_FILTER_UP;
+                if (flags & PNG_FLAGS_FILTER_AVG)
+                    filters |= PNG_FILTER_AVG;
+                if (flags & PNG_FLAGS_FILTER_PAETH)
+                    filters |= PNG_FILTER_PAETH;
+                png_set_filter(st, PNG_FILTER_TYPE_BASE, filters);
+            }
+            return S_OK;
+        }
+
         HRESULT WriteImage(const Image& image) noexcept(false)
         {
             int color_type = PNG_COLOR_TYPE_RGB;
@@ -298,10 +401,11 @@ namespace
             if (using_bgr)
                 png_set_bgr(st);
 
-            const size_t stride = static_cast<size_t>(channel) * image.width;
+            if (image.rowPitch < static_cast<size_t>(channel) * image.width)
+                return E_INVALIDARG;
             std::vector<png_bytep> rows(image.height);
             for (size_t i = 0u; i< image.height; ++i)
-                rows[i] = image.pixels + stride * i;
+                rows[i] = image.pixels + image.rowPitch * i;
             png_write_rows(st, rows.data(), static_cast<uint32_t>(rows.size()));
 
             // actual write will be done here
@@ -311,6 +415,38 @@ namespace
     };
 }
 
+_Use_decl_annotations_
+HRESULT DirectX::GetMetadataFromPNGMemory(
+    const void* pSource,
+    size_t size,
+    TexMetadata& metadata)
+{
+    if (!pSource || !size)
+        return E_INVALIDARG;
+
+    try
+    {
+        PNGMemorySource src{ static_cast<const uint8_t*>(pSource), size };
+        PNGDecompress decoder{};
+        decoder.UseInput(src);
+        decoder.Update();
+        decoder.GetHeader(metadata);
+        return S_OK;
+    }
+    catch (const std::bad_alloc&)
+    {
+        return E_OUTOFMEMORY;
+    }
+    catch (const std::invalid_argument&)
+    {
+        return HRESULT_E_NOT_SUPPORTED;
+    }
+    catch (const std::exception&)
+    {
+        return E_FAIL;
+    }
+}
+
 _Use_decl_annotations_
 HRESULT DirectX::GetMetadataFromPNGFile(
     const wchar_t* file,
@@ -350,6 +486,44 @@ HRESULT DirectX::GetMetadataFromPNGFile(
     }
 }
 
+_Use_decl_annotations_
+HRESULT DirectX::LoadFromPNGMemory(
+    const void* pSource,
+    size_t size,
+    TexMetadata* metadata,
+    ScratchImage& image)
+{
+    if (!pSource || !size)
+        return E_INVALIDARG;
+
+    image.Release();
+
+    try
+    {
+        PNGMemorySource src{ static_cast<const uint8_t*>(pSource), size };
+        PNGDecompress decoder{};
+        decoder.UseInput(src);
+        decoder.Update();
+        if (metadata == nullptr)
+            return decoder.GetImage(image);
+        return decoder.GetImage(*metadata, image);
+    }
+    catch (const std::bad_alloc&)
+    {
+        image.Release();
+        return E_OUTOFMEMORY;
+    }
+    catch (const std::invalid_argument&)
+    {
+        return HRESULT_E_NOT_SUPPORTED;
+    }
+    catch (const std::exception&)
+    {
+        image.Release();
+        return E_FAIL;
+    }
+}
+
 _Use_decl_annotations_
 HRESULT DirectX::LoadFromPNGFile(
     const wchar_t* file,
@@ -396,19 +570,74 @@ HRESULT DirectX::LoadFromPNGFile(
     }
 }
 
+_Use_decl_annotations_
+HRESULT DirectX::SaveToPNGMemory(
+    const Image& image,
+    PNG_FLAGS flags,
+    int compressionLevel,
+    Blob& blob)
+{
+    if (!image.pixels)
+        return E_POINTER;
+
+    blob.Release();
+
+    // Start from the size of stored (level 0) output so most images never reallocate
+    const uint64_t rawSize = uint64_t(image.rowPitch + 1) * uint64_t(image.height);
+    const uint64_t initialSize = rawSize + (rawSize >> 8) + 1024;
+    if (initialSize > SIZE_MAX)
+        return HRESULT_E_ARITHMETIC_OVERFLOW;
+
+    HRESULT hr = blob.Initialize(static_cast<size_t>(initialSize));
+    if (FAILED(hr))
+        return hr;
+
+    try
+    {
+        PNGMemoryDest dest{ &blob, 0 };
+        PNGCompress encoder{};
+        encoder.UseOutput(dest);
+        hr = encoder.SetOptions(flags, compressionLevel);
+        if (SUCCEEDED(hr))
+            hr = encoder.WriteImage(image);
+        if (SUCCEEDED(hr))
+            hr = blob.Trim(dest.offset);
+    }
+    catch (const std::bad_alloc&)
+    {
+        hr = E_OUTOFMEMORY;
+    }
+    catch (const std::exception&)
+    {
+        hr = E_FAIL;
+    }
+
+    if (FAILED(hr))
+        blob.Release();
+
+    return hr;
+}
+
 _Use_decl_annotations_
 HRESULT DirectX::SaveToPNGFile(
     const Image& image,
+    PNG_FLAGS flags,
+    int compressionLevel,
     const wchar_t* file)
 {
     if (!file)
         return E_INVALIDARG;
 
+    if (!image.pixels)
+        return E_POINTER;
+
     try
     {
         auto fout = CreateFILE(file);
         PNGCompress encoder{};
         encoder.UseOutput(fout.get());
+        if (auto hr = encoder.SetOptions(flags, compressionLevel); FAILED(hr))
+            return hr;
         return encoder.WriteImage(image);
     }
     catch (const std::bad_alloc&)
@@ -428,3 +657,11 @@ HRESULT DirectX::SaveToPNGFile(
         return E_FAIL;
     }
 }
+
+_Use_decl_annotations_
+HRESULT DirectX::SaveToPNGFile(
+    const Image& image,
+    const wchar_t* file)
+{
+    return SaveToPNGFile(image, PNG_FLAGS_NONE, 0, file);
+}
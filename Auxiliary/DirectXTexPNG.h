@@ -18,15 +18,60 @@
 
 namespace DirectX
 {
+    enum PNG_FLAGS : unsigned long
+    {
+        PNG_FLAGS_NONE = 0x0,
+
+        PNG_FLAGS_STRATEGY_FILTERED = 0x1,
+        PNG_FLAGS_STRATEGY_HUFFMAN_ONLY = 0x2,
+        PNG_FLAGS_STRATEGY_RLE = 0x3,
+        PNG_FLAGS_STRATEGY_FIXED = 0x4,
+        PNG_FLAGS_STRATEGY_MASK = 0x7,
+        // zlib compression strategy (defaults to Z_DEFAULT_STRATEGY)
+
+        PNG_FLAGS_FILTER_NONE = 0x10,
+        PNG_FLAGS_FILTER_SUB = 0x20,
+        PNG_FLAGS_FILTER_UP = 0x40,
+        PNG_FLAGS_FILTER_AVG = 0x80,
+        PNG_FLAGS_FILTER_PAETH = 0x100,
+        PNG_FLAGS_FILTER_MASK = 0x1F0,
+        // Row filters the encoder may choose from for each row (defaults to libpng's adaptive choice)
+        // Use PNG_FLAGS_FILTER_NONE alone for the fastest encode
+    };
+
+    DEFINE_ENUM_FLAG_OPERATORS(PNG_FLAGS);
+
+    constexpr int PNG_DEFAULT_COMPRESSION = -1;
+        // compressionLevel is the zlib level 0 (store) to 9 (smallest), or this for the zlib default
+
+    HRESULT __cdecl GetMetadataFromPNGMemory(
+        _In_reads_bytes_(size) const void* pSource, _In_ size_t size,
+        _Out_ TexMetadata& metadata);
+
     HRESULT __cdecl GetMetadataFromPNGFile(
         _In_z_ const wchar_t* szFile,
         _Out_ TexMetadata& metadata);
 
+    HRESULT __cdecl LoadFromPNGMemory(
+        _In_reads_bytes_(size) const void* pSource, _In_ size_t size,
+        _Out_opt_ TexMetadata* metadata,
+        _Out_ ScratchImage& image);
+
     HRESULT __cdecl LoadFromPNGFile(
         _In_z_ const wchar_t* szFile,
         _Out_opt_ TexMetadata* metadata,
         _Out_ ScratchImage& image);
 
+    HRESULT __cdecl SaveToPNGMemory(
+        _In_ const Image& image,
+        _In_ PNG_FLAGS flags, _In_ int compressionLevel,
+        _Out_ Blob& blob);
+
+    HRESULT __cdecl SaveToPNGFile(
+        _In_ const Image& image,
+        _In_ PNG_FLAGS flags, _In_ int compressionLevel,
+        _In_z_ const wchar_t* szFile);
+
     HRESULT __cdecl SaveToPNGFile(
         _In_ const Image& image,
         _In_z_ const wchar_t* szFile);
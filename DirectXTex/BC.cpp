@@ -315,12 +315,12 @@ namespace
 
 
     //-------------------------------------------------------------------------------------
-    inline void DecodeBC1(
-        _Out_writes_(NUM_PIXELS_PER_BLOCK) XMVECTOR *pColor,
+    inline void DecodeBC1Colors(
+        _Out_writes_(4) XMVECTOR *pPalette,
         _In_ const D3DX_BC1 *pBC,
         bool isbc1) noexcept
     {
-        assert(pColor && pBC);
+        assert(pPalette && pBC);
         static_assert(sizeof(D3DX_BC1) == 8, "D3DX_BC1 should be 8 bytes");
 
         static XMVECTORF32 s_Scale = { { { 1.f / 31.f, 1.f / 63.f, 1.f / 31.f, 1.f } } };
@@ -349,32 +349,451 @@ namespace
             clr3 = XMVectorLerp(clr0, clr1, 2.f / 3.f);
         }
 
+        pPalette[0] = clr0;
+        pPalette[1] = clr1;
+        pPalette[2] = clr2;
+        pPalette[3] = clr3;
+    }
+
+    inline void DecodeBC1(
+        _Out_writes_(NUM_PIXELS_PER_BLOCK) XMVECTOR *pColor,
+        _In_ const D3DX_BC1 *pBC,
+        bool isbc1) noexcept
+    {
+        assert(pColor && pBC);
+
+        XMVECTOR clr[4];
+        DecodeBC1Colors(clr, pBC, isbc1);
+
         uint32_t dw = pBC->bitmap;
 
         for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i, dw >>= 2)
+            pColor[i] = clr[dw & 3];
+    }
+
+    // Widens 16 2-bit texel indices to the 4-bit layout used by BC_PALETTE
+    inline uint64_t ExpandIndices2(uint32_t dw) noexcept
+    {
+        uint64_t result = 0;
+        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i, dw >>= 2)
+            result |= uint64_t(dw & 3) << (i * 4);
+        return result;
+    }
+
+    // Adaptive 3-bit alpha palette shared by BC3 decoding
+    inline void DecodeBC3Alpha(_Out_writes_(8) float *fAlpha, _In_ const D3DX_BC3 *pBC3) noexcept
+    {
+        fAlpha[0] = static_cast<float>(pBC3->alpha[0]) * (1.0f / 255.0f);
+        fAlpha[1] = static_cast<float>(pBC3->alpha[1]) * (1.0f / 255.0f);
+
+        if (pBC3->alpha[0] > pBC3->alpha[1])
+        {
+            for (size_t i = 1; i < 7; ++i)
+                fAlpha[i + 1] = (fAlpha[0] * float(7u - i) + fAlpha[1] * float(i)) * (1.0f / 7.0f);
+        }
+        else
+        {
+            for (size_t i = 1; i < 5; ++i)
+                fAlpha[i + 1] = (fAlpha[0] * float(5u - i) + fAlpha[1] * float(i)) * (1.0f / 5.0f);
+
+            fAlpha[6] = 0.0f;
+            fAlpha[7] = 1.0f;
+        }
+    }
+
+    // Stores BC1 colors with a zero alpha channel so they combine with a separate alpha plane
+    inline void DecodeBC1ColorPlane(_Out_ BC_PALETTE *pPalette, _In_ const D3DX_BC1 *pBC) noexcept
+    {
+        DecodeBC1Colors(pPalette->entries[0], pBC, false);
+        for (size_t i = 0; i < 4; ++i)
+            pPalette->entries[0][i] = XMVectorSetW(pPalette->entries[0][i], 0.f);
+        pPalette->indices[0] = ExpandIndices2(pBC->bitmap);
+        pPalette->count[0] = 4;
+    }
+
+
+    //-------------------------------------------------------------------------------------
+    // Four-wide version of OptimizeRGB that processes one block per vector lane.
+    //
+    // Each lane follows exactly the same sequence of operations as the scalar version
+    // (including the early outs, which become per-lane masks), so the endpoints match.
+    // Lanes with a step count of 0 are ignored.
+    //-------------------------------------------------------------------------------------
+    void OptimizeRGB4(
+        _Out_writes_(4) HDRColorA *pX,
+        _Out_writes_(4) HDRColorA *pY,
+        _In_reads_(4) const HDRColorA* const* ppPoints,
+        _In_reads_(4) const uint32_t *pSteps,
+        uint32_t flags) noexcept
+    {
+        constexpr float fEpsilon = (0.25f / 64.0f) * (0.25f / 64.0f);
+        static const HDRColorA s_Unused[NUM_PIXELS_PER_BLOCK] = {};
+
+        // Transpose to structure-of-arrays so each vector holds one channel of a point for all four blocks
+        XMVECTOR R[NUM_PIXELS_PER_BLOCK];
+        XMVECTOR G[NUM_PIXELS_PER_BLOCK];
+        XMVECTOR B[NUM_PIXELS_PER_BLOCK];
+
+        const HDRColorA* pPoints[4];
+        for (size_t iLane = 0; iLane < 4; ++iLane)
+        {
+            pPoints[iLane] = (pSteps[iLane] != 0) ? ppPoints[iLane] : s_Unused;
+        }
+
+        for (size_t iPoint = 0; iPoint < NUM_PIXELS_PER_BLOCK; ++iPoint)
+        {
+            XMMATRIX M(
+                XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&pPoints[0][iPoint])),
+                XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&pPoints[1][iPoint])),
+                XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&pPoints[2][iPoint])),
+                XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&pPoints[3][iPoint])));
+            M = XMMatrixTranspose(M);
+
+            R[iPoint] = M.r[0];
+            G[iPoint] = M.r[1];
+            B[iPoint] = M.r[2];
+        }
+
+        const XMVECTOR vValid = XMVectorSetInt(
+            pSteps[0] ? 0xFFFFFFFFu : 0u, pSteps[1] ? 0xFFFFFFFFu : 0u,
+            pSteps[2] ? 0xFFFFFFFFu : 0u, pSteps[3] ? 0xFFFFFFFFu : 0u);
+        const XMVECTOR vThree = XMVectorSetInt(
+            (3 == pSteps[0]) ? 0xFFFFFFFFu : 0u, (3 == pSteps[1]) ? 0xFFFFFFFFu : 0u,
+            (3 == pSteps[2]) ? 0xFFFFFFFFu : 0u, (3 == pSteps[3]) ? 0xFFFFFFFFu : 0u);
+
+        const XMVECTOR vZero = XMVectorZero();
+        const XMVECTOR vOne = XMVectorSplatOne();
+
+        // Find Min and Max points, as starting point
+        XMVECTOR Xr, Xg, Xb;
+        if (flags & BC_FLAGS_UNIFORM)
+        {
+            Xr = Xg = Xb = vOne;
+        }
+        else
+        {
+            Xr = XMVectorReplicate(g_Luminance.r);
+            Xg = XMVectorReplicate(g_Luminance.g);
+            Xb = XMVectorReplicate(g_Luminance.b);
+        }
+
+        XMVECTOR Yr = vZero;
+        XMVECTOR Yg = vZero;
+        XMVECTOR Yb = vZero;
+
+        for (size_t iPoint = 0; iPoint < NUM_PIXELS_PER_BLOCK; iPoint++)
+        {
+            Xr = XMVectorSelect(Xr, R[iPoint], XMVectorLess(R[iPoint], Xr));
+            Xg = XMVectorSelect(Xg, G[iPoint], XMVectorLess(G[iPoint], Xg));
+            Xb = XMVectorSelect(Xb, B[iPoint], XMVectorLess(B[iPoint], Xb));
+
+            Yr = XMVectorSelect(Yr, R[iPoint], XMVectorGreater(R[iPoint], Yr));
+            Yg = XMVectorSelect(Yg, G[iPoint], XMVectorGreater(G[iPoint], Yg));
+            Yb = XMVectorSelect(Yb, B[iPoint], XMVectorGreater(B[iPoint], Yb));
+        }
+
+        // Diagonal axis
+        const XMVECTOR ABr = XMVectorSubtract(Yr, Xr);
+        const XMVECTOR ABg = XMVectorSubtract(Yg, Xg);
+        const XMVECTOR ABb = XMVectorSubtract(Yb, Xb);
+
+        const XMVECTOR fAB = XMVectorAdd(XMVectorAdd(XMVectorMultiply(ABr, ABr), XMVectorMultiply(ABg, ABg)), XMVectorMultiply(ABb, ABb));
+
+        // Single color lanes keep the unsorted Min and Max
+        const XMVECTOR vSingle = XMVectorLess(fAB, XMVectorReplicate(FLT_MIN));
+
+        // Try all four axis directions, to determine which diagonal best fits data
+        const XMVECTOR fABInv = XMVectorDivide(vOne, fAB);
+
+        XMVECTOR Dirr = XMVectorMultiply(ABr, fABInv);
+        XMVECTOR Dirg = XMVectorMultiply(ABg, fABInv);
+        XMVECTOR Dirb = XMVectorMultiply(ABb, fABInv);
+
+        const XMVECTOR vHalf = XMVectorReplicate(0.5f);
+        const XMVECTOR Midr = XMVectorMultiply(XMVectorAdd(Xr, Yr), vHalf);
+        const XMVECTOR Midg = XMVectorMultiply(XMVectorAdd(Xg, Yg), vHalf);
+        const XMVECTOR Midb = XMVectorMultiply(XMVectorAdd(Xb, Yb), vHalf);
+
+        XMVECTOR fDir[4] = { vZero, vZero, vZero, vZero };
+
+        for (size_t iPoint = 0; iPoint < NUM_PIXELS_PER_BLOCK; iPoint++)
+        {
+            const XMVECTOR Ptr = XMVectorMultiply(XMVectorSubtract(R[iPoint], Midr), Dirr);
+            const XMVECTOR Ptg = XMVectorMultiply(XMVectorSubtract(G[iPoint], Midg), Dirg);
+            const XMVECTOR Ptb = XMVectorMultiply(XMVectorSubtract(B[iPoint], Midb), Dirb);
+
+            XMVECTOR f = XMVectorAdd(XMVectorAdd(Ptr, Ptg), Ptb);
+            fDir[0] = XMVectorAdd(fDir[0], XMVectorMultiply(f, f));
+
+            f = XMVectorSubtract(XMVectorAdd(Ptr, Ptg), Ptb);
+            fDir[1] = XMVectorAdd(fDir[1], XMVectorMultiply(f, f));
+
+            f = XMVectorAdd(XMVectorSubtract(Ptr, Ptg), Ptb);
+            fDir[2] = XMVectorAdd(fDir[2], XMVectorMultiply(f, f));
+
+            f = XMVectorSubtract(XMVectorSubtract(Ptr, Ptg), Ptb);
+            fDir[3] = XMVectorAdd(fDir[3], XMVectorMultiply(f, f));
+        }
+
+        // Track bit 1 (swap green) and bit 0 (swap blue) of the winning direction per lane
+        const XMVECTOR vTrue = XMVectorTrueInt();
+        const XMVECTOR vFalse = XMVectorFalseInt();
+
+        XMVECTOR fDirMax = fDir[0];
+        XMVECTOR vSwapG = vFalse;
+        XMVECTOR vSwapB = vFalse;
+
+        for (size_t iDir = 1; iDir < 4; iDir++)
+        {
+            const XMVECTOR vBetter = XMVectorGreater(fDir[iDir], fDirMax);
+            fDirMax = XMVectorSelect(fDirMax, fDir[iDir], vBetter);
+            vSwapG = XMVectorSelect(vSwapG, (iDir & 2) ? vTrue : vFalse, vBetter);
+            vSwapB = XMVectorSelect(vSwapB, (iDir & 1) ? vTrue : vFalse, vBetter);
+        }
+
+        vSwapG = XMVectorAndCInt(vSwapG, vSingle);
+        vSwapB = XMVectorAndCInt(vSwapB, vSingle);
+
+        XMVECTOR f = Xg;
+        Xg = XMVectorSelect(Xg, Yg, vSwapG);
+        Yg = XMVectorSelect(Yg, f, vSwapG);
+
+        f = Xb;
+        Xb = XMVectorSelect(Xb, Yb, vSwapB);
+        Yb = XMVectorSelect(Yb, f, vSwapB);
+
+        // Two color lanes (and single color lanes) don't need to root-find
+        const XMVECTOR vMinLen = XMVectorReplicate(1.0f / 4096.0f);
+        XMVECTOR vActive = XMVectorAndCInt(vValid, XMVectorLess(fAB, vMinLen));
+
+        // Use Newton's Method to find local minima of sum-of-squares error.
+        const XMVECTOR fSteps = XMVectorSelect(XMVectorReplicate(3.0f), XMVectorReplicate(2.0f), vThree);
+
+        // The interpolation weights pC[iStep] and pD[iStep] of the scalar version are exactly
+        // (fSteps - iStep) / fSteps and iStep / fSteps, which is what multiplying by 1/2 or by
+        // the float nearest 1/3 also produces for every step, so they can be computed directly.
+        const XMVECTOR fStepsInv = XMVectorSelect(XMVectorReplicate(1.0f / 3.0f), vHalf, vThree);
+
+        const XMVECTOR vEighth = XMVectorReplicate(1.0f / 8.0f);
+        const XMVECTOR vEpsilon = XMVectorReplicate(fEpsilon);
+
+        for (size_t iIteration = 0; iIteration < 8; iIteration++)
+        {
+            if (XMVector4EqualInt(vActive, vFalse))
+                break;
+
+            // Calculate color direction
+            Dirr = XMVectorSubtract(Yr, Xr);
+            Dirg = XMVectorSubtract(Yg, Xg);
+            Dirb = XMVectorSubtract(Yb, Xb);
+
+            const XMVECTOR fLen = XMVectorAdd(XMVectorAdd(XMVectorMultiply(Dirr, Dirr), XMVectorMultiply(Dirg, Dirg)), XMVectorMultiply(Dirb, Dirb));
+
+            vActive = XMVectorAndCInt(vActive, XMVectorLess(fLen, vMinLen));
+            if (XMVector4EqualInt(vActive, vFalse))
+                break;
+
+            const XMVECTOR fScale = XMVectorDivide(fSteps, fLen);
+
+            Dirr = XMVectorMultiply(Dirr, fScale);
+            Dirg = XMVectorMultiply(Dirg, fScale);
+            Dirb = XMVectorMultiply(Dirb, fScale);
+
+            // Evaluate function, and derivatives
+            XMVECTOR d2X = vZero;
+            XMVECTOR d2Y = vZero;
+            XMVECTOR dXr = vZero, dXg = vZero, dXb = vZero;
+            XMVECTOR dYr = vZero, dYg = vZero, dYb = vZero;
+
+            for (size_t iPoint = 0; iPoint < NUM_PIXELS_PER_BLOCK; iPoint++)
+            {
+                const XMVECTOR fDot = XMVectorAdd(
+                    XMVectorAdd(
+                        XMVectorMultiply(XMVectorSubtract(R[iPoint], Xr), Dirr),
+                        XMVectorMultiply(XMVectorSubtract(G[iPoint], Xg), Dirg)),
+                    XMVectorMultiply(XMVectorSubtract(B[iPoint], Xb), Dirb));
+
+                XMVECTOR vStep = XMVectorTruncate(XMVectorAdd(fDot, vHalf));
+                vStep = XMVectorSelect(vStep, fSteps, XMVectorGreaterOrEqual(fDot, fSteps));
+                vStep = XMVectorSelect(vStep, vZero, XMVectorLessOrEqual(fDot, vZero));
+
+                const XMVECTOR C = XMVectorMultiply(XMVectorSubtract(fSteps, vStep), fStepsInv);
+                const XMVECTOR D = XMVectorMultiply(vStep, fStepsInv);
+
+                const XMVECTOR Diffr = XMVectorSubtract(XMVectorAdd(XMVectorMultiply(Xr, C), XMVectorMultiply(Yr, D)), R[iPoint]);
+                const XMVECTOR Diffg = XMVectorSubtract(XMVectorAdd(XMVectorMultiply(Xg, C), XMVectorMultiply(Yg, D)), G[iPoint]);
+                const XMVECTOR Diffb = XMVectorSubtract(XMVectorAdd(XMVectorMultiply(Xb, C), XMVectorMultiply(Yb, D)), B[iPoint]);
+
+                const XMVECTOR fC = XMVectorMultiply(C, vEighth);
+                const XMVECTOR fD = XMVectorMultiply(D, vEighth);
+
+                d2X = XMVectorAdd(d2X, XMVectorMultiply(fC, C));
+                dXr = XMVectorAdd(dXr, XMVectorMultiply(fC, Diffr));
+                dXg = XMVectorAdd(dXg, XMVectorMultiply(fC, Diffg));
+                dXb = XMVectorAdd(dXb, XMVectorMultiply(fC, Diffb));
+
+                d2Y = XMVectorAdd(d2Y, XMVectorMultiply(fD, D));
+                dYr = XMVectorAdd(dYr, XMVectorMultiply(fD, Diffr));
+                dYg = XMVectorAdd(dYg, XMVectorMultiply(fD, Diffg));
+                dYb = XMVectorAdd(dYb, XMVectorMultiply(fD, Diffb));
+            }
+
+            // Move endpoints
+            const XMVECTOR vMoveX = XMVectorAndInt(vActive, XMVectorGreater(d2X, vZero));
+            const XMVECTOR fX = XMVectorDivide(g_XMNegativeOne, d2X);
+
+            Xr = XMVectorSelect(Xr, XMVectorAdd(Xr, XMVectorMultiply(dXr, fX)), vMoveX);
+            Xg = XMVectorSelect(Xg, XMVectorAdd(Xg, XMVectorMultiply(dXg, fX)), vMoveX);
+            Xb = XMVectorSelect(Xb, XMVectorAdd(Xb, XMVectorMultiply(dXb, fX)), vMoveX);
+
+            const XMVECTOR vMoveY = XMVectorAndInt(vActive, XMVectorGreater(d2Y, vZero));
+            const XMVECTOR fY = XMVectorDivide(g_XMNegativeOne, d2Y);
+
+            Yr = XMVectorSelect(Yr, XMVectorAdd(Yr, XMVectorMultiply(dYr, fY)), vMoveY);
+            Yg = XMVectorSelect(Yg, XMVectorAdd(Yg, XMVectorMultiply(dYg, fY)), vMoveY);
+            Yb = XMVectorSelect(Yb, XMVectorAdd(Yb, XMVectorMultiply(dYb, fY)), vMoveY);
+
+            XMVECTOR vDone = XMVectorAndInt(XMVectorLess(XMVectorMultiply(dXr, dXr), vEpsilon), XMVectorLess(XMVectorMultiply(dXg, dXg), vEpsilon));
+            vDone = XMVectorAndInt(vDone, XMVectorLess(XMVectorMultiply(dXb, dXb), vEpsilon));
+            vDone = XMVectorAndInt(vDone, XMVectorLess(XMVectorMultiply(dYr, dYr), vEpsilon));
+            vDone = XMVectorAndInt(vDone, XMVectorLess(XMVectorMultiply(dYg, dYg), vEpsilon));
+            vDone = XMVectorAndInt(vDone, XMVectorLess(XMVectorMultiply(dYb, dYb), vEpsilon));
+
+            vActive = XMVectorAndCInt(vActive, vDone);
+        }
+
+        XMFLOAT4A outX[3], outY[3];
+        XMStoreFloat4A(&outX[0], Xr);
+        XMStoreFloat4A(&outX[1], Xg);
+        XMStoreFloat4A(&outX[2], Xb);
+        XMStoreFloat4A(&outY[0], Yr);
+        XMStoreFloat4A(&outY[1], Yg);
+        XMStoreFloat4A(&outY[2], Yb);
+
+        for (size_t iLane = 0; iLane < 4; ++iLane)
+        {
+            const float* px0 = &outX[0].x;
+            const float* px1 = &outX[1].x;
+            const float* px2 = &outX[2].x;
+            const float* py0 = &outY[0].x;
+            const float* py1 = &outY[1].x;
+            const float* py2 = &outY[2].x;
+
+            pX[iLane] = HDRColorA(px0[iLane], px1[iLane], px2[iLane], 1.0f);
+            pY[iLane] = HDRColorA(py0[iLane], py1[iLane], py2[iLane], 1.0f);
+        }
+    }
+
+
+    //-------------------------------------------------------------------------------------
+    // Optimal single-color tables, indexed by the 8-bit channel value. Each entry holds the
+    // 5-bit (or 6-bit) endpoint pair whose 1/3 interpolant best reproduces that value.
+    //-------------------------------------------------------------------------------------
+    struct BC1SolidTable
+    {
+        uint8_t c0[256];
+        uint8_t c1[256];
+
+        explicit BC1SolidTable(uint32_t uMax) noexcept : c0{}, c1{}
         {
-            switch (dw & 3)
+            const float fScale = 1.0f / float(uMax);
+
+            for (uint32_t v = 0; v < 256; ++v)
             {
-            case 0: pColor[i] = clr0; break;
-            case 1: pColor[i] = clr1; break;
-            case 2: pColor[i] = clr2; break;
+                const float fTarget = float(v) * (1.0f / 255.0f);
+                float fBestErr = FLT_MAX;
+                uint32_t uBestSpread = UINT32_MAX;
+
+                for (uint32_t a = 0; a <= uMax; ++a)
+                {
+                    for (uint32_t b = 0; b <= uMax; ++b)
+                    {
+                        // Matches the decoder's lerp of the two endpoints at 1/3
+                        const float fA = float(a) * fScale;
+                        const float fB = float(b) * fScale;
+                        const float fErr = fabsf(fA + (fB - fA) * (1.0f / 3.0f) - fTarget);
+                        const uint32_t uSpread = (a > b) ? (a - b) : (b - a);
 
-            case 3:
-            default: pColor[i] = clr3; break;
+                        if (fErr < fBestErr || (fErr == fBestErr && uSpread < uBestSpread))
+                        {
+                            fBestErr = fErr;
+                            uBestSpread = uSpread;
+                            c0[v] = static_cast<uint8_t>(a);
+                            c1[v] = static_cast<uint8_t>(b);
+                        }
+                    }
+                }
             }
         }
+    };
+
+    inline uint32_t SolidTableIndex(float f) noexcept
+    {
+        f = (f < 0.0f) ? 0.0f : (f > 1.0f) ? 1.0f : f;
+        return static_cast<uint32_t>(f * 255.0f + 0.5f);
     }
 
+    inline bool IsSingleColorRGB(_In_reads_(NUM_PIXELS_PER_BLOCK) const HDRColorA *pColor) noexcept
+    {
+        for (size_t i = 1; i < NUM_PIXELS_PER_BLOCK; ++i)
+        {
+            if (pColor[i].r != pColor[0].r || pColor[i].g != pColor[0].g || pColor[i].b != pColor[0].b)
+                return false;
+        }
+        return true;
+    }
 
     //-------------------------------------------------------------------------------------
-    void EncodeBC1(
+    // Writes a block of a single color using the optimal endpoint tables
+    //-------------------------------------------------------------------------------------
+    void EncodeSingleColorBC1(_Out_ D3DX_BC1 *pBC, const HDRColorA& color) noexcept
+    {
+        static const BC1SolidTable s_Table5(31);
+        static const BC1SolidTable s_Table6(63);
+
+        const uint32_t r = SolidTableIndex(color.r);
+        const uint32_t g = SolidTableIndex(color.g);
+        const uint32_t b = SolidTableIndex(color.b);
+
+        const auto w0 = static_cast<uint16_t>((s_Table5.c0[r] << 11) | (s_Table6.c0[g] << 5) | s_Table5.c0[b]);
+        const auto w1 = static_cast<uint16_t>((s_Table5.c1[r] << 11) | (s_Table6.c1[g] << 5) | s_Table5.c1[b]);
+
+        if (w0 == w1)
+        {
+            pBC->rgb[0] = w0;
+            pBC->rgb[1] = w1;
+            pBC->bitmap = 0x00000000;
+        }
+        else if (w0 > w1)
+        {
+            // 4-color block, every texel at the 1/3 step (index 2)
+            pBC->rgb[0] = w0;
+            pBC->rgb[1] = w1;
+            pBC->bitmap = 0xaaaaaaaa;
+        }
+        else
+        {
+            // Swapped endpoints put the same value at the 2/3 step (index 3)
+            pBC->rgb[0] = w1;
+            pBC->rgb[1] = w0;
+            pBC->bitmap = 0xffffffff;
+        }
+    }
+
+
+    //-------------------------------------------------------------------------------------
+    // Determines the number of color steps for the block and quantizes it for OptimizeRGB,
+    // returning 0 if the block was fully transparent or solid and has already been written.
+    //-------------------------------------------------------------------------------------
+    uint32_t PrepareBC1(
         _Out_ D3DX_BC1 *pBC,
+        _Out_writes_(NUM_PIXELS_PER_BLOCK) HDRColorA *Color,
         _In_reads_(NUM_PIXELS_PER_BLOCK) const HDRColorA *pColor,
         bool bColorKey,
         float threshold,
         uint32_t flags) noexcept
     {
-        assert(pBC && pColor);
+        assert(pBC && Color && pColor);
         static_assert(sizeof(D3DX_BC1) == 8, "D3DX_BC1 should be 8 bytes");
 
         // Determine if we need to colorkey this block
@@ -395,7 +814,7 @@ namespace
                 pBC->rgb[0] = 0x0000;
                 pBC->rgb[1] = 0xffff;
                 pBC->bitmap = 0xffffffff;
-                return;
+                return 0;
             }
 
             uSteps = (uColorKey > 0) ? 3u : 4u;
@@ -405,10 +824,16 @@ namespace
             uSteps = 4u;
         }
 
+        // Solid blocks skip the optimizer entirely
+        if ((4 == uSteps) && !(flags & BC_FLAGS_DITHER_RGB) && IsSingleColorRGB(pColor))
+        {
+            EncodeSingleColorBC1(pBC, pColor[0]);
+            return 0;
+        }
+
         // Quantize block to R56B5, using Floyd Stienberg error diffusion.  This
         // increases the chance that colors will map directly to the quantized
         // axis endpoints.
-        HDRColorA Color[NUM_PIXELS_PER_BLOCK];
         HDRColorA Error[NUM_PIXELS_PER_BLOCK];
 
         if (flags & BC_FLAGS_DITHER_RGB)
@@ -489,11 +914,24 @@ namespace
             }
         }
 
-        // Perform 6D root finding function to find two endpoints of color axis.
-        // Then quantize and sort the endpoints depending on mode.
-        HDRColorA ColorA, ColorB, ColorC, ColorD;
+        return uSteps;
+    }
 
-        OptimizeRGB(&ColorA, &ColorB, Color, uSteps, flags);
+
+    //-------------------------------------------------------------------------------------
+    // Quantizes and sorts the endpoints found by OptimizeRGB, then encodes the indices
+    //-------------------------------------------------------------------------------------
+    void FinishBC1(
+        _Out_ D3DX_BC1 *pBC,
+        _In_reads_(NUM_PIXELS_PER_BLOCK) const HDRColorA *pColor,
+        _In_reads_(NUM_PIXELS_PER_BLOCK) const HDRColorA *Color,
+        HDRColorA ColorA,
+        HDRColorA ColorB,
+        uint32_t uSteps,
+        float threshold,
+        uint32_t flags) noexcept
+    {
+        HDRColorA ColorC, ColorD;
 
         if (flags & BC_FLAGS_UNIFORM)
         {
@@ -597,10 +1035,11 @@ namespace
 
         // Encode colors
         uint32_t dw = 0;
+        HDRColorA Error[NUM_PIXELS_PER_BLOCK];
         if (flags & BC_FLAGS_DITHER_RGB)
             memset(Error, 0x00, NUM_PIXELS_PER_BLOCK * sizeof(HDRColorA));
 
-        for (i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
         {
             if ((3 == uSteps) && (pColor[i].a < threshold))
             {
@@ -684,6 +1123,71 @@ namespace
         pBC->bitmap = dw;
     }
 
+
+    //-------------------------------------------------------------------------------------
+    void EncodeBC1(
+        _Out_ D3DX_BC1 *pBC,
+        _In_reads_(NUM_PIXELS_PER_BLOCK) const HDRColorA *pColor,
+        bool bColorKey,
+        float threshold,
+        uint32_t flags) noexcept
+    {
+        HDRColorA Color[NUM_PIXELS_PER_BLOCK];
+        const uint32_t uSteps = PrepareBC1(pBC, Color, pColor, bColorKey, threshold, flags);
+        if (!uSteps)
+            return;
+
+        // Perform 6D root finding function to find two endpoints of color axis.
+        // Then quantize and sort the endpoints depending on mode.
+        HDRColorA ColorA, ColorB;
+        OptimizeRGB(&ColorA, &ColorB, Color, uSteps, flags);
+
+        FinishBC1(pBC, pColor, Color, ColorA, ColorB, uSteps, threshold, flags);
+    }
+
+
+    //-------------------------------------------------------------------------------------
+    // Encodes the color part of up to four blocks, sharing one OptimizeRGB4 root finding
+    //-------------------------------------------------------------------------------------
+    void EncodeBC1x4(
+        _In_reads_(count) D3DX_BC1 *const *ppBC,
+        _In_reads_(count) const HDRColorA *const *ppColor,
+        size_t count,
+        bool bColorKey,
+        float threshold,
+        uint32_t flags) noexcept
+    {
+        assert(count > 0 && count <= 4);
+
+        HDRColorA Color[4][NUM_PIXELS_PER_BLOCK];
+        const HDRColorA* pColors[4] = {};
+        uint32_t uSteps[4] = {};
+
+        for (size_t j = 0; j < count; ++j)
+        {
+            uSteps[j] = PrepareBC1(ppBC[j], Color[j], ppColor[j], bColorKey, threshold, flags);
+            pColors[j] = Color[j];
+        }
+
+        HDRColorA ColorA[4], ColorB[4];
+
+    #ifdef COLOR_WEIGHTS
+        for (size_t j = 0; j < count; ++j)
+        {
+            if (uSteps[j])
+                OptimizeRGB(&ColorA[j], &ColorB[j], Color[j], uSteps[j], flags);
+        }
+    #else
+        OptimizeRGB4(ColorA, ColorB, pColors, uSteps, flags);
+    #endif
+
+        for (size_t j = 0; j < count; ++j)
+        {
+            if (uSteps[j])
+                FinishBC1(ppBC[j], ppColor[j], Color[j], ColorA[j], ColorB[j], uSteps[j], threshold, flags);
+        }
+    }
+
     //-------------------------------------------------------------------------------------
 #ifdef COLOR_WEIGHTS
     void EncodeSolidBC1(_Out_ D3DX_BC1 *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK) const HDRColorA *pColor)
@@ -717,83 +1221,388 @@ namespace
         pBC->bitmap = 0x00000000;
     }
 #endif // COLOR_WEIGHTS
-}
-
-
-//=====================================================================================
-// Entry points
-//=====================================================================================
-
-//-------------------------------------------------------------------------------------
-// BC1 Compression
-//-------------------------------------------------------------------------------------
-_Use_decl_annotations_
-void DirectX::D3DXDecodeBC1(XMVECTOR *pColor, const uint8_t *pBC) noexcept
-{
-    auto pBC1 = reinterpret_cast<const D3DX_BC1 *>(pBC);
-    DecodeBC1(pColor, pBC1, true);
-}
-
-_Use_decl_annotations_
-void DirectX::D3DXEncodeBC1(uint8_t *pBC, const XMVECTOR *pColor, float threshold, uint32_t flags) noexcept
-{
-    assert(pBC && pColor);
 
-    HDRColorA Color[NUM_PIXELS_PER_BLOCK];
 
-    if (flags & BC_FLAGS_DITHER_A)
+    //-------------------------------------------------------------------------------------
+    // Converts a BC1 block to HDRColorA, applying alpha dithering before the colorkey test
+    //-------------------------------------------------------------------------------------
+    void LoadBC1(
+        _Out_writes_(NUM_PIXELS_PER_BLOCK) HDRColorA *Color,
+        _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR *pColor,
+        uint32_t flags) noexcept
     {
-        float fError[NUM_PIXELS_PER_BLOCK] = {};
 
-        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+        if (flags & BC_FLAGS_DITHER_A)
         {
-            HDRColorA clr;
-            XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&clr), pColor[i]);
-
-            const float fAlph = clr.a + fError[i];
-
-            Color[i].r = clr.r;
-            Color[i].g = clr.g;
-            Color[i].b = clr.b;
-            Color[i].a = static_cast<float>(static_cast<int32_t>(clr.a + fError[i] + 0.5f));
-
-            const float fDiff = fAlph - Color[i].a;
+            float fError[NUM_PIXELS_PER_BLOCK] = {};
 
-            if (3 != (i & 3))
+            for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
             {
-                assert(i < 15);
-                _Analysis_assume_(i < 15);
-                fError[i + 1] += fDiff * (7.0f / 16.0f);
-            }
+                HDRColorA clr;
+                XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&clr), pColor[i]);
 
-            if (i < 12)
-            {
-                if (i & 3)
-                    fError[i + 3] += fDiff * (3.0f / 16.0f);
+                const float fAlph = clr.a + fError[i];
+
+                Color[i].r = clr.r;
+                Color[i].g = clr.g;
+                Color[i].b = clr.b;
+                Color[i].a = static_cast<float>(static_cast<int32_t>(clr.a + fError[i] + 0.5f));
 
-                fError[i + 4] += fDiff * (5.0f / 16.0f);
+                const float fDiff = fAlph - Color[i].a;
 
                 if (3 != (i & 3))
                 {
-                    assert(i < 11);
-                    _Analysis_assume_(i < 11);
-                    fError[i + 5] += fDiff * (1.0f / 16.0f);
+                    assert(i < 15);
+                    _Analysis_assume_(i < 15);
+                    fError[i + 1] += fDiff * (7.0f / 16.0f);
+                }
+
+                if (i < 12)
+                {
+                    if (i & 3)
+                        fError[i + 3] += fDiff * (3.0f / 16.0f);
+
+                    fError[i + 4] += fDiff * (5.0f / 16.0f);
+
+                    if (3 != (i & 3))
+                    {
+                        assert(i < 11);
+                        _Analysis_assume_(i < 11);
+                        fError[i + 5] += fDiff * (1.0f / 16.0f);
+                    }
+                }
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+            {
+                XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&Color[i]), pColor[i]);
+            }
+        }
+    }
+
+
+    //-------------------------------------------------------------------------------------
+    void EncodeBC2Alpha(
+        _Out_ D3DX_BC2 *pBC2,
+        _In_reads_(NUM_PIXELS_PER_BLOCK) const HDRColorA *Color,
+        uint32_t flags) noexcept
+    {
+        // 4-bit alpha part.  Dithered using Floyd Stienberg error diffusion.
+        pBC2->bitmap[0] = 0;
+        pBC2->bitmap[1] = 0;
+
+        float fError[NUM_PIXELS_PER_BLOCK] = {};
+        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+        {
+            float fAlph = Color[i].a;
+            if (flags & BC_FLAGS_DITHER_A)
+                fAlph += fError[i];
+
+            const auto u = static_cast<uint32_t>(fAlph * 15.0f + 0.5f);
+
+            pBC2->bitmap[i >> 3] >>= 4;
+            pBC2->bitmap[i >> 3] |= (u << 28);
+
+            if (flags & BC_FLAGS_DITHER_A)
+            {
+                const float fDiff = fAlph - float(u) * (1.0f / 15.0f);
+
+                if (3 != (i & 3))
+                {
+                    assert(i < 15);
+                    _Analysis_assume_(i < 15);
+                    fError[i + 1] += fDiff * (7.0f / 16.0f);
+                }
+
+                if (i < 12)
+                {
+                    if (i & 3)
+                        fError[i + 3] += fDiff * (3.0f / 16.0f);
+
+                    fError[i + 4] += fDiff * (5.0f / 16.0f);
+
+                    if (3 != (i & 3))
+                    {
+                        assert(i < 11);
+                        _Analysis_assume_(i < 11);
+                        fError[i + 5] += fDiff * (1.0f / 16.0f);
+                    }
                 }
             }
         }
     }
-    else
+
+
+    //-------------------------------------------------------------------------------------
+    void EncodeBC3Alpha(
+        _Out_ D3DX_BC3 *pBC3,
+        _In_reads_(NUM_PIXELS_PER_BLOCK) const HDRColorA *Color,
+        uint32_t flags) noexcept
     {
+        // Quantize block to A8, using Floyd Stienberg error diffusion.  This
+        // increases the chance that colors will map directly to the quantized
+        // axis endpoints.
+        float fAlpha[NUM_PIXELS_PER_BLOCK] = {};
+        float fError[NUM_PIXELS_PER_BLOCK] = {};
+
+        float fMinAlpha = Color[0].a;
+        float fMaxAlpha = Color[0].a;
+
         for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
         {
-            XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&Color[i]), pColor[i]);
+            float fAlph = Color[i].a;
+            if (flags & BC_FLAGS_DITHER_A)
+                fAlph += fError[i];
+
+            fAlpha[i] = static_cast<float>(static_cast<int32_t>(fAlph * 255.0f + 0.5f)) * (1.0f / 255.0f);
+
+            if (fAlpha[i] < fMinAlpha)
+                fMinAlpha = fAlpha[i];
+            else if (fAlpha[i] > fMaxAlpha)
+                fMaxAlpha = fAlpha[i];
+
+            if (flags & BC_FLAGS_DITHER_A)
+            {
+                const float fDiff = fAlph - fAlpha[i];
+
+                if (3 != (i & 3))
+                {
+                    assert(i < 15);
+                    _Analysis_assume_(i < 15);
+                    fError[i + 1] += fDiff * (7.0f / 16.0f);
+                }
+
+                if (i < 12)
+                {
+                    if (i & 3)
+                        fError[i + 3] += fDiff * (3.0f / 16.0f);
+
+                    fError[i + 4] += fDiff * (5.0f / 16.0f);
+
+                    if (3 != (i & 3))
+                    {
+                        assert(i < 11);
+                        _Analysis_assume_(i < 11);
+                        fError[i + 5] += fDiff * (1.0f / 16.0f);
+                    }
+                }
+            }
+        }
+
+        // Alpha part
+        if (1.0f == fMinAlpha)
+        {
+            pBC3->alpha[0] = 0xff;
+            pBC3->alpha[1] = 0xff;
+            memset(pBC3->bitmap, 0x00, 6);
+            return;
+        }
+
+        if (!(flags & BC_FLAGS_DITHER_A))
+        {
+            // Solid alpha is exact with both endpoints at the quantized value. This compares the
+            // clamped 8-bit values, since fMinAlpha/fMaxAlpha start from the unquantized first texel.
+            uint32_t uMinAlpha = 255;
+            uint32_t uMaxAlpha = 0;
+            for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+            {
+                const float fClamped = (fAlpha[i] < 0.0f) ? 0.0f : (fAlpha[i] > 1.0f) ? 1.0f : fAlpha[i];
+                const auto uAlpha = static_cast<uint32_t>(fClamped * 255.0f + 0.5f);
+                uMinAlpha = std::min(uMinAlpha, uAlpha);
+                uMaxAlpha = std::max(uMaxAlpha, uAlpha);
+            }
+
+            if (uMinAlpha == uMaxAlpha)
+            {
+                pBC3->alpha[0] = static_cast<uint8_t>(uMinAlpha);
+                pBC3->alpha[1] = static_cast<uint8_t>(uMinAlpha);
+                memset(pBC3->bitmap, 0x00, 6);
+                return;
+            }
+        }
+
+        // Optimize and Quantize Min and Max values
+        const uint32_t uSteps = ((0.0f == fMinAlpha) || (1.0f == fMaxAlpha)) ? 6u : 8u;
+
+        float fAlphaA, fAlphaB;
+        OptimizeAlpha<false>(&fAlphaA, &fAlphaB, fAlpha, uSteps);
+
+        auto const bAlphaA = static_cast<uint8_t>(static_cast<int32_t>(fAlphaA * 255.0f + 0.5f));
+        auto const bAlphaB = static_cast<uint8_t>(static_cast<int32_t>(fAlphaB * 255.0f + 0.5f));
+
+        fAlphaA = static_cast<float>(bAlphaA) * (1.0f / 255.0f);
+        fAlphaB = static_cast<float>(bAlphaB) * (1.0f / 255.0f);
+
+        // Setup block
+        if ((8 == uSteps) && (bAlphaA == bAlphaB))
+        {
+            pBC3->alpha[0] = bAlphaA;
+            pBC3->alpha[1] = bAlphaB;
+            memset(pBC3->bitmap, 0x00, 6);
+            return;
+        }
+
+        static const size_t pSteps6[] = { 0, 2, 3, 4, 5, 1 };
+        static const size_t pSteps8[] = { 0, 2, 3, 4, 5, 6, 7, 1 };
+
+        const size_t *pSteps;
+        float fStep[8] = {};
+
+        if (6 == uSteps)
+        {
+            pBC3->alpha[0] = bAlphaA;
+            pBC3->alpha[1] = bAlphaB;
+
+            fStep[0] = fAlphaA;
+            fStep[1] = fAlphaB;
+
+            for (size_t i = 1; i < 5; ++i)
+                fStep[i + 1] = (fStep[0] * float(5u - i) + fStep[1] * float(i)) * (1.0f / 5.0f);
+
+            fStep[6] = 0.0f;
+            fStep[7] = 1.0f;
+
+            pSteps = pSteps6;
+        }
+        else
+        {
+            pBC3->alpha[0] = bAlphaB;
+            pBC3->alpha[1] = bAlphaA;
+
+            fStep[0] = fAlphaB;
+            fStep[1] = fAlphaA;
+
+            for (size_t i = 1; i < 7; ++i)
+                fStep[i + 1] = (fStep[0] * float(7u - i) + fStep[1] * float(i)) * (1.0f / 7.0f);
+
+            pSteps = pSteps8;
+        }
+
+        // Encode alpha bitmap
+        auto const fSteps = static_cast<float>(uSteps - 1);
+        const float fScale = (fStep[0] != fStep[1]) ? (fSteps / (fStep[1] - fStep[0])) : 0.0f;
+
+        if (flags & BC_FLAGS_DITHER_A)
+            memset(fError, 0x00, NUM_PIXELS_PER_BLOCK * sizeof(float));
+
+        for (size_t iSet = 0; iSet < 2; iSet++)
+        {
+            uint32_t dw = 0;
+
+            const size_t iMin = iSet * 8;
+            const size_t iLim = iMin + 8;
+
+            for (size_t i = iMin; i < iLim; ++i)
+            {
+                float fAlph = Color[i].a;
+                if (flags & BC_FLAGS_DITHER_A)
+                    fAlph += fError[i];
+                const float fDot = (fAlph - fStep[0]) * fScale;
+
+                uint32_t iStep;
+                if (fDot <= 0.0f)
+                    iStep = ((6 == uSteps) && (fAlph <= fStep[0] * 0.5f)) ? 6u : 0u;
+                else if (fDot >= fSteps)
+                    iStep = ((6 == uSteps) && (fAlph >= (fStep[1] + 1.0f) * 0.5f)) ? 7u : 1u;
+                else
+                    iStep = uint32_t(pSteps[uint32_t(fDot + 0.5f)]);
+
+                dw = (iStep << 21) | (dw >> 3);
+
+                if (flags & BC_FLAGS_DITHER_A)
+                {
+                    const float fDiff = (fAlph - fStep[iStep]);
+
+                    if (3 != (i & 3))
+                        fError[i + 1] += fDiff * (7.0f / 16.0f);
+
+                    if (i < 12)
+                    {
+                        if (i & 3)
+                            fError[i + 3] += fDiff * (3.0f / 16.0f);
+
+                        fError[i + 4] += fDiff * (5.0f / 16.0f);
+
+                        if (3 != (i & 3))
+                            fError[i + 5] += fDiff * (1.0f / 16.0f);
+                    }
+                }
+            }
+
+            pBC3->bitmap[0 + iSet * 3] = reinterpret_cast<uint8_t *>(&dw)[0];
+            pBC3->bitmap[1 + iSet * 3] = reinterpret_cast<uint8_t *>(&dw)[1];
+            pBC3->bitmap[2 + iSet * 3] = reinterpret_cast<uint8_t *>(&dw)[2];
         }
     }
+}
+
+
+//=====================================================================================
+// Entry points
+//=====================================================================================
+
+//-------------------------------------------------------------------------------------
+// BC1 Compression
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+void DirectX::D3DXDecodeBC1(XMVECTOR *pColor, const uint8_t *pBC) noexcept
+{
+    auto pBC1 = reinterpret_cast<const D3DX_BC1 *>(pBC);
+    DecodeBC1(pColor, pBC1, true);
+}
+
+_Use_decl_annotations_
+void DirectX::D3DXDecodeBC1Palette(BC_PALETTE *pPalette, const uint8_t *pBC) noexcept
+{
+    assert(pPalette && pBC);
+
+    auto pBC1 = reinterpret_cast<const D3DX_BC1 *>(pBC);
+
+    DecodeBC1Colors(pPalette->entries[0], pBC1, true);
+    pPalette->indices[0] = ExpandIndices2(pBC1->bitmap);
+    pPalette->count[0] = 4;
+    pPalette->indices[1] = 0;
+    pPalette->count[1] = 0;
+}
+
+_Use_decl_annotations_
+void DirectX::D3DXEncodeBC1(uint8_t *pBC, const XMVECTOR *pColor, float threshold, uint32_t flags) noexcept
+{
+    assert(pBC && pColor);
+
+    HDRColorA Color[NUM_PIXELS_PER_BLOCK];
+    LoadBC1(Color, pColor, flags);
 
     auto pBC1 = reinterpret_cast<D3DX_BC1 *>(pBC);
     EncodeBC1(pBC1, Color, true, threshold, flags);
 }
 
+_Use_decl_annotations_
+void DirectX::D3DXEncodeBC1Batch(uint8_t *pBC, const XMVECTOR *pColor, size_t count, float threshold, uint32_t flags) noexcept
+{
+    assert(pBC && pColor);
+
+    for (size_t j = 0; j < count; j += 4)
+    {
+        const size_t n = std::min<size_t>(4, count - j);
+
+        HDRColorA Color[4][NUM_PIXELS_PER_BLOCK];
+        D3DX_BC1 *pBC1[4] = {};
+        const HDRColorA *pColors[4] = {};
+
+        for (size_t k = 0; k < n; ++k)
+        {
+            LoadBC1(Color[k], pColor + (j + k) * NUM_PIXELS_PER_BLOCK, flags);
+            pBC1[k] = reinterpret_cast<D3DX_BC1 *>(pBC + (j + k) * sizeof(D3DX_BC1));
+            pColors[k] = Color[k];
+        }
+
+        EncodeBC1x4(pBC1, pColors, n, true, threshold, flags);
+    }
+}
+
 
 //-------------------------------------------------------------------------------------
 // BC2 Compression
@@ -824,6 +1633,23 @@ void DirectX::D3DXDecodeBC2(XMVECTOR *pColor, const uint8_t *pBC) noexcept
         pColor[i] = XMVectorSetW(pColor[i], static_cast<float>(dw & 0xf) * (1.0f / 15.0f));
 }
 
+_Use_decl_annotations_
+void DirectX::D3DXDecodeBC2Palette(BC_PALETTE *pPalette, const uint8_t *pBC) noexcept
+{
+    assert(pPalette && pBC);
+
+    auto pBC2 = reinterpret_cast<const D3DX_BC2 *>(pBC);
+
+    DecodeBC1ColorPlane(pPalette, &pBC2->bc1);
+
+    // Explicit 4-bit alpha already matches the palette index layout
+    for (size_t i = 0; i < 16; ++i)
+        pPalette->entries[1][i] = XMVectorSet(0.f, 0.f, 0.f, static_cast<float>(i) * (1.0f / 15.0f));
+
+    pPalette->indices[1] = uint64_t(pBC2->bitmap[0]) | (uint64_t(pBC2->bitmap[1]) << 32);
+    pPalette->count[1] = 16;
+}
+
 _Use_decl_annotations_
 void DirectX::D3DXEncodeBC2(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flags) noexcept
 {
@@ -838,60 +1664,57 @@ void DirectX::D3DXEncodeBC2(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flags
 
     auto pBC2 = reinterpret_cast<D3DX_BC2 *>(pBC);
 
-    // 4-bit alpha part.  Dithered using Floyd Stienberg error diffusion.
-    pBC2->bitmap[0] = 0;
-    pBC2->bitmap[1] = 0;
+    EncodeBC2Alpha(pBC2, Color, flags);
 
-    float fError[NUM_PIXELS_PER_BLOCK] = {};
-    for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+    // RGB part
+#ifdef COLOR_WEIGHTS
+    if (!pBC2->bitmap[0] && !pBC2->bitmap[1])
     {
-        float fAlph = Color[i].a;
-        if (flags & BC_FLAGS_DITHER_A)
-            fAlph += fError[i];
+        EncodeSolidBC1(pBC2->dxt1, Color);
+        return;
+    }
+#endif // COLOR_WEIGHTS
 
-        const auto u = static_cast<uint32_t>(fAlph * 15.0f + 0.5f);
+    EncodeBC1(&pBC2->bc1, Color, false, 0.f, flags);
+}
 
-        pBC2->bitmap[i >> 3] >>= 4;
-        pBC2->bitmap[i >> 3] |= (u << 28);
+_Use_decl_annotations_
+void DirectX::D3DXEncodeBC2Batch(uint8_t *pBC, const XMVECTOR *pColor, size_t count, uint32_t flags) noexcept
+{
+    assert(pBC && pColor);
 
-        if (flags & BC_FLAGS_DITHER_A)
-        {
-            const float fDiff = fAlph - float(u) * (1.0f / 15.0f);
+#ifdef COLOR_WEIGHTS
+    for (size_t j = 0; j < count; ++j)
+    {
+        D3DXEncodeBC2(pBC + j * sizeof(D3DX_BC2), pColor + j * NUM_PIXELS_PER_BLOCK, flags);
+    }
+#else
+    for (size_t j = 0; j < count; j += 4)
+    {
+        const size_t n = std::min<size_t>(4, count - j);
 
-            if (3 != (i & 3))
-            {
-                assert(i < 15);
-                _Analysis_assume_(i < 15);
-                fError[i + 1] += fDiff * (7.0f / 16.0f);
-            }
+        HDRColorA Color[4][NUM_PIXELS_PER_BLOCK];
+        D3DX_BC1 *pBC1[4] = {};
+        const HDRColorA *pColors[4] = {};
 
-            if (i < 12)
+        for (size_t k = 0; k < n; ++k)
+        {
+            const XMVECTOR *pSrc = pColor + (j + k) * NUM_PIXELS_PER_BLOCK;
+            for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
             {
-                if (i & 3)
-                    fError[i + 3] += fDiff * (3.0f / 16.0f);
+                XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&Color[k][i]), pSrc[i]);
+            }
 
-                fError[i + 4] += fDiff * (5.0f / 16.0f);
+            auto pBC2 = reinterpret_cast<D3DX_BC2 *>(pBC + (j + k) * sizeof(D3DX_BC2));
+            EncodeBC2Alpha(pBC2, Color[k], flags);
 
-                if (3 != (i & 3))
-                {
-                    assert(i < 11);
-                    _Analysis_assume_(i < 11);
-                    fError[i + 5] += fDiff * (1.0f / 16.0f);
-                }
-            }
+            pBC1[k] = &pBC2->bc1;
+            pColors[k] = Color[k];
         }
-    }
 
-    // RGB part
-#ifdef COLOR_WEIGHTS
-    if (!pBC2->bitmap[0] && !pBC2->bitmap[1])
-    {
-        EncodeSolidBC1(pBC2->dxt1, Color);
-        return;
+        EncodeBC1x4(pBC1, pColors, n, false, 0.f, flags);
     }
 #endif // COLOR_WEIGHTS
-
-    EncodeBC1(&pBC2->bc1, Color, false, 0.f, flags);
 }
 
 
@@ -911,23 +1734,7 @@ void DirectX::D3DXDecodeBC3(XMVECTOR *pColor, const uint8_t *pBC) noexcept
 
     // Adaptive 3-bit alpha part
     float fAlpha[8];
-
-    fAlpha[0] = static_cast<float>(pBC3->alpha[0]) * (1.0f / 255.0f);
-    fAlpha[1] = static_cast<float>(pBC3->alpha[1]) * (1.0f / 255.0f);
-
-    if (pBC3->alpha[0] > pBC3->alpha[1])
-    {
-        for (size_t i = 1; i < 7; ++i)
-            fAlpha[i + 1] = (fAlpha[0] * float(7u - i) + fAlpha[1] * float(i)) * (1.0f / 7.0f);
-    }
-    else
-    {
-        for (size_t i = 1; i < 5; ++i)
-            fAlpha[i + 1] = (fAlpha[0] * float(5u - i) + fAlpha[1] * float(i)) * (1.0f / 5.0f);
-
-        fAlpha[6] = 0.0f;
-        fAlpha[7] = 1.0f;
-    }
+    DecodeBC3Alpha(fAlpha, pBC3);
 
     uint32_t dw = uint32_t(pBC3->bitmap[0]) | uint32_t(pBC3->bitmap[1] << 8) | uint32_t(pBC3->bitmap[2] << 16);
 
@@ -941,201 +1748,81 @@ void DirectX::D3DXDecodeBC3(XMVECTOR *pColor, const uint8_t *pBC) noexcept
 }
 
 _Use_decl_annotations_
-void DirectX::D3DXEncodeBC3(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flags) noexcept
+void DirectX::D3DXDecodeBC3Palette(BC_PALETTE *pPalette, const uint8_t *pBC) noexcept
 {
-    assert(pBC && pColor);
-    static_assert(sizeof(D3DX_BC3) == 16, "D3DX_BC3 should be 16 bytes");
+    assert(pPalette && pBC);
 
-    HDRColorA Color[NUM_PIXELS_PER_BLOCK];
-    for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
-    {
-        XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&Color[i]), pColor[i]);
-    }
+    auto pBC3 = reinterpret_cast<const D3DX_BC3 *>(pBC);
 
-    auto pBC3 = reinterpret_cast<D3DX_BC3 *>(pBC);
+    DecodeBC1ColorPlane(pPalette, &pBC3->bc1);
 
-    // Quantize block to A8, using Floyd Stienberg error diffusion.  This
-    // increases the chance that colors will map directly to the quantized
-    // axis endpoints.
-    float fAlpha[NUM_PIXELS_PER_BLOCK] = {};
-    float fError[NUM_PIXELS_PER_BLOCK] = {};
+    float fAlpha[8];
+    DecodeBC3Alpha(fAlpha, pBC3);
 
-    float fMinAlpha = Color[0].a;
-    float fMaxAlpha = Color[0].a;
+    for (size_t i = 0; i < 8; ++i)
+        pPalette->entries[1][i] = XMVectorSet(0.f, 0.f, 0.f, fAlpha[i]);
 
-    for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+    uint64_t indices = 0;
+    for (size_t half = 0; half < 2; ++half)
     {
-        float fAlph = Color[i].a;
-        if (flags & BC_FLAGS_DITHER_A)
-            fAlph += fError[i];
+        uint32_t dw = uint32_t(pBC3->bitmap[half * 3]) | uint32_t(pBC3->bitmap[half * 3 + 1] << 8) | uint32_t(pBC3->bitmap[half * 3 + 2] << 16);
 
-        fAlpha[i] = static_cast<float>(static_cast<int32_t>(fAlph * 255.0f + 0.5f)) * (1.0f / 255.0f);
-
-        if (fAlpha[i] < fMinAlpha)
-            fMinAlpha = fAlpha[i];
-        else if (fAlpha[i] > fMaxAlpha)
-            fMaxAlpha = fAlpha[i];
-
-        if (flags & BC_FLAGS_DITHER_A)
-        {
-            const float fDiff = fAlph - fAlpha[i];
-
-            if (3 != (i & 3))
-            {
-                assert(i < 15);
-                _Analysis_assume_(i < 15);
-                fError[i + 1] += fDiff * (7.0f / 16.0f);
-            }
-
-            if (i < 12)
-            {
-                if (i & 3)
-                    fError[i + 3] += fDiff * (3.0f / 16.0f);
-
-                fError[i + 4] += fDiff * (5.0f / 16.0f);
-
-                if (3 != (i & 3))
-                {
-                    assert(i < 11);
-                    _Analysis_assume_(i < 11);
-                    fError[i + 5] += fDiff * (1.0f / 16.0f);
-                }
-            }
-        }
+        for (size_t i = half * 8; i < half * 8 + 8; ++i, dw >>= 3)
+            indices |= uint64_t(dw & 0x7) << (i * 4);
     }
+    pPalette->indices[1] = indices;
+    pPalette->count[1] = 8;
+}
 
-#ifdef COLOR_WEIGHTS
-    if (0.0f == fMaxAlpha)
+_Use_decl_annotations_
+void DirectX::D3DXEncodeBC3(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flags) noexcept
+{
+    assert(pBC && pColor);
+    static_assert(sizeof(D3DX_BC3) == 16, "D3DX_BC3 should be 16 bytes");
+
+    HDRColorA Color[NUM_PIXELS_PER_BLOCK];
+    for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
     {
-        EncodeSolidBC1(&pBC3->dxt1, Color);
-        pBC3->alpha[0] = 0x00;
-        pBC3->alpha[1] = 0x00;
-        memset(pBC3->bitmap, 0x00, 6);
+        XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&Color[i]), pColor[i]);
     }
-#endif
+
+    auto pBC3 = reinterpret_cast<D3DX_BC3 *>(pBC);
 
     // RGB part
     EncodeBC1(&pBC3->bc1, Color, false, 0.f, flags);
 
     // Alpha part
-    if (1.0f == fMinAlpha)
-    {
-        pBC3->alpha[0] = 0xff;
-        pBC3->alpha[1] = 0xff;
-        memset(pBC3->bitmap, 0x00, 6);
-        return;
-    }
-
-    // Optimize and Quantize Min and Max values
-    const uint32_t uSteps = ((0.0f == fMinAlpha) || (1.0f == fMaxAlpha)) ? 6u : 8u;
-
-    float fAlphaA, fAlphaB;
-    OptimizeAlpha<false>(&fAlphaA, &fAlphaB, fAlpha, uSteps);
-
-    auto const bAlphaA = static_cast<uint8_t>(static_cast<int32_t>(fAlphaA * 255.0f + 0.5f));
-    auto const bAlphaB = static_cast<uint8_t>(static_cast<int32_t>(fAlphaB * 255.0f + 0.5f));
-
-    fAlphaA = static_cast<float>(bAlphaA) * (1.0f / 255.0f);
-    fAlphaB = static_cast<float>(bAlphaB) * (1.0f / 255.0f);
-
-    // Setup block
-    if ((8 == uSteps) && (bAlphaA == bAlphaB))
-    {
-        pBC3->alpha[0] = bAlphaA;
-        pBC3->alpha[1] = bAlphaB;
-        memset(pBC3->bitmap, 0x00, 6);
-        return;
-    }
-
-    static const size_t pSteps6[] = { 0, 2, 3, 4, 5, 1 };
-    static const size_t pSteps8[] = { 0, 2, 3, 4, 5, 6, 7, 1 };
-
-    const size_t *pSteps;
-    float fStep[8] = {};
-
-    if (6 == uSteps)
-    {
-        pBC3->alpha[0] = bAlphaA;
-        pBC3->alpha[1] = bAlphaB;
-
-        fStep[0] = fAlphaA;
-        fStep[1] = fAlphaB;
-
-        for (size_t i = 1; i < 5; ++i)
-            fStep[i + 1] = (fStep[0] * float(5u - i) + fStep[1] * float(i)) * (1.0f / 5.0f);
-
-        fStep[6] = 0.0f;
-        fStep[7] = 1.0f;
-
-        pSteps = pSteps6;
-    }
-    else
-    {
-        pBC3->alpha[0] = bAlphaB;
-        pBC3->alpha[1] = bAlphaA;
-
-        fStep[0] = fAlphaB;
-        fStep[1] = fAlphaA;
-
-        for (size_t i = 1; i < 7; ++i)
-            fStep[i + 1] = (fStep[0] * float(7u - i) + fStep[1] * float(i)) * (1.0f / 7.0f);
-
-        pSteps = pSteps8;
-    }
-
-    // Encode alpha bitmap
-    auto const fSteps = static_cast<float>(uSteps - 1);
-    const float fScale = (fStep[0] != fStep[1]) ? (fSteps / (fStep[1] - fStep[0])) : 0.0f;
+    EncodeBC3Alpha(pBC3, Color, flags);
+}
 
-    if (flags & BC_FLAGS_DITHER_A)
-        memset(fError, 0x00, NUM_PIXELS_PER_BLOCK * sizeof(float));
+_Use_decl_annotations_
+void DirectX::D3DXEncodeBC3Batch(uint8_t *pBC, const XMVECTOR *pColor, size_t count, uint32_t flags) noexcept
+{
+    assert(pBC && pColor);
 
-    for (size_t iSet = 0; iSet < 2; iSet++)
+    for (size_t j = 0; j < count; j += 4)
     {
-        uint32_t dw = 0;
+        const size_t n = std::min<size_t>(4, count - j);
 
-        const size_t iMin = iSet * 8;
-        const size_t iLim = iMin + 8;
+        HDRColorA Color[4][NUM_PIXELS_PER_BLOCK];
+        D3DX_BC1 *pBC1[4] = {};
+        const HDRColorA *pColors[4] = {};
 
-        for (size_t i = iMin; i < iLim; ++i)
+        for (size_t k = 0; k < n; ++k)
         {
-            float fAlph = Color[i].a;
-            if (flags & BC_FLAGS_DITHER_A)
-                fAlph += fError[i];
-            const float fDot = (fAlph - fStep[0]) * fScale;
-
-            uint32_t iStep;
-            if (fDot <= 0.0f)
-                iStep = ((6 == uSteps) && (fAlph <= fStep[0] * 0.5f)) ? 6u : 0u;
-            else if (fDot >= fSteps)
-                iStep = ((6 == uSteps) && (fAlph >= (fStep[1] + 1.0f) * 0.5f)) ? 7u : 1u;
-            else
-                iStep = uint32_t(pSteps[uint32_t(fDot + 0.5f)]);
-
-            dw = (iStep << 21) | (dw >> 3);
-
-            if (flags & BC_FLAGS_DITHER_A)
+            const XMVECTOR *pSrc = pColor + (j + k) * NUM_PIXELS_PER_BLOCK;
+            for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
             {
-                const float fDiff = (fAlph - fStep[iStep]);
-
-                if (3 != (i & 3))
-                    fError[i + 1] += fDiff * (7.0f / 16.0f);
+                XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&Color[k][i]), pSrc[i]);
+            }
 
-                if (i < 12)
-                {
-                    if (i & 3)
-                        fError[i + 3] += fDiff * (3.0f / 16.0f);
+            auto pBC3 = reinterpret_cast<D3DX_BC3 *>(pBC + (j + k) * sizeof(D3DX_BC3));
+            EncodeBC3Alpha(pBC3, Color[k], flags);
 
-                    fError[i + 4] += fDiff * (5.0f / 16.0f);
-
-                    if (3 != (i & 3))
-                        fError[i + 5] += fDiff * (1.0f / 16.0f);
-                }
-            }
+            pBC1[k] = &pBC3->bc1;
+            pColors[k] = Color[k];
         }
 
-        pBC3->bitmap[0 + iSet * 3] = reinterpret_cast<uint8_t *>(&dw)[0];
-        pBC3->bitmap[1 + iSet * 3] = reinterpret_cast<uint8_t *>(&dw)[1];
-        pBC3->bitmap[2 + iSet * 3] = reinterpret_cast<uint8_t *>(&dw)[2];
+        EncodeBC1x4(pBC1, pColors, n, false, 0.f, flags);
     }
 }
@@ -31,6 +31,9 @@ namespace DirectX
     {
         BC_FLAGS_NONE = 0x0,
 
+        BC_FLAGS_BC7_LEVEL_MASK = 0xF,
+        // BC7 search level (1 is fastest, 7 is exhaustive); 0 uses the default search
+
         BC_FLAGS_DITHER_RGB = 0x10000,
         // Enables dithering for RGB colors for BC1-3
 
@@ -45,6 +48,12 @@ namespace DirectX
 
         BC_FLAGS_FORCE_BC7_MODE6 = 0x100000,
         // BC7 should only use mode 6; skip other modes
+
+        BC_FLAGS_BC6H_QUICK = 0x200000,
+        // BC6H prunes modes by the block's dynamic range and stops at the first good enough fit
+
+        BC_FLAGS_SCALAR = 0x400000,
+        // Encode one block at a time instead of using the multi-block encoders (output is identical)
     };
 
     //-------------------------------------------------------------------------------------
@@ -179,6 +188,16 @@ namespace DirectX
     };
 #pragma pack(pop)
 
+    // Per-block palette used to decode directly into packed pixels. Each texel selects one
+    // entry from each plane with a 4-bit index (texel 0 in the low nibble). The planes hold
+    // disjoint channels with the others left at zero, so the packed entries combine with OR.
+    struct BC_PALETTE
+    {
+        XMVECTOR    entries[2][NUM_PIXELS_PER_BLOCK];
+        uint64_t    indices[2];
+        size_t      count[2];   // 0 for an unused plane
+    };
+
 //-------------------------------------------------------------------------------------
 // Templates
 //-------------------------------------------------------------------------------------
@@ -329,11 +348,33 @@ namespace DirectX
     void D3DXDecodeBC6HS(_Out_writes_(NUM_PIXELS_PER_BLOCK) XMVECTOR *pColor, _In_reads_(16) const uint8_t *pBC) noexcept;
     void D3DXDecodeBC7(_Out_writes_(NUM_PIXELS_PER_BLOCK) XMVECTOR *pColor, _In_reads_(16) const uint8_t *pBC) noexcept;
 
+    typedef void (*BC_DECODE_PALETTE)(BC_PALETTE *pPalette, const uint8_t *pBC);
+
+    void D3DXDecodeBC1Palette(_Out_ BC_PALETTE *pPalette, _In_reads_(8) const uint8_t *pBC) noexcept;
+    void D3DXDecodeBC2Palette(_Out_ BC_PALETTE *pPalette, _In_reads_(16) const uint8_t *pBC) noexcept;
+    void D3DXDecodeBC3Palette(_Out_ BC_PALETTE *pPalette, _In_reads_(16) const uint8_t *pBC) noexcept;
+    void D3DXDecodeBC4UPalette(_Out_ BC_PALETTE *pPalette, _In_reads_(8) const uint8_t *pBC) noexcept;
+    void D3DXDecodeBC4SPalette(_Out_ BC_PALETTE *pPalette, _In_reads_(8) const uint8_t *pBC) noexcept;
+    void D3DXDecodeBC5UPalette(_Out_ BC_PALETTE *pPalette, _In_reads_(16) const uint8_t *pBC) noexcept;
+    void D3DXDecodeBC5SPalette(_Out_ BC_PALETTE *pPalette, _In_reads_(16) const uint8_t *pBC) noexcept;
+        // Palette entries are computed exactly as the D3DXDecodeBC* functions compute texels,
+        // so resolving the indices reproduces their output.
+
+    void D3DXDecodeBC7RGBA8(_Out_writes_(NUM_PIXELS_PER_BLOCK * 4) uint8_t *pColor, _In_reads_(16) const uint8_t *pBC) noexcept;
+        // BC7 endpoints and interpolation are 8-bit, so this yields the R8G8B8A8 texels without a float pass
+
     void D3DXEncodeBC1(_Out_writes_(8) uint8_t *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR *pColor, _In_ float threshold, _In_ uint32_t flags) noexcept;
         // BC1 requires one additional parameter, so it doesn't match signature of BC_ENCODE above
 
     void D3DXEncodeBC2(_Out_writes_(16) uint8_t *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR *pColor, _In_ uint32_t flags) noexcept;
     void D3DXEncodeBC3(_Out_writes_(16) uint8_t *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR *pColor, _In_ uint32_t flags) noexcept;
+
+    void D3DXEncodeBC1Batch(_Out_writes_(count * 8) uint8_t *pBC, _In_reads_(count * NUM_PIXELS_PER_BLOCK) const XMVECTOR *pColor, _In_ size_t count, _In_ float threshold, _In_ uint32_t flags) noexcept;
+    void D3DXEncodeBC2Batch(_Out_writes_(count * 16) uint8_t *pBC, _In_reads_(count * NUM_PIXELS_PER_BLOCK) const XMVECTOR *pColor, _In_ size_t count, _In_ uint32_t flags) noexcept;
+    void D3DXEncodeBC3Batch(_Out_writes_(count * 16) uint8_t *pBC, _In_reads_(count * NUM_PIXELS_PER_BLOCK) const XMVECTOR *pColor, _In_ size_t count, _In_ uint32_t flags) noexcept;
+        // Encodes 'count' consecutive blocks, solving the color endpoints of four blocks at a time in SIMD lanes.
+        // Output is identical to calling D3DXEncodeBC1/2/3 on each block.
+
     void D3DXEncodeBC4U(_Out_writes_(8) uint8_t *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR *pColor, _In_ uint32_t flags) noexcept;
     void D3DXEncodeBC4S(_Out_writes_(8) uint8_t *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR *pColor, _In_ uint32_t flags) noexcept;
     void D3DXEncodeBC5U(_Out_writes_(16) uint8_t *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR *pColor, _In_ uint32_t flags) noexcept;
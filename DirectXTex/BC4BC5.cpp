@@ -294,30 +294,62 @@ namespace
 
 
     //------------------------------------------------------------------------------
-    inline void FindEndPointsBC5U(
-        _In_reads_(BLOCK_SIZE) const float theTexelsU[],
-        _In_reads_(BLOCK_SIZE) const float theTexelsV[],
-        _Out_ uint8_t &endpointU_0,
-        _Out_ uint8_t &endpointU_1,
-        _Out_ uint8_t &endpointV_0,
-        _Out_ uint8_t &endpointV_1) noexcept
+    // A solid channel is reproduced to within 1/14 of a quantization step by a pair
+    // of adjacent endpoints in 8-value mode, so it bypasses the endpoint optimizer.
+    //------------------------------------------------------------------------------
+    bool IsSolidChannel(_In_reads_(BLOCK_SIZE) const float theTexelsU[]) noexcept
     {
-        //Encoding the U and V channel by BC4 codec separately.
-        FindEndPointsBC4U(theTexelsU, endpointU_0, endpointU_1);
-        FindEndPointsBC4U(theTexelsV, endpointV_0, endpointV_1);
+        for (size_t i = 1; i < BLOCK_SIZE; ++i)
+        {
+            if (theTexelsU[i] != theTexelsU[0])
+                return false;
+        }
+        return true;
     }
 
-    inline void FindEndPointsBC5S(
-        _In_reads_(BLOCK_SIZE) const float theTexelsU[],
-        _In_reads_(BLOCK_SIZE) const float theTexelsV[],
-        _Out_ int8_t &endpointU_0,
-        _Out_ int8_t &endpointU_1,
-        _Out_ int8_t &endpointV_0,
-        _Out_ int8_t &endpointV_1) noexcept
+    template <class BC4, typename T>
+    void EncodeSolidBC4(_Inout_ BC4* pBC, int iLow, uint32_t uFrac, int iMax) noexcept
     {
-        //Encoding the U and V channel by BC4 codec separately.
-        FindEndPointsBC4S(theTexelsU, endpointU_0, endpointU_1);
-        FindEndPointsBC4S(theTexelsV, endpointV_0, endpointV_1);
+        // uFrac is the weight of the upper endpoint in sevenths
+        if (uFrac == 7)
+        {
+            ++iLow;
+            uFrac = 0;
+        }
+
+        pBC->data = 0;
+
+        if (!uFrac || iLow >= iMax)
+        {
+            pBC->red_0 = pBC->red_1 = static_cast<T>(std::min(iLow, iMax));
+            return;
+        }
+
+        pBC->red_0 = static_cast<T>(iLow + 1);
+        pBC->red_1 = static_cast<T>(iLow);
+
+        for (size_t i = 0; i < BLOCK_SIZE; ++i)
+        {
+            pBC->SetIndex(i, 8u - uFrac);
+        }
+    }
+
+    void EncodeSolidBC4U(_Inout_ BC4_UNORM* pBC, float fVal) noexcept
+    {
+        fVal = isnan(fVal) ? 0.f : std::max(0.f, std::min(1.f, fVal)) * 255.f;
+
+        const float fLow = floorf(fVal);
+        const auto uFrac = static_cast<uint32_t>((fVal - fLow) * 7.f + 0.5f);
+        EncodeSolidBC4<BC4_UNORM, uint8_t>(pBC, static_cast<int>(fLow), uFrac, 255);
+    }
+
+    void EncodeSolidBC4S(_Inout_ BC4_SNORM* pBC, float fVal) noexcept
+    {
+        fVal = isnan(fVal) ? 0.f : std::max(-1.f, std::min(1.f, fVal)) * 127.f;
+
+        const float fLow = floorf(fVal);
+        const auto uFrac = static_cast<uint32_t>((fVal - fLow) * 7.f + 0.5f);
+        EncodeSolidBC4<BC4_SNORM, int8_t>(pBC, static_cast<int>(fLow), uFrac, 127);
     }
 
 
@@ -375,6 +407,60 @@ namespace
             pBC->SetIndex(i, uBestIndex);
         }
     }
+
+
+    //------------------------------------------------------------------------------
+    void EncodeChannelBC4U(
+        _Inout_ BC4_UNORM* pBC,
+        _In_reads_(NUM_PIXELS_PER_BLOCK) const float theTexelsU[]) noexcept
+    {
+        if (IsSolidChannel(theTexelsU))
+        {
+            EncodeSolidBC4U(pBC, theTexelsU[0]);
+            return;
+        }
+
+        FindEndPointsBC4U(theTexelsU, pBC->red_0, pBC->red_1);
+        FindClosestUNORM(pBC, theTexelsU);
+    }
+
+    void EncodeChannelBC4S(
+        _Inout_ BC4_SNORM* pBC,
+        _In_reads_(NUM_PIXELS_PER_BLOCK) const float theTexelsU[]) noexcept
+    {
+        if (IsSolidChannel(theTexelsU))
+        {
+            EncodeSolidBC4S(pBC, theTexelsU[0]);
+            return;
+        }
+
+        FindEndPointsBC4S(theTexelsU, pBC->red_0, pBC->red_1);
+        FindClosestSNORM(pBC, theTexelsU);
+    }
+
+
+    //------------------------------------------------------------------------------
+    // Fills one BC_PALETTE plane from a BC4 channel. The red channel carries the
+    // constant alpha of 1 that the per-texel decoders produce.
+    template <class BC4>
+    void DecodeChannelPalette(
+        _Out_ BC_PALETTE* pPalette,
+        size_t plane,
+        _In_ const BC4* pBC) noexcept
+    {
+        for (size_t i = 0; i < 8; ++i)
+        {
+            const float f = pBC->DecodeFromIndex(i);
+            pPalette->entries[plane][i] = (plane == 0) ? XMVectorSet(f, 0, 0, 1.0f) : XMVectorSet(0, f, 0, 0);
+        }
+
+        uint64_t indices = 0;
+        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+            indices |= uint64_t(pBC->GetIndex(i)) << (i * 4);
+
+        pPalette->indices[plane] = indices;
+        pPalette->count[plane] = 8;
+    }
 }
 
 
@@ -415,6 +501,26 @@ void DirectX::D3DXDecodeBC4S(XMVECTOR *pColor, const uint8_t *pBC) noexcept
     }
 }
 
+_Use_decl_annotations_
+void DirectX::D3DXDecodeBC4UPalette(BC_PALETTE *pPalette, const uint8_t *pBC) noexcept
+{
+    assert(pPalette && pBC);
+
+    DecodeChannelPalette(pPalette, 0, reinterpret_cast<const BC4_UNORM*>(pBC));
+    pPalette->indices[1] = 0;
+    pPalette->count[1] = 0;
+}
+
+_Use_decl_annotations_
+void DirectX::D3DXDecodeBC4SPalette(BC_PALETTE *pPalette, const uint8_t *pBC) noexcept
+{
+    assert(pPalette && pBC);
+
+    DecodeChannelPalette(pPalette, 0, reinterpret_cast<const BC4_SNORM*>(pBC));
+    pPalette->indices[1] = 0;
+    pPalette->count[1] = 0;
+}
+
 _Use_decl_annotations_
 void DirectX::D3DXEncodeBC4U(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flags) noexcept
 {
@@ -432,8 +538,7 @@ void DirectX::D3DXEncodeBC4U(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flag
         theTexelsU[i] = XMVectorGetX(pColor[i]);
     }
 
-    FindEndPointsBC4U(theTexelsU, pBC4->red_0, pBC4->red_1);
-    FindClosestUNORM(pBC4, theTexelsU);
+    EncodeChannelBC4U(pBC4, theTexelsU);
 }
 
 _Use_decl_annotations_
@@ -453,8 +558,7 @@ void DirectX::D3DXEncodeBC4S(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flag
         theTexelsU[i] = XMVectorGetX(pColor[i]);
     }
 
-    FindEndPointsBC4S(theTexelsU, pBC4->red_0, pBC4->red_1);
-    FindClosestSNORM(pBC4, theTexelsU);
+    EncodeChannelBC4S(pBC4, theTexelsU);
 }
 
 
@@ -493,6 +597,24 @@ void DirectX::D3DXDecodeBC5S(XMVECTOR *pColor, const uint8_t *pBC) noexcept
     }
 }
 
+_Use_decl_annotations_
+void DirectX::D3DXDecodeBC5UPalette(BC_PALETTE *pPalette, const uint8_t *pBC) noexcept
+{
+    assert(pPalette && pBC);
+
+    DecodeChannelPalette(pPalette, 0, reinterpret_cast<const BC4_UNORM*>(pBC));
+    DecodeChannelPalette(pPalette, 1, reinterpret_cast<const BC4_UNORM*>(pBC + sizeof(BC4_UNORM)));
+}
+
+_Use_decl_annotations_
+void DirectX::D3DXDecodeBC5SPalette(BC_PALETTE *pPalette, const uint8_t *pBC) noexcept
+{
+    assert(pPalette && pBC);
+
+    DecodeChannelPalette(pPalette, 0, reinterpret_cast<const BC4_SNORM*>(pBC));
+    DecodeChannelPalette(pPalette, 1, reinterpret_cast<const BC4_SNORM*>(pBC + sizeof(BC4_SNORM)));
+}
+
 _Use_decl_annotations_
 void DirectX::D3DXEncodeBC5U(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flags) noexcept
 {
@@ -515,16 +637,9 @@ void DirectX::D3DXEncodeBC5U(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flag
         theTexelsV[i] = clr.y;
     }
 
-    FindEndPointsBC5U(
-        theTexelsU,
-        theTexelsV,
-        pBCR->red_0,
-        pBCR->red_1,
-        pBCG->red_0,
-        pBCG->red_1);
-
-    FindClosestUNORM(pBCR, theTexelsU);
-    FindClosestUNORM(pBCG, theTexelsV);
+    // Encoding the U and V channel by BC4 codec separately.
+    EncodeChannelBC4U(pBCR, theTexelsU);
+    EncodeChannelBC4U(pBCG, theTexelsV);
 }
 
 _Use_decl_annotations_
@@ -549,14 +664,7 @@ void DirectX::D3DXEncodeBC5S(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flag
         theTexelsV[i] = clr.y;
     }
 
-    FindEndPointsBC5S(
-        theTexelsU,
-        theTexelsV,
-        pBCR->red_0,
-        pBCR->red_1,
-        pBCG->red_0,
-        pBCG->red_1);
-
-    FindClosestSNORM(pBCR, theTexelsU);
-    FindClosestSNORM(pBCG, theTexelsV);
+    // Encoding the U and V channel by BC4 codec separately.
+    EncodeChannelBC4S(pBCR, theTexelsU);
+    EncodeChannelBC4S(pBCG, theTexelsV);
 }
@@ -40,10 +40,35 @@ namespace
 
     constexpr size_t BC6H_NUM_CHANNELS = 3;
     constexpr size_t BC6H_MAX_SHAPES = 32;
+    constexpr int BC6H_QUICK_FLAT_RANGE = 64;           // max per-channel span (in f16 units) treated as flat
+    constexpr float BC6H_QUICK_MAX_ERROR = 16 * 3 * 16; // block error to stop searching at (4 f16 units per channel)
 
     constexpr size_t BC7_NUM_CHANNELS = 4;
     constexpr size_t BC7_MAX_SHAPES = 64;
 
+    // BC7 search levels (see BC_FLAGS_BC7_LEVEL_MASK)
+    struct BC7Level
+    {
+        uint8_t uModeMask;      // bit per mode to try
+        uint8_t uShapeShift;    // refine the best (shapes >> shift) rough-MSE candidates, at least 1
+        bool bAllRotations;     // try all rotations & index modes for modes 4 & 5
+        bool bOptimize;         // perturb endpoints after the initial fit
+    };
+
+    constexpr BC7Level g_BC7Levels[] =
+    {
+        { 0xFA, 2, true,  true  },  // 0: default
+        { 0x40, 2, true,  false },  // 1: mode 6 only, no endpoint refinement
+        { 0x40, 2, true,  true  },  // 2: mode 6 only
+        { 0xC2, 6, false, true  },  // 3: modes 1, 6 & 7 with the single best shape
+        { 0xFA, 4, false, true  },  // 4
+        { 0xFA, 3, true,  true  },  // 5
+        { 0xFA, 2, true,  true  },  // 6
+        { 0xFF, 2, true,  true  },  // 7: all modes
+    };
+
+    static_assert(std::size(g_BC7Levels) == TEX_BC7_LEVEL_MAX + 1, "g_BC7Levels should cover every TEX_BC7_LEVEL_*");
+
     constexpr int32_t BC67_WEIGHT_MAX = 64;
     constexpr uint32_t BC67_WEIGHT_SHIFT = 6;
     constexpr int32_t BC67_WEIGHT_ROUND = 32;
@@ -327,6 +352,42 @@ namespace
     const int g_aWeights2[] = { 0, 21, 43, 64 };
     const int g_aWeights3[] = { 0, 9, 18, 27, 37, 46, 55, 64 };
     const int g_aWeights4[] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    // Optimal 7-bit endpoint pair for each 8-bit channel value of a solid BC7 mode 5 block,
+    // with every texel at color index 1
+    constexpr size_t BC7_SOLID_INDEX = 1;
+
+    struct BC7SolidTable
+    {
+        uint8_t lo[256];
+        uint8_t hi[256];
+
+        BC7SolidTable() noexcept : lo{}, hi{}
+        {
+            const int w = g_aWeights2[BC7_SOLID_INDEX];
+
+            for (int v = 0; v < 256; ++v)
+            {
+                int iBestErr = INT32_MAX;
+                for (int a = 0; a < 128; ++a)
+                {
+                    for (int b = 0; b < 128; ++b)
+                    {
+                        const int ea = (a << 1) | (a >> 6);
+                        const int eb = (b << 1) | (b >> 6);
+                        const int iVal = (ea * (BC67_WEIGHT_MAX - w) + eb * w + BC67_WEIGHT_ROUND) >> BC67_WEIGHT_SHIFT;
+                        const int iErr = abs(iVal - v);
+                        if (iErr < iBestErr)
+                        {
+                            iBestErr = iErr;
+                            lo[v] = static_cast<uint8_t>(a);
+                            hi[v] = static_cast<uint8_t>(b);
+                        }
+                    }
+                }
+            }
+        }
+    };
 }
 
 namespace DirectX
@@ -667,7 +728,7 @@ namespace
     {
     public:
         void Decode(_In_ bool bSigned, _Out_writes_(NUM_PIXELS_PER_BLOCK) HDRColorA* pOut) const noexcept;
-        void Encode(_In_ bool bSigned, _In_reads_(NUM_PIXELS_PER_BLOCK) const HDRColorA* const pIn) noexcept;
+        void Encode(_In_ bool bSigned, _In_ uint32_t flags, _In_reads_(NUM_PIXELS_PER_BLOCK) const HDRColorA* const pIn) noexcept;
 
     private:
     #pragma warning(push)
@@ -755,6 +816,8 @@ namespace
         void EmitBlock(_In_ const EncodeParams* pEP, _In_reads_(BC6H_MAX_REGIONS) const INTEndPntPair aEndPts[],
             _In_reads_(NUM_PIXELS_PER_BLOCK) const size_t aIndices[]) noexcept;
         void Refine(_Inout_ EncodeParams* pEP) noexcept;
+        void RefineShapes(_Inout_ EncodeParams* pEP, _In_ size_t uItemsShift) noexcept;
+        void EncodeQuick(_Inout_ EncodeParams* pEP) noexcept;
 
         static void GeneratePaletteUnquantized(_In_ const EncodeParams* pEP, _In_ size_t uRegion, _Out_writes_(BC6H_MAX_INDICES) INTColor aPalette[]) noexcept;
         float MapColors(_In_ const EncodeParams* pEP, _In_ size_t uRegion, _In_ size_t np, _In_reads_(np) const size_t* auIndex) const noexcept;
@@ -774,6 +837,7 @@ namespace
     {
     public:
         void Decode(_Out_writes_(NUM_PIXELS_PER_BLOCK) HDRColorA* pOut) const noexcept;
+        void Decode(_Out_writes_(NUM_PIXELS_PER_BLOCK) LDRColorA* pOut) const noexcept;
         void Encode(uint32_t flags, _In_reads_(NUM_PIXELS_PER_BLOCK) const HDRColorA* const pIn) noexcept;
 
     private:
@@ -862,7 +926,8 @@ namespace
             _In_reads_(NUM_PIXELS_PER_BLOCK) const size_t aIndex[],
             _In_reads_(NUM_PIXELS_PER_BLOCK) const size_t aIndex2[]) noexcept;
         void FixEndpointPBits(_In_ const EncodeParams* pEP, _In_reads_(BC7_MAX_REGIONS) const LDREndPntPair *pOrigEndpoints, _Out_writes_(BC7_MAX_REGIONS) LDREndPntPair *pFixedEndpoints) noexcept;
-        float Refine(_In_ const EncodeParams* pEP, _In_ size_t uShape, _In_ size_t uRotation, _In_ size_t uIndexMode) noexcept;
+        float Refine(_In_ const EncodeParams* pEP, _In_ size_t uShape, _In_ size_t uRotation, _In_ size_t uIndexMode, _In_ bool bOptimize) noexcept;
+        void EncodeSolid(_Inout_ EncodeParams* pEP) noexcept;
 
         float MapColors(_In_ const EncodeParams* pEP, _In_reads_(np) const LDRColorA aColors[], _In_ size_t np, _In_ size_t uIndexMode,
             _In_ const LDREndPntPair& endPts, _In_ float fMinErr) const noexcept;
@@ -1648,6 +1713,18 @@ namespace
         #endif
         }
     }
+
+    void FillWithErrorColors(_Out_writes_(NUM_PIXELS_PER_BLOCK) LDRColorA* pOut) noexcept
+    {
+        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+        {
+        #ifdef _DEBUG
+            pOut[i] = LDRColorA(255, 0, 255, 255);
+        #else
+            pOut[i] = LDRColorA(0, 0, 0, 255);
+        #endif
+        }
+    }
 }
 
 
@@ -1814,48 +1891,118 @@ void D3DX_BC6H::Decode(bool bSigned, HDRColorA* pOut) const noexcept
 
 
 _Use_decl_annotations_
-void D3DX_BC6H::Encode(bool bSigned, const HDRColorA* const pIn) noexcept
+void D3DX_BC6H::Encode(bool bSigned, uint32_t flags, const HDRColorA* const pIn) noexcept
 {
     assert(pIn);
 
     EncodeParams EP(pIn, bSigned);
 
+    if (flags & BC_FLAGS_BC6H_QUICK)
+    {
+        EncodeQuick(&EP);
+        return;
+    }
+
     for (EP.uMode = 0; EP.uMode < c_NumModes && EP.fBestErr > 0; ++EP.uMode)
     {
-        const uint8_t uShapes = ms_aInfo[EP.uMode].uPartitions ? 32u : 1u;
         // Number of rough cases to look at. reasonable values of this are 1, uShapes/4, and uShapes
         // uShapes/4 gets nearly all the cases; you can increase that a bit (say by 3 or 4) if you really want to squeeze the last bit out
-        const size_t uItems = std::max<size_t>(1u, size_t(uShapes >> 2));
-        float afRoughMSE[BC6H_MAX_SHAPES];
-        uint8_t auShape[BC6H_MAX_SHAPES];
+        RefineShapes(&EP, 2);
+    }
+}
 
-        // pick the best uItems shapes and refine these.
-        for (EP.uShape = 0; EP.uShape < uShapes; ++EP.uShape)
-        {
-            size_t uShape = EP.uShape;
-            afRoughMSE[uShape] = RoughMSE(&EP);
-            auShape[uShape] = static_cast<uint8_t>(uShape);
-        }
+void D3DX_BC6H::EncodeQuick(EncodeParams* pEP) noexcept
+{
+    assert(pEP);
+
+    // Modes ordered by decreasing endpoint precision, one region modes first
+    static constexpr uint8_t s_aModeOrder[c_NumModes] = { 13, 12, 11, 10, 2, 3, 4, 0, 5, 6, 7, 8, 1, 9 };
+
+    INTColor cMin = pEP->aIPixels[0];
+    INTColor cMax = pEP->aIPixels[0];
+    for (size_t i = 1; i < NUM_PIXELS_PER_BLOCK; ++i)
+    {
+        const INTColor& c = pEP->aIPixels[i];
+        cMin.r = std::min<int>(cMin.r, c.r); cMax.r = std::max<int>(cMax.r, c.r);
+        cMin.g = std::min<int>(cMin.g, c.g); cMax.g = std::max<int>(cMax.g, c.g);
+        cMin.b = std::min<int>(cMin.b, c.b); cMax.b = std::max<int>(cMax.b, c.b);
+    }
 
-        // Bubble up the first uItems items
-        for (size_t i = 0; i < uItems; i++)
+    // A single region already interpolates a flat block to within the early-out error
+    const int iRange = std::max<int>(cMax.r - cMin.r, std::max<int>(cMax.g - cMin.g, cMax.b - cMin.b));
+    const bool bFlat = (iRange <= BC6H_QUICK_FLAT_RANGE);
+
+    for (size_t m = 0; m < c_NumModes && pEP->fBestErr > BC6H_QUICK_MAX_ERROR; ++m)
+    {
+        pEP->uMode = s_aModeOrder[m];
+        const ModeInfo& info = ms_aInfo[pEP->uMode];
+
+        if (bFlat && info.uPartitions)
+            continue;
+
+        if (info.bTransformed)
         {
-            for (size_t j = i + 1; j < uShapes; j++)
+            // Skip modes whose deltas cannot span the block's dynamic range once quantized
+            const LDRColorA& Prec0 = info.RGBAPrec[0][0];
+            LDRColorA PrecD = info.RGBAPrec[0][1];
+            if (info.uPartitions)
             {
-                if (afRoughMSE[i] > afRoughMSE[j])
+                for (size_t i = 1; i < 4; ++i)
                 {
-                    std::swap(afRoughMSE[i], afRoughMSE[j]);
-                    std::swap(auShape[i], auShape[j]);
+                    const LDRColorA& Prec = info.RGBAPrec[i >> 1][i & 1];
+                    PrecD.r = std::min(PrecD.r, Prec.r);
+                    PrecD.g = std::min(PrecD.g, Prec.g);
+                    PrecD.b = std::min(PrecD.b, Prec.b);
                 }
             }
+
+            if ((Quantize(cMax.r, Prec0.r, pEP->bSigned) - Quantize(cMin.r, Prec0.r, pEP->bSigned)) >= (1 << (PrecD.r - 1))
+                || (Quantize(cMax.g, Prec0.g, pEP->bSigned) - Quantize(cMin.g, Prec0.g, pEP->bSigned)) >= (1 << (PrecD.g - 1))
+                || (Quantize(cMax.b, Prec0.b, pEP->bSigned) - Quantize(cMin.b, Prec0.b, pEP->bSigned)) >= (1 << (PrecD.b - 1)))
+                continue;
         }
 
-        for (size_t i = 0; i < uItems && EP.fBestErr > 0; i++)
+        RefineShapes(pEP, 3);
+    }
+}
+
+void D3DX_BC6H::RefineShapes(EncodeParams* pEP, size_t uItemsShift) noexcept
+{
+    assert(pEP);
+    assert(pEP->uMode < c_NumModes);
+    _Analysis_assume_(pEP->uMode < c_NumModes);
+
+    const uint8_t uShapes = ms_aInfo[pEP->uMode].uPartitions ? 32u : 1u;
+    const size_t uItems = std::max<size_t>(1u, size_t(uShapes >> uItemsShift));
+    float afRoughMSE[BC6H_MAX_SHAPES];
+    uint8_t auShape[BC6H_MAX_SHAPES];
+
+    // pick the best uItems shapes and refine these.
+    for (pEP->uShape = 0; pEP->uShape < uShapes; ++pEP->uShape)
+    {
+        size_t uShape = pEP->uShape;
+        afRoughMSE[uShape] = RoughMSE(pEP);
+        auShape[uShape] = static_cast<uint8_t>(uShape);
+    }
+
+    // Bubble up the first uItems items
+    for (size_t i = 0; i < uItems; i++)
+    {
+        for (size_t j = i + 1; j < uShapes; j++)
         {
-            EP.uShape = auShape[i];
-            Refine(&EP);
+            if (afRoughMSE[i] > afRoughMSE[j])
+            {
+                std::swap(afRoughMSE[i], afRoughMSE[j]);
+                std::swap(auShape[i], auShape[j]);
+            }
         }
     }
+
+    for (size_t i = 0; i < uItems && pEP->fBestErr > 0; i++)
+    {
+        pEP->uShape = auShape[i];
+        Refine(pEP);
+    }
 }
 
 
@@ -2567,6 +2714,18 @@ void D3DX_BC7::Decode(HDRColorA* pOut) const noexcept
 {
     assert(pOut);
 
+    LDRColorA ldr[NUM_PIXELS_PER_BLOCK];
+    Decode(ldr);
+
+    for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+        pOut[i] = HDRColorA(ldr[i]);
+}
+
+_Use_decl_annotations_
+void D3DX_BC7::Decode(LDRColorA* pOut) const noexcept
+{
+    assert(pOut);
+
     size_t uFirst = 0;
     while (uFirst < 128 && !GetBit(uFirst)) {}
     const uint8_t uMode = uint8_t(uFirst - 1);
@@ -2766,7 +2925,7 @@ void D3DX_BC7::Decode(HDRColorA* pOut) const noexcept
             default: break;
             }
 
-            pOut[i] = HDRColorA(outPixel);
+            pOut[i] = outPixel;
         }
     }
     else
@@ -2775,7 +2934,7 @@ void D3DX_BC7::Decode(HDRColorA* pOut) const noexcept
         OutputDebugStringA("BC7: Reserved mode 8 encountered during decoding\n");
     #endif
         // Per the BC7 format spec, we must return transparent black
-        memset(pOut, 0, sizeof(HDRColorA) * NUM_PIXELS_PER_BLOCK);
+        memset(pOut, 0, sizeof(LDRColorA) * NUM_PIXELS_PER_BLOCK);
     }
 }
 
@@ -2800,19 +2959,43 @@ void D3DX_BC7::Encode(uint32_t flags, const HDRColorA* const pIn) noexcept
 
     const bool bHasAlpha = (alphaMask != 0xFF);
 
-    for (EP.uMode = 0; EP.uMode < 8 && fMSEBest > 0; ++EP.uMode)
+    const BC7Level& level = g_BC7Levels[std::min<uint32_t>(flags & BC_FLAGS_BC7_LEVEL_MASK, TEX_BC7_LEVEL_MAX)];
+
+    uint32_t uModeMask = level.uModeMask;
+    if (flags & BC_FLAGS_USE_3SUBSETS)
+    {
+        // 3 subset modes tend to be used rarely and add significant compression time
+        uModeMask |= 0x5;
+    }
+
+    if (flags & BC_FLAGS_FORCE_BC7_MODE6)
+    {
+        // Use only mode 6
+        uModeMask = 0x40;
+    }
+
+    // Solid blocks are encoded directly in mode 5, but only when the level allows that mode
+    if (uModeMask & 0x20)
     {
-        if (!(flags & BC_FLAGS_USE_3SUBSETS) && (EP.uMode == 0 || EP.uMode == 2))
+        size_t i = 1;
+        for (; i < NUM_PIXELS_PER_BLOCK; ++i)
         {
-            // 3 subset modes tend to be used rarely and add significant compression time
-            continue;
+            const LDRColorA& c = EP.aLDRPixels[i];
+            if (c.r != EP.aLDRPixels[0].r || c.g != EP.aLDRPixels[0].g || c.b != EP.aLDRPixels[0].b || c.a != EP.aLDRPixels[0].a)
+                break;
         }
 
-        if ((flags & TEX_COMPRESS_BC7_QUICK) && (EP.uMode != 6))
+        if (i == NUM_PIXELS_PER_BLOCK)
         {
-            // Use only mode 6
-            continue;
+            EncodeSolid(&EP);
+            return;
         }
+    }
+
+    for (EP.uMode = 0; EP.uMode < 8 && fMSEBest > 0; ++EP.uMode)
+    {
+        if (!(uModeMask & (1u << EP.uMode)))
+            continue;
 
         if ((!bHasAlpha) && (EP.uMode == 7))
         {
@@ -2824,11 +3007,11 @@ void D3DX_BC7::Encode(uint32_t flags, const HDRColorA* const pIn) noexcept
         assert(uShapes <= BC7_MAX_SHAPES);
         _Analysis_assume_(uShapes <= BC7_MAX_SHAPES);
 
-        const size_t uNumRots = size_t(1) << ms_aInfo[EP.uMode].uRotationBits;
-        const size_t uNumIdxMode = size_t(1) << ms_aInfo[EP.uMode].uIndexModeBits;
+        const size_t uNumRots = level.bAllRotations ? (size_t(1) << ms_aInfo[EP.uMode].uRotationBits) : 1;
+        const size_t uNumIdxMode = level.bAllRotations ? (size_t(1) << ms_aInfo[EP.uMode].uIndexModeBits) : 1;
         // Number of rough cases to look at. reasonable values of this are 1, uShapes/4, and uShapes
         // uShapes/4 gets nearly all the cases; you can increase that a bit (say by 3 or 4) if you really want to squeeze the last bit out
-        const size_t uItems = std::max<size_t>(1, uShapes >> 2);
+        const size_t uItems = std::max<size_t>(1, uShapes >> level.uShapeShift);
         float afRoughMSE[BC7_MAX_SHAPES];
         size_t auShape[BC7_MAX_SHAPES];
 
@@ -2866,7 +3049,7 @@ void D3DX_BC7::Encode(uint32_t flags, const HDRColorA* const pIn) noexcept
 
                 for (size_t i = 0; i < uItems && fMSEBest > 0; i++)
                 {
-                    const float fMSE = Refine(&EP, auShape[i], r, im);
+                    const float fMSE = Refine(&EP, auShape[i], r, im, level.bOptimize);
                     if (fMSE < fMSEBest)
                     {
                         final = *this;
@@ -3307,6 +3490,32 @@ void D3DX_BC7::EmitBlock(const EncodeParams* pEP, size_t uShape, size_t uRotatio
     assert(uStartBit == 128);
 }
 
+_Use_decl_annotations_
+void D3DX_BC7::EncodeSolid(EncodeParams* pEP) noexcept
+{
+    assert(pEP);
+
+    // Mode 5 reproduces any solid 8-bit color exactly: table endpoints for RGB at color
+    // index 1, and both alpha endpoints at the alpha value with alpha index 0
+    static const BC7SolidTable s_Table;
+
+    const LDRColorA& c = pEP->aLDRPixels[0];
+
+    LDREndPntPair aEndPts[BC7_MAX_REGIONS] = {};
+    aEndPts[0].A = LDRColorA(s_Table.lo[c.r], s_Table.lo[c.g], s_Table.lo[c.b], c.a);
+    aEndPts[0].B = LDRColorA(s_Table.hi[c.r], s_Table.hi[c.g], s_Table.hi[c.b], c.a);
+
+    size_t aIndex[NUM_PIXELS_PER_BLOCK];
+    size_t aIndex2[NUM_PIXELS_PER_BLOCK] = {};
+    for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+    {
+        aIndex[i] = BC7_SOLID_INDEX;
+    }
+
+    pEP->uMode = 5;
+    EmitBlock(pEP, 0, 0, 0, aEndPts, aIndex, aIndex2);
+}
+
 _Use_decl_annotations_
 void D3DX_BC7::FixEndpointPBits(const EncodeParams* pEP, const LDREndPntPair *pOrigEndpoints, LDREndPntPair *pFixedEndpoints) noexcept
 {
@@ -3396,7 +3605,7 @@ void D3DX_BC7::FixEndpointPBits(const EncodeParams* pEP, const LDREndPntPair *pO
 }
 
 _Use_decl_annotations_
-float D3DX_BC7::Refine(const EncodeParams* pEP, size_t uShape, size_t uRotation, size_t uIndexMode) noexcept
+float D3DX_BC7::Refine(const EncodeParams* pEP, size_t uShape, size_t uRotation, size_t uIndexMode, bool bOptimize) noexcept
 {
     assert(pEP);
     assert(uShape < BC7_MAX_SHAPES);
@@ -3437,6 +3646,18 @@ float D3DX_BC7::Refine(const EncodeParams* pEP, size_t uShape, size_t uRotation,
 
     AssignIndices(pEP, uShape, uIndexMode, newEndPts1, aOrgIdx, aOrgIdx2, aOrgErr);
 
+    float fOrgTotErr = 0;
+    for (size_t p = 0; p <= uPartitions; p++)
+    {
+        fOrgTotErr += aOrgErr[p];
+    }
+
+    if (!bOptimize)
+    {
+        EmitBlock(pEP, uShape, uRotation, uIndexMode, newEndPts1, aOrgIdx, aOrgIdx2);
+        return fOrgTotErr;
+    }
+
     OptimizeEndPoints(pEP, uShape, uIndexMode, aOrgErr, newEndPts1, aOptEndPts);
 
     LDREndPntPair newEndPts2[BC7_MAX_REGIONS];
@@ -3444,10 +3665,9 @@ float D3DX_BC7::Refine(const EncodeParams* pEP, size_t uShape, size_t uRotation,
 
     AssignIndices(pEP, uShape, uIndexMode, newEndPts2, aOptIdx, aOptIdx2, aOptErr);
 
-    float fOrgTotErr = 0, fOptTotErr = 0;
+    float fOptTotErr = 0;
     for (size_t p = 0; p <= uPartitions; p++)
     {
-        fOrgTotErr += aOrgErr[p];
         fOptTotErr += aOptErr[p];
     }
     if (fOptTotErr < fOrgTotErr)
@@ -3623,19 +3843,17 @@ void DirectX::D3DXDecodeBC6HS(XMVECTOR *pColor, const uint8_t *pBC) noexcept
 _Use_decl_annotations_
 void DirectX::D3DXEncodeBC6HU(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flags) noexcept
 {
-    UNREFERENCED_PARAMETER(flags);
     assert(pBC && pColor);
     static_assert(sizeof(D3DX_BC6H) == 16, "D3DX_BC6H should be 16 bytes");
-    reinterpret_cast<D3DX_BC6H*>(pBC)->Encode(false, reinterpret_cast<const HDRColorA*>(pColor));
+    reinterpret_cast<D3DX_BC6H*>(pBC)->Encode(false, flags, reinterpret_cast<const HDRColorA*>(pColor));
 }
 
 _Use_decl_annotations_
 void DirectX::D3DXEncodeBC6HS(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flags) noexcept
 {
-    UNREFERENCED_PARAMETER(flags);
     assert(pBC && pColor);
     static_assert(sizeof(D3DX_BC6H) == 16, "D3DX_BC6H should be 16 bytes");
-    reinterpret_cast<D3DX_BC6H*>(pBC)->Encode(true, reinterpret_cast<const HDRColorA*>(pColor));
+    reinterpret_cast<D3DX_BC6H*>(pBC)->Encode(true, flags, reinterpret_cast<const HDRColorA*>(pColor));
 }
 
 
@@ -3650,6 +3868,14 @@ void DirectX::D3DXDecodeBC7(XMVECTOR *pColor, const uint8_t *pBC) noexcept
     reinterpret_cast<const D3DX_BC7*>(pBC)->Decode(reinterpret_cast<HDRColorA*>(pColor));
 }
 
+_Use_decl_annotations_
+void DirectX::D3DXDecodeBC7RGBA8(uint8_t *pColor, const uint8_t *pBC) noexcept
+{
+    assert(pColor && pBC);
+    static_assert(sizeof(LDRColorA) == 4, "LDRColorA should be 4 bytes");
+    reinterpret_cast<const D3DX_BC7*>(pBC)->Decode(reinterpret_cast<LDRColorA*>(pColor));
+}
+
 _Use_decl_annotations_
 void DirectX::D3DXEncodeBC7(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flags) noexcept
 {
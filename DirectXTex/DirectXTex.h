@@ -278,6 +278,26 @@ namespace DirectX
 
         TGA_FLAGS_DEFAULT_SRGB = 0x80,
         // If no colorspace is specified in TGA 2.0 metadata, assume sRGB
+
+        TGA_FLAGS_RLE = 0x100,
+        // Writes RLE compressed pixel data
+
+        TGA_FLAGS_PARALLEL = 0x10000000,
+        // Encodes RLE scanlines on multiple threads
+    };
+
+    enum HDR_FLAGS : unsigned long
+    {
+        HDR_FLAGS_NONE = 0x0,
+
+        HDR_FLAGS_FORMAT_HALF = 0x1,
+        // Loads as DXGI_FORMAT_R16G16B16A16_FLOAT rather than DXGI_FORMAT_R32G32B32A32_FLOAT
+
+        HDR_FLAGS_FORMAT_SHAREDEXP = 0x2,
+        // Loads as DXGI_FORMAT_R9G9B9E5_SHAREDEXP rather than DXGI_FORMAT_R32G32B32A32_FLOAT
+
+        HDR_FLAGS_PARALLEL = 0x10000000,
+        // Decodes or encodes scanlines on multiple threads
     };
 
     enum WIC_FLAGS : unsigned long
@@ -382,6 +402,8 @@ namespace DirectX
         _In_z_ const wchar_t* szFile,
         _Out_ TexMetadata& metadata) noexcept;
 
+    class MappedImage;
+
     //---------------------------------------------------------------------------------
     // Bitmap image container
     struct Image
@@ -398,9 +420,9 @@ namespace DirectX
     {
     public:
         ScratchImage() noexcept
-            : m_nimages(0), m_size(0), m_metadata{}, m_image(nullptr), m_memory(nullptr) {}
+            : m_nimages(0), m_size(0), m_metadata{}, m_image(nullptr), m_memory(nullptr), m_deleter(nullptr), m_deleterContext(nullptr) {}
         ScratchImage(ScratchImage&& moveFrom) noexcept
-            : m_nimages(0), m_size(0), m_metadata{}, m_image(nullptr), m_memory(nullptr) { *this = std::move(moveFrom); }
+            : m_nimages(0), m_size(0), m_metadata{}, m_image(nullptr), m_memory(nullptr), m_deleter(nullptr), m_deleterContext(nullptr) { *this = std::move(moveFrom); }
         ~ScratchImage() { Release(); }
 
         ScratchImage& __cdecl operator= (ScratchImage&& moveFrom) noexcept;
@@ -420,6 +442,17 @@ namespace DirectX
         HRESULT __cdecl InitializeCubeFromImages(_In_reads_(nImages) const Image* images, _In_ size_t nImages, _In_ CP_FLAGS flags = CP_FLAGS_NONE) noexcept;
         HRESULT __cdecl Initialize3DFromImages(_In_reads_(depth) const Image* images, _In_ size_t depth, _In_ CP_FLAGS flags = CP_FLAGS_NONE) noexcept;
 
+        HRESULT __cdecl InitializeView(
+            _In_ const TexMetadata& mdata,
+            _Inout_updates_bytes_(size) uint8_t* pMemory, _In_ size_t size,
+            _In_ CP_FLAGS flags = CP_FLAGS_NONE,
+            _In_opt_ void (__cdecl *deleter)(uint8_t* pMemory, void* context) = nullptr,
+            _In_opt_ void* context = nullptr) noexcept;
+            // Lays out the images over caller memory instead of allocating; pMemory must be 16-byte aligned like a
+            // ScratchImage allocation (E_INVALIDARG otherwise). The images are a mutable view, so writes to them modify
+            // pMemory. On Release the memory and context are passed to deleter if one is given, otherwise the caller
+            // must keep the memory alive for the lifetime of the view
+
         void __cdecl Release() noexcept;
 
         bool __cdecl OverrideFormat(_In_ DXGI_FORMAT f) noexcept;
@@ -441,6 +474,18 @@ namespace DirectX
         TexMetadata m_metadata;
         Image*      m_image;
         uint8_t*    m_memory;
+
+        void        (__cdecl *m_deleter)(uint8_t*, void*);
+        void*       m_deleterContext;
+
+        HRESULT __cdecl SetupView(
+            _In_ const TexMetadata& mdata,
+            _Inout_updates_bytes_(size) uint8_t* pMemory, _In_ size_t size,
+            _In_ CP_FLAGS flags,
+            _In_opt_ void (__cdecl *deleter)(uint8_t*, void*),
+            _In_opt_ void* context) noexcept;
+
+        friend HRESULT __cdecl LoadFromDDSFileMapped(const wchar_t*, DDS_FLAGS, TexMetadata*, DDSMetaData*, MappedImage&) noexcept;
     };
 
     //---------------------------------------------------------------------------------
@@ -475,6 +520,46 @@ namespace DirectX
         size_t  m_size;
     };
 
+    //---------------------------------------------------------------------------------
+    // Memory-mapped DDS file (images point directly into a private copy-on-write mapping
+    // when the file needs no conversion, otherwise into a ScratchImage copy)
+    class MappedImage
+    {
+    public:
+        MappedImage() noexcept : m_mapping(nullptr), m_mappingSize(0) {}
+        MappedImage(MappedImage&& moveFrom) noexcept : m_mapping(nullptr), m_mappingSize(0) { *this = std::move(moveFrom); }
+        ~MappedImage() { Release(); }
+
+        MappedImage& __cdecl operator= (MappedImage&& moveFrom) noexcept;
+
+        MappedImage(const MappedImage&) = delete;
+        MappedImage& operator=(const MappedImage&) = delete;
+
+        void __cdecl Release() noexcept;
+
+        const TexMetadata& __cdecl GetMetadata() const noexcept { return m_image.GetMetadata(); }
+        const Image* __cdecl GetImage(_In_ size_t mip, _In_ size_t item, _In_ size_t slice) const noexcept { return m_image.GetImage(mip, item, slice); }
+
+        const Image* __cdecl GetImages() const noexcept { return m_image.GetImages(); }
+        size_t __cdecl GetImageCount() const noexcept { return m_image.GetImageCount(); }
+
+        bool __cdecl IsMapped() const noexcept { return m_mapping != nullptr; }
+            // True if the images alias the file mapping rather than a copy
+
+        void __cdecl Prefetch(_In_ size_t index, _In_ size_t count) const noexcept;
+            // Hints that images [index, index + count) will be read soon
+
+        void __cdecl Evict(_In_ size_t index, _In_ size_t count) const noexcept;
+            // Hints that images [index, index + count) are no longer needed (any writes to them are discarded)
+
+    private:
+        void*        m_mapping;
+        size_t       m_mappingSize;
+        ScratchImage m_image;
+
+        friend HRESULT __cdecl LoadFromDDSFileMapped(const wchar_t*, DDS_FLAGS, TexMetadata*, DDSMetaData*, MappedImage&) noexcept;
+    };
+
     //---------------------------------------------------------------------------------
     // Image I/O
 
@@ -494,6 +579,14 @@ namespace DirectX
         _Out_opt_ TexMetadata* metadata,
         _Out_opt_ DDSMetaData* ddPixelFormat,
         _Out_ ScratchImage& image) noexcept;
+    HRESULT __cdecl LoadFromDDSMemoryView(
+        _Inout_updates_bytes_(size) void* pSource, _In_ size_t size,
+        _In_ DDS_FLAGS flags,
+        _Out_opt_ TexMetadata* metadata,
+        _Out_opt_ DDSMetaData* ddPixelFormat,
+        _Out_ ScratchImage& image) noexcept;
+        // Like LoadFromDDSMemoryEx, but when no conversion is needed and the pixels are 16-byte aligned the images are a
+        // view over pSource instead of a copy: the buffer must outlive the image, and writes to the images modify it
     HRESULT __cdecl LoadFromDDSFileEx(
         _In_z_ const wchar_t* szFile,
         _In_ DDS_FLAGS flags,
@@ -501,6 +594,28 @@ namespace DirectX
         _Out_opt_ DDSMetaData* ddPixelFormat,
         _Out_ ScratchImage& image) noexcept;
 
+    HRESULT __cdecl LoadFromDDSFileRange(
+        _In_z_ const wchar_t* szFile,
+        _In_ DDS_FLAGS flags,
+        _In_ size_t firstMip, _In_ size_t mipCount,
+        _In_ size_t firstItem, _In_ size_t itemCount,
+        _Out_opt_ TexMetadata* metadata,
+        _Out_opt_ DDSMetaData* ddPixelFormat,
+        _Out_ ScratchImage& image) noexcept;
+        // Reads only mips [firstMip, firstMip + mipCount) of array items (or cubemap faces) [firstItem, firstItem + itemCount),
+        // where a count of 0 means through the end; metadata describes the loaded subset. A cubemap range that does not
+        // start and end on a multiple of 6 faces loads as a plain 2D array (TEX_MISC_TEXTURECUBE is cleared)
+
+    HRESULT __cdecl LoadFromDDSFileMapped(
+        _In_z_ const wchar_t* szFile,
+        _In_ DDS_FLAGS flags,
+        _Out_opt_ TexMetadata* metadata,
+        _Out_opt_ DDSMetaData* ddPixelFormat,
+        _Out_ MappedImage& image) noexcept;
+        // Maps the file instead of reading it (POSIX only; other platforms always load a copy)
+        // Mapped images start at their offset in the file, so Image::pixels is only 4-byte aligned for files with the
+        // 'DX10' header extension (16-byte for legacy headers); use LoadFromDDSFile where 16-byte aligned rows are required
+
     HRESULT __cdecl SaveToDDSMemory(
         _In_ const Image& image,
         _In_ DDS_FLAGS flags,
@@ -518,13 +633,15 @@ namespace DirectX
     // HDR operations
     HRESULT __cdecl LoadFromHDRMemory(
         _In_reads_bytes_(size) const void* pSource, _In_ size_t size,
+        _In_ HDR_FLAGS flags,
         _Out_opt_ TexMetadata* metadata, _Out_ ScratchImage& image) noexcept;
     HRESULT __cdecl LoadFromHDRFile(
         _In_z_ const wchar_t* szFile,
+        _In_ HDR_FLAGS flags,
         _Out_opt_ TexMetadata* metadata, _Out_ ScratchImage& image) noexcept;
 
-    HRESULT __cdecl SaveToHDRMemory(_In_ const Image& image, _Out_ Blob& blob) noexcept;
-    HRESULT __cdecl SaveToHDRFile(_In_ const Image& image, _In_z_ const wchar_t* szFile) noexcept;
+    HRESULT __cdecl SaveToHDRMemory(_In_ const Image& image, _In_ HDR_FLAGS flags, _Out_ Blob& blob) noexcept;
+    HRESULT __cdecl SaveToHDRFile(_In_ const Image& image, _In_ HDR_FLAGS flags, _In_z_ const wchar_t* szFile) noexcept;
 
     // TGA operations
     HRESULT __cdecl LoadFromTGAMemory(
@@ -577,6 +694,16 @@ namespace DirectX
 #endif // WIN32
 
     // Compatability helpers
+    HRESULT __cdecl LoadFromHDRMemory(
+        _In_reads_bytes_(size) const void* pSource, _In_ size_t size,
+        _Out_opt_ TexMetadata* metadata, _Out_ ScratchImage& image) noexcept;
+    HRESULT __cdecl LoadFromHDRFile(
+        _In_z_ const wchar_t* szFile,
+        _Out_opt_ TexMetadata* metadata, _Out_ ScratchImage& image) noexcept;
+
+    HRESULT __cdecl SaveToHDRMemory(_In_ const Image& image, _Out_ Blob& blob) noexcept;
+    HRESULT __cdecl SaveToHDRFile(_In_ const Image& image, _In_z_ const wchar_t* szFile) noexcept;
+
     HRESULT __cdecl LoadFromTGAMemory(
         _In_reads_bytes_(size) const void* pSource, _In_ size_t size,
         _Out_opt_ TexMetadata* metadata, _Out_ ScratchImage& image) noexcept;
@@ -646,6 +773,8 @@ namespace DirectX
         TEX_FILTER_BOX = 0x400000,
         TEX_FILTER_FANT = 0x400000, // Equiv to Box filtering for mipmap generation
         TEX_FILTER_TRIANGLE = 0x500000,
+        TEX_FILTER_LANCZOS = 0x600000, // Lanczos-3 windowed sinc
+        TEX_FILTER_KAISER = 0x700000, // Kaiser windowed sinc (radius 3, alpha 4)
         // Filtering mode to use for any required image resizing
 
         TEX_FILTER_SRGB_IN = 0x1000000,
@@ -660,6 +789,13 @@ namespace DirectX
 
         TEX_FILTER_FORCE_WIC = 0x20000000,
         // Forces use of the WIC path even when logic would have picked a non-WIC path when both are an option
+
+        TEX_FILTER_PARALLEL = 0x40000000,
+        // Convert, Resize, and GenerateMipMaps/3D are free to use multithreading to improve performance (by default they do not)
+        // Convert splits rows and subresources; Resize splits bands of destination rows;
+        // mip generation splits array items, volume slices and row bands of each level
+        // Output is identical to the serial path; not used by the WIC paths
+        // ConvertOptions::maxThreads and the Resize and GenerateMipMaps/3D overloads taking maxThreads limit the thread count
     };
 
     constexpr unsigned long TEX_FILTER_DITHER_MASK = 0xF0000;
@@ -676,6 +812,16 @@ namespace DirectX
         // Resize the image to width x height. Defaults to Fant filtering.
         // Note for a complex resize, the result will always have mipLevels == 1
 
+    HRESULT __cdecl Resize(
+        _In_ const Image& srcImage, _In_ size_t width, _In_ size_t height,
+        _In_ TEX_FILTER_FLAGS filter, _In_ size_t maxThreads,
+        _Out_ ScratchImage& image) noexcept;
+    HRESULT __cdecl Resize(
+        _In_reads_(nimages) const Image* srcImages, _In_ size_t nimages, _In_ const TexMetadata& metadata,
+        _In_ size_t width, _In_ size_t height, _In_ TEX_FILTER_FLAGS filter, _In_ size_t maxThreads,
+        _Out_ ScratchImage& result) noexcept;
+        // maxThreads limits the thread count for TEX_FILTER_PARALLEL; 0 uses all hardware threads
+
     constexpr float TEX_THRESHOLD_DEFAULT = 0.5f;
         // Default value for alpha threshold used when converting to 1-bit alpha
 
@@ -683,6 +829,8 @@ namespace DirectX
     {
         TEX_FILTER_FLAGS filter;
         float            threshold;
+        uint32_t         maxThreads;
+            // Thread count limit for TEX_FILTER_PARALLEL; 0 uses all hardware threads
     };
 
     HRESULT __cdecl Convert(
@@ -717,6 +865,14 @@ namespace DirectX
         // levels of '0' indicates a full mipchain, otherwise is generates that number of total levels (including the source base image)
         // Defaults to Fant filtering which is equivalent to a box filter
 
+    HRESULT __cdecl GenerateMipMaps(
+        _In_ const Image& baseImage, _In_ TEX_FILTER_FLAGS filter, _In_ size_t levels, _In_ size_t maxThreads,
+        _Inout_ ScratchImage& mipChain, _In_ bool allow1D = false) noexcept;
+    HRESULT __cdecl GenerateMipMaps(
+        _In_reads_(nimages) const Image* srcImages, _In_ size_t nimages, _In_ const TexMetadata& metadata,
+        _In_ TEX_FILTER_FLAGS filter, _In_ size_t levels, _In_ size_t maxThreads, _Inout_ ScratchImage& mipChain);
+        // maxThreads limits the thread count for TEX_FILTER_PARALLEL; 0 uses all hardware threads
+
     HRESULT __cdecl GenerateMipMaps3D(
         _In_reads_(depth) const Image* baseImages, _In_ size_t depth, _In_ TEX_FILTER_FLAGS filter, _In_ size_t levels,
         _Out_ ScratchImage& mipChain) noexcept;
@@ -726,9 +882,40 @@ namespace DirectX
         // levels of '0' indicates a full mipchain, otherwise is generates that number of total levels (including the source base image)
         // Defaults to Fant filtering which is equivalent to a box filter
 
+    HRESULT __cdecl GenerateMipMaps3D(
+        _In_reads_(depth) const Image* baseImages, _In_ size_t depth, _In_ TEX_FILTER_FLAGS filter, _In_ size_t levels,
+        _In_ size_t maxThreads, _Out_ ScratchImage& mipChain) noexcept;
+    HRESULT __cdecl GenerateMipMaps3D(
+        _In_reads_(nimages) const Image* srcImages, _In_ size_t nimages, _In_ const TexMetadata& metadata,
+        _In_ TEX_FILTER_FLAGS filter, _In_ size_t levels, _In_ size_t maxThreads, _Out_ ScratchImage& mipChain);
+        // maxThreads limits the thread count for TEX_FILTER_PARALLEL; 0 uses all hardware threads
+
+    HRESULT __cdecl ResizeStreaming(
+        _In_ DXGI_FORMAT format, _In_ size_t srcWidth, _In_ size_t srcHeight,
+        _In_ std::function<HRESULT __cdecl(_Out_writes_bytes_(rowPitch) uint8_t* pixels, size_t rowPitch, size_t y)> sourceFunc,
+        _In_ size_t width, _In_ size_t height, _In_ TEX_FILTER_FLAGS filter,
+        _In_ std::function<HRESULT __cdecl(_In_reads_bytes_(rowPitch) const uint8_t* pixels, size_t rowPitch, size_t y)> sinkFunc);
+    HRESULT __cdecl GenerateMipMapsStreaming(
+        _In_ DXGI_FORMAT format, _In_ size_t width, _In_ size_t height,
+        _In_ std::function<HRESULT __cdecl(_Out_writes_bytes_(rowPitch) uint8_t* pixels, size_t rowPitch, size_t y)> sourceFunc,
+        _In_ TEX_FILTER_FLAGS filter, _In_ size_t levels,
+        _In_ std::function<HRESULT __cdecl(_In_reads_bytes_(rowPitch) const uint8_t* pixels, size_t rowPitch, size_t level, size_t y)> sinkFunc);
+        // Resize or build a mip chain for images too large to hold in memory, using the custom (non-WIC) filters
+        // sourceFunc is called once for each source row, top to bottom; sinkFunc receives each result row as soon as it is complete,
+        // in order for each level (GenerateMipMapsStreaming passes the base level through as level 0)
+        // Memory use is proportional to the width times the vertical filter support
+        // Rows are filtered on the calling thread (TEX_FILTER_PARALLEL is ignored). TEX_FILTER_WRAP_V returns
+        // HRESULT_E_NOT_SUPPORTED, since the first rows would need the last ones; TEX_FILTER_MIRROR_V is supported
+        // TEX_FILTER_POINT copies texels unchanged (except for sub-byte and packed formats), matching Resize
+
     HRESULT __cdecl ScaleMipMapsAlphaForCoverage(
         _In_reads_(nimages) const Image* srcImages, _In_ size_t nimages, _In_ const TexMetadata& metadata, _In_ size_t item,
         _In_ float alphaReference, _Inout_ ScratchImage& mipChain) noexcept;
+    HRESULT __cdecl ScaleMipMapsAlphaForCoverage(
+        _In_reads_(nimages) const Image* srcImages, _In_ size_t nimages, _In_ const TexMetadata& metadata, _In_ size_t item,
+        _In_ float alphaReference, _In_ TEX_FILTER_FLAGS filter, _Inout_ ScratchImage& mipChain) noexcept;
+        // Scales the alpha of each mip so its coverage at alphaReference matches the base level
+        // Only TEX_FILTER_PARALLEL is used from filter
 
 
     enum TEX_PMALPHA_FLAGS : unsigned long
@@ -776,6 +963,13 @@ namespace DirectX
         TEX_COMPRESS_BC7_QUICK = 0x100000,
         // Minimal modes (usually mode 6) for BC7 compression
 
+        TEX_COMPRESS_BC6H_QUICK = 0x200000,
+        // Faster BC6H compression by skipping modes that can't represent the block and stopping early on a close match
+
+        TEX_COMPRESS_SCALAR = 0x400000,
+        // Encodes BC1-3 one block at a time instead of several blocks per SIMD register; output is identical,
+        // so this is only useful for verifying that both code paths agree
+
         TEX_COMPRESS_SRGB_IN = 0x1000000,
         TEX_COMPRESS_SRGB_OUT = 0x2000000,
         TEX_COMPRESS_SRGB = (TEX_COMPRESS_SRGB_IN | TEX_COMPRESS_SRGB_OUT),
@@ -784,16 +978,41 @@ namespace DirectX
 
         TEX_COMPRESS_PARALLEL = 0x10000000,
         // Compress is free to use multithreading to improve performance (by default it does not use multithreading)
+        // All subresources are compressed together on a work-stealing thread pool
+        // Output is byte-identical to serial compression for any thread count; it only depends on the input,
+        // the options, and the build (compiling with FMA3/AVX2 enabled can change floating-point rounding)
     };
 
     constexpr float TEX_ALPHA_WEIGHT_DEFAULT = 1.0f;
         // Default value for alpha weight used for GPU BC7 compression
 
+    constexpr uint32_t TEX_BC7_LEVEL_DEFAULT = 0;
+    constexpr uint32_t TEX_BC7_LEVEL_FASTEST = 1;
+    constexpr uint32_t TEX_BC7_LEVEL_MAX = 7;
+        // Search levels for CPU BC7 compression
+        //  1: mode 6 only, no endpoint refinement
+        //  2: mode 6 only (same as TEX_COMPRESS_BC7_QUICK)
+        //  3: modes 1, 6 & 7, best rough-MSE shape only, no rotations or index mode swap
+        //  4: modes 1 & 3-7, best 1/16th of the shapes, no rotations
+        //  5: modes 1 & 3-7, best 1/8th of the shapes
+        //  6: modes 1 & 3-7, best 1/4th of the shapes (same as TEX_BC7_LEVEL_DEFAULT)
+        //  7: all modes, best 1/4th of the shapes (same as TEX_COMPRESS_BC7_USE_3SUBSETS)
+
     struct CompressOptions
     {
         TEX_COMPRESS_FLAGS flags;
         float              threshold;
         float              alphaWeight;
+        uint32_t           bc7Level;
+            // TEX_BC7_LEVEL_DEFAULT or 1 to TEX_BC7_LEVEL_MAX; ignored by GPU compression
+        uint32_t           maxThreads;
+            // Thread count limit for TEX_COMPRESS_PARALLEL; 0 uses all hardware threads
+        float              rdoLambda;
+            // Rate-distortion weight for BC1 & BC7 output (0 disables); larger values accept more error per literal bit
+            // saved to make the result compress better with LZ-style compressors
+            // Blocks are matched against the previous 64 blocks in the row and nearby blocks in the row above.
+            // BC7 gains less than BC1 because only whole blocks, endpoints or indices of same-mode blocks are
+            // reused. Tests/benchrdo reports the LZ-compressed size and PSNR for each lambda
     };
 
     HRESULT __cdecl Compress(
@@ -832,11 +1051,28 @@ namespace DirectX
         _In_ std::function<bool __cdecl(size_t, size_t)> statusCallBack = nullptr);
 #endif
 
+    enum TEX_DECOMPRESS_FLAGS : unsigned long
+    {
+        TEX_DECOMPRESS_DEFAULT = 0,
+
+        TEX_DECOMPRESS_PARALLEL = 0x10000000,
+        // Decompress is free to use multithreading to improve performance (by default it does not use multithreading)
+        // All subresources are decoded together, one row of blocks per task; output does not depend on the thread count
+    };
+
     HRESULT __cdecl Decompress(_In_ const Image& cImage, _In_ DXGI_FORMAT format, _Out_ ScratchImage& image) noexcept;
     HRESULT __cdecl Decompress(
         _In_reads_(nimages) const Image* cImages, _In_ size_t nimages, _In_ const TexMetadata& metadata,
         _In_ DXGI_FORMAT format, _Out_ ScratchImage& images) noexcept;
 
+    HRESULT __cdecl Decompress(
+        _In_ const Image& cImage, _In_ DXGI_FORMAT format, _In_ TEX_DECOMPRESS_FLAGS flags, _In_ size_t maxThreads,
+        _Out_ ScratchImage& image) noexcept;
+    HRESULT __cdecl Decompress(
+        _In_reads_(nimages) const Image* cImages, _In_ size_t nimages, _In_ const TexMetadata& metadata,
+        _In_ DXGI_FORMAT format, _In_ TEX_DECOMPRESS_FLAGS flags, _In_ size_t maxThreads, _Out_ ScratchImage& images) noexcept;
+        // maxThreads limits the thread count for TEX_DECOMPRESS_PARALLEL; 0 uses all hardware threads
+
     //---------------------------------------------------------------------------------
     // Normal map operations
 
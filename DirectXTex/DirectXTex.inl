@@ -17,11 +17,13 @@
 DEFINE_ENUM_FLAG_OPERATORS(CP_FLAGS);
 DEFINE_ENUM_FLAG_OPERATORS(DDS_FLAGS);
 DEFINE_ENUM_FLAG_OPERATORS(TGA_FLAGS);
+DEFINE_ENUM_FLAG_OPERATORS(HDR_FLAGS);
 DEFINE_ENUM_FLAG_OPERATORS(WIC_FLAGS);
 DEFINE_ENUM_FLAG_OPERATORS(TEX_FR_FLAGS);
 DEFINE_ENUM_FLAG_OPERATORS(TEX_FILTER_FLAGS);
 DEFINE_ENUM_FLAG_OPERATORS(TEX_PMALPHA_FLAGS);
 DEFINE_ENUM_FLAG_OPERATORS(TEX_COMPRESS_FLAGS);
+DEFINE_ENUM_FLAG_OPERATORS(TEX_DECOMPRESS_FLAGS);
 DEFINE_ENUM_FLAG_OPERATORS(CNMAP_FLAGS);
 DEFINE_ENUM_FLAG_OPERATORS(CMSE_FLAGS);
 DEFINE_ENUM_FLAG_OPERATORS(CREATETEX_FLAGS);
@@ -167,6 +169,30 @@ inline HRESULT __cdecl GetMetadataFromTGAFile(const wchar_t* szFile, TexMetadata
     return GetMetadataFromTGAFile(szFile, TGA_FLAGS_NONE, metadata);
 }
 
+_Use_decl_annotations_
+inline HRESULT __cdecl LoadFromHDRMemory(const void* pSource, size_t size, TexMetadata* metadata, ScratchImage& image) noexcept
+{
+    return LoadFromHDRMemory(pSource, size, HDR_FLAGS_NONE, metadata, image);
+}
+
+_Use_decl_annotations_
+inline HRESULT __cdecl LoadFromHDRFile(const wchar_t* szFile, TexMetadata* metadata, ScratchImage& image) noexcept
+{
+    return LoadFromHDRFile(szFile, HDR_FLAGS_NONE, metadata, image);
+}
+
+_Use_decl_annotations_
+inline HRESULT __cdecl SaveToHDRMemory(const Image& image, Blob& blob) noexcept
+{
+    return SaveToHDRMemory(image, HDR_FLAGS_NONE, blob);
+}
+
+_Use_decl_annotations_
+inline HRESULT __cdecl SaveToHDRFile(const Image& image, const wchar_t* szFile) noexcept
+{
+    return SaveToHDRFile(image, HDR_FLAGS_NONE, szFile);
+}
+
 _Use_decl_annotations_
 inline HRESULT __cdecl LoadFromTGAMemory(const void* pSource, size_t size, TexMetadata* metadata, ScratchImage& image) noexcept
 {
@@ -190,3 +216,11 @@ inline HRESULT __cdecl SaveToTGAFile(const Image& image, const wchar_t* szFile,
 {
     return SaveToTGAFile(image, TGA_FLAGS_NONE, szFile, metadata);
 }
+
+_Use_decl_annotations_
+inline HRESULT __cdecl ScaleMipMapsAlphaForCoverage(
+    const Image* srcImages, size_t nimages, const TexMetadata& metadata, size_t item,
+    float alphaReference, ScratchImage& mipChain) noexcept
+{
+    return ScaleMipMapsAlphaForCoverage(srcImages, nimages, metadata, item, alphaReference, TEX_FILTER_DEFAULT, mipChain);
+}
@@ -11,11 +11,6 @@
 
 #include "DirectXTexP.h"
 
-#ifdef _OPENMP
-#include <omp.h>
-#pragma warning(disable : 4616 6993)
-#endif
-
 #include "BC.h"
 
 using namespace DirectX;
@@ -31,7 +26,15 @@ namespace
         static_assert(static_cast<int>(TEX_COMPRESS_UNIFORM) == static_cast<int>(BC_FLAGS_UNIFORM), "TEX_COMPRESS_* flags should match BC_FLAGS_*");
         static_assert(static_cast<int>(TEX_COMPRESS_BC7_USE_3SUBSETS) == static_cast<int>(BC_FLAGS_USE_3SUBSETS), "TEX_COMPRESS_* flags should match BC_FLAGS_*");
         static_assert(static_cast<int>(TEX_COMPRESS_BC7_QUICK) == static_cast<int>(BC_FLAGS_FORCE_BC7_MODE6), "TEX_COMPRESS_* flags should match BC_FLAGS_*");
-        return (compress & (BC_FLAGS_DITHER_RGB | BC_FLAGS_DITHER_A | BC_FLAGS_UNIFORM | BC_FLAGS_USE_3SUBSETS | BC_FLAGS_FORCE_BC7_MODE6));
+        static_assert(static_cast<int>(TEX_COMPRESS_BC6H_QUICK) == static_cast<int>(BC_FLAGS_BC6H_QUICK), "TEX_COMPRESS_* flags should match BC_FLAGS_*");
+        static_assert(static_cast<int>(TEX_COMPRESS_SCALAR) == static_cast<int>(BC_FLAGS_SCALAR), "TEX_COMPRESS_* flags should match BC_FLAGS_*");
+        return (compress & (BC_FLAGS_DITHER_RGB | BC_FLAGS_DITHER_A | BC_FLAGS_UNIFORM | BC_FLAGS_USE_3SUBSETS | BC_FLAGS_FORCE_BC7_MODE6 | BC_FLAGS_BC6H_QUICK | BC_FLAGS_SCALAR));
+    }
+
+    constexpr uint32_t GetBCFlags(_In_ const CompressOptions& options) noexcept
+    {
+        static_assert(TEX_BC7_LEVEL_MAX <= BC_FLAGS_BC7_LEVEL_MASK, "TEX_BC7_LEVEL_* should fit in BC_FLAGS_BC7_LEVEL_MASK");
+        return GetBCFlags(options.flags) | (options.bc7Level & BC_FLAGS_BC7_LEVEL_MASK);
     }
 
     constexpr TEX_FILTER_FLAGS GetSRGBFlags(_In_ TEX_COMPRESS_FLAGS compress) noexcept
@@ -68,6 +71,632 @@ namespace
     }
 
 
+    // Number of blocks handed to the encoders at a time, which matches the lane count of the multi-block BC1-3 encoders
+    constexpr size_t BC_BLOCK_BATCH = 4;
+
+    //-------------------------------------------------------------------------------------
+    // Loads the 4x4 block whose top-left pixel is at (x, y), replicating pixels for partial blocks
+    //-------------------------------------------------------------------------------------
+    bool LoadBlock(
+        _Out_writes_(NUM_PIXELS_PER_BLOCK) XMVECTOR* temp,
+        const Image& image,
+        size_t x,
+        size_t y,
+        size_t sbpp) noexcept
+    {
+        assert((x < image.width) && (y < image.height));
+
+        const size_t rowPitch = image.rowPitch;
+        const uint8_t *pSrc = image.pixels + (y * rowPitch) + (x * sbpp);
+        const uint8_t *pEnd = image.pixels + image.slicePitch;
+
+        const size_t ph = std::min<size_t>(4, image.height - y);
+        const size_t pw = std::min<size_t>(4, image.width - x);
+        assert(pw > 0 && ph > 0);
+
+        const ptrdiff_t bytesLeft = pEnd - pSrc;
+        assert(bytesLeft > 0);
+        size_t bytesToRead = std::min<size_t>(rowPitch, static_cast<size_t>(bytesLeft));
+        if (!LoadScanline(&temp[0], pw, pSrc, bytesToRead, image.format))
+            return false;
+
+        if (ph > 1)
+        {
+            bytesToRead = std::min<size_t>(rowPitch, static_cast<size_t>(bytesLeft) - rowPitch);
+            if (!LoadScanline(&temp[4], pw, pSrc + rowPitch, bytesToRead, image.format))
+                return false;
+
+            if (ph > 2)
+            {
+                bytesToRead = std::min<size_t>(rowPitch, static_cast<size_t>(bytesLeft) - rowPitch * 2);
+                if (!LoadScanline(&temp[8], pw, pSrc + rowPitch * 2, bytesToRead, image.format))
+                    return false;
+
+                if (ph > 3)
+                {
+                    bytesToRead = std::min<size_t>(rowPitch, static_cast<size_t>(bytesLeft) - rowPitch * 3);
+                    if (!LoadScanline(&temp[12], pw, pSrc + rowPitch * 3, bytesToRead, image.format))
+                        return false;
+                }
+            }
+        }
+
+        if (pw != 4 || ph != 4)
+        {
+            // Replicate pixels for partial block
+            static const size_t uSrc[] = { 0, 0, 0, 1 };
+
+            if (pw < 4)
+            {
+                for (size_t t = 0; t < ph && t < 4; ++t)
+                {
+                    for (size_t s = pw; s < 4; ++s)
+                    {
+                    #pragma prefast(suppress: 26000, "PREFAST false positive")
+                        temp[(t << 2) | s] = temp[(t << 2) | uSrc[s]];
+                    }
+                }
+            }
+
+            if (ph < 4)
+            {
+                for (size_t t = ph; t < 4; ++t)
+                {
+                    for (size_t s = 0; s < 4; ++s)
+                    {
+                    #pragma prefast(suppress: 26000, "PREFAST false positive")
+                        temp[(t << 2) | s] = temp[(uSrc[t] << 2) | s];
+                    }
+                }
+            }
+        }
+
+        return true;
+    }
+
+
+    //-------------------------------------------------------------------------------------
+    // Encodes a run of consecutive blocks, using the multi-block encoders where available.
+    //
+    // Every block is encoded from its own texels only, so the result does not depend on how
+    // rows are split between threads or on which of these paths is taken.
+    //-------------------------------------------------------------------------------------
+    void EncodeBlocks(
+        _Out_writes_(count * blocksize) uint8_t* pDest,
+        _In_reads_(count * NUM_PIXELS_PER_BLOCK) const XMVECTOR* pColor,
+        size_t count,
+        DXGI_FORMAT format,
+        BC_ENCODE pfEncode,
+        size_t blocksize,
+        uint32_t bcflags,
+        float threshold) noexcept
+    {
+        if (!(bcflags & BC_FLAGS_SCALAR))
+        {
+            switch (format)
+            {
+            case DXGI_FORMAT_BC1_UNORM:
+            case DXGI_FORMAT_BC1_UNORM_SRGB:
+                D3DXEncodeBC1Batch(pDest, pColor, count, threshold, bcflags);
+                return;
+
+            case DXGI_FORMAT_BC2_UNORM:
+            case DXGI_FORMAT_BC2_UNORM_SRGB:
+                D3DXEncodeBC2Batch(pDest, pColor, count, bcflags);
+                return;
+
+            case DXGI_FORMAT_BC3_UNORM:
+            case DXGI_FORMAT_BC3_UNORM_SRGB:
+                D3DXEncodeBC3Batch(pDest, pColor, count, bcflags);
+                return;
+
+            default:
+                break;
+            }
+        }
+
+        for (size_t j = 0; j < count; ++j)
+        {
+            if (!pfEncode)
+            {
+                // BC1 takes the extra threshold parameter
+                D3DXEncodeBC1(pDest + j * blocksize, pColor + j * NUM_PIXELS_PER_BLOCK, threshold, bcflags);
+            }
+            else
+            {
+                pfEncode(pDest + j * blocksize, pColor + j * NUM_PIXELS_PER_BLOCK, bcflags);
+            }
+        }
+    }
+
+
+    //-------------------------------------------------------------------------------------
+    // Duplicate-block cache: maps the converted texels of a block to its encoded bytes so
+    // repeated blocks (flat areas, tiles, padding) are only encoded once per call. Each
+    // entry is guarded by a sequence number (odd while being written) so workers share the
+    // table without locking; a reader that sees the sequence change under it counts the
+    // lookup as a miss. When a probe neighborhood is full, the least recently used entry in
+    // it is replaced, so large atlases keep hitting on their recent repeats.
+    //-------------------------------------------------------------------------------------
+    constexpr size_t BLOCK_CACHE_MAX_ENTRIES = 4096;
+    constexpr size_t BLOCK_CACHE_PROBES = 8;
+
+    class BlockCache
+    {
+    public:
+        BlockCache() noexcept : m_mask(0), m_blocksize(0), m_seed(0), m_clock(0) {}
+
+        BlockCache(const BlockCache&) = delete;
+        BlockCache& operator=(const BlockCache&) = delete;
+
+        HRESULT Initialize(size_t nblocks, size_t blocksize, uint32_t bcflags) noexcept
+        {
+            assert(blocksize <= sizeof(uint64_t) * BLOCK_WORDS);
+
+            size_t count = 16;
+            while (count < nblocks && count < BLOCK_CACHE_MAX_ENTRIES)
+                count <<= 1;
+
+            m_entries.reset(new (std::nothrow) Entry[count]());
+            if (!m_entries)
+                return E_OUTOFMEMORY;
+
+            m_mask = count - 1;
+            m_blocksize = blocksize;
+            m_seed = bcflags;
+            return S_OK;
+        }
+
+        uint64_t Hash(_In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR* pColor) const noexcept
+        {
+            // FNV-1a over 64-bit words, with the encoder flags as part of the key
+            auto pBytes = reinterpret_cast<const uint8_t*>(pColor);
+            uint64_t h = 14695981039346656037ull ^ m_seed;
+            for (size_t i = 0; i < PIXEL_WORDS; ++i)
+            {
+                uint64_t w;
+                memcpy(&w, pBytes + i * sizeof(uint64_t), sizeof(w));
+                h = (h ^ w) * 1099511628211ull;
+            }
+
+            // Final avalanche so the low bits used for the slot depend on every texel
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdull;
+            h ^= h >> 33;
+            return h;
+        }
+
+        bool Find(uint64_t hash, _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR* pColor, _Out_writes_(m_blocksize) uint8_t* pBC) noexcept
+        {
+            for (size_t p = 0; p < BLOCK_CACHE_PROBES; ++p)
+            {
+                Entry& e = m_entries[(hash + p) & m_mask];
+                const uint32_t seq = e.seq.load(std::memory_order_acquire);
+                if (!seq)
+                    return false;
+
+                uint64_t block[BLOCK_WORDS];
+                if (!(seq & 1) && Read(e, seq, hash, pColor, block))
+                {
+                    memcpy(pBC, block, m_blocksize);
+                    e.lastUse.store(m_clock.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        void Insert(uint64_t hash, _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR* pColor, _In_reads_(m_blocksize) const uint8_t* pBC) noexcept
+        {
+            Entry* victim = nullptr;
+            uint32_t victimSeq = 0;
+            uint32_t victimUse = UINT32_MAX;
+
+            for (size_t p = 0; p < BLOCK_CACHE_PROBES; ++p)
+            {
+                Entry& e = m_entries[(hash + p) & m_mask];
+                const uint32_t seq = e.seq.load(std::memory_order_acquire);
+                if (!seq)
+                {
+                    victim = &e;
+                    victimSeq = 0;
+                    break;
+                }
+
+                if (seq & 1)
+                    continue;
+
+                uint64_t block[BLOCK_WORDS];
+                if (Read(e, seq, hash, pColor, block))
+                    return;
+
+                const uint32_t use = e.lastUse.load(std::memory_order_relaxed);
+                if (use < victimUse)
+                {
+                    victim = &e;
+                    victimSeq = seq;
+                    victimUse = use;
+                }
+            }
+
+            // Every slot in the neighborhood is being written by another thread
+            if (!victim)
+                return;
+
+            // Claim the slot by making its sequence odd; losing the race just means this block isn't cached
+            uint32_t seq = victimSeq;
+            if (!victim->seq.compare_exchange_strong(seq, victimSeq + 1, std::memory_order_acquire))
+                return;
+
+            std::atomic_thread_fence(std::memory_order_release);
+
+            victim->hash.store(hash, std::memory_order_relaxed);
+
+            auto pPixels = reinterpret_cast<const uint8_t*>(pColor);
+            for (size_t i = 0; i < PIXEL_WORDS; ++i)
+            {
+                uint64_t w;
+                memcpy(&w, pPixels + i * sizeof(uint64_t), sizeof(w));
+                victim->pixels[i].store(w, std::memory_order_relaxed);
+            }
+
+            uint64_t block[BLOCK_WORDS] = {};
+            memcpy(block, pBC, m_blocksize);
+            for (size_t i = 0; i < BLOCK_WORDS; ++i)
+            {
+                victim->block[i].store(block[i], std::memory_order_relaxed);
+            }
+
+            victim->lastUse.store(m_clock.fetch_add(1, std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            victim->seq.store(victimSeq + 2, std::memory_order_release);
+        }
+
+    private:
+        static constexpr size_t PIXEL_WORDS = sizeof(XMVECTOR) * NUM_PIXELS_PER_BLOCK / sizeof(uint64_t);
+        static constexpr size_t BLOCK_WORDS = 2;
+
+        // seq is 0 for an empty slot, odd while a writer owns it and even (non-zero) once published.
+        // The payload is kept in relaxed atomics so a reader racing a writer is well defined; the
+        // reader then sees seq change and discards what it read.
+        struct Entry
+        {
+            std::atomic<uint32_t> seq;
+            std::atomic<uint32_t> lastUse;
+            std::atomic<uint64_t> hash;
+            std::atomic<uint64_t> pixels[PIXEL_WORDS];
+            std::atomic<uint64_t> block[BLOCK_WORDS];
+        };
+
+        // Compares a published entry against the key and copies its block out; false on mismatch or if
+        // the entry was rewritten while it was being read
+        static bool Read(
+            const Entry& e,
+            uint32_t seq,
+            uint64_t hash,
+            _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR* pColor,
+            _Out_writes_(BLOCK_WORDS) uint64_t* block) noexcept
+        {
+            if (e.hash.load(std::memory_order_relaxed) != hash)
+                return false;
+
+            auto pPixels = reinterpret_cast<const uint8_t*>(pColor);
+            for (size_t i = 0; i < PIXEL_WORDS; ++i)
+            {
+                uint64_t w;
+                memcpy(&w, pPixels + i * sizeof(uint64_t), sizeof(w));
+                if (e.pixels[i].load(std::memory_order_relaxed) != w)
+                    return false;
+            }
+
+            for (size_t i = 0; i < BLOCK_WORDS; ++i)
+            {
+                block[i] = e.block[i].load(std::memory_order_relaxed);
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return e.seq.load(std::memory_order_relaxed) == seq;
+        }
+
+        std::unique_ptr<Entry[]> m_entries;
+        size_t m_mask;
+        size_t m_blocksize;
+        uint32_t m_seed;
+        std::atomic<uint32_t> m_clock;
+    };
+
+    // A lookup costs about a third of a BC1-BC5 block encode, and flat blocks already take
+    // the single-color paths there, so only the BC6H/BC7 encoders are worth caching
+    inline bool UseBlockCache(DXGI_FORMAT format) noexcept
+    {
+        switch (format)
+        {
+        case DXGI_FORMAT_BC6H_UF16:
+        case DXGI_FORMAT_BC6H_SF16:
+        case DXGI_FORMAT_BC7_UNORM:
+        case DXGI_FORMAT_BC7_UNORM_SRGB:
+            return true;
+
+        default:
+            return false;
+        }
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Encodes a run of consecutive blocks, taking repeated blocks from the cache if given
+    //-------------------------------------------------------------------------------------
+    void EncodeBlocksCached(
+        _Out_writes_(count * blocksize) uint8_t* pDest,
+        _In_reads_(count * NUM_PIXELS_PER_BLOCK) const XMVECTOR* pColor,
+        size_t count,
+        DXGI_FORMAT format,
+        BC_ENCODE pfEncode,
+        size_t blocksize,
+        uint32_t bcflags,
+        float threshold,
+        _In_opt_ BlockCache* cache) noexcept
+    {
+        assert(count <= BC_BLOCK_BATCH);
+
+        if (!cache)
+        {
+            EncodeBlocks(pDest, pColor, count, format, pfEncode, blocksize, bcflags, threshold);
+            return;
+        }
+
+        uint64_t hashes[BC_BLOCK_BATCH];
+        size_t misses[BC_BLOCK_BATCH];
+        size_t nmisses = 0;
+
+        for (size_t j = 0; j < count; ++j)
+        {
+            hashes[j] = cache->Hash(pColor + j * NUM_PIXELS_PER_BLOCK);
+            if (!cache->Find(hashes[j], pColor + j * NUM_PIXELS_PER_BLOCK, pDest + j * blocksize))
+                misses[nmisses++] = j;
+        }
+
+        if (!nmisses)
+            return;
+
+        if (nmisses == count)
+        {
+            EncodeBlocks(pDest, pColor, count, format, pfEncode, blocksize, bcflags, threshold);
+        }
+        else
+        {
+            // Gather the misses so the multi-block encoders still see a contiguous run
+            XM_ALIGNED_DATA(16) XMVECTOR temp[NUM_PIXELS_PER_BLOCK * BC_BLOCK_BATCH];
+            uint8_t encoded[16 * BC_BLOCK_BATCH];
+
+            for (size_t k = 0; k < nmisses; ++k)
+            {
+                memcpy(&temp[k * NUM_PIXELS_PER_BLOCK], pColor + misses[k] * NUM_PIXELS_PER_BLOCK, sizeof(XMVECTOR) * NUM_PIXELS_PER_BLOCK);
+            }
+
+            EncodeBlocks(encoded, temp, nmisses, format, pfEncode, blocksize, bcflags, threshold);
+
+            for (size_t k = 0; k < nmisses; ++k)
+            {
+                memcpy(pDest + misses[k] * blocksize, encoded + k * blocksize, blocksize);
+            }
+        }
+
+        for (size_t k = 0; k < nmisses; ++k)
+        {
+            const size_t j = misses[k];
+            cache->Insert(hashes[j], pColor + j * NUM_PIXELS_PER_BLOCK, pDest + j * blocksize);
+        }
+    }
+
+
+    //-------------------------------------------------------------------------------------
+    // Rate-distortion optimization: replaces byte runs of each block with those of a
+    // recent block in the same row or a nearby block in the row above when the added error
+    // is worth the saved bits, so that LZ-style compressors applied to the output find more
+    // matches
+    //-------------------------------------------------------------------------------------
+    constexpr size_t RDO_WINDOW_BLOCKS = 64;
+
+    // Number of BC7 header bits (mode, partition, rotation, endpoints and p-bits) before the indices, by mode
+    constexpr size_t c_BC7HeaderBits[8] = { 83, 82, 99, 98, 50, 66, 65, 98 };
+
+    inline size_t GetBC7Mode(_In_ const uint8_t* pBC) noexcept
+    {
+        for (size_t mode = 0; mode < 8; ++mode)
+        {
+            if (pBC[0] & (1u << mode))
+                return mode;
+        }
+        return 8;
+    }
+
+    // Returns the candidate byte ranges to copy from pRef into pBlock. A whole-block copy is
+    // always tried. Endpoint-only and index-only copies are only tried when the bit layouts
+    // line up: always for BC1, and for BC7 only when both blocks use the same mode.
+    size_t GetRDOCandidates(
+        _In_ const uint8_t* pBlock,
+        _In_ const uint8_t* pRef,
+        bool bc7,
+        size_t blocksize,
+        _Out_writes_(3) size_t ranges[3][2]) noexcept
+    {
+        ranges[0][0] = 0;
+        ranges[0][1] = blocksize;
+
+        if (!bc7)
+        {
+            // BC1: 4 bytes of endpoints followed by 4 bytes of indices
+            const size_t half = blocksize / 2;
+            ranges[1][0] = 0;       ranges[1][1] = half;
+            ranges[2][0] = half;    ranges[2][1] = blocksize;
+            return 3;
+        }
+
+        const size_t mode = GetBC7Mode(pBlock);
+        if (mode >= 8 || GetBC7Mode(pRef) != mode)
+            return 1;
+
+        // Only whole bytes are copied; a byte straddling header and indices stays a literal
+        const size_t hb = c_BC7HeaderBits[mode];
+        ranges[1][0] = 0;               ranges[1][1] = hb / 8;
+        ranges[2][0] = (hb + 7) / 8;    ranges[2][1] = blocksize;
+        return 3;
+    }
+
+    float BlockError(
+        _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR* pColor,
+        _In_ const uint8_t* pBC,
+        BC_DECODE pfDecode) noexcept
+    {
+        XM_ALIGNED_DATA(16) XMVECTOR temp[NUM_PIXELS_PER_BLOCK];
+        pfDecode(temp, pBC);
+
+        XMVECTOR sse = XMVectorZero();
+        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+        {
+            const XMVECTOR diff = XMVectorSubtract(XMVectorSaturate(pColor[i]), temp[i]);
+            sse = XMVectorAdd(sse, XMVectorMultiply(diff, diff));
+        }
+
+        return XMVectorGetX(XMVector4Dot(sse, g_XMOne)) * (255.f * 255.f);
+    }
+
+    inline bool UseRDO(DXGI_FORMAT format) noexcept
+    {
+        switch (format)
+        {
+        case DXGI_FORMAT_BC1_UNORM:
+        case DXGI_FORMAT_BC1_UNORM_SRGB:
+        case DXGI_FORMAT_BC7_UNORM:
+        case DXGI_FORMAT_BC7_UNORM_SRGB:
+            return true;
+
+        default:
+            return false;
+        }
+    }
+
+    // pPrevRow is the already-final row of blocks above pRow (or nullptr for the first row). Blocks
+    // before bx in pRow must also be final, so the result is the same whatever order rows are encoded in.
+    void ReduceEntropy(
+        _Inout_ uint8_t* pRow,
+        _In_opt_ const uint8_t* pPrevRow,
+        size_t nbWidth,
+        size_t bx,
+        _In_reads_(count * NUM_PIXELS_PER_BLOCK) const XMVECTOR* pColor,
+        size_t count,
+        DXGI_FORMAT format,
+        size_t blocksize,
+        float lambda) noexcept
+    {
+        BC_DECODE pfDecode;
+        bool bc7;
+        switch (format)
+        {
+        case DXGI_FORMAT_BC1_UNORM:
+        case DXGI_FORMAT_BC1_UNORM_SRGB:    pfDecode = D3DXDecodeBC1;   bc7 = false;    break;
+        case DXGI_FORMAT_BC7_UNORM:
+        case DXGI_FORMAT_BC7_UNORM_SRGB:    pfDecode = D3DXDecodeBC7;   bc7 = true;     break;
+        default:                            return;
+        }
+
+        assert(blocksize <= 16);
+
+        for (size_t j = 0; j < count; ++j)
+        {
+            const size_t index = bx + j;
+            uint8_t* pBlock = pRow + index * blocksize;
+            const XMVECTOR* pBlockColor = pColor + j * NUM_PIXELS_PER_BLOCK;
+
+            uint8_t best[16];
+            memcpy(best, pBlock, blocksize);
+
+            // Cost is squared error (0-255 scale) plus lambda per literal bit
+            float bestCost = BlockError(pBlockColor, pBlock, pfDecode) + lambda * float(blocksize * 8);
+
+            auto tryReference = [&](const uint8_t* pRef) noexcept
+            {
+                size_t ranges[3][2];
+                const size_t nranges = GetRDOCandidates(pBlock, pRef, bc7, blocksize, ranges);
+                for (size_t r = 0; r < nranges; ++r)
+                {
+                    const size_t first = ranges[r][0];
+                    const size_t last = ranges[r][1];
+                    if (first >= last || !memcmp(pBlock + first, pRef + first, last - first))
+                        continue;
+
+                    uint8_t candidate[16];
+                    memcpy(candidate, pBlock, blocksize);
+                    memcpy(candidate + first, pRef + first, last - first);
+
+                    const float cost = BlockError(pBlockColor, candidate, pfDecode) + lambda * float((blocksize - (last - first)) * 8);
+                    if (cost < bestCost)
+                    {
+                        bestCost = cost;
+                        memcpy(best, candidate, blocksize);
+                    }
+                }
+            };
+
+            // Earlier blocks in the same row
+            for (size_t w = (index > RDO_WINDOW_BLOCKS) ? index - RDO_WINDOW_BLOCKS : 0; w < index; ++w)
+            {
+                tryReference(pRow + w * blocksize);
+            }
+
+            // Blocks around the same column in the row above
+            if (pPrevRow)
+            {
+                const size_t first = (index > RDO_WINDOW_BLOCKS / 2) ? index - RDO_WINDOW_BLOCKS / 2 : 0;
+                const size_t last = std::min(nbWidth, index + RDO_WINDOW_BLOCKS / 2);
+                for (size_t w = first; w < last; ++w)
+                {
+                    tryReference(pPrevRow + w * blocksize);
+                }
+            }
+
+            memcpy(pBlock, best, blocksize);
+        }
+    }
+
+    // Runs ReduceEntropy over an already encoded image, top to bottom
+    HRESULT ReduceEntropyImage(
+        const Image& image,
+        const Image& result,
+        size_t sbpp,
+        TEX_FILTER_FLAGS cflags,
+        size_t blocksize,
+        float lambda) noexcept
+    {
+        const size_t nbWidth = std::max<size_t>(1, (image.width + 3) / 4);
+        const size_t nbHeight = std::max<size_t>(1, (image.height + 3) / 4);
+
+        XM_ALIGNED_DATA(16) XMVECTOR temp[NUM_PIXELS_PER_BLOCK * BC_BLOCK_BATCH];
+        for (size_t by = 0; by < nbHeight; ++by)
+        {
+            uint8_t* pRow = result.pixels + (by * result.rowPitch);
+            const uint8_t* pPrevRow = (by > 0) ? pRow - result.rowPitch : nullptr;
+
+            for (size_t bx = 0; bx < nbWidth; bx += BC_BLOCK_BATCH)
+            {
+                const size_t count = std::min<size_t>(BC_BLOCK_BATCH, nbWidth - bx);
+
+                for (size_t j = 0; j < count; ++j)
+                {
+                    if (!LoadBlock(&temp[j * NUM_PIXELS_PER_BLOCK], image, (bx + j) * 4, by * 4, sbpp))
+                        return E_FAIL;
+                }
+
+                ConvertScanline(temp, count * NUM_PIXELS_PER_BLOCK, result.format, image.format, cflags);
+
+                ReduceEntropy(pRow, pPrevRow, nbWidth, bx, temp, count, result.format, blocksize, lambda);
+            }
+        }
+
+        return S_OK;
+    }
+
+
     //-------------------------------------------------------------------------------------
     HRESULT CompressBC(
         const Image& image,
@@ -75,6 +704,7 @@ namespace
         uint32_t bcflags,
         TEX_FILTER_FLAGS srgb,
         float threshold,
+        float rdoLambda,
         const std::function<bool __cdecl(size_t, size_t)>& statusCallback) noexcept
     {
         if (!image.pixels || !result.pixels)
@@ -106,10 +736,21 @@ namespace
         if (!DetermineEncoderSettings(result.format, pfEncode, blocksize, cflags))
             return HRESULT_E_NOT_SUPPORTED;
 
-        XM_ALIGNED_DATA(16) XMVECTOR temp[16];
-        const uint8_t *pSrc = image.pixels;
-        const uint8_t *pEnd = image.pixels + image.slicePitch;
-        const size_t rowPitch = image.rowPitch;
+        const size_t nbWidth = std::max<size_t>(1, (image.width + 3) / 4);
+        const size_t nbHeight = std::max<size_t>(1, (image.height + 3) / 4);
+
+        BlockCache cache;
+        BlockCache* pCache = nullptr;
+        if (UseBlockCache(result.format))
+        {
+            const HRESULT hr = cache.Initialize(nbWidth * nbHeight, blocksize, bcflags);
+            if (FAILED(hr))
+                return hr;
+
+            pCache = &cache;
+        }
+
+        XM_ALIGNED_DATA(16) XMVECTOR temp[NUM_PIXELS_PER_BLOCK * BC_BLOCK_BATCH];
         for (size_t h = 0; h < image.height; h += 4)
         {
             if (statusCallback)
@@ -120,108 +761,117 @@ namespace
                 }
             }
 
-            const uint8_t *sptr = pSrc;
             uint8_t* dptr = pDest;
-            const size_t ph = std::min<size_t>(4, image.height - h);
-            size_t w = 0;
-            for (size_t count = 0; (count < result.rowPitch) && (w < image.width); count += blocksize, w += 4)
+            for (size_t bx = 0; bx < nbWidth; bx += BC_BLOCK_BATCH)
             {
-                const size_t pw = std::min<size_t>(4, image.width - w);
-                assert(pw > 0 && ph > 0);
+                const size_t count = std::min<size_t>(BC_BLOCK_BATCH, nbWidth - bx);
 
-                const ptrdiff_t bytesLeft = pEnd - sptr;
-                assert(bytesLeft > 0);
-                size_t bytesToRead = std::min<size_t>(rowPitch, static_cast<size_t>(bytesLeft));
-                if (!LoadScanline(&temp[0], pw, sptr, bytesToRead, format))
-                    return E_FAIL;
-
-                if (ph > 1)
+                for (size_t j = 0; j < count; ++j)
                 {
-                    bytesToRead = std::min<size_t>(rowPitch, static_cast<size_t>(bytesLeft) - rowPitch);
-                    if (!LoadScanline(&temp[4], pw, sptr + rowPitch, bytesToRead, format))
+                    if (!LoadBlock(&temp[j * NUM_PIXELS_PER_BLOCK], image, (bx + j) * 4, h, sbpp))
                         return E_FAIL;
-
-                    if (ph > 2)
-                    {
-                        bytesToRead = std::min<size_t>(rowPitch, static_cast<size_t>(bytesLeft) - rowPitch * 2);
-                        if (!LoadScanline(&temp[8], pw, sptr + rowPitch * 2, bytesToRead, format))
-                            return E_FAIL;
-
-                        if (ph > 3)
-                        {
-                            bytesToRead = std::min<size_t>(rowPitch, static_cast<size_t>(bytesLeft) - rowPitch * 3);
-                            if (!LoadScanline(&temp[12], pw, sptr + rowPitch * 3, bytesToRead, format))
-                                return E_FAIL;
-                        }
-                    }
                 }
 
-                if (pw != 4 || ph != 4)
+                ConvertScanline(temp, count * NUM_PIXELS_PER_BLOCK, result.format, format, cflags | srgb);
+
+                EncodeBlocksCached(dptr, temp, count, result.format, pfEncode, blocksize, bcflags, threshold, pCache);
+
+                if (rdoLambda > 0.f)
                 {
-                    // Replicate pixels for partial block
-                    static const size_t uSrc[] = { 0, 0, 0, 1 };
+                    ReduceEntropy(pDest, (h > 0) ? pDest - result.rowPitch : nullptr, nbWidth, bx, temp, count, result.format, blocksize, rdoLambda);
+                }
+
+                dptr += count * blocksize;
+            }
+
+            pDest += result.rowPitch;
+        }
+
+        return S_OK;
+    }
+
+
+    //-------------------------------------------------------------------------------------
+    struct CompressContext
+    {
+        const Image* images;
+        const Image* results;
+        const size_t* rowStart;
+        size_t nimages;
+        size_t sbpp;
+        BC_ENCODE pfEncode;
+        size_t blocksize;
+        TEX_FILTER_FLAGS cflags;
+        uint32_t bcflags;
+        float threshold;
+        BlockCache* cache;
+        const std::function<bool __cdecl(size_t, size_t)>* statusCallback;
+        size_t progressTotal;
+        std::atomic<size_t> progress;
+        std::mutex progressLock;
+    };
+
+    HRESULT CompressRow(CompressContext& ctx, size_t row) noexcept
+    {
+        // rowStart holds the first task index for each image
+        const size_t index = size_t(std::upper_bound(ctx.rowStart, ctx.rowStart + ctx.nimages + 1, row) - ctx.rowStart) - 1;
+        assert(index < ctx.nimages);
+
+        const Image& image = ctx.images[index];
+        const Image& result = ctx.results[index];
+        const size_t by = row - ctx.rowStart[index];
+
+        const size_t nbWidth = std::max<size_t>(1, (image.width + 3) / 4);
+
+        uint8_t* pRow = result.pixels + (by * result.rowPitch);
+        uint8_t* pDest = pRow;
+
+        XM_ALIGNED_DATA(16) XMVECTOR temp[NUM_PIXELS_PER_BLOCK * BC_BLOCK_BATCH];
+        for (size_t bx = 0; bx < nbWidth; bx += BC_BLOCK_BATCH)
+        {
+            const size_t count = std::min<size_t>(BC_BLOCK_BATCH, nbWidth - bx);
 
-                    if (pw < 4)
-                    {
-                        for (size_t t = 0; t < ph && t < 4; ++t)
-                        {
-                            for (size_t s = pw; s < 4; ++s)
-                            {
-                            #pragma prefast(suppress: 26000, "PREFAST false positive")
-                                temp[(t << 2) | s] = temp[(t << 2) | uSrc[s]];
-                            }
-                        }
-                    }
+            for (size_t j = 0; j < count; ++j)
+            {
+                if (!LoadBlock(&temp[j * NUM_PIXELS_PER_BLOCK], image, (bx + j) * 4, by * 4, ctx.sbpp))
+                    return E_FAIL;
+            }
 
-                    if (ph < 4)
-                    {
-                        for (size_t t = ph; t < 4; ++t)
-                        {
-                            for (size_t s = 0; s < 4; ++s)
-                            {
-                            #pragma prefast(suppress: 26000, "PREFAST false positive")
-                                temp[(t << 2) | s] = temp[(uSrc[t] << 2) | s];
-                            }
-                        }
-                    }
-                }
+            ConvertScanline(temp, count * NUM_PIXELS_PER_BLOCK, result.format, image.format, ctx.cflags);
 
-                ConvertScanline(temp, 16, result.format, format, cflags | srgb);
+            EncodeBlocksCached(pDest, temp, count, result.format, ctx.pfEncode, ctx.blocksize, ctx.bcflags, ctx.threshold, ctx.cache);
 
-                if (pfEncode)
-                    pfEncode(dptr, temp, bcflags);
-                else
-                    D3DXEncodeBC1(dptr, temp, threshold, bcflags);
+            pDest += count * ctx.blocksize;
+        }
 
-                sptr += sbpp * 4;
-                dptr += blocksize;
-            }
+        ctx.progress.fetch_add(std::min<size_t>(4, image.height - by * 4));
 
-            pSrc += rowPitch * 4;
-            pDest += result.rowPitch;
+        if (*ctx.statusCallback)
+        {
+            // Only one worker reports at a time; the others keep compressing rather than wait
+            std::unique_lock<std::mutex> lock(ctx.progressLock, std::try_to_lock);
+            if (lock.owns_lock() && !(*ctx.statusCallback)(ctx.progress.load(), ctx.progressTotal))
+                return E_ABORT;
         }
 
         return S_OK;
     }
 
-
-    //-------------------------------------------------------------------------------------
-#ifdef _OPENMP
     HRESULT CompressBC_Parallel(
-        const Image& image,
-        const Image& result,
+        const Image* images,
+        const Image* results,
+        size_t nimages,
         uint32_t bcflags,
         TEX_FILTER_FLAGS srgb,
         float threshold,
+        float rdoLambda,
+        size_t maxThreads,
         const std::function<bool __cdecl(size_t, size_t)>& statusCallback) noexcept
     {
-        if (!image.pixels || !result.pixels)
-            return E_POINTER;
-
-        assert(image.width == result.width);
-        assert(image.height == result.height);
+        if (!images || !results || !nimages)
+            return E_INVALIDARG;
 
-        const DXGI_FORMAT format = image.format;
+        const DXGI_FORMAT format = images[0].format;
         size_t sbpp = BitsPerPixel(format);
         if (!sbpp)
             return E_FAIL;
@@ -235,142 +885,84 @@ namespace
         // Round to bytes
         sbpp = (sbpp + 7) / 8;
 
-        const uint8_t *pEnd = image.pixels + image.slicePitch;
-
         // Determine BC format encoder
         BC_ENCODE pfEncode;
         size_t blocksize;
         TEX_FILTER_FLAGS cflags;
-        if (!DetermineEncoderSettings(result.format, pfEncode, blocksize, cflags))
+        if (!DetermineEncoderSettings(results[0].format, pfEncode, blocksize, cflags))
             return HRESULT_E_NOT_SUPPORTED;
 
-        // Refactored version of loop to support parallel independance
-        const size_t nBlocks = std::max<size_t>(1, (image.width + 3) / 4) * std::max<size_t>(1, (image.height + 3) / 4);
+        // Every row of blocks in every image is a separate task
+        std::unique_ptr<size_t[]> rowStart(new (std::nothrow) size_t[nimages + 1]);
+        if (!rowStart)
+            return E_OUTOFMEMORY;
 
-        bool fail = false;
-
-        size_t progress = 0;
-        bool abort = false;
-
-        const size_t progressTotal = std::max<size_t>(1, (image.height + 3) / 4);
-
-#pragma omp parallel for shared(progress)
-        for (int nb = 0; nb < static_cast<int>(nBlocks); ++nb)
+        size_t progressTotal = 0;
+        size_t nblocks = 0;
+        rowStart[0] = 0;
+        for (size_t index = 0; index < nimages; ++index)
         {
-#pragma omp flush (abort)
-            if (abort)
-            {
-                // Short circuit the loop body if an abort is requested.
-                // OpenMP 2.0 does not support cancellation of a 'parallel for' loop.
-                continue;
-            }
-
-            const int nbWidth = std::max<int>(1, int((image.width + 3) / 4));
-
-            int y = nb / nbWidth;
-            const int x = (nb - (y*nbWidth)) * 4;
-            y *= 4;
-
-            assert((x >= 0) && (x < int(image.width)));
-            assert((y >= 0) && (y < int(image.height)));
-
-            const size_t rowPitch = image.rowPitch;
-            const uint8_t *pSrc = image.pixels + (size_t(y)*rowPitch) + (size_t(x)*sbpp);
-
-            uint8_t *pDest = result.pixels + (size_t(nb)*blocksize);
-
-            const size_t ph = std::min<size_t>(4, image.height - size_t(y));
-            const size_t pw = std::min<size_t>(4, image.width - size_t(x));
-            assert(pw > 0 && ph > 0);
-
-            const ptrdiff_t bytesLeft = pEnd - pSrc;
-            assert(bytesLeft > 0);
-            size_t bytesToRead = std::min<size_t>(rowPitch, size_t(bytesLeft));
-
-            XM_ALIGNED_DATA(16) XMVECTOR temp[16];
-            if (!LoadScanline(&temp[0], pw, pSrc, bytesToRead, format))
-                fail = true;
-
-            if (ph > 1)
-            {
-                bytesToRead = std::min<size_t>(rowPitch, size_t(bytesLeft) - rowPitch);
-                if (!LoadScanline(&temp[4], pw, pSrc + rowPitch, bytesToRead, format))
-                    fail = true;
-
-                if (ph > 2)
-                {
-                    bytesToRead = std::min<size_t>(rowPitch, size_t(bytesLeft) - rowPitch * 2);
-                    if (!LoadScanline(&temp[8], pw, pSrc + rowPitch * 2, bytesToRead, format))
-                        fail = true;
-
-                    if (ph > 3)
-                    {
-                        bytesToRead = std::min<size_t>(rowPitch, size_t(bytesLeft) - rowPitch * 3);
-                        if (!LoadScanline(&temp[12], pw, pSrc + rowPitch * 3, bytesToRead, format))
-                            fail = true;
-                    }
-                }
-            }
+            const Image& image = images[index];
+            const Image& result = results[index];
 
-            if (pw != 4 || ph != 4)
-            {
-                // Replicate pixels for partial block
-                static const size_t uSrc[] = { 0, 0, 0, 1 };
+            if (!image.pixels || !result.pixels)
+                return E_POINTER;
 
-                if (pw < 4)
-                {
-                    for (size_t t = 0; t < ph && t < 4; ++t)
-                    {
-                        for (size_t s = pw; s < 4; ++s)
-                        {
-                            temp[(t << 2) | s] = temp[(t << 2) | uSrc[s]];
-                        }
-                    }
-                }
+            if (image.format != format || result.format != results[0].format
+                || image.width != result.width || image.height != result.height)
+                return E_FAIL;
 
-                if (ph < 4)
-                {
-                    for (size_t t = ph; t < 4; ++t)
-                    {
-                        for (size_t s = 0; s < 4; ++s)
-                        {
-                            temp[(t << 2) | s] = temp[(uSrc[t] << 2) | s];
-                        }
-                    }
-                }
-            }
+            const size_t nbHeight = std::max<size_t>(1, (image.height + 3) / 4);
+            rowStart[index + 1] = rowStart[index] + nbHeight;
+            progressTotal += image.height;
+            nblocks += nbHeight * std::max<size_t>(1, (image.width + 3) / 4);
+        }
 
-            ConvertScanline(temp, 16, result.format, format, cflags | srgb);
+        // One cache shared by every worker, so repeats across rows and images are found
+        BlockCache cache;
+        BlockCache* pCache = nullptr;
+        if (UseBlockCache(results[0].format))
+        {
+            const HRESULT hr = cache.Initialize(nblocks, blocksize, bcflags);
+            if (FAILED(hr))
+                return hr;
 
-            if (pfEncode)
-                pfEncode(pDest, temp, bcflags);
-            else
-                D3DXEncodeBC1(pDest, temp, threshold, bcflags);
+            pCache = &cache;
+        }
 
-            // Report progress when a new row is reached.
-            if (x == 0 && statusCallback)
-            {
-#pragma omp atomic
-                progress += 4;
+        CompressContext ctx = {};
+        ctx.images = images;
+        ctx.results = results;
+        ctx.rowStart = rowStart.get();
+        ctx.nimages = nimages;
+        ctx.sbpp = sbpp;
+        ctx.pfEncode = pfEncode;
+        ctx.blocksize = blocksize;
+        ctx.cflags = cflags | srgb;
+        ctx.bcflags = bcflags;
+        ctx.threshold = threshold;
+        ctx.cache = pCache;
+        ctx.statusCallback = &statusCallback;
+        ctx.progressTotal = progressTotal;
+
+        HRESULT hr = ParallelFor(rowStart[nimages], maxThreads,
+            [&ctx](size_t row) -> HRESULT { return CompressRow(ctx, row); });
+        if (FAILED(hr))
+            return hr;
 
-                if (!statusCallback(progress, progressTotal))
+        // Each row's RDO pass reads the final row above it, so it runs top to bottom per image
+        // once every row is encoded; images are independent of each other
+        if (rdoLambda > 0.f && UseRDO(results[0].format))
+        {
+            hr = ParallelFor(nimages, maxThreads,
+                [&](size_t index) -> HRESULT
                 {
-                    abort = true;
-#pragma omp flush (abort)
-                }
-            }
+                    return ReduceEntropyImage(images[index], results[index], sbpp, ctx.cflags, blocksize, rdoLambda);
+                });
         }
 
-        if (abort)
-        {
-            return E_ABORT;
-        }
-        else
-        {
-            return (fail) ? E_FAIL : S_OK;
-        }
+        return hr;
     }
-#endif // _OPENMP
 
 
     //-------------------------------------------------------------------------------------
@@ -422,15 +1014,61 @@ namespace
 
 
     //-------------------------------------------------------------------------------------
-    HRESULT DecompressBC(_In_ const Image& cImage, _In_ const Image& result) noexcept
+    // Decompression
+    //-------------------------------------------------------------------------------------
+
+    // True when ConvertScanline from the BC format to the output format is the identity,
+    // so decoded texels can be packed straight into the destination.
+    bool IsDirectDecode(_In_ DXGI_FORMAT cformat, _In_ DXGI_FORMAT format) noexcept
     {
-        if (!cImage.pixels || !result.pixels)
-            return E_POINTER;
+        switch (cformat)
+        {
+        case DXGI_FORMAT_BC1_UNORM:
+        case DXGI_FORMAT_BC2_UNORM:
+        case DXGI_FORMAT_BC3_UNORM:
+        case DXGI_FORMAT_BC7_UNORM:
+            return (format == DXGI_FORMAT_R8G8B8A8_UNORM)
+                || (format == DXGI_FORMAT_R16G16B16A16_FLOAT)
+                || (format == DXGI_FORMAT_R32G32B32A32_FLOAT);
+
+        case DXGI_FORMAT_BC1_UNORM_SRGB:
+        case DXGI_FORMAT_BC2_UNORM_SRGB:
+        case DXGI_FORMAT_BC3_UNORM_SRGB:
+        case DXGI_FORMAT_BC7_UNORM_SRGB:
+            return (format == DXGI_FORMAT_R8G8B8A8_UNORM_SRGB);
+
+        case DXGI_FORMAT_BC4_UNORM: return (format == DXGI_FORMAT_R8_UNORM);
+        case DXGI_FORMAT_BC4_SNORM: return (format == DXGI_FORMAT_R8_SNORM);
+        case DXGI_FORMAT_BC5_UNORM: return (format == DXGI_FORMAT_R8G8_UNORM);
+        case DXGI_FORMAT_BC5_SNORM: return (format == DXGI_FORMAT_R8G8_SNORM);
+
+        case DXGI_FORMAT_BC6H_UF16:
+        case DXGI_FORMAT_BC6H_SF16:
+            return (format == DXGI_FORMAT_R16G16B16A16_FLOAT)
+                || (format == DXGI_FORMAT_R32G32B32A32_FLOAT);
 
-        assert(cImage.width == result.width);
-        assert(cImage.height == result.height);
+        default:
+            return false;
+        }
+    }
 
-        const DXGI_FORMAT format = result.format;
+    struct DecompressContext
+    {
+        const Image*        images;
+        const Image*        results;
+        const size_t*       rowStart;
+        size_t              nimages;
+        DXGI_FORMAT         cformat;
+        size_t              sbpp;
+        size_t              dbpp;
+        BC_DECODE           pfDecode;
+        BC_DECODE_PALETTE   pfDecodePalette;    // non-null when palettes can be packed directly
+        bool                directRGBA8;        // BC7 to 8-bit RGBA without the float decode
+        bool                convert;            // decoded texels need ConvertScanline
+    };
+
+    HRESULT SetupDecompress(_In_ DXGI_FORMAT srcFormat, _In_ DXGI_FORMAT format, _Out_ DecompressContext& ctx) noexcept
+    {
         size_t dbpp = BitsPerPixel(format);
         if (!dbpp)
             return E_FAIL;
@@ -442,97 +1080,246 @@ namespace
         }
 
         // Round to bytes
-        dbpp = (dbpp + 7) / 8;
-
-        uint8_t *pDest = result.pixels;
-        if (!pDest)
-            return E_POINTER;
+        ctx.dbpp = (dbpp + 7) / 8;
 
         // Promote "typeless" BC formats
-        DXGI_FORMAT cformat;
-        switch (cImage.format)
+        switch (srcFormat)
         {
-        case DXGI_FORMAT_BC1_TYPELESS:  cformat = DXGI_FORMAT_BC1_UNORM; break;
-        case DXGI_FORMAT_BC2_TYPELESS:  cformat = DXGI_FORMAT_BC2_UNORM; break;
-        case DXGI_FORMAT_BC3_TYPELESS:  cformat = DXGI_FORMAT_BC3_UNORM; break;
-        case DXGI_FORMAT_BC4_TYPELESS:  cformat = DXGI_FORMAT_BC4_UNORM; break;
-        case DXGI_FORMAT_BC5_TYPELESS:  cformat = DXGI_FORMAT_BC5_UNORM; break;
-        case DXGI_FORMAT_BC6H_TYPELESS: cformat = DXGI_FORMAT_BC6H_UF16; break;
-        case DXGI_FORMAT_BC7_TYPELESS:  cformat = DXGI_FORMAT_BC7_UNORM; break;
-        default:                        cformat = cImage.format;         break;
+        case DXGI_FORMAT_BC1_TYPELESS:  ctx.cformat = DXGI_FORMAT_BC1_UNORM; break;
+        case DXGI_FORMAT_BC2_TYPELESS:  ctx.cformat = DXGI_FORMAT_BC2_UNORM; break;
+        case DXGI_FORMAT_BC3_TYPELESS:  ctx.cformat = DXGI_FORMAT_BC3_UNORM; break;
+        case DXGI_FORMAT_BC4_TYPELESS:  ctx.cformat = DXGI_FORMAT_BC4_UNORM; break;
+        case DXGI_FORMAT_BC5_TYPELESS:  ctx.cformat = DXGI_FORMAT_BC5_UNORM; break;
+        case DXGI_FORMAT_BC6H_TYPELESS: ctx.cformat = DXGI_FORMAT_BC6H_UF16; break;
+        case DXGI_FORMAT_BC7_TYPELESS:  ctx.cformat = DXGI_FORMAT_BC7_UNORM; break;
+        default:                        ctx.cformat = srcFormat;             break;
         }
 
         // Determine BC format decoder
-        BC_DECODE pfDecode;
-        size_t sbpp;
-        switch (cformat)
+        BC_DECODE_PALETTE pfDecodePalette;
+        switch (ctx.cformat)
         {
         case DXGI_FORMAT_BC1_UNORM:
-        case DXGI_FORMAT_BC1_UNORM_SRGB:    pfDecode = D3DXDecodeBC1;   sbpp = 8;   break;
+        case DXGI_FORMAT_BC1_UNORM_SRGB:    ctx.pfDecode = D3DXDecodeBC1;   pfDecodePalette = D3DXDecodeBC1Palette;     ctx.sbpp = 8;   break;
         case DXGI_FORMAT_BC2_UNORM:
-        case DXGI_FORMAT_BC2_UNORM_SRGB:    pfDecode = D3DXDecodeBC2;   sbpp = 16;  break;
+        case DXGI_FORMAT_BC2_UNORM_SRGB:    ctx.pfDecode = D3DXDecodeBC2;   pfDecodePalette = D3DXDecodeBC2Palette;     ctx.sbpp = 16;  break;
         case DXGI_FORMAT_BC3_UNORM:
-        case DXGI_FORMAT_BC3_UNORM_SRGB:    pfDecode = D3DXDecodeBC3;   sbpp = 16;  break;
-        case DXGI_FORMAT_BC4_UNORM:         pfDecode = D3DXDecodeBC4U;  sbpp = 8;   break;
-        case DXGI_FORMAT_BC4_SNORM:         pfDecode = D3DXDecodeBC4S;  sbpp = 8;   break;
-        case DXGI_FORMAT_BC5_UNORM:         pfDecode = D3DXDecodeBC5U;  sbpp = 16;  break;
-        case DXGI_FORMAT_BC5_SNORM:         pfDecode = D3DXDecodeBC5S;  sbpp = 16;  break;
-        case DXGI_FORMAT_BC6H_UF16:         pfDecode = D3DXDecodeBC6HU; sbpp = 16;  break;
-        case DXGI_FORMAT_BC6H_SF16:         pfDecode = D3DXDecodeBC6HS; sbpp = 16;  break;
+        case DXGI_FORMAT_BC3_UNORM_SRGB:    ctx.pfDecode = D3DXDecodeBC3;   pfDecodePalette = D3DXDecodeBC3Palette;     ctx.sbpp = 16;  break;
+        case DXGI_FORMAT_BC4_UNORM:         ctx.pfDecode = D3DXDecodeBC4U;  pfDecodePalette = D3DXDecodeBC4UPalette;    ctx.sbpp = 8;   break;
+        case DXGI_FORMAT_BC4_SNORM:         ctx.pfDecode = D3DXDecodeBC4S;  pfDecodePalette = D3DXDecodeBC4SPalette;    ctx.sbpp = 8;   break;
+        case DXGI_FORMAT_BC5_UNORM:         ctx.pfDecode = D3DXDecodeBC5U;  pfDecodePalette = D3DXDecodeBC5UPalette;    ctx.sbpp = 16;  break;
+        case DXGI_FORMAT_BC5_SNORM:         ctx.pfDecode = D3DXDecodeBC5S;  pfDecodePalette = D3DXDecodeBC5SPalette;    ctx.sbpp = 16;  break;
+        case DXGI_FORMAT_BC6H_UF16:         ctx.pfDecode = D3DXDecodeBC6HU; pfDecodePalette = nullptr;                  ctx.sbpp = 16;  break;
+        case DXGI_FORMAT_BC6H_SF16:         ctx.pfDecode = D3DXDecodeBC6HS; pfDecodePalette = nullptr;                  ctx.sbpp = 16;  break;
         case DXGI_FORMAT_BC7_UNORM:
-        case DXGI_FORMAT_BC7_UNORM_SRGB:    pfDecode = D3DXDecodeBC7;   sbpp = 16;  break;
+        case DXGI_FORMAT_BC7_UNORM_SRGB:    ctx.pfDecode = D3DXDecodeBC7;   pfDecodePalette = nullptr;                  ctx.sbpp = 16;  break;
         default:
             return HRESULT_E_NOT_SUPPORTED;
         }
 
-        XM_ALIGNED_DATA(16) XMVECTOR temp[16];
-        const uint8_t *pSrc = cImage.pixels;
+        const bool direct = IsDirectDecode(ctx.cformat, format);
+        ctx.pfDecodePalette = direct ? pfDecodePalette : nullptr;
+        ctx.directRGBA8 = direct && (ctx.dbpp == 4) && !pfDecodePalette;
+        ctx.convert = !direct;
+
+        return S_OK;
+    }
+
+    // Decodes one row of blocks through the float path, used for any output format
+    HRESULT DecompressRowGeneric(const DecompressContext& ctx, const Image& cImage, const Image& result, size_t by) noexcept
+    {
+        const uint8_t *sptr = cImage.pixels + by * cImage.rowPitch;
+        uint8_t *dptr = result.pixels + by * 4 * result.rowPitch;
         const size_t rowPitch = result.rowPitch;
-        for (size_t h = 0; h < cImage.height; h += 4)
+        const size_t ph = std::min<size_t>(4, cImage.height - by * 4);
+
+        XM_ALIGNED_DATA(16) XMVECTOR temp[NUM_PIXELS_PER_BLOCK];
+        size_t w = 0;
+        for (size_t count = 0; (count < cImage.rowPitch) && (w < cImage.width); count += ctx.sbpp, w += 4)
         {
-            const uint8_t *sptr = pSrc;
-            uint8_t* dptr = pDest;
-            const size_t ph = std::min<size_t>(4, cImage.height - h);
-            size_t w = 0;
-            for (size_t count = 0; (count < cImage.rowPitch) && (w < cImage.width); count += sbpp, w += 4)
+            ctx.pfDecode(temp, sptr);
+            if (ctx.convert)
             {
-                pfDecode(temp, sptr);
-                ConvertScanline(temp, 16, format, cformat, TEX_FILTER_DEFAULT);
+                ConvertScanline(temp, NUM_PIXELS_PER_BLOCK, result.format, ctx.cformat, TEX_FILTER_DEFAULT);
+            }
 
-                const size_t pw = std::min<size_t>(4, cImage.width - w);
-                assert(pw > 0 && ph > 0);
+            const size_t pw = std::min<size_t>(4, cImage.width - w);
+            assert(pw > 0 && ph > 0);
 
-                if (!StoreScanline(dptr, rowPitch, format, &temp[0], pw))
+            for (size_t y = 0; y < ph; ++y)
+            {
+                if (!StoreScanline(dptr + rowPitch * y, rowPitch, result.format, &temp[y * 4], pw))
                     return E_FAIL;
+            }
 
-                if (ph > 1)
-                {
-                    if (!StoreScanline(dptr + rowPitch, rowPitch, format, &temp[4], pw))
-                        return E_FAIL;
+            sptr += ctx.sbpp;
+            dptr += ctx.dbpp * 4;
+        }
+
+        return S_OK;
+    }
+
+    // Decodes one row of blocks by packing each block's palette once and copying the
+    // selected entries into the destination. N is the output pixel size in bytes.
+    template <size_t N>
+    HRESULT DecompressRowPalette(const DecompressContext& ctx, const Image& cImage, const Image& result, size_t by) noexcept
+    {
+        const uint8_t *sptr = cImage.pixels + by * cImage.rowPitch;
+        uint8_t *dptr = result.pixels + by * 4 * result.rowPitch;
+        const size_t rowPitch = result.rowPitch;
+        const size_t ph = std::min<size_t>(4, cImage.height - by * 4);
+
+        BC_PALETTE palette;
+        uint8_t packed[2][NUM_PIXELS_PER_BLOCK * N];
+        size_t w = 0;
+        for (size_t count = 0; (count < cImage.rowPitch) && (w < cImage.width); count += ctx.sbpp, w += 4)
+        {
+            ctx.pfDecodePalette(&palette, sptr);
+
+            for (size_t plane = 0; plane < 2; ++plane)
+            {
+                if (palette.count[plane] > 0
+                    && !StoreScanline(packed[plane], sizeof(packed[plane]), result.format, palette.entries[plane], palette.count[plane]))
+                    return E_FAIL;
+            }
 
-                    if (ph > 2)
+            const size_t pw = std::min<size_t>(4, cImage.width - w);
+            assert(pw > 0 && ph > 0);
+
+            uint64_t indices0 = palette.indices[0];
+            uint64_t indices1 = palette.indices[1];
+            uint8_t line[4 * N];
+            for (size_t y = 0; y < ph; ++y)
+            {
+                if (palette.count[1] > 0)
+                {
+                    for (size_t x = 0; x < 4; ++x, indices0 >>= 4, indices1 >>= 4)
                     {
-                        if (!StoreScanline(dptr + rowPitch * 2, rowPitch, format, &temp[8], pw))
-                            return E_FAIL;
-
-                        if (ph > 3)
-                        {
-                            if (!StoreScanline(dptr + rowPitch * 3, rowPitch, format, &temp[12], pw))
-                                return E_FAIL;
-                        }
+                        const uint8_t *c0 = &packed[0][(indices0 & 0xf) * N];
+                        const uint8_t *c1 = &packed[1][(indices1 & 0xf) * N];
+                        for (size_t k = 0; k < N; ++k)
+                            line[x * N + k] = static_cast<uint8_t>(c0[k] | c1[k]);
                     }
                 }
+                else
+                {
+                    for (size_t x = 0; x < 4; ++x, indices0 >>= 4)
+                        memcpy(&line[x * N], &packed[0][(indices0 & 0xf) * N], N);
+                }
+
+                memcpy(dptr + rowPitch * y, line, pw * N);
+            }
+
+            sptr += ctx.sbpp;
+            dptr += N * 4;
+        }
+
+        return S_OK;
+    }
+
+    // Decodes one row of BC7 blocks straight to 8-bit RGBA
+    HRESULT DecompressRowBC7(const DecompressContext& ctx, const Image& cImage, const Image& result, size_t by) noexcept
+    {
+        const uint8_t *sptr = cImage.pixels + by * cImage.rowPitch;
+        uint8_t *dptr = result.pixels + by * 4 * result.rowPitch;
+        const size_t rowPitch = result.rowPitch;
+        const size_t ph = std::min<size_t>(4, cImage.height - by * 4);
+
+        uint8_t texels[NUM_PIXELS_PER_BLOCK * 4];
+        size_t w = 0;
+        for (size_t count = 0; (count < cImage.rowPitch) && (w < cImage.width); count += ctx.sbpp, w += 4)
+        {
+            D3DXDecodeBC7RGBA8(texels, sptr);
+
+            const size_t pw = std::min<size_t>(4, cImage.width - w);
+            assert(pw > 0 && ph > 0);
 
-                sptr += sbpp;
-                dptr += dbpp * 4;
+            for (size_t y = 0; y < ph; ++y)
+            {
+                memcpy(dptr + rowPitch * y, &texels[y * 16], pw * 4);
             }
 
-            pSrc += cImage.rowPitch;
-            pDest += rowPitch * 4;
+            sptr += ctx.sbpp;
+            dptr += 16;
         }
 
         return S_OK;
     }
+
+    HRESULT DecompressRow(const DecompressContext& ctx, size_t row) noexcept
+    {
+        // rowStart holds the first task index for each image
+        const size_t index = size_t(std::upper_bound(ctx.rowStart, ctx.rowStart + ctx.nimages + 1, row) - ctx.rowStart) - 1;
+        assert(index < ctx.nimages);
+
+        const Image& cImage = ctx.images[index];
+        const Image& result = ctx.results[index];
+        const size_t by = row - ctx.rowStart[index];
+
+        if (ctx.directRGBA8)
+            return DecompressRowBC7(ctx, cImage, result, by);
+
+        if (ctx.pfDecodePalette)
+        {
+            switch (ctx.dbpp)
+            {
+            case 1:  return DecompressRowPalette<1>(ctx, cImage, result, by);
+            case 2:  return DecompressRowPalette<2>(ctx, cImage, result, by);
+            case 4:  return DecompressRowPalette<4>(ctx, cImage, result, by);
+            case 8:  return DecompressRowPalette<8>(ctx, cImage, result, by);
+            case 16: return DecompressRowPalette<16>(ctx, cImage, result, by);
+            default: break;
+            }
+        }
+
+        return DecompressRowGeneric(ctx, cImage, result, by);
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Decompresses a set of images of the same formats, one task per row of blocks.
+    // Blocks are independent, so the output does not depend on the thread count.
+    //-------------------------------------------------------------------------------------
+    HRESULT DecompressBC(
+        _In_reads_(nimages) const Image* cImages,
+        _In_reads_(nimages) const Image* results,
+        size_t nimages,
+        size_t maxThreads) noexcept
+    {
+        assert(cImages && results && nimages > 0);
+
+        DecompressContext ctx = {};
+        HRESULT hr = SetupDecompress(cImages[0].format, results[0].format, ctx);
+        if (FAILED(hr))
+            return hr;
+
+        std::unique_ptr<size_t[]> rowStart(new (std::nothrow) size_t[nimages + 1]);
+        if (!rowStart)
+            return E_OUTOFMEMORY;
+
+        rowStart[0] = 0;
+        for (size_t index = 0; index < nimages; ++index)
+        {
+            const Image& cImage = cImages[index];
+            const Image& result = results[index];
+
+            if (!cImage.pixels || !result.pixels)
+                return E_POINTER;
+
+            if (cImage.format != cImages[0].format || result.format != results[0].format
+                || cImage.width != result.width || cImage.height != result.height)
+                return E_FAIL;
+
+            rowStart[index + 1] = rowStart[index] + (cImage.height + 3) / 4;
+        }
+
+        ctx.images = cImages;
+        ctx.results = results;
+        ctx.rowStart = rowStart.get();
+        ctx.nimages = nimages;
+
+        return ParallelFor(rowStart[nimages], maxThreads,
+            [&ctx](size_t row) -> HRESULT { return DecompressRow(ctx, row); });
+    }
 }
 
 //-------------------------------------------------------------------------------------
@@ -671,6 +1458,9 @@ HRESULT DirectX::CompressEx(
     if (IsCompressed(srcImage.format) || !IsCompressed(format))
         return E_INVALIDARG;
 
+    if (options.bc7Level > TEX_BC7_LEVEL_MAX || options.rdoLambda < 0.f)
+        return E_INVALIDARG;
+
     if (IsTypeless(format)
         || IsTypeless(srcImage.format) || IsPlanar(srcImage.format) || IsPalettized(srcImage.format))
         return HRESULT_E_NOT_SUPPORTED;
@@ -699,15 +1489,11 @@ HRESULT DirectX::CompressEx(
     // Compress single image
     if (options.flags & TEX_COMPRESS_PARALLEL)
     {
-    #ifndef _OPENMP
-        hr = E_NOTIMPL;
-    #else
-        hr = CompressBC_Parallel(srcImage, *img, GetBCFlags(options.flags), GetSRGBFlags(options.flags), options.threshold, statusCallback);
-    #endif // _OPENMP
+        hr = CompressBC_Parallel(&srcImage, img, 1, GetBCFlags(options), GetSRGBFlags(options.flags), options.threshold, options.rdoLambda, options.maxThreads, statusCallback);
     }
     else
     {
-        hr = CompressBC(srcImage, *img, GetBCFlags(options.flags), GetSRGBFlags(options.flags), options.threshold, statusCallback);
+        hr = CompressBC(srcImage, *img, GetBCFlags(options), GetSRGBFlags(options.flags), options.threshold, options.rdoLambda, statusCallback);
     }
 
     if (FAILED(hr))
@@ -744,6 +1530,9 @@ HRESULT DirectX::CompressEx(
     if (IsCompressed(metadata.format) || !IsCompressed(format))
         return E_INVALIDARG;
 
+    if (options.bc7Level > TEX_BC7_LEVEL_MAX || options.rdoLambda < 0.f)
+        return E_INVALIDARG;
+
     if (IsTypeless(format)
         || IsTypeless(metadata.format) || IsPlanar(metadata.format) || IsPalettized(metadata.format))
         return HRESULT_E_NOT_SUPPORTED;
@@ -791,43 +1580,54 @@ HRESULT DirectX::CompressEx(
         }
     }
 
-    for (size_t index = 0; index < nimages; ++index)
+    if (options.flags & TEX_COMPRESS_PARALLEL)
     {
-        assert(dest[index].format == format);
-
-        const Image& src = srcImages[index];
-
-        if (src.width != dest[index].width || src.height != dest[index].height)
-        {
-            cImages.Release();
-            return E_FAIL;
-        }
-
-        if (options.flags & TEX_COMPRESS_PARALLEL)
-        {
-        #ifndef _OPENMP
-            hr = E_NOTIMPL;
-        #else
-            hr = CompressBC_Parallel(src, dest[index], GetBCFlags(options.flags), GetSRGBFlags(options.flags), options.threshold, nullptr);
-        #endif // _OPENMP
-        }
-        else
+        // Compress all subresources at once so small mips and array slices share the thread pool
+        std::function<bool __cdecl(size_t, size_t)> progress;
+        if (statusCallback)
         {
-            hr = CompressBC(src, dest[index], GetBCFlags(options.flags), GetSRGBFlags(options.flags), options.threshold, nullptr);
+            // Scale row progress to the image count used by this overload
+            progress = [&](size_t rows, size_t total) -> bool
+                {
+                    return statusCallback(rows * nimages / total, nimages);
+                };
         }
 
+        hr = CompressBC_Parallel(srcImages, dest, nimages, GetBCFlags(options), GetSRGBFlags(options.flags), options.threshold, options.rdoLambda, options.maxThreads, progress);
         if (FAILED(hr))
         {
             cImages.Release();
             return hr;
         }
-
-        if (statusCallback)
+    }
+    else
+    {
+        for (size_t index = 0; index < nimages; ++index)
         {
-            if (!statusCallback(index, nimages))
+            assert(dest[index].format == format);
+
+            const Image& src = srcImages[index];
+
+            if (src.width != dest[index].width || src.height != dest[index].height)
             {
                 cImages.Release();
-                return E_ABORT;
+                return E_FAIL;
+            }
+
+            hr = CompressBC(src, dest[index], GetBCFlags(options), GetSRGBFlags(options.flags), options.threshold, options.rdoLambda, nullptr);
+            if (FAILED(hr))
+            {
+                cImages.Release();
+                return hr;
+            }
+
+            if (statusCallback)
+            {
+                if (!statusCallback(index, nimages))
+                {
+                    cImages.Release();
+                    return E_ABORT;
+                }
             }
         }
     }
@@ -853,6 +1653,17 @@ HRESULT DirectX::Decompress(
     const Image& cImage,
     DXGI_FORMAT format,
     ScratchImage& image) noexcept
+{
+    return Decompress(cImage, format, TEX_DECOMPRESS_DEFAULT, 0, image);
+}
+
+_Use_decl_annotations_
+HRESULT DirectX::Decompress(
+    const Image& cImage,
+    DXGI_FORMAT format,
+    TEX_DECOMPRESS_FLAGS flags,
+    size_t maxThreads,
+    ScratchImage& image) noexcept
 {
     if (!IsCompressed(cImage.format) || IsCompressed(format))
         return E_INVALIDARG;
@@ -889,7 +1700,7 @@ HRESULT DirectX::Decompress(
     }
 
     // Decompress single image
-    hr = DecompressBC(cImage, *img);
+    hr = DecompressBC(&cImage, img, 1, (flags & TEX_DECOMPRESS_PARALLEL) ? maxThreads : 1);
     if (FAILED(hr))
         image.Release();
 
@@ -903,6 +1714,19 @@ HRESULT DirectX::Decompress(
     const TexMetadata& metadata,
     DXGI_FORMAT format,
     ScratchImage& images) noexcept
+{
+    return Decompress(cImages, nimages, metadata, format, TEX_DECOMPRESS_DEFAULT, 0, images);
+}
+
+_Use_decl_annotations_
+HRESULT DirectX::Decompress(
+    const Image* cImages,
+    size_t nimages,
+    const TexMetadata& metadata,
+    DXGI_FORMAT format,
+    TEX_DECOMPRESS_FLAGS flags,
+    size_t maxThreads,
+    ScratchImage& images) noexcept
 {
     if (!cImages || !nimages)
         return E_INVALIDARG;
@@ -966,13 +1790,14 @@ HRESULT DirectX::Decompress(
             images.Release();
             return E_FAIL;
         }
+    }
 
-        hr = DecompressBC(src, dest[index]);
-        if (FAILED(hr))
-        {
-            images.Release();
-            return hr;
-        }
+    // Decompress all images together so small mips and array slices share the workers
+    hr = DecompressBC(cImages, dest, nimages, (flags & TEX_DECOMPRESS_PARALLEL) ? maxThreads : 1);
+    if (FAILED(hr))
+    {
+        images.Release();
+        return hr;
     }
 
     return S_OK;
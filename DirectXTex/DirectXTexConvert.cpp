@@ -2790,6 +2790,189 @@ HRESULT DirectX::Internal::ConvertFromR16G16B16A16(const Image& srcImage, const
 }
 
 
+//-------------------------------------------------------------------------------------
+// Table-driven sRGB for 8-bit UNORM formats
+//
+// Decoding looks up the linear value of each of the 256 codes. Encoding returns the
+// number of decision thresholds (the linear values halfway between adjacent codes in
+// sRGB space) at or below the input; a bucket table indexed by the upper float bits
+// gives the starting code, so the result is exactly rounded to the nearest code.
+//-------------------------------------------------------------------------------------
+namespace
+{
+    constexpr uint32_t SRGB8_MIN_BITS = 0x39000000;         // 2^-13, below the first threshold
+    constexpr uint32_t SRGB8_ONE_BITS = 0x3F800000;         // 1.0
+    constexpr uint32_t SRGB8_BUCKET_SHIFT = 16;             // 128 buckets per octave
+    constexpr size_t SRGB8_BUCKETS = (SRGB8_ONE_BITS - SRGB8_MIN_BITS) >> SRGB8_BUCKET_SHIFT;
+
+    struct SRGB8Tables
+    {
+        float   toLinear[256];
+        float   unorm[256];                 // Same values as XMLoadUByteN4
+        float   threshold[256];             // Smallest float that encodes to each code
+        uint8_t bucket[SRGB8_BUCKETS];      // Code of the smallest float in each bucket
+
+        SRGB8Tables() noexcept
+        {
+            auto decode = [](double s) -> double
+                {
+                    return (s <= 0.04045) ? (s / 12.92) : pow((s + 0.055) / 1.055, 2.4);
+                };
+
+            for (size_t j = 0; j < 256; ++j)
+            {
+                toLinear[j] = static_cast<float>(decode(double(j) / 255.0));
+
+                XMUBYTEN4 code;
+                code.x = code.y = code.z = code.w = static_cast<uint8_t>(j);
+                unorm[j] = XMVectorGetX(XMLoadUByteN4(&code));
+
+                if (!j)
+                {
+                    threshold[j] = 0.f;
+                    continue;
+                }
+
+                // Round up so that 'v >= threshold' is exact for float inputs
+                const double t = decode((double(j) - 0.5) / 255.0);
+                float f = static_cast<float>(t);
+                if (double(f) < t)
+                {
+                    f = nextafterf(f, 2.f);
+                }
+                threshold[j] = f;
+            }
+
+            uint32_t code = 0;
+            for (size_t j = 0; j < SRGB8_BUCKETS; ++j)
+            {
+                const uint32_t bits = SRGB8_MIN_BITS + static_cast<uint32_t>(j << SRGB8_BUCKET_SHIFT);
+                float v;
+                memcpy(&v, &bits, sizeof(float));
+                while (code < 255 && threshold[code + 1] <= v)
+                    ++code;
+                bucket[j] = static_cast<uint8_t>(code);
+            }
+        }
+
+        uint8_t Encode(float v) const noexcept
+        {
+            // Written so that NaN maps to 0
+            if (!(v >= threshold[1]))
+                return 0;
+
+            if (v >= threshold[255])
+                return 255;
+
+            uint32_t bits;
+            memcpy(&bits, &v, sizeof(float));
+
+            uint32_t code = bucket[(bits - SRGB8_MIN_BITS) >> SRGB8_BUCKET_SHIFT];
+            while (v >= threshold[code + 1])
+                ++code;
+
+            return static_cast<uint8_t>(code);
+        }
+    };
+
+    const SRGB8Tables& GetSRGB8Tables() noexcept
+    {
+        static const SRGB8Tables s_tables;
+        return s_tables;
+    }
+
+    bool IsSRGB8Format(DXGI_FORMAT format) noexcept
+    {
+        switch (format)
+        {
+        case DXGI_FORMAT_R8G8B8A8_UNORM:
+        case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+        case DXGI_FORMAT_B8G8R8A8_UNORM:
+        case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+        case DXGI_FORMAT_B8G8R8X8_UNORM:
+        case DXGI_FORMAT_B8G8R8X8_UNORM_SRGB:
+            return true;
+
+        default:
+            return false;
+        }
+    }
+
+    // LoadScanline followed by sRGB to linear for IsSRGB8Format formats
+    bool LoadScanlineSRGB8(
+        _Out_writes_(count) XMVECTOR* pDestination,
+        size_t count,
+        _In_reads_bytes_(size) const void* pSource,
+        size_t size,
+        DXGI_FORMAT format) noexcept
+    {
+        if (size < sizeof(XMUBYTEN4))
+            return false;
+
+        const SRGB8Tables& tables = GetSRGB8Tables();
+
+        const bool bgr = (format != DXGI_FORMAT_R8G8B8A8_UNORM && format != DXGI_FORMAT_R8G8B8A8_UNORM_SRGB);
+        const bool noalpha = (format == DXGI_FORMAT_B8G8R8X8_UNORM || format == DXGI_FORMAT_B8G8R8X8_UNORM_SRGB);
+
+        XMVECTOR* __restrict dPtr = pDestination;
+        const XMVECTOR* ePtr = pDestination + count;
+        const XMUBYTEN4 * __restrict sPtr = static_cast<const XMUBYTEN4*>(pSource);
+        for (size_t icount = 0; icount < (size - sizeof(XMUBYTEN4) + 1); icount += sizeof(XMUBYTEN4), ++sPtr)
+        {
+            if (dPtr >= ePtr) break;
+            const float r = tables.toLinear[bgr ? sPtr->z : sPtr->x];
+            const float g = tables.toLinear[sPtr->y];
+            const float b = tables.toLinear[bgr ? sPtr->x : sPtr->z];
+            const float a = noalpha ? 1.f : tables.unorm[sPtr->w];
+            *(dPtr++) = XMVectorSet(r, g, b, a);
+        }
+
+        return true;
+    }
+
+    // Linear to sRGB followed by StoreScanline for IsSRGB8Format formats
+    bool StoreScanlineSRGB8(
+        _Out_writes_bytes_(size) void* pDestination,
+        size_t size,
+        DXGI_FORMAT format,
+        _In_reads_(count) const XMVECTOR* pSource,
+        size_t count) noexcept
+    {
+        if (size < sizeof(XMUBYTEN4))
+            return false;
+
+        const SRGB8Tables& tables = GetSRGB8Tables();
+
+        const bool bgr = (format != DXGI_FORMAT_R8G8B8A8_UNORM && format != DXGI_FORMAT_R8G8B8A8_UNORM_SRGB);
+        const bool noalpha = (format == DXGI_FORMAT_B8G8R8X8_UNORM || format == DXGI_FORMAT_B8G8R8X8_UNORM_SRGB);
+
+        const XMVECTOR* __restrict sPtr = pSource;
+        const XMVECTOR* ePtr = pSource + count;
+        XMUBYTEN4 * __restrict dPtr = static_cast<XMUBYTEN4*>(pDestination);
+        for (size_t icount = 0; icount < (size - sizeof(XMUBYTEN4) + 1); icount += sizeof(XMUBYTEN4), ++dPtr)
+        {
+            if (sPtr >= ePtr) break;
+
+            XMFLOAT4A v;
+            XMStoreFloat4A(&v, *sPtr);
+
+            // Alpha is rounded the same way as StoreScanline
+            XMUBYTEN4 alpha;
+            XMStoreUByteN4(&alpha, XMVectorAdd(*sPtr++, g_8BitBias));
+
+            const uint8_t r = tables.Encode(v.x);
+            const uint8_t b = tables.Encode(v.z);
+            dPtr->x = bgr ? b : r;
+            dPtr->y = tables.Encode(v.y);
+            dPtr->z = bgr ? r : b;
+            dPtr->w = noalpha ? uint8_t(255) : alpha.w;
+        }
+
+        return true;
+    }
+}
+
+
 //-------------------------------------------------------------------------------------
 // Convert from Linear RGB to sRGB
 //
@@ -2855,6 +3038,9 @@ bool DirectX::Internal::StoreScanlineLinear(
     // sRGB output processing (Linear RGB -> sRGB)
     if (flags & TEX_FILTER_SRGB_OUT)
     {
+        if (IsSRGB8Format(format))
+            return StoreScanlineSRGB8(pDestination, size, format, pSource, count);
+
         // To avoid the need for another temporary scanline buffer, we allow this function to overwrite the source buffer in-place
         // Given the intended usage in the filtering routines, this is not a problem.
         XMVECTOR* ptr = pSource;
@@ -2924,6 +3110,9 @@ bool DirectX::Internal::LoadScanlineLinear(
         break;
     }
 
+    if ((flags & TEX_FILTER_SRGB_IN) && IsSRGB8Format(format))
+        return LoadScanlineSRGB8(pDestination, count, pSource, size, format);
+
     if (LoadScanline(pDestination, count, pSource, size, format))
     {
         // sRGB input processing (sRGB -> Linear RGB)
@@ -3167,7 +3356,21 @@ void DirectX::Internal::ConvertScanline(
     // sRGB input processing (sRGB -> Linear RGB)
     if (flags & TEX_FILTER_SRGB_IN)
     {
-        if (!(in->flags & CONVF_DEPTH) && ((in->flags & CONVF_FLOAT) || (in->flags & CONVF_UNORM)))
+        if (IsSRGB8Format(inFormat))
+        {
+            // Values were loaded from 8-bit codes, so decode by table
+            const float* toLinear = GetSRGB8Tables().toLinear;
+
+            XMVECTOR* ptr = pBuffer;
+            for (size_t i = 0; i < count; ++i, ++ptr)
+            {
+                XMUBYTEN4 code;
+                XMStoreUByteN4(&code, XMVectorAdd(*ptr, g_8BitBias));
+                const XMVECTOR v = XMVectorSet(toLinear[code.x], toLinear[code.y], toLinear[code.z], 0.f);
+                *ptr = XMVectorSelect(*ptr, v, g_XMSelect1110);
+            }
+        }
+        else if (!(in->flags & CONVF_DEPTH) && ((in->flags & CONVF_FLOAT) || (in->flags & CONVF_UNORM)))
         {
             XMVECTOR* ptr = pBuffer;
             for (size_t i = 0; i < count; ++i, ++ptr)
@@ -4796,6 +4999,359 @@ namespace
     #endif // WIN32
     }
 
+    //-------------------------------------------------------------------------------------
+    // Direct conversions between common packed formats
+    //
+    // Each channel of these formats converts independently of the others (sRGB curves,
+    // saturation, x2 bias and the store rounding are all per-channel), so a table built by
+    // running the float path once over every channel value gives exactly the same results
+    // as converting each pixel with LoadScanline / ConvertScanline / StoreScanline.
+    //-------------------------------------------------------------------------------------
+    enum PACKED_LAYOUT : uint32_t
+    {
+        PACKED_RGBA8 = 0,   // 4 x 8-bit
+        PACKED_BGRA8,       // 4 x 8-bit with red and blue swapped
+        PACKED_RGB10A2,     // 3 x 10-bit + 2-bit alpha
+        PACKED_RGBA16,      // 4 x 16-bit
+        PACKED_COUNT,
+    };
+
+    bool GetPackedLayout(_In_ DXGI_FORMAT format, _Out_ PACKED_LAYOUT& layout) noexcept
+    {
+        switch (format)
+        {
+        case DXGI_FORMAT_R8G8B8A8_UNORM:
+        case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:   layout = PACKED_RGBA8; return true;
+        case DXGI_FORMAT_B8G8R8A8_UNORM:
+        case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:   layout = PACKED_BGRA8; return true;
+        case DXGI_FORMAT_R10G10B10A2_UNORM:     layout = PACKED_RGB10A2; return true;
+        case DXGI_FORMAT_R16G16B16A16_UNORM:
+        case DXGI_FORMAT_R16G16B16A16_FLOAT:    layout = PACKED_RGBA16; return true;
+        default:                                layout = PACKED_COUNT; return false;
+        }
+    }
+
+    constexpr size_t PackedPixelSize(PACKED_LAYOUT layout) noexcept
+    {
+        return (layout == PACKED_RGBA16) ? 8 : 4;
+    }
+
+    // Number of distinct values of the widest channel, which sizes the lookup table
+    constexpr size_t PackedChannelValues(PACKED_LAYOUT layout) noexcept
+    {
+        return (layout == PACKED_RGBA16) ? 65536 : (layout == PACKED_RGB10A2) ? 1024 : 256;
+    }
+
+    inline void UnpackPixel(PACKED_LAYOUT layout, _In_ const uint8_t* pSrc, _Out_writes_(4) uint32_t* c) noexcept
+    {
+        switch (layout)
+        {
+        case PACKED_RGBA8:
+        case PACKED_BGRA8:
+            {
+                uint32_t v;
+                memcpy(&v, pSrc, sizeof(v));
+                const bool bgr = (layout == PACKED_BGRA8);
+                c[bgr ? 2 : 0] = v & 0xFF;
+                c[1] = (v >> 8) & 0xFF;
+                c[bgr ? 0 : 2] = (v >> 16) & 0xFF;
+                c[3] = v >> 24;
+            }
+            break;
+
+        case PACKED_RGB10A2:
+            {
+                uint32_t v;
+                memcpy(&v, pSrc, sizeof(v));
+                c[0] = v & 0x3FF;
+                c[1] = (v >> 10) & 0x3FF;
+                c[2] = (v >> 20) & 0x3FF;
+                c[3] = v >> 30;
+            }
+            break;
+
+        default:
+            {
+                uint16_t v[4];
+                memcpy(v, pSrc, sizeof(v));
+                c[0] = v[0];
+                c[1] = v[1];
+                c[2] = v[2];
+                c[3] = v[3];
+            }
+            break;
+        }
+    }
+
+    inline void PackPixel(PACKED_LAYOUT layout, _Out_ uint8_t* pDest, _In_reads_(4) const uint32_t* c) noexcept
+    {
+        switch (layout)
+        {
+        case PACKED_RGBA8:
+        case PACKED_BGRA8:
+            {
+                const bool bgr = (layout == PACKED_BGRA8);
+                const uint32_t v = c[bgr ? 2 : 0] | (c[1] << 8) | (c[bgr ? 0 : 2] << 16) | (c[3] << 24);
+                memcpy(pDest, &v, sizeof(v));
+            }
+            break;
+
+        case PACKED_RGB10A2:
+            {
+                const uint32_t v = c[0] | (c[1] << 10) | (c[2] << 20) | (c[3] << 30);
+                memcpy(pDest, &v, sizeof(v));
+            }
+            break;
+
+        default:
+            {
+                const uint16_t v[4] = { uint16_t(c[0]), uint16_t(c[1]), uint16_t(c[2]), uint16_t(c[3]) };
+                memcpy(pDest, v, sizeof(v));
+            }
+            break;
+        }
+    }
+
+    // Table layout is [channel][value]; count is PackedChannelValues of the source
+    typedef void (*PackedRowFunc)(uint8_t* pDest, const uint8_t* pSrc, size_t width, const uint16_t* table, size_t count);
+
+    template <PACKED_LAYOUT S, PACKED_LAYOUT D>
+    void ConvertPackedRow(
+        _Out_writes_bytes_(width * PackedPixelSize(D)) uint8_t* pDest,
+        _In_reads_bytes_(width * PackedPixelSize(S)) const uint8_t* pSrc,
+        size_t width,
+        _In_reads_(count * 4) const uint16_t* table,
+        size_t count) noexcept
+    {
+        for (size_t x = 0; x < width; ++x)
+        {
+            uint32_t c[4];
+            UnpackPixel(S, pSrc, c);
+
+            c[0] = table[c[0]];
+            c[1] = table[count + c[1]];
+            c[2] = table[count * 2 + c[2]];
+            c[3] = table[count * 3 + c[3]];
+
+            PackPixel(D, pDest, c);
+
+            pSrc += PackedPixelSize(S);
+            pDest += PackedPixelSize(D);
+        }
+    }
+
+    // RGBA8 <-> BGRA8 when the table is the identity
+    void SwizzlePackedRow(
+        _Out_writes_bytes_(width * 4) uint8_t* pDest,
+        _In_reads_bytes_(width * 4) const uint8_t* pSrc,
+        size_t width,
+        const uint16_t*,
+        size_t) noexcept
+    {
+        for (size_t x = 0; x < width; ++x)
+        {
+            uint32_t v;
+            memcpy(&v, pSrc + x * 4, sizeof(v));
+            v = (v & 0xFF00FF00) | ((v >> 16) & 0xFF) | ((v & 0xFF) << 16);
+            memcpy(pDest + x * 4, &v, sizeof(v));
+        }
+    }
+
+#define PACKED_ROW_FUNCS(S) { ConvertPackedRow<S, PACKED_RGBA8>, ConvertPackedRow<S, PACKED_BGRA8>, ConvertPackedRow<S, PACKED_RGB10A2>, ConvertPackedRow<S, PACKED_RGBA16> }
+
+    const PackedRowFunc g_PackedRowFuncs[PACKED_COUNT][PACKED_COUNT] =
+    {
+        PACKED_ROW_FUNCS(PACKED_RGBA8),
+        PACKED_ROW_FUNCS(PACKED_BGRA8),
+        PACKED_ROW_FUNCS(PACKED_RGB10A2),
+        PACKED_ROW_FUNCS(PACKED_RGBA16),
+    };
+
+#undef PACKED_ROW_FUNCS
+
+    // Runs the float conversion over a row where pixel i has every channel set to i
+    HRESULT BuildPackedTable(
+        _In_ DXGI_FORMAT sformat,
+        _In_ PACKED_LAYOUT slayout,
+        _In_ DXGI_FORMAT tformat,
+        _In_ PACKED_LAYOUT tlayout,
+        _In_ TEX_FILTER_FLAGS filter,
+        _Out_writes_(count * 4) uint16_t* table,
+        size_t count) noexcept
+    {
+        const size_t spitch = count * PackedPixelSize(slayout);
+        const size_t tpitch = count * PackedPixelSize(tlayout);
+
+        std::unique_ptr<uint8_t[]> row(new (std::nothrow) uint8_t[spitch + tpitch]);
+        auto scanline = make_AlignedArrayXMVECTOR(count);
+        if (!row || !scanline)
+            return E_OUTOFMEMORY;
+
+        uint8_t* pSrc = row.get();
+        uint8_t* pDest = row.get() + spitch;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const auto v = static_cast<uint32_t>(i);
+            const uint32_t c[4] = { v, v, v, (slayout == PACKED_RGB10A2) ? (v & 0x3) : v };
+            PackPixel(slayout, pSrc + i * PackedPixelSize(slayout), c);
+        }
+
+        if (!LoadScanline(scanline.get(), count, pSrc, spitch, sformat))
+            return E_FAIL;
+
+        ConvertScanline(scanline.get(), count, tformat, sformat, filter);
+
+        if (!StoreScanline(pDest, tpitch, tformat, scanline.get(), count))
+            return E_FAIL;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            uint32_t c[4];
+            UnpackPixel(tlayout, pDest + i * PackedPixelSize(tlayout), c);
+
+            for (size_t ch = 0; ch < 4; ++ch)
+            {
+                table[ch * count + i] = static_cast<uint16_t>(c[ch]);
+            }
+        }
+
+        return S_OK;
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Sets up conversion with a packed lookup table; returns S_FALSE if the formats or
+    // flags need the general path
+    //-------------------------------------------------------------------------------------
+    struct PackedConverter
+    {
+        PackedRowFunc               pfRow;
+        std::unique_ptr<uint16_t[]> table;
+        size_t                      count;
+
+        PackedConverter() noexcept : pfRow(nullptr), count(0) {}
+    };
+
+    HRESULT SetupPackedConverter(
+        _In_ DXGI_FORMAT sformat,
+        _In_ DXGI_FORMAT tformat,
+        _In_ TEX_FILTER_FLAGS filter,
+        _In_ uint64_t pixelCount,
+        _Out_ PackedConverter& packed) noexcept
+    {
+        packed.pfRow = nullptr;
+
+        if (filter & TEX_FILTER_DITHER_MASK)
+        {
+            // Dithering depends on the pixel position
+            return S_FALSE;
+        }
+
+        PACKED_LAYOUT slayout, tlayout;
+        if (!GetPackedLayout(sformat, slayout) || !GetPackedLayout(tformat, tlayout))
+            return S_FALSE;
+
+        // 16-bit UNORM loads are already cheap, and its 512 KB table loses to them
+        if (sformat == DXGI_FORMAT_R16G16B16A16_UNORM)
+            return S_FALSE;
+
+        // Only worthwhile when the image is large compared to the table
+        const size_t count = PackedChannelValues(slayout);
+        if (pixelCount < uint64_t(count) * 4)
+            return S_FALSE;
+
+        packed.table.reset(new (std::nothrow) uint16_t[count * 4]);
+        if (!packed.table)
+            return E_OUTOFMEMORY;
+
+        HRESULT hr = BuildPackedTable(sformat, slayout, tformat, tlayout, filter, packed.table.get(), count);
+        if (FAILED(hr))
+            return hr;
+
+        packed.count = count;
+        packed.pfRow = g_PackedRowFuncs[slayout][tlayout];
+
+        if (count == 256 && PackedChannelValues(tlayout) == 256)
+        {
+            bool identity = true;
+            for (size_t i = 0; identity && i < count * 4; ++i)
+            {
+                identity = (packed.table[i] == (i & 0xFF));
+            }
+
+            if (identity && slayout != tlayout)
+            {
+                packed.pfRow = SwizzlePackedRow;
+            }
+        }
+
+        return S_OK;
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Convert rows [y0, y1) without error diffusion; scanline is only needed if there is
+    // no packed converter
+    //-------------------------------------------------------------------------------------
+    HRESULT ConvertRows(
+        _In_ const Image& srcImage,
+        _In_ TEX_FILTER_FLAGS filter,
+        _In_ const Image& destImage,
+        _In_ float threshold,
+        size_t z,
+        size_t y0,
+        size_t y1,
+        _In_ const PackedConverter& packed,
+        _Inout_updates_opt_(srcImage.width) XMVECTOR* scanline,
+        const std::function<bool __cdecl(size_t, size_t)>& statusCallback) noexcept
+    {
+        assert(!(filter & TEX_FILTER_DITHER_DIFFUSION));
+        assert(packed.pfRow || scanline);
+
+        const size_t width = srcImage.width;
+        const uint8_t *pSrc = srcImage.pixels + y0 * srcImage.rowPitch;
+        uint8_t *pDest = destImage.pixels + y0 * destImage.rowPitch;
+
+        for (size_t h = y0; h < y1; ++h)
+        {
+            if (statusCallback)
+            {
+                if (!statusCallback(h, srcImage.height))
+                {
+                    return E_ABORT;
+                }
+            }
+
+            if (packed.pfRow)
+            {
+                packed.pfRow(pDest, pSrc, width, packed.table.get(), packed.count);
+            }
+            else
+            {
+                if (!LoadScanline(scanline, width, pSrc, srcImage.rowPitch, srcImage.format))
+                    return E_FAIL;
+
+                ConvertScanline(scanline, width, destImage.format, srcImage.format, filter);
+
+                if (filter & TEX_FILTER_DITHER)
+                {
+                    // Ordered dithering
+                    if (!StoreScanlineDither(pDest, destImage.rowPitch, destImage.format, scanline, width, threshold, h, z, nullptr))
+                        return E_FAIL;
+                }
+                else
+                {
+                    if (!StoreScanline(pDest, destImage.rowPitch, destImage.format, scanline, width, threshold))
+                        return E_FAIL;
+                }
+            }
+
+            pSrc += srcImage.rowPitch;
+            pDest += destImage.rowPitch;
+        }
+
+        return S_OK;
+    }
+
     //-------------------------------------------------------------------------------------
     // Convert the source image (not using WIC)
     //-------------------------------------------------------------------------------------
@@ -4848,66 +5404,222 @@ namespace
                 pSrc += srcImage.rowPitch;
                 pDest += destImage.rowPitch;
             }
+
+            return S_OK;
         }
-        else
+
+        PackedConverter packed;
+        HRESULT hr = SetupPackedConverter(srcImage.format, destImage.format, filter,
+            uint64_t(srcImage.width) * uint64_t(srcImage.height), packed);
+        if (FAILED(hr))
+            return hr;
+
+        ScopedAlignedArrayXMVECTOR scanline;
+        if (!packed.pfRow)
         {
-            auto scanline = make_AlignedArrayXMVECTOR(width);
+            scanline = make_AlignedArrayXMVECTOR(width);
             if (!scanline)
                 return E_OUTOFMEMORY;
+        }
+
+        return ConvertRows(srcImage, filter, destImage, threshold, z, 0, srcImage.height, packed, scanline.get(), statusCallback);
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Convert a set of images (not using WIC) on the thread pool
+    //
+    // Without error diffusion every row is independent, so images are split into bands of
+    // rows; error diffusion carries state from row to row, so each image is a single task.
+    // Either way the result is identical to ConvertCustom.
+    //
+    // statusCallback is only invoked on the calling thread. It reports completed rows of
+    // a single image, or completed images when there are several.
+    //-------------------------------------------------------------------------------------
+    constexpr size_t CONVERT_BAND_PIXELS = 32768;
+
+    HRESULT ConvertCustomParallel(
+        _In_reads_(nimages) const Image* srcImages,
+        _In_reads_(nimages) const Image* destImages,
+        _In_reads_opt_(nimages) const size_t* slices,
+        size_t nimages,
+        _In_ TEX_FILTER_FLAGS filter,
+        _In_ float threshold,
+        size_t maxThreads,
+        const std::function<bool __cdecl(size_t, size_t)>& statusCallback) noexcept
+    {
+        if (!srcImages || !destImages || !nimages)
+            return E_INVALIDARG;
+
+        const bool diffusion = (filter & TEX_FILTER_DITHER_DIFFUSION) != 0;
+
+        // Per-image band sizes and the running band count
+        std::unique_ptr<size_t[]> bandRows(new (std::nothrow) size_t[nimages * 2 + 1]);
+        if (!bandRows)
+            return E_OUTOFMEMORY;
+
+        size_t* bandStart = bandRows.get() + nimages;
+        bandStart[0] = 0;
+
+        uint64_t pixelCount = 0;
+        for (size_t index = 0; index < nimages; ++index)
+        {
+            const Image& src = srcImages[index];
+            if (!src.pixels || !destImages[index].pixels)
+                return E_POINTER;
+
+            const size_t rows = (diffusion || !src.width)
+                ? std::max<size_t>(src.height, 1)
+                : std::max<size_t>(CONVERT_BAND_PIXELS / src.width, 1);
+            bandRows[index] = rows;
+            bandStart[index + 1] = bandStart[index] + std::max<size_t>((src.height + rows - 1) / rows, 1);
+
+            pixelCount += uint64_t(src.width) * uint64_t(src.height);
+        }
+
+        const size_t bandCount = bandStart[nimages];
+
+        PackedConverter packed;
+        HRESULT hr = SetupPackedConverter(srcImages[0].format, destImages[0].format, filter, pixelCount, packed);
+        if (FAILED(hr))
+            return hr;
+
+        // Progress is counted in rows for a single image, in images otherwise
+        const size_t progressTotal = (nimages == 1) ? srcImages[0].height : nimages;
+        std::unique_ptr<std::atomic<size_t>[]> bandsLeft;
+        if (nimages > 1)
+        {
+            bandsLeft.reset(new (std::nothrow) std::atomic<size_t>[nimages]);
+            if (!bandsLeft)
+                return E_OUTOFMEMORY;
+
+            for (size_t index = 0; index < nimages; ++index)
+            {
+                bandsLeft[index] = bandStart[index + 1] - bandStart[index];
+            }
+        }
+
+        std::atomic<size_t> progress(0);
+        const std::thread::id caller = std::this_thread::get_id();
 
-            if (filter & TEX_FILTER_DITHER)
+        return ParallelFor(bandCount, maxThreads,
+            [&](size_t band) -> HRESULT
             {
-                // Ordered dithering
-                for (size_t h = 0; h < srcImage.height; ++h)
+                const size_t index = static_cast<size_t>(std::upper_bound(bandStart, bandStart + nimages + 1, band) - bandStart) - 1;
+
+                const Image& src = srcImages[index];
+                const Image& dst = destImages[index];
+                const size_t z = slices ? slices[index] : 0;
+
+                if (diffusion)
+                {
+                    const HRESULT hrb = ConvertCustom(src, filter, dst, threshold, z, nullptr);
+                    if (FAILED(hrb))
+                        return hrb;
+                }
+                else
                 {
-                    if (statusCallback)
+                    ScopedAlignedArrayXMVECTOR scanline;
+                    if (!packed.pfRow)
                     {
-                        if (!statusCallback(h, srcImage.height))
-                        {
-                            return E_ABORT;
-                        }
+                        scanline = make_AlignedArrayXMVECTOR(src.width);
+                        if (!scanline)
+                            return E_OUTOFMEMORY;
                     }
 
-                    if (!LoadScanline(scanline.get(), width, pSrc, srcImage.rowPitch, srcImage.format))
-                        return E_FAIL;
+                    const size_t y0 = (band - bandStart[index]) * bandRows[index];
+                    const size_t y1 = std::min(y0 + bandRows[index], src.height);
 
-                    ConvertScanline(scanline.get(), width, destImage.format, srcImage.format, filter);
+                    const HRESULT hrb = ConvertRows(src, filter, dst, threshold, z, y0, y1, packed, scanline.get(), nullptr);
+                    if (FAILED(hrb))
+                        return hrb;
 
-                    if (!StoreScanlineDither(pDest, destImage.rowPitch, destImage.format, scanline.get(), width, threshold, h, z, nullptr))
-                        return E_FAIL;
+                    if (nimages == 1)
+                    {
+                        progress += y1 - y0;
+                    }
+                }
 
-                    pSrc += srcImage.rowPitch;
-                    pDest += destImage.rowPitch;
+                if (nimages > 1 && (--bandsLeft[index] == 0))
+                {
+                    ++progress;
                 }
-            }
-            else
+
+                if (statusCallback && std::this_thread::get_id() == caller)
+                {
+                    if (!statusCallback(std::min(progress.load(), progressTotal), progressTotal))
+                        return E_ABORT;
+                }
+
+                return S_OK;
+            });
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Validate the subresources of a complex conversion and convert them on the thread pool
+    //-------------------------------------------------------------------------------------
+    HRESULT ConvertParallel(
+        _In_reads_(nimages) const Image* srcImages,
+        _In_reads_(nimages) const Image* destImages,
+        size_t nimages,
+        _In_ const TexMetadata& metadata,
+        _In_ const ConvertOptions& options,
+        const std::function<bool __cdecl(size_t, size_t)>& statusCallback) noexcept
+    {
+        // Volume slice of each image, used by ordered dithering
+        std::unique_ptr<size_t[]> slices(new (std::nothrow) size_t[nimages]);
+        if (!slices)
+            return E_OUTOFMEMORY;
+
+        switch (metadata.dimension)
+        {
+        case TEX_DIMENSION_TEXTURE1D:
+        case TEX_DIMENSION_TEXTURE2D:
+            memset(slices.get(), 0, sizeof(size_t) * nimages);
+            break;
+
+        case TEX_DIMENSION_TEXTURE3D:
             {
-                // No dithering
-                for (size_t h = 0; h < srcImage.height; ++h)
+                size_t index = 0;
+                size_t d = metadata.depth;
+                for (size_t level = 0; level < metadata.mipLevels; ++level)
                 {
-                    if (statusCallback)
+                    for (size_t slice = 0; slice < d; ++slice, ++index)
                     {
-                        if (!statusCallback(h, srcImage.height))
-                        {
-                            return E_ABORT;
-                        }
+                        if (index >= nimages)
+                            return E_FAIL;
+
+                        slices[index] = slice;
                     }
 
-                    if (!LoadScanline(scanline.get(), width, pSrc, srcImage.rowPitch, srcImage.format))
-                        return E_FAIL;
+                    if (d > 1)
+                        d >>= 1;
+                }
 
-                    ConvertScanline(scanline.get(), width, destImage.format, srcImage.format, filter);
+                if (index != nimages)
+                    return E_FAIL;
+            }
+            break;
 
-                    if (!StoreScanline(pDest, destImage.rowPitch, destImage.format, scanline.get(), width, threshold))
-                        return E_FAIL;
+        default:
+            return E_FAIL;
+        }
 
-                    pSrc += srcImage.rowPitch;
-                    pDest += destImage.rowPitch;
-                }
-            }
+        for (size_t index = 0; index < nimages; ++index)
+        {
+            const Image& src = srcImages[index];
+            if (src.format != metadata.format)
+                return E_FAIL;
+
+            if ((src.width > UINT32_MAX) || (src.height > UINT32_MAX))
+                return E_FAIL;
+
+            const Image& dst = destImages[index];
+            if (src.width != dst.width || src.height != dst.height)
+                return E_FAIL;
         }
 
-        return S_OK;
+        return ConvertCustomParallel(srcImages, destImages, slices.get(), nimages,
+            options.filter, options.threshold, options.maxThreads, statusCallback);
     }
 
     //-------------------------------------------------------------------------------------
@@ -5148,6 +5860,11 @@ HRESULT DirectX::ConvertEx(
     {
         hr = ConvertUsingWIC(srcImage, pfGUID, targetGUID, options.filter, options.threshold, *rimage);
     }
+    else if (options.filter & TEX_FILTER_PARALLEL)
+    {
+        hr = ConvertCustomParallel(&srcImage, rimage, nullptr, 1,
+            options.filter, options.threshold, options.maxThreads, statusCallback);
+    }
     else
     {
         hr = ConvertCustom(srcImage, options.filter, *rimage, options.threshold, 0, statusCallback);
@@ -5258,130 +5975,142 @@ HRESULT DirectX::ConvertEx(
     WICPixelFormatGUID pfGUID, targetGUID;
     const bool usewic = !metadata.IsPMAlpha() && UseWICConversion(options.filter, metadata.format, format, pfGUID, targetGUID);
 
-    switch (metadata.dimension)
+    if (!usewic && (options.filter & TEX_FILTER_PARALLEL))
     {
-    case TEX_DIMENSION_TEXTURE1D:
-    case TEX_DIMENSION_TEXTURE2D:
-        for (size_t index = 0; index < nimages; ++index)
+        hr = ConvertParallel(srcImages, dest, nimages, metadata, options, statusCallback);
+        if (FAILED(hr))
         {
-            const Image& src = srcImages[index];
-            if (src.format != metadata.format)
+            result.Release();
+            return hr;
+        }
+    }
+    else
+    {
+        switch (metadata.dimension)
+        {
+        case TEX_DIMENSION_TEXTURE1D:
+        case TEX_DIMENSION_TEXTURE2D:
+            for (size_t index = 0; index < nimages; ++index)
             {
-                result.Release();
-                return E_FAIL;
-            }
+                const Image& src = srcImages[index];
+                if (src.format != metadata.format)
+                {
+                    result.Release();
+                    return E_FAIL;
+                }
 
-            if ((src.width > UINT32_MAX) || (src.height > UINT32_MAX))
-            {
-                result.Release();
-                return E_FAIL;
-            }
+                if ((src.width > UINT32_MAX) || (src.height > UINT32_MAX))
+                {
+                    result.Release();
+                    return E_FAIL;
+                }
 
-            const Image& dst = dest[index];
-            assert(dst.format == format);
+                const Image& dst = dest[index];
+                assert(dst.format == format);
 
-            if (src.width != dst.width || src.height != dst.height)
-            {
-                result.Release();
-                return E_FAIL;
-            }
-
-            if (usewic)
-            {
-                hr = ConvertUsingWIC(src, pfGUID, targetGUID, options.filter, options.threshold, dst);
-            }
-            else
-            {
-                hr = ConvertCustom(src, options.filter, dst, options.threshold, 0, nullptr);
-            }
+                if (src.width != dst.width || src.height != dst.height)
+                {
+                    result.Release();
+                    return E_FAIL;
+                }
 
-            if (FAILED(hr))
-            {
-                result.Release();
-                return hr;
-            }
+                if (usewic)
+                {
+                    hr = ConvertUsingWIC(src, pfGUID, targetGUID, options.filter, options.threshold, dst);
+                }
+                else
+                {
+                    hr = ConvertCustom(src, options.filter, dst, options.threshold, 0, nullptr);
+                }
 
-            if (statusCallback)
-            {
-                if (!statusCallback(index, nimages))
+                if (FAILED(hr))
                 {
                     result.Release();
-                    return E_ABORT;
+                    return hr;
                 }
-            }
-        }
-        break;
 
-    case TEX_DIMENSION_TEXTURE3D:
-        {
-            size_t index = 0;
-            size_t d = metadata.depth;
-            for (size_t level = 0; level < metadata.mipLevels; ++level)
-            {
-                for (size_t slice = 0; slice < d; ++slice, ++index)
+                if (statusCallback)
                 {
-                    if (index >= nimages)
+                    if (!statusCallback(index, nimages))
                     {
                         result.Release();
-                        return E_FAIL;
+                        return E_ABORT;
                     }
+                }
+            }
+            break;
 
-                    const Image& src = srcImages[index];
-                    if (src.format != metadata.format)
+        case TEX_DIMENSION_TEXTURE3D:
+            {
+                size_t index = 0;
+                size_t d = metadata.depth;
+                for (size_t level = 0; level < metadata.mipLevels; ++level)
+                {
+                    for (size_t slice = 0; slice < d; ++slice, ++index)
                     {
-                        result.Release();
-                        return E_FAIL;
-                    }
+                        if (index >= nimages)
+                        {
+                            result.Release();
+                            return E_FAIL;
+                        }
 
-                    if ((src.width > UINT32_MAX) || (src.height > UINT32_MAX))
-                    {
-                        result.Release();
-                        return E_FAIL;
-                    }
+                        const Image& src = srcImages[index];
+                        if (src.format != metadata.format)
+                        {
+                            result.Release();
+                            return E_FAIL;
+                        }
 
-                    const Image& dst = dest[index];
-                    assert(dst.format == format);
+                        if ((src.width > UINT32_MAX) || (src.height > UINT32_MAX))
+                        {
+                            result.Release();
+                            return E_FAIL;
+                        }
 
-                    if (src.width != dst.width || src.height != dst.height)
-                    {
-                        result.Release();
-                        return E_FAIL;
-                    }
+                        const Image& dst = dest[index];
+                        assert(dst.format == format);
 
-                    if (usewic)
-                    {
-                        hr = ConvertUsingWIC(src, pfGUID, targetGUID, options.filter, options.threshold, dst);
-                    }
-                    else
-                    {
-                        hr = ConvertCustom(src, options.filter, dst, options.threshold, slice, nullptr);
-                    }
+                        if (src.width != dst.width || src.height != dst.height)
+                        {
+                            result.Release();
+                            return E_FAIL;
+                        }
 
-                    if (FAILED(hr))
-                    {
-                        result.Release();
-                        return hr;
-                    }
+                        if (usewic)
+                        {
+                            hr = ConvertUsingWIC(src, pfGUID, targetGUID, options.filter, options.threshold, dst);
+                        }
+                        else
+                        {
+                            hr = ConvertCustom(src, options.filter, dst, options.threshold, slice, nullptr);
+                        }
 
-                    if (statusCallback)
-                    {
-                        if (!statusCallback(index, nimages))
+                        if (FAILED(hr))
                         {
                             result.Release();
-                            return E_ABORT;
+                            return hr;
+                        }
+
+                        if (statusCallback)
+                        {
+                            if (!statusCallback(index, nimages))
+                            {
+                                result.Release();
+                                return E_ABORT;
+                            }
                         }
                     }
-                }
 
-                if (d > 1)
-                    d >>= 1;
+                    if (d > 1)
+                        d >>= 1;
+                }
             }
-        }
-        break;
+            break;
 
-    default:
-        result.Release();
-        return E_FAIL;
+        default:
+            result.Release();
+            return E_FAIL;
+        }
     }
 
     if (statusCallback)
@@ -13,6 +13,13 @@
 
 #include "DDS.h"
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 using namespace DirectX;
 using namespace DirectX::Internal;
 
@@ -1463,6 +1470,24 @@ namespace
         }
     }
 
+    //-------------------------------------------------------------------------------------
+    // Returns the pitch flags that describe the pixel layout stored in the file
+    //-------------------------------------------------------------------------------------
+    CP_FLAGS GetSourceCopyFlags(CP_FLAGS cpFlags, uint32_t convFlags) noexcept
+    {
+        if (convFlags & CONV_FLAGS_EXPAND)
+        {
+            if (convFlags & CONV_FLAGS_888)
+                cpFlags |= CP_FLAGS_24BPP;
+            else if (convFlags & (CONV_FLAGS_565 | CONV_FLAGS_5551 | CONV_FLAGS_4444 | CONV_FLAGS_8332 | CONV_FLAGS_A8P8 | CONV_FLAGS_L16 | CONV_FLAGS_A8L8 | CONV_FLAGS_L6V5U5))
+                cpFlags |= CP_FLAGS_16BPP;
+            else if (convFlags & (CONV_FLAGS_44 | CONV_FLAGS_332 | CONV_FLAGS_PAL8 | CONV_FLAGS_L8))
+                cpFlags |= CP_FLAGS_8BPP;
+        }
+
+        return cpFlags;
+    }
+
     //-------------------------------------------------------------------------------------
     // Converts or copies image data from pPixels into scratch image data
     //-------------------------------------------------------------------------------------
@@ -1481,15 +1506,7 @@ namespace
         if (!size)
             return E_FAIL;
 
-        if (convFlags & CONV_FLAGS_EXPAND)
-        {
-            if (convFlags & CONV_FLAGS_888)
-                cpFlags |= CP_FLAGS_24BPP;
-            else if (convFlags & (CONV_FLAGS_565 | CONV_FLAGS_5551 | CONV_FLAGS_4444 | CONV_FLAGS_8332 | CONV_FLAGS_A8P8 | CONV_FLAGS_L16 | CONV_FLAGS_A8L8 | CONV_FLAGS_L6V5U5))
-                cpFlags |= CP_FLAGS_16BPP;
-            else if (convFlags & (CONV_FLAGS_44 | CONV_FLAGS_332 | CONV_FLAGS_PAL8 | CONV_FLAGS_L8))
-                cpFlags |= CP_FLAGS_8BPP;
-        }
+        cpFlags = GetSourceCopyFlags(cpFlags, convFlags);
 
         size_t pixelSize, nimages;
         HRESULT hr = DetermineImageArray(metadata, cpFlags, nimages, pixelSize);
@@ -1822,6 +1839,135 @@ namespace
 
         return S_OK;
     }
+
+    //-------------------------------------------------------------------------------------
+    // Computes the metadata of a range of mips and array items (0 counts mean through the end)
+    //-------------------------------------------------------------------------------------
+    HRESULT GetSubresourceMetadata(
+        const TexMetadata& mdata,
+        size_t firstMip,
+        size_t mipCount,
+        size_t firstItem,
+        size_t itemCount,
+        _Out_ TexMetadata& sub) noexcept
+    {
+        if (firstMip >= mdata.mipLevels || firstItem >= mdata.arraySize)
+            return E_INVALIDARG;
+
+        if (!mipCount)
+            mipCount = mdata.mipLevels - firstMip;
+
+        if (!itemCount)
+            itemCount = mdata.arraySize - firstItem;
+
+        if (mipCount > mdata.mipLevels - firstMip || itemCount > mdata.arraySize - firstItem)
+            return E_INVALIDARG;
+
+        sub = mdata;
+        sub.width = std::max<size_t>(mdata.width >> firstMip, 1);
+        sub.height = std::max<size_t>(mdata.height >> firstMip, 1);
+        sub.depth = std::max<size_t>(mdata.depth >> firstMip, 1);
+        sub.mipLevels = mipCount;
+        sub.arraySize = itemCount;
+
+        // A partial set of cubemap faces loads as a plain 2D array
+        if (mdata.IsCubemap() && ((firstItem % 6) != 0 || (itemCount % 6) != 0))
+        {
+            sub.miscFlags &= ~static_cast<uint32_t>(TEX_MISC_TEXTURECUBE);
+        }
+
+        return S_OK;
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Returns true if the file pixels cannot be used as-is by a ScratchImage
+    //-------------------------------------------------------------------------------------
+    inline bool NeedsPixelConversion(DDS_FLAGS flags, uint32_t convFlags) noexcept
+    {
+        return (convFlags & (CONV_FLAGS_EXPAND | CONV_FLAGS_NOALPHA | CONV_FLAGS_SWIZZLE | CONV_FLAGS_PAL8 | CONV_FLAGS_L8U8V8 | CONV_FLAGS_WUV10)) != 0
+            || (flags & (DDS_FLAGS_LEGACY_DWORD | DDS_FLAGS_BAD_DXTN_TAILS)) != 0;
+    }
+
+#ifndef _WIN32
+    //-------------------------------------------------------------------------------------
+    // Applies madvise to the pages holding a range of mapped images
+    //-------------------------------------------------------------------------------------
+    void AdviseMappedImages(
+        _In_ void* mapping,
+        size_t mappingSize,
+        _In_reads_(nimages) const Image* images,
+        size_t nimages,
+        size_t index,
+        size_t count,
+        int advice) noexcept
+    {
+        if (!mapping || !images || index >= nimages || !count)
+            return;
+
+        count = std::min(count, nimages - index);
+
+        // Images are laid out contiguously in file order
+        auto base = static_cast<uint8_t*>(mapping);
+        const Image& first = images[index];
+        const Image& last = images[index + count - 1];
+
+        size_t start = static_cast<size_t>(first.pixels - base);
+        size_t end = std::min(static_cast<size_t>(last.pixels - base) + last.slicePitch, mappingSize);
+
+        const long pageSize = sysconf(_SC_PAGESIZE);
+        const size_t page = (pageSize > 0) ? static_cast<size_t>(pageSize) : 4096u;
+
+        if (advice == MADV_DONTNEED)
+        {
+            // Only drop pages that lie entirely within the range so neighboring images are untouched
+            start = (start + page - 1) & ~(page - 1);
+            end &= ~(page - 1);
+        }
+        else
+        {
+            start &= ~(page - 1);
+        }
+
+        if (end > start)
+        {
+            std::ignore = madvise(base + start, end - start, advice);
+        }
+    }
+#endif
+
+    //-------------------------------------------------------------------------------------
+    // Decodes the header of a DDS file in memory and finds its pixels; returns S_FALSE if
+    // they need conversion, so the file can't be used in place
+    //-------------------------------------------------------------------------------------
+    HRESULT DecodeDDSView(
+        _In_reads_bytes_(size) const void* pSource,
+        size_t size,
+        DDS_FLAGS flags,
+        _Out_ TexMetadata& metadata,
+        _Out_opt_ DDSMetaData* ddPixelFormat,
+        _Out_ size_t& offset) noexcept
+    {
+        offset = 0;
+
+        if (!pSource || size == 0)
+            return E_INVALIDARG;
+
+        uint32_t convFlags = 0;
+        const HRESULT hr = DecodeDDSHeader(pSource, size, flags, metadata, ddPixelFormat, convFlags);
+        if (FAILED(hr))
+            return hr;
+
+        if (NeedsPixelConversion(flags, convFlags))
+            return S_FALSE;
+
+        offset = DDS_MIN_HEADER_SIZE;
+        if (convFlags & CONV_FLAGS_DX10)
+            offset += sizeof(DDS_HEADER_DXT10);
+
+        assert(offset <= size);
+
+        return S_OK;
+    }
 }
 
 
@@ -2036,6 +2182,41 @@ HRESULT DirectX::LoadFromDDSMemoryEx(
     return S_OK;
 }
 
+_Use_decl_annotations_
+HRESULT DirectX::LoadFromDDSMemoryView(
+    void* pSource,
+    size_t size,
+    DDS_FLAGS flags,
+    TexMetadata* metadata,
+    DDSMetaData* ddPixelFormat,
+    ScratchImage& image) noexcept
+{
+    image.Release();
+
+    TexMetadata mdata;
+    size_t offset = 0;
+    HRESULT hr = DecodeDDSView(pSource, size, flags, mdata, ddPixelFormat, offset);
+    if (FAILED(hr))
+        return hr;
+
+    auto pPixels = static_cast<uint8_t*>(pSource) + offset;
+    if (hr == S_OK && (reinterpret_cast<uintptr_t>(pPixels) & 0xF) == 0)
+    {
+        // The pixels already have the ScratchImage layout, so point the images at the source
+        hr = image.InitializeView(mdata, pPixels, size - offset);
+        if (FAILED(hr))
+            return hr;
+
+        if (metadata)
+            memcpy(metadata, &mdata, sizeof(TexMetadata));
+
+        return S_OK;
+    }
+
+    // Pixels that need conversion or aren't 16-byte aligned are copied
+    return LoadFromDDSMemoryEx(pSource, size, flags, metadata, ddPixelFormat, image);
+}
+
 
 //-------------------------------------------------------------------------------------
 // Load a DDS file from disk
@@ -2301,6 +2482,481 @@ HRESULT DirectX::LoadFromDDSFileEx(
 }
 
 
+//-------------------------------------------------------------------------------------
+// Load a range of mips and array items from a DDS file on disk
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+HRESULT DirectX::LoadFromDDSFileRange(
+    const wchar_t* szFile,
+    DDS_FLAGS flags,
+    size_t firstMip,
+    size_t mipCount,
+    size_t firstItem,
+    size_t itemCount,
+    TexMetadata* metadata,
+    DDSMetaData* ddPixelFormat,
+    ScratchImage& image) noexcept
+{
+    if (!szFile)
+        return E_INVALIDARG;
+
+    // The whole file is read in one pass by the full loader
+    if (!firstMip && !mipCount && !firstItem && !itemCount)
+        return LoadFromDDSFileEx(szFile, flags, metadata, ddPixelFormat, image);
+
+    image.Release();
+
+#ifdef _WIN32
+#if (_WIN32_WINNT >= _WIN32_WINNT_WIN8)
+    ScopedHandle hFile(safe_handle(CreateFile2(szFile, GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, nullptr)));
+#else
+    ScopedHandle hFile(safe_handle(CreateFileW(szFile, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_FLAG_SEQUENTIAL_SCAN, nullptr)));
+#endif
+    if (!hFile)
+    {
+        return HRESULT_FROM_WIN32(GetLastError());
+    }
+
+    // Get the file size
+    FILE_STANDARD_INFO fileInfo;
+    if (!GetFileInformationByHandleEx(hFile.get(), FileStandardInfo, &fileInfo, sizeof(fileInfo)))
+    {
+        return HRESULT_FROM_WIN32(GetLastError());
+    }
+
+    // File is too big for 32-bit allocation, so reject read (4 GB should be plenty large enough for a valid DDS file)
+    if (fileInfo.EndOfFile.HighPart > 0)
+        return HRESULT_E_FILE_TOO_LARGE;
+
+    const size_t len = fileInfo.EndOfFile.LowPart;
+#else // !WIN32
+    std::ifstream inFile(std::filesystem::path(szFile), std::ios::in | std::ios::binary | std::ios::ate);
+    if (!inFile)
+        return E_FAIL;
+
+    std::streampos fileLen = inFile.tellg();
+    if (!inFile)
+        return E_FAIL;
+
+    if (fileLen > UINT32_MAX)
+        return HRESULT_E_FILE_TOO_LARGE;
+
+    inFile.seekg(0, std::ios::beg);
+    if (!inFile)
+        return E_FAIL;
+
+    const size_t len = fileLen;
+#endif
+
+    // Need at least enough data to fill the standard header and magic number to be a valid DDS
+    if (len < DDS_MIN_HEADER_SIZE)
+    {
+        return E_FAIL;
+    }
+
+    // Read the header in (including extended header if present)
+    uint8_t header[DDS_DX10_HEADER_SIZE] = {};
+
+#ifdef _WIN32
+    DWORD bytesRead = 0;
+    if (!ReadFile(hFile.get(), header, DDS_DX10_HEADER_SIZE, &bytesRead, nullptr))
+    {
+        return HRESULT_FROM_WIN32(GetLastError());
+    }
+
+    auto const headerLen = static_cast<size_t>(bytesRead);
+#else
+    auto const headerLen = std::min<size_t>(len, DDS_DX10_HEADER_SIZE);
+
+    inFile.read(reinterpret_cast<char*>(header), headerLen);
+    if (!inFile)
+        return E_FAIL;
+#endif
+
+    uint32_t convFlags = 0;
+    TexMetadata mdata;
+    HRESULT hr = DecodeDDSHeader(header, headerLen, flags, mdata, ddPixelFormat, convFlags);
+    if (FAILED(hr))
+        return hr;
+
+    size_t offset = DDS_DX10_HEADER_SIZE;
+
+    if (!(convFlags & CONV_FLAGS_DX10))
+    {
+    #ifdef _WIN32
+            // Must reset file position since we read more than the standard header above
+        const LARGE_INTEGER filePos = { { DDS_MIN_HEADER_SIZE, 0 } };
+        if (!SetFilePointerEx(hFile.get(), filePos, nullptr, FILE_BEGIN))
+        {
+            return HRESULT_FROM_WIN32(GetLastError());
+        }
+    #else
+        inFile.seekg(DDS_MIN_HEADER_SIZE, std::ios::beg);
+        if (!inFile)
+            return E_FAIL;
+    #endif
+
+        offset = DDS_MIN_HEADER_SIZE;
+    }
+
+    std::unique_ptr<uint32_t[]> pal8;
+    if (convFlags & CONV_FLAGS_PAL8)
+    {
+        pal8.reset(new (std::nothrow) uint32_t[256]);
+        if (!pal8)
+        {
+            return E_OUTOFMEMORY;
+        }
+
+    #ifdef _WIN32
+        if (!ReadFile(hFile.get(), pal8.get(), 256 * sizeof(uint32_t), &bytesRead, nullptr))
+        {
+            return HRESULT_FROM_WIN32(GetLastError());
+        }
+
+        if (bytesRead != (256 * sizeof(uint32_t)))
+        {
+            return E_FAIL;
+        }
+    #else
+        inFile.read(reinterpret_cast<char*>(pal8.get()), 256 * sizeof(uint32_t));
+        if (!inFile)
+            return E_FAIL;
+    #endif
+
+        offset += (256 * sizeof(uint32_t));
+    }
+
+    if (len <= offset)
+        return E_FAIL;
+
+    const size_t remaining = len - offset;
+
+    TexMetadata sub;
+    hr = GetSubresourceMetadata(mdata, firstMip, mipCount, firstItem, itemCount, sub);
+    if (FAILED(hr))
+        return hr;
+
+    CP_FLAGS cflags = CP_FLAGS_NONE;
+    if (flags & DDS_FLAGS_LEGACY_DWORD)
+    {
+        cflags |= CP_FLAGS_LEGACY_DWORD;
+    }
+    if (flags & DDS_FLAGS_BAD_DXTN_TAILS)
+    {
+        cflags |= CP_FLAGS_BAD_DXTN_TAILS;
+    }
+
+    // Byte layout of the file: each item is its mip chain, and only whole mip levels are read
+    uint64_t mipOffset = 0;
+    uint64_t mipBytes = 0;
+    uint64_t itemBytes = 0;
+    {
+        const CP_FLAGS sflags = GetSourceCopyFlags(cflags, convFlags);
+
+        size_t width = mdata.width;
+        size_t height = mdata.height;
+        size_t depth = mdata.depth;
+        for (size_t level = 0; level < mdata.mipLevels; ++level)
+        {
+            size_t rowPitch, slicePitch;
+            hr = ComputePitch(mdata.format, width, height, rowPitch, slicePitch, sflags);
+            if (FAILED(hr))
+                return hr;
+
+            const uint64_t levelBytes = uint64_t(slicePitch) * uint64_t(depth);
+            if (level < sub.mipLevels + firstMip)
+            {
+                if (level < firstMip)
+                    mipOffset += levelBytes;
+                else
+                    mipBytes += levelBytes;
+            }
+            itemBytes += levelBytes;
+
+            if (width > 1)
+                width >>= 1;
+
+            if (height > 1)
+                height >>= 1;
+
+            if (depth > 1)
+                depth >>= 1;
+        }
+    }
+
+    if (itemBytes * uint64_t(mdata.arraySize) > remaining)
+        return HRESULT_E_HANDLE_EOF;
+
+    // Spans of consecutive items are contiguous when every mip level is loaded
+    const bool contiguous = (sub.mipLevels == mdata.mipLevels);
+    const size_t spanCount = contiguous ? 1 : sub.arraySize;
+    const uint64_t spanBytes = contiguous ? (itemBytes * uint64_t(sub.arraySize)) : mipBytes;
+
+    if (spanBytes > UINT32_MAX)
+        return HRESULT_E_ARITHMETIC_OVERFLOW;
+
+    auto readSpans = [&](uint8_t* pDest) -> HRESULT
+    {
+        for (size_t span = 0; span < spanCount; ++span)
+        {
+            const uint64_t filePos = uint64_t(offset) + uint64_t(firstItem + span) * itemBytes + mipOffset;
+
+        #ifdef _WIN32
+            LARGE_INTEGER pos = {};
+            pos.QuadPart = static_cast<LONGLONG>(filePos);
+            if (!SetFilePointerEx(hFile.get(), pos, nullptr, FILE_BEGIN))
+            {
+                return HRESULT_FROM_WIN32(GetLastError());
+            }
+
+            auto const spanSize = static_cast<DWORD>(spanBytes);
+            if (!ReadFile(hFile.get(), pDest, spanSize, &bytesRead, nullptr))
+            {
+                return HRESULT_FROM_WIN32(GetLastError());
+            }
+
+            if (bytesRead != spanSize)
+            {
+                return E_FAIL;
+            }
+        #else
+            inFile.seekg(static_cast<std::streamoff>(filePos), std::ios::beg);
+            if (!inFile)
+                return E_FAIL;
+
+            inFile.read(reinterpret_cast<char*>(pDest), static_cast<std::streamsize>(spanBytes));
+            if (!inFile)
+                return E_FAIL;
+        #endif
+
+            pDest += spanBytes;
+        }
+
+        return S_OK;
+    };
+
+    hr = image.Initialize(sub);
+    if (FAILED(hr))
+        return hr;
+
+    if ((convFlags & CONV_FLAGS_EXPAND) || (flags & (DDS_FLAGS_LEGACY_DWORD | DDS_FLAGS_BAD_DXTN_TAILS)))
+    {
+        const size_t tempSize = static_cast<size_t>(spanBytes * spanCount);
+
+        std::unique_ptr<uint8_t[]> temp(new (std::nothrow) uint8_t[tempSize]);
+        if (!temp)
+        {
+            image.Release();
+            return E_OUTOFMEMORY;
+        }
+
+        hr = readSpans(temp.get());
+        if (FAILED(hr))
+        {
+            image.Release();
+            return hr;
+        }
+
+        hr = CopyImage(temp.get(),
+            tempSize,
+            sub,
+            cflags,
+            convFlags,
+            pal8.get(),
+            image);
+        if (FAILED(hr))
+        {
+            image.Release();
+            return hr;
+        }
+    }
+    else
+    {
+        // Without expansion the file layout is the ScratchImage layout, so read straight into it
+        if (spanBytes * spanCount != image.GetPixelsSize())
+        {
+            image.Release();
+            return E_UNEXPECTED;
+        }
+
+        hr = readSpans(image.GetPixels());
+        if (FAILED(hr))
+        {
+            image.Release();
+            return hr;
+        }
+
+        if (convFlags & (CONV_FLAGS_SWIZZLE | CONV_FLAGS_NOALPHA | CONV_FLAGS_L8U8V8 | CONV_FLAGS_WUV10))
+        {
+            // Swizzle/copy image in place
+            hr = CopyImageInPlace(convFlags, image);
+            if (FAILED(hr))
+            {
+                image.Release();
+                return hr;
+            }
+        }
+    }
+
+    if (metadata)
+        memcpy(metadata, &sub, sizeof(TexMetadata));
+
+    return S_OK;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Memory-mapped DDS file
+//-------------------------------------------------------------------------------------
+MappedImage& MappedImage::operator= (MappedImage&& moveFrom) noexcept
+{
+    if (this != &moveFrom)
+    {
+        Release();
+
+        m_mapping = moveFrom.m_mapping;
+        m_mappingSize = moveFrom.m_mappingSize;
+        m_image = std::move(moveFrom.m_image);
+
+        moveFrom.m_mapping = nullptr;
+        moveFrom.m_mappingSize = 0;
+    }
+    return *this;
+}
+
+void MappedImage::Release() noexcept
+{
+    // The images may be a view of the mapping, so they go first
+    m_image.Release();
+
+#ifndef _WIN32
+    if (m_mapping)
+    {
+        munmap(m_mapping, m_mappingSize);
+    }
+#endif
+
+    m_mapping = nullptr;
+    m_mappingSize = 0;
+}
+
+_Use_decl_annotations_
+void MappedImage::Prefetch(size_t index, size_t count) const noexcept
+{
+#ifndef _WIN32
+    AdviseMappedImages(m_mapping, m_mappingSize, m_image.GetImages(), m_image.GetImageCount(), index, count, MADV_WILLNEED);
+#else
+    UNREFERENCED_PARAMETER(index);
+    UNREFERENCED_PARAMETER(count);
+#endif
+}
+
+_Use_decl_annotations_
+void MappedImage::Evict(size_t index, size_t count) const noexcept
+{
+#ifndef _WIN32
+    AdviseMappedImages(m_mapping, m_mappingSize, m_image.GetImages(), m_image.GetImageCount(), index, count, MADV_DONTNEED);
+#else
+    UNREFERENCED_PARAMETER(index);
+    UNREFERENCED_PARAMETER(count);
+#endif
+}
+
+
+//-------------------------------------------------------------------------------------
+// Load a DDS file from disk by mapping it into memory
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+HRESULT DirectX::LoadFromDDSFileMapped(
+    const wchar_t* szFile,
+    DDS_FLAGS flags,
+    TexMetadata* metadata,
+    DDSMetaData* ddPixelFormat,
+    MappedImage& image) noexcept
+{
+    if (!szFile)
+        return E_INVALIDARG;
+
+    image.Release();
+
+#ifdef _WIN32
+    return LoadFromDDSFileEx(szFile, flags, metadata, ddPixelFormat, image.m_image);
+#else // !WIN32
+    void* mapping = nullptr;
+    size_t len = 0;
+
+    {
+        const int fd = open(std::filesystem::path(szFile).c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd == -1)
+            return E_FAIL;
+
+        struct stat st = {};
+        if (fstat(fd, &st) != 0)
+        {
+            close(fd);
+            return E_FAIL;
+        }
+
+        if (static_cast<uint64_t>(st.st_size) > SIZE_MAX)
+        {
+            close(fd);
+            return HRESULT_E_FILE_TOO_LARGE;
+        }
+
+        len = static_cast<size_t>(st.st_size);
+
+        // Need at least enough data to fill the standard header and magic number to be a valid DDS
+        if (len < DDS_MIN_HEADER_SIZE)
+        {
+            close(fd);
+            return E_FAIL;
+        }
+
+        // Private mapping so writes through Image::pixels never reach the file
+        mapping = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        close(fd);
+
+        if (mapping == MAP_FAILED)
+            return E_FAIL;
+    }
+
+    image.m_mapping = mapping;
+    image.m_mappingSize = len;
+
+    TexMetadata mdata;
+    size_t offset = 0;
+    HRESULT hr = DecodeDDSView(mapping, len, flags, mdata, ddPixelFormat, offset);
+    if (hr == S_OK)
+    {
+        // The mapping is page-aligned, so pixels after a 'DX10' header are only 4-byte aligned; those stay mapped
+        // too, which is why this skips the 16-byte check in InitializeView
+        hr = image.m_image.SetupView(mdata, static_cast<uint8_t*>(mapping) + offset, len - offset, CP_FLAGS_NONE, nullptr, nullptr);
+        if (SUCCEEDED(hr) && metadata)
+            memcpy(metadata, &mdata, sizeof(TexMetadata));
+    }
+    else if (hr == S_FALSE)
+    {
+        // Pixels need conversion, so the images are a copy and the mapping is no longer needed
+        hr = LoadFromDDSMemoryEx(mapping, len, flags, metadata, ddPixelFormat, image.m_image);
+
+        munmap(mapping, len);
+        image.m_mapping = nullptr;
+        image.m_mappingSize = 0;
+    }
+
+    if (FAILED(hr))
+    {
+        image.Release();
+        return hr;
+    }
+
+    return S_OK;
+#endif
+}
+
+
 //-------------------------------------------------------------------------------------
 // Save a DDS file to memory
 //-------------------------------------------------------------------------------------
@@ -33,6 +33,7 @@
 //#define WRITE_OLD_COLORS
 
 using namespace DirectX;
+using namespace DirectX::Internal;
 
 #ifndef _WIN32
 #include <cstdarg>
@@ -55,6 +56,12 @@ namespace
     const char g_sRGBE[] = "32-bit_rle_rgbe";
     const char g_sXYZE[] = "32-bit_rle_xyze";
 
+    constexpr size_t HDR_BAND_ROWS = 16;
+        // Scanlines decoded or encoded per parallel task
+
+    constexpr size_t HDR_WRITE_CHUNK = 64 * 1024 * 1024;
+        // Bytes of uncompressed scanlines encoded per file write
+
     const char g_Header[] =
         "#?RADIANCE\n"\
         "FORMAT=32-bit_rle_rgbe\n"\
@@ -323,86 +330,72 @@ namespace
     }
 
     //-------------------------------------------------------------------------------------
-    // FloatToRGBE
+    // VectorToRGBE
     //-------------------------------------------------------------------------------------
-    inline void FloatToRGBE(_Out_writes_(width*4) uint8_t* pDestination, _In_reads_(width*fpp) const float* pSource, size_t width, _In_range_(3, 4) int fpp) noexcept
+    inline XMVECTOR XM_CALLCONV PackRGBE(FXMVECTOR p0, FXMVECTOR p1, FXMVECTOR p2, GXMVECTOR p3) noexcept
     {
-        auto ePtr = pSource + width * size_t(fpp);
-
-        for (size_t j = 0; j < width; ++j)
-        {
-            if (pSource + 2 >= ePtr) break;
-            const float r = pSource[0] >= 0.f ? pSource[0] : 0.f;
-            const float g = pSource[1] >= 0.f ? pSource[1] : 0.f;
-            const float b = pSource[2] >= 0.f ? pSource[2] : 0.f;
-            pSource += fpp;
-
-            const float max_xy = (r > g) ? r : g;
-            float max_xyz = (max_xy > b) ? max_xy : b;
-
-            if (max_xyz > 1e-32f)
-            {
-                int e;
-                max_xyz = frexpf(max_xyz, &e) * 256.f / max_xyz;
-                e += 128;
-
-                const uint8_t red = uint8_t(r * max_xyz);
-                const uint8_t green = uint8_t(g * max_xyz);
-                const uint8_t blue = uint8_t(b * max_xyz);
-
-                pDestination[0] = red;
-                pDestination[1] = green;
-                pDestination[2] = blue;
-                pDestination[3] = (red || green || blue) ? uint8_t(e & 0xff) : 0u;
-            }
-            else
-            {
-                pDestination[0] = pDestination[1] = pDestination[2] = pDestination[3] = 0;
-            }
-
-            pDestination += 4;
-        }
+        static const XMVECTORF32 s_minColor = { { { 1e-32f, 1e-32f, 1e-32f, 1e-32f } } };
+        static const XMVECTORU32 s_expMask = { { { 0x7F800000, 0x7F800000, 0x7F800000, 0x7F800000 } } };
+        static const XMVECTORU32 s_expBias = { { { 0x02000000, 0x02000000, 0x02000000, 0x02000000 } } };
+        static const XMVECTORU32 s_expByte = { { { 0xFF000000, 0xFF000000, 0xFF000000, 0xFF000000 } } };
+        static const XMVECTORU32 s_scaleBias = { { { 0x82800000, 0x82800000, 0x82800000, 0x82800000 } } };
+        static const XMVECTORF32 s_greenShift = { { { 256.f, 256.f, 256.f, 256.f } } };
+        static const XMVECTORF32 s_blueShift = { { { 65536.f, 65536.f, 65536.f, 65536.f } } };
+
+        // Four pixels at a time, one channel per vector
+        XMMATRIX pixels(p0, p1, p2, p3);
+        pixels = XMMatrixTranspose(pixels);
+
+        // Negative and NaN channels become zero
+        const XMVECTOR r = XMVectorSelect(g_XMZero, pixels.r[0], XMVectorGreaterOrEqual(pixels.r[0], g_XMZero));
+        const XMVECTOR g = XMVectorSelect(g_XMZero, pixels.r[1], XMVectorGreaterOrEqual(pixels.r[1], g_XMZero));
+        const XMVECTOR b = XMVectorSelect(g_XMZero, pixels.r[2], XMVectorGreaterOrEqual(pixels.r[2], g_XMZero));
+
+        const XMVECTOR maxColor = XMVectorMax(XMVectorMax(r, g), b);
+
+        // The exponent field of maxColor gives the power of two frexpf would divide out. The mantissa
+        // scale 2^(134 - exponent) is built directly in the exponent bits, so it is exact.
+        const XMVECTOR power = XMVectorAndInt(maxColor, s_expMask);
+        const XMVECTOR scale = XMVectorSubtractInt(s_scaleBias, power);
+
+        XMVECTOR rgb = XMVectorTruncate(XMVectorMultiply(r, scale));
+        rgb = XMVectorMultiplyAdd(XMVectorTruncate(XMVectorMultiply(g, scale)), s_greenShift, rgb);
+        rgb = XMVectorMultiplyAdd(XMVectorTruncate(XMVectorMultiply(b, scale)), s_blueShift, rgb);
+        rgb = XMConvertVectorFloatToInt(rgb, 0);
+
+        // Shared exponent is the float exponent field + 2, in the top byte
+        XMVECTOR e = XMVectorAndInt(XMVectorAddInt(XMVectorAddInt(power, power), s_expBias), s_expByte);
+        e = XMVectorSelect(e, g_XMZero, XMVectorEqualInt(rgb, g_XMZero));
+
+        return XMVectorAndInt(XMVectorOrInt(rgb, e), XMVectorGreater(maxColor, s_minColor));
     }
 
     //-------------------------------------------------------------------------------------
-    // HalfToRGBE
+    // VectorToRGBE
     //-------------------------------------------------------------------------------------
-    inline void HalfToRGBE(_Out_writes_(width * 4) uint8_t* pDestination, _In_reads_(width* fpp) const uint16_t* pSource, size_t width, _In_range_(3, 4) int fpp) noexcept
+    void VectorToRGBE(_Out_writes_(width * 4) uint8_t* pDestination, _In_reads_(width) const XMVECTOR* pSource, size_t width) noexcept
     {
-        auto ePtr = pSource + width * size_t(fpp);
+        auto dPtr = reinterpret_cast<uint32_t*>(pDestination);
 
-        for (size_t j = 0; j < width; ++j)
+        size_t j = 0;
+        for (; j + 4 <= width; j += 4)
         {
-            if (pSource + 2 >= ePtr) break;
-            float r = PackedVector::XMConvertHalfToFloat(pSource[0]); r = (r >= 0.f) ? r : 0.f;
-            float g = PackedVector::XMConvertHalfToFloat(pSource[1]); g = (g >= 0.f) ? g : 0.f;
-            float b = PackedVector::XMConvertHalfToFloat(pSource[2]); b = (b >= 0.f) ? b : 0.f;
-            pSource += fpp;
-
-            const float max_xy = (r > g) ? r : g;
-            float max_xyz = (max_xy > b) ? max_xy : b;
+            XMStoreInt4(dPtr, PackRGBE(pSource[0], pSource[1], pSource[2], pSource[3]));
+            pSource += 4;
+            dPtr += 4;
+        }
 
-            if (max_xyz > 1e-32f)
-            {
-                int e;
-                max_xyz = frexpf(max_xyz, &e) * 256.f / max_xyz;
-                e += 128;
-
-                const uint8_t red = uint8_t(r * max_xyz);
-                const uint8_t green = uint8_t(g * max_xyz);
-                const uint8_t blue = uint8_t(b * max_xyz);
-
-                pDestination[0] = red;
-                pDestination[1] = green;
-                pDestination[2] = blue;
-                pDestination[3] = (red || green || blue) ? uint8_t(e & 0xff) : 0u;
-            }
-            else
+        if (j < width)
+        {
+            XMVECTOR tail[4] = { g_XMZero, g_XMZero, g_XMZero, g_XMZero };
+            for (size_t k = 0; k < width - j; ++k)
             {
-                pDestination[0] = pDestination[1] = pDestination[2] = pDestination[3] = 0;
+                tail[k] = pSource[k];
             }
 
-            pDestination += 4;
+            uint32_t rgbe[4];
+            XMStoreInt4(rgbe, PackRGBE(tail[0], tail[1], tail[2], tail[3]));
+            memcpy(dPtr, rgbe, (width - j) * sizeof(uint32_t));
         }
     }
 
@@ -528,22 +521,17 @@ namespace
         enc += 4;
         size_t encSize = 4;
 
-        uint8_t scan[128] = {};
-
         for (int channel = 0; channel < 4; ++channel)
         {
             const uint8_t* spanPtr = rgbe + channel;
             for (size_t pixelCount = 0; pixelCount < width;)
             {
-                uint8_t spanLen = 1;
-                while (pixelCount + spanLen < width && spanLen < 127)
+                const size_t maxLen = std::min<size_t>(width - pixelCount, 127);
+
+                size_t spanLen = 1;
+                while (spanLen < maxLen && spanPtr[spanLen * 4] == *spanPtr)
                 {
-                    if (spanPtr[spanLen * 4] == *spanPtr)
-                    {
-                        ++spanLen;
-                    }
-                    else
-                        break;
+                    ++spanLen;
                 }
 
                 if (spanLen > 1)
@@ -551,36 +539,33 @@ namespace
                     if (encSize + 2 > rowPitch)
                         return 0;
 
-                    enc[0] = 128u + spanLen;
+                    enc[0] = uint8_t(128u + spanLen);
                     enc[1] = *spanPtr;
                     enc += 2;
                     encSize += 2;
-                    spanPtr += size_t(spanLen) * 4;
+                    spanPtr += spanLen * 4;
                     pixelCount += spanLen;
                 }
                 else
                 {
-                    uint8_t runLen = 1;
-                    scan[0] = *spanPtr;
-                    while (pixelCount + runLen < width && runLen < 127)
+                    // A literal run ends before the next pair of equal values
+                    size_t runLen = 1;
+                    while (runLen < maxLen && spanPtr[(runLen - 1) * 4] != spanPtr[runLen * 4])
                     {
-                        if (spanPtr[(runLen - 1) * 4] != spanPtr[runLen * 4])
-                        {
-                            scan[runLen] = spanPtr[runLen * 4];
-                            runLen++;
-                        }
-                        else
-                            break;
+                        ++runLen;
                     }
 
                     if (encSize + runLen + 1 > rowPitch)
                         return 0;
 
-                    *enc++ = runLen;
-                    memcpy(enc, scan, runLen);
+                    *enc++ = uint8_t(runLen);
+                    for (size_t j = 0; j < runLen; ++j)
+                    {
+                        enc[j] = spanPtr[j * 4];
+                    }
                     enc += runLen;
-                    encSize += size_t(runLen) + 1;
-                    spanPtr += size_t(runLen) * 4;
+                    encSize += runLen + 1;
+                    spanPtr += runLen * 4;
                     pixelCount += runLen;
                 }
             }
@@ -589,6 +574,316 @@ namespace
         return encSize;
     #endif
     }
+
+    //-------------------------------------------------------------------------------------
+    // Converts and encodes rows [firstRow, firstRow + rowCount) of the image to pDestination,
+    // which must hold rowCount uncompressed scanlines
+    //-------------------------------------------------------------------------------------
+    HRESULT EncodeHDRRows(
+        _In_ const Image& image,
+        size_t firstRow,
+        size_t rowCount,
+        _Out_writes_(rowCount * image.width * 4) uint8_t* pDestination,
+        size_t maxThreads,
+        _Out_ size_t& encodedSize) noexcept
+    {
+        encodedSize = 0;
+
+        const size_t rowPitch = image.width * 4;
+        const size_t bandCount = (rowCount + HDR_BAND_ROWS - 1) / HDR_BAND_ROWS;
+
+        std::unique_ptr<size_t[]> bandSizes(new (std::nothrow) size_t[bandCount]);
+        if (!bandSizes)
+            return E_OUTOFMEMORY;
+
+        // Each band is written at its uncompressed offset, which it can never overrun
+        HRESULT hr = ParallelFor(bandCount, maxThreads,
+            [&](size_t band) -> HRESULT
+            {
+                auto scanline = make_AlignedArrayXMVECTOR(image.width);
+                if (!scanline)
+                    return E_OUTOFMEMORY;
+
+                std::unique_ptr<uint8_t[]> temp(new (std::nothrow) uint8_t[rowPitch * 2]);
+                if (!temp)
+                    return E_OUTOFMEMORY;
+
+                auto rgbe = temp.get();
+                auto enc = temp.get() + rowPitch;
+
+                const size_t startRow = band * HDR_BAND_ROWS;
+                const size_t endRow = std::min(rowCount, startRow + HDR_BAND_ROWS);
+
+                uint8_t* bandPtr = pDestination + startRow * rowPitch;
+                uint8_t* dPtr = bandPtr;
+                const uint8_t* sPtr = image.pixels + (firstRow + startRow) * image.rowPitch;
+                for (size_t scan = startRow; scan < endRow; ++scan)
+                {
+                    if (!LoadScanline(scanline.get(), image.width, sPtr, image.rowPitch, image.format))
+                        return E_FAIL;
+
+                    sPtr += image.rowPitch;
+
+                    VectorToRGBE(rgbe, scanline.get(), image.width);
+
+                #ifdef DISABLE_COMPRESS
+                    const size_t encSize = 0;
+                #else
+                    const size_t encSize = EncodeRLE(enc, rgbe, rowPitch, image.width);
+                #endif
+                    if (encSize > 0)
+                    {
+                        memcpy(dPtr, enc, encSize);
+                        dPtr += encSize;
+                    }
+                    else
+                    {
+                        memcpy(dPtr, rgbe, rowPitch);
+                        dPtr += rowPitch;
+                    }
+                }
+
+                bandSizes[band] = size_t(dPtr - bandPtr);
+
+                return S_OK;
+            });
+        if (FAILED(hr))
+            return hr;
+
+        // Close the gaps between the encoded bands
+        for (size_t band = 0; band < bandCount; ++band)
+        {
+            const uint8_t* bandPtr = pDestination + band * HDR_BAND_ROWS * rowPitch;
+            if (bandPtr != pDestination + encodedSize)
+            {
+                memmove(pDestination + encodedSize, bandPtr, bandSizes[band]);
+            }
+            encodedSize += bandSizes[band];
+        }
+
+        return S_OK;
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Finds the size of the encoded scanline at pSource, validating it
+    //-------------------------------------------------------------------------------------
+    HRESULT ScanHDRScanline(
+        _In_reads_bytes_(size) const uint8_t* pSource,
+        size_t size,
+        size_t width,
+        _Out_ size_t& scanSize) noexcept
+    {
+        scanSize = 0;
+
+        const uint8_t* sourcePtr = pSource;
+        size_t pixelLen = size;
+
+        if (pixelLen < 4)
+            return E_FAIL;
+
+        if (sourcePtr[0] == 2 && sourcePtr[1] == 2 && sourcePtr[2] < 128)
+        {
+            // Adaptive Run Length Encoding (RLE)
+            if (size_t((size_t(sourcePtr[2]) << 8) + sourcePtr[3]) != width)
+                return E_FAIL;
+
+            sourcePtr += 4;
+            pixelLen -= 4;
+
+            for (int channel = 0; channel < 4; ++channel)
+            {
+                for (size_t pixelCount = 0; pixelCount < width;)
+                {
+                    if (pixelLen < 2)
+                        return E_FAIL;
+
+                    size_t runLen = *sourcePtr;
+                    if (runLen > 128)
+                    {
+                        runLen &= 127;
+                        if (pixelCount + runLen > width)
+                            return E_FAIL;
+
+                        sourcePtr += 2;
+                        pixelLen -= 2;
+                    }
+                    else
+                    {
+                        if ((pixelLen < runLen + 1) || ((pixelCount + runLen) > width))
+                            return E_FAIL;
+
+                        sourcePtr += runLen + 1;
+                        pixelLen -= runLen + 1;
+                    }
+                    pixelCount += runLen;
+                }
+            }
+        }
+        else
+        {
+            uint8_t inColor[4];
+            memcpy(inColor, sourcePtr, 4);
+            sourcePtr += 4;
+            pixelLen -= 4;
+
+            int bitShift = 0;
+            for (size_t pixelCount = 0; pixelCount < width;)
+            {
+                if (inColor[0] == 1 && inColor[1] == 1 && inColor[2] == 1)
+                {
+                    if (bitShift > 24)
+                        return E_FAIL;
+
+                    // "Standard" Run Length Encoding
+                    const size_t spanLen = size_t(inColor[3]) << bitShift;
+                    if (spanLen + pixelCount > width)
+                        return E_FAIL;
+
+                    pixelCount += spanLen;
+                    bitShift += 8;
+                }
+                else
+                {
+                    // Uncompressed
+                    bitShift = 0;
+                    ++pixelCount;
+                }
+
+                if (pixelCount >= width)
+                    break;
+
+                if (pixelLen < 4)
+                    return E_FAIL;
+
+                memcpy(inColor, sourcePtr, 4);
+                sourcePtr += 4;
+                pixelLen -= 4;
+            }
+        }
+
+        scanSize = size_t(sourcePtr - pSource);
+        return S_OK;
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Expands a scanline already validated by ScanHDRScanline to RGBE bytes
+    //-------------------------------------------------------------------------------------
+    void DecodeHDRScanline(
+        _Out_writes_(width * 4) uint8_t* pDestination,
+        _In_reads_bytes_(size) const uint8_t* pSource,
+        size_t size,
+        size_t width) noexcept
+    {
+        assert(size >= 4);
+        UNREFERENCED_PARAMETER(size);
+
+        const uint8_t* sourcePtr = pSource;
+
+        if (sourcePtr[0] == 2 && sourcePtr[1] == 2 && sourcePtr[2] < 128)
+        {
+            // Adaptive Run Length Encoding (RLE)
+            sourcePtr += 4;
+
+            for (size_t channel = 0; channel < 4; ++channel)
+            {
+                uint8_t* pixelLoc = pDestination + channel;
+                for (size_t pixelCount = 0; pixelCount < width;)
+                {
+                    size_t runLen = *sourcePtr;
+                    if (runLen > 128)
+                    {
+                        runLen &= 127;
+                        const uint8_t val = sourcePtr[1];
+                        for (size_t j = 0; j < runLen; ++j)
+                        {
+                            *pixelLoc = val;
+                            pixelLoc += 4;
+                        }
+                        sourcePtr += 2;
+                    }
+                    else
+                    {
+                        ++sourcePtr;
+                        for (size_t j = 0; j < runLen; ++j)
+                        {
+                            *pixelLoc = *sourcePtr++;
+                            pixelLoc += 4;
+                        }
+                    }
+                    pixelCount += runLen;
+                }
+            }
+        }
+        else
+        {
+            uint8_t* pixelLoc = pDestination;
+
+            uint8_t inColor[4];
+            memcpy(inColor, sourcePtr, 4);
+            sourcePtr += 4;
+
+            uint8_t prevColor[4];
+            memcpy(prevColor, inColor, 4);
+
+            int bitShift = 0;
+            for (size_t pixelCount = 0; pixelCount < width;)
+            {
+                if (inColor[0] == 1 && inColor[1] == 1 && inColor[2] == 1)
+                {
+                    // "Standard" Run Length Encoding
+                    const size_t spanLen = size_t(inColor[3]) << bitShift;
+                    for (size_t j = 0; j < spanLen; ++j)
+                    {
+                        memcpy(pixelLoc, prevColor, 4);
+                        pixelLoc += 4;
+                    }
+                    pixelCount += spanLen;
+                    bitShift += 8;
+                }
+                else
+                {
+                    // Uncompressed
+                    memcpy(pixelLoc, inColor, 4);
+                    memcpy(prevColor, inColor, 4);
+                    bitShift = 0;
+                    ++pixelCount;
+                    pixelLoc += 4;
+                }
+
+                if (pixelCount >= width)
+                    break;
+
+                memcpy(inColor, sourcePtr, 4);
+                sourcePtr += 4;
+            }
+        }
+
+        assert(size_t(sourcePtr - pSource) == size);
+    }
+
+    //-------------------------------------------------------------------------------------
+    // RGBEToVector
+    //-------------------------------------------------------------------------------------
+    inline void RGBEToVector(
+        _Out_writes_(width) XMVECTOR* pDestination,
+        _In_reads_(width * 4) const uint8_t* pSource,
+        size_t width,
+        _In_reads_(256) const float* exponents,
+        float invExposure) noexcept
+    {
+        using namespace DirectX::PackedVector;
+
+        const XMVECTOR scale = XMVectorReplicate(invExposure);
+
+        for (size_t j = 0; j < width; ++j, pSource += 4)
+        {
+            // (mantissa + 0.5) * 2^(exponent - 136) is exact, so only the exposure scale rounds
+            XMVECTOR v = XMLoadUByte4(reinterpret_cast<const XMUBYTE4*>(pSource));
+            v = XMVectorMultiply(XMVectorAdd(v, g_XMOneHalf), XMVectorReplicate(exponents[pSource[3]]));
+            v = XMVectorMultiply(v, scale);
+            pDestination[j] = XMVectorSelect(g_XMIdentityR3, v, g_XMSelect1110);
+        }
+    }
 }
 
 
@@ -696,7 +991,7 @@ HRESULT DirectX::GetMetadataFromHDRFile(const wchar_t* szFile, TexMetadata& meta
 // Load a HDR file in memory
 //-------------------------------------------------------------------------------------
 _Use_decl_annotations_
-HRESULT DirectX::LoadFromHDRMemory(const void* pSource, size_t size, TexMetadata* metadata, ScratchImage& image) noexcept
+HRESULT DirectX::LoadFromHDRMemory(const void* pSource, size_t size, HDR_FLAGS flags, TexMetadata* metadata, ScratchImage& image) noexcept
 {
     if (!pSource || size == 0)
         return E_INVALIDARG;
@@ -717,14 +1012,35 @@ HRESULT DirectX::LoadFromHDRMemory(const void* pSource, size_t size, TexMetadata
     if (remaining == 0)
         return E_FAIL;
 
-    hr = image.Initialize2D(mdata.format, mdata.width, mdata.height, 1, 1, CP_FLAGS_LIMIT_4GB);
-    if (FAILED(hr))
-        return hr;
+    switch (flags & (HDR_FLAGS_FORMAT_HALF | HDR_FLAGS_FORMAT_SHAREDEXP))
+    {
+    case HDR_FLAGS_NONE:                break;
+    case HDR_FLAGS_FORMAT_HALF:         mdata.format = DXGI_FORMAT_R16G16B16A16_FLOAT; break;
+    case HDR_FLAGS_FORMAT_SHAREDEXP:    mdata.format = DXGI_FORMAT_R9G9B9E5_SHAREDEXP; break;
+    default:                            return E_INVALIDARG;
+    }
+
+    // Index the scanlines so they can be decoded independently
+    std::unique_ptr<size_t[]> scanOffsets(new (std::nothrow) size_t[mdata.height + 1]);
+    if (!scanOffsets)
+        return E_OUTOFMEMORY;
 
-    // Copy pixels
     auto sourcePtr = static_cast<const uint8_t*>(pSource) + offset;
 
-    size_t pixelLen = remaining;
+    scanOffsets[0] = 0;
+    for (size_t scan = 0; scan < mdata.height; ++scan)
+    {
+        size_t scanSize = 0;
+        hr = ScanHDRScanline(sourcePtr + scanOffsets[scan], remaining - scanOffsets[scan], mdata.width, scanSize);
+        if (FAILED(hr))
+            return hr;
+
+        scanOffsets[scan + 1] = scanOffsets[scan] + scanSize;
+    }
+
+    hr = image.Initialize2D(mdata.format, mdata.width, mdata.height, 1, 1, CP_FLAGS_LIMIT_4GB);
+    if (FAILED(hr))
+        return hr;
 
     const Image* img = image.GetImage(0, 0, 0);
     if (!img)
@@ -733,173 +1049,55 @@ HRESULT DirectX::LoadFromHDRMemory(const void* pSource, size_t size, TexMetadata
         return E_POINTER;
     }
 
-    auto destPtr = img->pixels;
-
-#ifdef _DEBUG
-    memset(img->pixels, 0xFF, img->rowPitch * img->height);
-#endif
-
-    for (size_t scan = 0; scan < mdata.height; ++scan)
+    // Exact powers of two for each RGBE exponent
+    float exponents[256];
+    for (int e = 0; e < 256; ++e)
     {
-        if (pixelLen < 4)
-        {
-            image.Release();
-            return E_FAIL;
-        }
-
-        uint8_t inColor[4];
-        memcpy(inColor, sourcePtr, 4);
-        sourcePtr += 4;
-        pixelLen -= 4;
+        exponents[e] = ldexpf(1.f, e - (128 + 8));
+    }
 
-        auto scanLine = reinterpret_cast<float*>(destPtr);
+    const float invExposure = 1.0f / exposure;
+    const bool directStore = (mdata.format == DXGI_FORMAT_R32G32B32A32_FLOAT);
 
-        if (inColor[0] == 2 && inColor[1] == 2 && inColor[2] < 128)
+    hr = ParallelFor((mdata.height + HDR_BAND_ROWS - 1) / HDR_BAND_ROWS, (flags & HDR_FLAGS_PARALLEL) ? 0u : 1u,
+        [&](size_t band) -> HRESULT
         {
-            // Adaptive Run Length Encoding (RLE)
-            if (size_t((size_t(inColor[2]) << 8) + inColor[3]) != mdata.width)
-            {
-                image.Release();
-                return E_FAIL;
-            }
+            std::unique_ptr<uint8_t[]> rgbe(new (std::nothrow) uint8_t[mdata.width * 4]);
+            if (!rgbe)
+                return E_OUTOFMEMORY;
 
-            for (int channel = 0; channel < 4; ++channel)
+            ScopedAlignedArrayXMVECTOR scanline;
+            if (!directStore)
             {
-                auto pixelLoc = scanLine + channel;
-                for (size_t pixelCount = 0; pixelCount < mdata.width;)
-                {
-                    if (pixelLen < 2)
-                    {
-                        image.Release();
-                        return E_FAIL;
-                    }
-
-                    assert(sourcePtr < (reinterpret_cast<const uint8_t*>(pSource) + size));
-
-                    uint8_t runLen = *sourcePtr;
-                    if (runLen > 128)
-                    {
-                        runLen &= 127;
-                        if (pixelCount + runLen > mdata.width)
-                        {
-                            image.Release();
-                            return E_FAIL;
-                        }
-
-                        auto val = static_cast<float>(sourcePtr[1]);
-                        for (uint8_t j = 0; j < runLen; ++j)
-                        {
-                            *pixelLoc = val;
-                            pixelLoc += 4;
-                        }
-                        pixelCount += runLen;
-                        sourcePtr += 2;
-                        pixelLen -= 2;
-                    }
-                    else if ((size < size_t(runLen) + 1) || ((pixelCount + size_t(runLen)) > mdata.width))
-                    {
-                        image.Release();
-                        return E_FAIL;
-                    }
-                    else
-                    {
-                        ++sourcePtr;
-                        for (uint8_t j = 0; j < runLen; ++j)
-                        {
-                            auto val = static_cast<float>(*sourcePtr++);
-                            *pixelLoc = val;
-                            pixelLoc += 4;
-                        }
-                        pixelCount += runLen;
-                        pixelLen -= size_t(runLen) + 1;
-                    }
-                }
+                scanline = make_AlignedArrayXMVECTOR(mdata.width);
+                if (!scanline)
+                    return E_OUTOFMEMORY;
             }
-        }
-        else
-        {
-            auto pixelLoc = scanLine;
-
-            float prevColor[4];
-            prevColor[0] = inColor[0];
-            prevColor[1] = inColor[1];
-            prevColor[2] = inColor[2];
-            prevColor[3] = inColor[3];
 
-            int bitShift = 0;
-            for (size_t pixelCount = 0; pixelCount < mdata.width;)
+            const size_t endScan = std::min(mdata.height, (band + 1) * HDR_BAND_ROWS);
+            for (size_t scan = band * HDR_BAND_ROWS; scan < endScan; ++scan)
             {
-                if (inColor[0] == 1 && inColor[1] == 1 && inColor[2] == 1)
-                {
-                    if (bitShift > 24)
-                    {
-                        image.Release();
-                        return E_FAIL;
-                    }
-
-                    // "Standard" Run Length Encoding
-                    const size_t spanLen = size_t(inColor[3]) << bitShift;
-                    if (spanLen + pixelCount > mdata.width)
-                    {
-                        image.Release();
-                        return E_FAIL;
-                    }
+                DecodeHDRScanline(rgbe.get(), sourcePtr + scanOffsets[scan], scanOffsets[scan + 1] - scanOffsets[scan], mdata.width);
 
-                    for (size_t j = 0; j < spanLen; ++j)
-                    {
-                        pixelLoc[0] = prevColor[0];
-                        pixelLoc[1] = prevColor[1];
-                        pixelLoc[2] = prevColor[2];
-                        pixelLoc[3] = prevColor[3];
-                        pixelLoc += 4;
-                    }
-                    pixelCount += spanLen;
-                    bitShift += 8;
-                }
-                else
+                uint8_t* pDest = img->pixels + scan * img->rowPitch;
+                if (directStore)
                 {
-                    // Uncompressed
-                    pixelLoc[0] = prevColor[0] = inColor[0];
-                    pixelLoc[1] = prevColor[1] = inColor[1];
-                    pixelLoc[2] = prevColor[2] = inColor[2];
-                    pixelLoc[3] = prevColor[3] = inColor[3];
-                    bitShift = 0;
-                    ++pixelCount;
-                    pixelLoc += 4;
+                    RGBEToVector(reinterpret_cast<XMVECTOR*>(pDest), rgbe.get(), mdata.width, exponents, invExposure);
                 }
-
-                if (pixelCount >= mdata.width)
-                    break;
-
-                if (pixelLen < 4)
+                else
                 {
-                    image.Release();
-                    return E_FAIL;
+                    RGBEToVector(scanline.get(), rgbe.get(), mdata.width, exponents, invExposure);
+                    if (!StoreScanline(pDest, img->rowPitch, mdata.format, scanline.get(), mdata.width))
+                        return E_FAIL;
                 }
-
-                memcpy(inColor, sourcePtr, 4);
-                sourcePtr += 4;
-                pixelLen -= 4;
             }
-        }
-
-        destPtr += img->rowPitch;
-    }
 
-    // Transform values
+            return S_OK;
+        });
+    if (FAILED(hr))
     {
-        auto fdata = reinterpret_cast<float*>(image.GetPixels());
-
-        for (size_t j = 0; j < image.GetPixelsSize(); j += 16)
-        {
-            auto const exponent = static_cast<int>(fdata[3]);
-            fdata[0] = 1.0f / exposure*ldexpf((fdata[0] + 0.5f), exponent - (128 + 8));
-            fdata[1] = 1.0f / exposure*ldexpf((fdata[1] + 0.5f), exponent - (128 + 8));
-            fdata[2] = 1.0f / exposure*ldexpf((fdata[2] + 0.5f), exponent - (128 + 8));
-            fdata[3] = 1.f;
-
-            fdata += 4;
-        }
+        image.Release();
+        return hr;
     }
 
     if (metadata)
@@ -913,7 +1111,7 @@ HRESULT DirectX::LoadFromHDRMemory(const void* pSource, size_t size, TexMetadata
 // Load a HDR file from disk
 //-------------------------------------------------------------------------------------
 _Use_decl_annotations_
-HRESULT DirectX::LoadFromHDRFile(const wchar_t* szFile, TexMetadata* metadata, ScratchImage& image) noexcept
+HRESULT DirectX::LoadFromHDRFile(const wchar_t* szFile, HDR_FLAGS flags, TexMetadata* metadata, ScratchImage& image) noexcept
 {
     if (!szFile)
         return E_INVALIDARG;
@@ -995,7 +1193,7 @@ HRESULT DirectX::LoadFromHDRFile(const wchar_t* szFile, TexMetadata* metadata, S
         return E_FAIL;
 #endif
 
-    return LoadFromHDRMemory(temp.get(), len, metadata, image);
+    return LoadFromHDRMemory(temp.get(), len, flags, metadata, image);
 }
 
 
@@ -1003,7 +1201,7 @@ HRESULT DirectX::LoadFromHDRFile(const wchar_t* szFile, TexMetadata* metadata, S
 // Save a HDR file to memory
 //-------------------------------------------------------------------------------------
 _Use_decl_annotations_
-HRESULT DirectX::SaveToHDRMemory(const Image& image, Blob& blob) noexcept
+HRESULT DirectX::SaveToHDRMemory(const Image& image, HDR_FLAGS flags, Blob& blob) noexcept
 {
     if (!image.pixels)
         return E_POINTER;
@@ -1015,15 +1213,11 @@ HRESULT DirectX::SaveToHDRMemory(const Image& image, Blob& blob) noexcept
         return HRESULT_E_NOT_SUPPORTED;
     }
 
-    int fpp;
     switch (image.format)
     {
     case DXGI_FORMAT_R32G32B32A32_FLOAT:
     case DXGI_FORMAT_R16G16B16A16_FLOAT:
-        fpp = 4;
-        break;
     case DXGI_FORMAT_R32G32B32_FLOAT:
-        fpp = 3;
         break;
 
     default:
@@ -1037,7 +1231,7 @@ HRESULT DirectX::SaveToHDRMemory(const Image& image, Blob& blob) noexcept
 
     auto headerLen = static_cast<DWORD>(strlen(header));
 
-    size_t rowPitch = image.width * 4;
+    const size_t rowPitch = image.width * 4;
     const size_t slicePitch = image.height * rowPitch;
 
     HRESULT hr = blob.Initialize(headerLen + slicePitch);
@@ -1050,54 +1244,15 @@ HRESULT DirectX::SaveToHDRMemory(const Image& image, Blob& blob) noexcept
     memcpy(dPtr, header, headerLen);
     dPtr += headerLen;
 
-#ifdef DISABLE_COMPRESS
-    // Uncompressed write
-    auto sPtr = reinterpret_cast<const uint8_t*>(image.pixels);
-    for (size_t scan = 0; scan < image.height; ++scan)
-    {
-        FloatToRGBE(dPtr, reinterpret_cast<const float*>(sPtr), image.width, fpp);
-        dPtr += rowPitch;
-        sPtr += image.rowPitch;
-    }
-#else
-    std::unique_ptr<uint8_t[]> temp(new (std::nothrow) uint8_t[rowPitch * 2]);
-    if (!temp)
+    size_t encodedSize = 0;
+    hr = EncodeHDRRows(image, 0, image.height, dPtr, (flags & HDR_FLAGS_PARALLEL) ? 0u : 1u, encodedSize);
+    if (FAILED(hr))
     {
         blob.Release();
-        return E_OUTOFMEMORY;
-    }
-
-    auto rgbe = temp.get();
-    auto enc = temp.get() + rowPitch;
-
-    const uint8_t* sPtr = image.pixels;
-    for (size_t scan = 0; scan < image.height; ++scan)
-    {
-        if (image.format == DXGI_FORMAT_R32G32B32A32_FLOAT || image.format == DXGI_FORMAT_R32G32B32_FLOAT)
-        {
-            FloatToRGBE(rgbe, reinterpret_cast<const float*>(sPtr), image.width, fpp);
-        }
-        else if (image.format == DXGI_FORMAT_R16G16B16A16_FLOAT)
-        {
-            HalfToRGBE(rgbe, reinterpret_cast<const uint16_t*>(sPtr), image.width, fpp);
-        }
-        sPtr += image.rowPitch;
-
-        size_t encSize = EncodeRLE(enc, rgbe, rowPitch, image.width);
-        if (encSize > 0)
-        {
-            memcpy(dPtr, enc, encSize);
-            dPtr += encSize;
-        }
-        else
-        {
-            memcpy(dPtr, rgbe, rowPitch);
-            dPtr += rowPitch;
-        }
+        return hr;
     }
-#endif
 
-    hr = blob.Trim(size_t(dPtr - static_cast<uint8_t*>(blob.GetBufferPointer())));
+    hr = blob.Trim(headerLen + encodedSize);
     if (FAILED(hr))
     {
         blob.Release();
@@ -1112,7 +1267,7 @@ HRESULT DirectX::SaveToHDRMemory(const Image& image, Blob& blob) noexcept
 // Save a HDR file to disk
 //-------------------------------------------------------------------------------------
 _Use_decl_annotations_
-HRESULT DirectX::SaveToHDRFile(const Image& image, const wchar_t* szFile) noexcept
+HRESULT DirectX::SaveToHDRFile(const Image& image, HDR_FLAGS flags, const wchar_t* szFile) noexcept
 {
     if (!szFile)
         return E_INVALIDARG;
@@ -1127,15 +1282,11 @@ HRESULT DirectX::SaveToHDRFile(const Image& image, const wchar_t* szFile) noexce
         return HRESULT_E_NOT_SUPPORTED;
     }
 
-    int fpp;
     switch (image.format)
     {
     case DXGI_FORMAT_R32G32B32A32_FLOAT:
     case DXGI_FORMAT_R16G16B16A16_FLOAT:
-        fpp = 4;
-        break;
     case DXGI_FORMAT_R32G32B32_FLOAT:
-        fpp = 3;
         break;
 
     default:
@@ -1164,150 +1315,64 @@ HRESULT DirectX::SaveToHDRFile(const Image& image, const wchar_t* szFile) noexce
 #endif
 
     const uint64_t pitch = uint64_t(image.width) * 4u;
-    const uint64_t slicePitch = uint64_t(image.height) * pitch;
-
     if (pitch > UINT32_MAX)
         return HRESULT_E_ARITHMETIC_OVERFLOW;
 
-    size_t rowPitch = static_cast<size_t>(pitch);
+    const size_t rowPitch = static_cast<size_t>(pitch);
 
-    if (slicePitch < 65535)
-    {
-        // For small images, it is better to create an in-memory file and write it out
-        Blob blob;
+    // The image is encoded in chunks of scanlines, each written out with a single call
+    const size_t chunkRows = std::min<size_t>(image.height, std::max<size_t>(HDR_WRITE_CHUNK / rowPitch, 1));
 
-        HRESULT hr = SaveToHDRMemory(image, blob);
-        if (FAILED(hr))
-            return hr;
+    std::unique_ptr<uint8_t[]> temp(new (std::nothrow) uint8_t[chunkRows * rowPitch]);
+    if (!temp)
+        return E_OUTOFMEMORY;
 
-        // Write blob
-    #ifdef _WIN32
-        auto const bytesToWrite = static_cast<const DWORD>(blob.GetBufferSize());
-        DWORD bytesWritten;
-        if (!WriteFile(hFile.get(), blob.GetBufferPointer(), bytesToWrite, &bytesWritten, nullptr))
-        {
-            return HRESULT_FROM_WIN32(GetLastError());
-        }
+    // Write header
+    char header[256] = {};
+    sprintf_s(header, g_Header, image.height, image.width);
 
-        if (bytesWritten != bytesToWrite)
-        {
-            return E_FAIL;
-        }
-    #else
-        outFile.write(reinterpret_cast<char*>(blob.GetBufferPointer()),
-            static_cast<std::streamsize>(blob.GetBufferSize()));
+#ifdef _WIN32
+    auto const headerLen = static_cast<DWORD>(strlen(header));
 
-        if (!outFile)
-            return E_FAIL;
-    #endif
-    }
-    else
+    DWORD bytesWritten;
+    if (!WriteFile(hFile.get(), header, headerLen, &bytesWritten, nullptr))
     {
-        // Otherwise, write the image one scanline at a time...
-        std::unique_ptr<uint8_t[]> temp(new (std::nothrow) uint8_t[rowPitch * 2]);
-        if (!temp)
-            return E_OUTOFMEMORY;
+        return HRESULT_FROM_WIN32(GetLastError());
+    }
 
-        auto rgbe = temp.get();
+    if (bytesWritten != headerLen)
+        return E_FAIL;
+#else
+    outFile.write(reinterpret_cast<char*>(header), static_cast<std::streamsize>(strlen(header)));
+    if (!outFile)
+        return E_FAIL;
+#endif
 
-        // Write header
-        char header[256] = {};
-        sprintf_s(header, g_Header, image.height, image.width);
+    const size_t maxThreads = (flags & HDR_FLAGS_PARALLEL) ? 0u : 1u;
 
-    #ifdef _WIN32
-        auto const headerLen = static_cast<DWORD>(strlen(header));
+    for (size_t row = 0; row < image.height; row += chunkRows)
+    {
+        size_t encSize = 0;
+        HRESULT hr = EncodeHDRRows(image, row, std::min(chunkRows, image.height - row), temp.get(), maxThreads, encSize);
+        if (FAILED(hr))
+            return hr;
 
-        DWORD bytesWritten;
-        if (!WriteFile(hFile.get(), header, headerLen, &bytesWritten, nullptr))
+        if (encSize > UINT32_MAX)
+            return HRESULT_E_ARITHMETIC_OVERFLOW;
+
+    #ifdef _WIN32
+        if (!WriteFile(hFile.get(), temp.get(), static_cast<DWORD>(encSize), &bytesWritten, nullptr))
         {
             return HRESULT_FROM_WIN32(GetLastError());
         }
 
-        if (bytesWritten != headerLen)
+        if (bytesWritten != encSize)
             return E_FAIL;
     #else
-        outFile.write(reinterpret_cast<char*>(header), static_cast<std::streamsize>(strlen(header)));
+        outFile.write(reinterpret_cast<char*>(temp.get()), static_cast<std::streamsize>(encSize));
         if (!outFile)
             return E_FAIL;
     #endif
-
-    #ifdef DISABLE_COMPRESS
-            // Uncompressed write
-        auto sPtr = reinterpret_cast<const uint8_t*>(image.pixels);
-        for (size_t scan = 0; scan < image.height; ++scan)
-        {
-            FloatToRGBE(rgbe, reinterpret_cast<const float*>(sPtr), image.width, fpp);
-            sPtr += image.rowPitch;
-
-        #ifdef _WIN32
-            if (!WriteFile(hFile.get(), rgbe, static_cast<DWORD>(rowPitch), &bytesWritten, nullptr))
-            {
-                return HRESULT_FROM_WIN32(GetLastError());
-            }
-
-            if (bytesWritten != rowPitch)
-                return E_FAIL;
-        #else
-            outFile.write(reinterpret_cast<char*>(rgbe), static_cast<std::streamsize>(rowPitch));
-            if (!outFile)
-                return E_FAIL;
-        #endif
-
-        }
-    #else
-        auto enc = temp.get() + rowPitch;
-
-        const uint8_t* sPtr = image.pixels;
-        for (size_t scan = 0; scan < image.height; ++scan)
-        {
-            if (image.format == DXGI_FORMAT_R32G32B32A32_FLOAT || image.format == DXGI_FORMAT_R32G32B32_FLOAT)
-            {
-                FloatToRGBE(rgbe, reinterpret_cast<const float*>(sPtr), image.width, fpp);
-            }
-            else if (image.format == DXGI_FORMAT_R16G16B16A16_FLOAT)
-            {
-                HalfToRGBE(rgbe, reinterpret_cast<const uint16_t*>(sPtr), image.width, fpp);
-            }
-            sPtr += image.rowPitch;
-
-            const size_t encSize = EncodeRLE(enc, rgbe, rowPitch, image.width);
-            if (encSize > 0)
-            {
-                if (encSize > UINT32_MAX)
-                    return HRESULT_E_ARITHMETIC_OVERFLOW;
-
-            #ifdef _WIN32
-                if (!WriteFile(hFile.get(), enc, static_cast<DWORD>(encSize), &bytesWritten, nullptr))
-                {
-                    return HRESULT_FROM_WIN32(GetLastError());
-                }
-
-                if (bytesWritten != encSize)
-                    return E_FAIL;
-            #else
-                outFile.write(reinterpret_cast<char*>(enc), static_cast<std::streamsize>(encSize));
-                if (!outFile)
-                    return E_FAIL;
-            #endif
-            }
-            else
-            {
-            #ifdef _WIN32
-                if (!WriteFile(hFile.get(), rgbe, static_cast<DWORD>(rowPitch), &bytesWritten, nullptr))
-                {
-                    return HRESULT_FROM_WIN32(GetLastError());
-                }
-
-                if (bytesWritten != rowPitch)
-                    return E_FAIL;
-            #else
-                outFile.write(reinterpret_cast<char*>(rgbe), static_cast<std::streamsize>(rowPitch));
-                if (!outFile)
-                    return E_FAIL;
-            #endif
-            }
-        }
-    #endif
     }
 
 #ifdef _WIN32
@@ -1334,17 +1399,19 @@ namespace DirectX
 
     HRESULT __cdecl LoadFromHDRFile(
         _In_z_ const __wchar_t* szFile,
+        _In_ HDR_FLAGS flags,
         _Out_opt_ TexMetadata* metadata,
         _Out_ ScratchImage& image) noexcept
     {
-        return LoadFromHDRFile(reinterpret_cast<const unsigned short*>(szFile), metadata, image);
+        return LoadFromHDRFile(reinterpret_cast<const unsigned short*>(szFile), flags, metadata, image);
     }
 
     HRESULT __cdecl SaveToHDRFile(
         _In_ const Image& image,
+        _In_ HDR_FLAGS flags,
         _In_z_ const __wchar_t* szFile) noexcept
     {
-        return SaveToHDRFile(image, reinterpret_cast<const unsigned short*>(szFile));
+        return SaveToHDRFile(image, flags, reinterpret_cast<const unsigned short*>(szFile));
     }
 }
 
@@ -272,6 +272,66 @@ bool DirectX::Internal::SetupImageArray(
 // ScratchImage - Bitmap image container
 //=====================================================================================
 
+namespace
+{
+    //---------------------------------------------------------------------------------
+    // Validates the dimensions of a new image and computes the mip count if it is 0
+    //---------------------------------------------------------------------------------
+    HRESULT ValidateMetadata(const TexMetadata& mdata, size_t& mipLevels) noexcept
+    {
+        if (!IsValid(mdata.format))
+            return E_INVALIDARG;
+
+        if (IsPalettized(mdata.format))
+            return HRESULT_E_NOT_SUPPORTED;
+
+        mipLevels = mdata.mipLevels;
+
+        switch (mdata.dimension)
+        {
+        case TEX_DIMENSION_TEXTURE1D:
+            if (!mdata.width || mdata.height != 1 || mdata.depth != 1 || !mdata.arraySize)
+                return E_INVALIDARG;
+
+            if (!CalculateMipLevels(mdata.width, 1, mipLevels))
+                return E_INVALIDARG;
+            break;
+
+        case TEX_DIMENSION_TEXTURE2D:
+            if (!mdata.width || !mdata.height || mdata.depth != 1 || !mdata.arraySize)
+                return E_INVALIDARG;
+
+            if (mdata.IsCubemap())
+            {
+                if ((mdata.arraySize % 6) != 0)
+                    return E_INVALIDARG;
+            }
+
+            if (!CalculateMipLevels(mdata.width, mdata.height, mipLevels))
+                return E_INVALIDARG;
+            break;
+
+        case TEX_DIMENSION_TEXTURE3D:
+            if (!mdata.width || !mdata.height || !mdata.depth || mdata.arraySize != 1)
+                return E_INVALIDARG;
+
+            if (!CalculateMipLevels3D(mdata.width, mdata.height, mdata.depth, mipLevels))
+                return E_INVALIDARG;
+            break;
+
+        default:
+            return HRESULT_E_NOT_SUPPORTED;
+        }
+
+        return S_OK;
+    }
+
+    // Deleter for views without one: the caller owns the memory
+    void __cdecl KeepViewMemory(uint8_t*, void*)
+    {
+    }
+}
+
 ScratchImage& ScratchImage::operator= (ScratchImage&& moveFrom) noexcept
 {
     if (this != &moveFrom)
@@ -283,11 +343,15 @@ ScratchImage& ScratchImage::operator= (ScratchImage&& moveFrom) noexcept
         m_metadata = moveFrom.m_metadata;
         m_image = moveFrom.m_image;
         m_memory = moveFrom.m_memory;
+        m_deleter = moveFrom.m_deleter;
+        m_deleterContext = moveFrom.m_deleterContext;
 
         moveFrom.m_nimages = 0;
         moveFrom.m_size = 0;
         moveFrom.m_image = nullptr;
         moveFrom.m_memory = nullptr;
+        moveFrom.m_deleter = nullptr;
+        moveFrom.m_deleterContext = nullptr;
     }
     return *this;
 }
@@ -299,49 +363,10 @@ ScratchImage& ScratchImage::operator= (ScratchImage&& moveFrom) noexcept
 _Use_decl_annotations_
 HRESULT ScratchImage::Initialize(const TexMetadata& mdata, CP_FLAGS flags) noexcept
 {
-    if (!IsValid(mdata.format))
-        return E_INVALIDARG;
-
-    if (IsPalettized(mdata.format))
-        return HRESULT_E_NOT_SUPPORTED;
-
-    size_t mipLevels = mdata.mipLevels;
-
-    switch (mdata.dimension)
-    {
-    case TEX_DIMENSION_TEXTURE1D:
-        if (!mdata.width || mdata.height != 1 || mdata.depth != 1 || !mdata.arraySize)
-            return E_INVALIDARG;
-
-        if (!CalculateMipLevels(mdata.width, 1, mipLevels))
-            return E_INVALIDARG;
-        break;
-
-    case TEX_DIMENSION_TEXTURE2D:
-        if (!mdata.width || !mdata.height || mdata.depth != 1 || !mdata.arraySize)
-            return E_INVALIDARG;
-
-        if (mdata.IsCubemap())
-        {
-            if ((mdata.arraySize % 6) != 0)
-                return E_INVALIDARG;
-        }
-
-        if (!CalculateMipLevels(mdata.width, mdata.height, mipLevels))
-            return E_INVALIDARG;
-        break;
-
-    case TEX_DIMENSION_TEXTURE3D:
-        if (!mdata.width || !mdata.height || !mdata.depth || mdata.arraySize != 1)
-            return E_INVALIDARG;
-
-        if (!CalculateMipLevels3D(mdata.width, mdata.height, mdata.depth, mipLevels))
-            return E_INVALIDARG;
-        break;
-
-    default:
-        return HRESULT_E_NOT_SUPPORTED;
-    }
+    size_t mipLevels = 0;
+    HRESULT hr = ValidateMetadata(mdata, mipLevels);
+    if (FAILED(hr))
+        return hr;
 
     Release();
 
@@ -356,7 +381,7 @@ HRESULT ScratchImage::Initialize(const TexMetadata& mdata, CP_FLAGS flags) noexc
     m_metadata.dimension = mdata.dimension;
 
     size_t pixelSize, nimages;
-    HRESULT hr = DetermineImageArray(m_metadata, flags, nimages, pixelSize);
+    hr = DetermineImageArray(m_metadata, flags, nimages, pixelSize);
     if (FAILED(hr))
         return hr;
 
@@ -706,6 +731,90 @@ HRESULT ScratchImage::Initialize3DFromImages(const Image* images, size_t depth,
     return S_OK;
 }
 
+_Use_decl_annotations_
+HRESULT ScratchImage::InitializeView(
+    const TexMetadata& mdata,
+    uint8_t* pMemory,
+    size_t size,
+    CP_FLAGS flags,
+    void (__cdecl *deleter)(uint8_t*, void*),
+    void* context) noexcept
+{
+    // Views keep the 16-byte alignment that ScratchImage allocations guarantee
+    if (reinterpret_cast<uintptr_t>(pMemory) & 0xF)
+        return E_INVALIDARG;
+
+    return SetupView(mdata, pMemory, size, flags, deleter, context);
+}
+
+_Use_decl_annotations_
+HRESULT ScratchImage::SetupView(
+    const TexMetadata& mdata,
+    uint8_t* pMemory,
+    size_t size,
+    CP_FLAGS flags,
+    void (__cdecl *deleter)(uint8_t*, void*),
+    void* context) noexcept
+{
+    if (!pMemory || !size)
+        return E_INVALIDARG;
+
+    size_t mipLevels = 0;
+    HRESULT hr = ValidateMetadata(mdata, mipLevels);
+    if (FAILED(hr))
+        return hr;
+
+    Release();
+
+    m_metadata.width = mdata.width;
+    m_metadata.height = mdata.height;
+    m_metadata.depth = mdata.depth;
+    m_metadata.arraySize = mdata.arraySize;
+    m_metadata.mipLevels = mipLevels;
+    m_metadata.miscFlags = mdata.miscFlags;
+    m_metadata.miscFlags2 = mdata.miscFlags2;
+    m_metadata.format = mdata.format;
+    m_metadata.dimension = mdata.dimension;
+
+    size_t pixelSize, nimages;
+    hr = DetermineImageArray(m_metadata, flags, nimages, pixelSize);
+    if (FAILED(hr))
+    {
+        Release();
+        return hr;
+    }
+
+    if (pixelSize > size)
+    {
+        Release();
+        return HRESULT_E_HANDLE_EOF;
+    }
+
+    m_image = new (std::nothrow) Image[nimages];
+    if (!m_image)
+    {
+        Release();
+        return E_OUTOFMEMORY;
+    }
+
+    m_nimages = nimages;
+    memset(m_image, 0, sizeof(Image) * nimages);
+
+    if (!SetupImageArray(pMemory, pixelSize, m_metadata, flags, m_image, nimages))
+    {
+        Release();
+        return E_FAIL;
+    }
+
+    // The caller keeps ownership of the memory until the view is successfully set up
+    m_memory = pMemory;
+    m_size = pixelSize;
+    m_deleter = deleter ? deleter : KeepViewMemory;
+    m_deleterContext = context;
+
+    return S_OK;
+}
+
 void ScratchImage::Release() noexcept
 {
     m_nimages = 0;
@@ -719,10 +828,20 @@ void ScratchImage::Release() noexcept
 
     if (m_memory)
     {
-        _aligned_free(m_memory);
+        if (m_deleter)
+        {
+            m_deleter(m_memory, m_deleterContext);
+        }
+        else
+        {
+            _aligned_free(m_memory);
+        }
         m_memory = nullptr;
     }
 
+    m_deleter = nullptr;
+    m_deleterContext = nullptr;
+
     memset(&m_metadata, 0, sizeof(m_metadata));
 }
 
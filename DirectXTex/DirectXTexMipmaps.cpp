@@ -124,22 +124,6 @@ namespace
 #endif // WIN32
 
 
-#if DIRECTX_MATH_VERSION >= 310
-#define VectorSum XMVectorSum
-#else
-    inline XMVECTOR XM_CALLCONV VectorSum
-    (
-        FXMVECTOR V
-    )
-    {
-        XMVECTOR vTemp = XMVectorSwizzle<2, 3, 0, 1>(V);
-        XMVECTOR vTemp2 = XMVectorAdd(V, vTemp);
-        vTemp = XMVectorSwizzle<1, 0, 3, 2>(vTemp2);
-        return XMVectorAdd(vTemp, vTemp2);
-    }
-#endif
-
-
     HRESULT ScaleAlpha(
         const Image& srcImage,
         float alphaScale,
@@ -191,9 +175,41 @@ namespace
     }
 
 
-    void GenerateAlphaCoverageConvolutionVectors(
+    //--- Alpha coverage ---
+    // Coverage is measured on N x N bilinear samples inside every 2x2 quad of alpha values. Scaling
+    // alpha up never uncovers a sample, so each sample has a threshold scale above which it passes
+    // the reference. A histogram of the thresholds gives the coverage at every scale from one pass.
+    constexpr size_t COVERAGE_SAMPLES = 8;
+    constexpr float COVERAGE_MAX_SCALE = 4.0f;
+    constexpr size_t COVERAGE_BINS = 16384;
+    constexpr size_t COVERAGE_BAND_ROWS = 64;
+
+    constexpr float COVERAGE_BIN_SCALE = float(COVERAGE_BINS) / COVERAGE_MAX_SCALE;
+
+    struct AlphaCoverageHistogram
+    {
+        uint64_t bins[COVERAGE_BINS + 1]; // the last bin counts samples that never pass up to COVERAGE_MAX_SCALE
+        uint64_t total;
+
+        // Coverage at the scale of the given bin edge
+        float GetCoverage(size_t edge) const noexcept
+        {
+            if (!total)
+                return 0.f;
+
+            uint64_t count = 0;
+            for (size_t j = 0; j < edge; ++j)
+            {
+                count += bins[j];
+            }
+
+            return static_cast<float>(count) / static_cast<float>(total);
+        }
+    };
+
+    void GenerateAlphaCoverageWeights(
         _In_ size_t N,
-        _Out_writes_(N*N) XMVECTOR* vectors) noexcept
+        _Out_writes_(N*N) XMFLOAT4* weights) noexcept
     {
         for (size_t sy = 0; sy < N; ++sy)
         {
@@ -206,152 +222,211 @@ namespace
                 const float ifx = 1.0f - fx;
 
                 // [0]=(x+0, y+0), [1]=(x+0, y+1), [2]=(x+1, y+0), [3]=(x+1, y+1)
-                vectors[sy * N + sx] = XMVectorSet(ifx * ify, ifx * fy, fx * ify, fx * fy);
+                weights[sy * N + sx] = XMFLOAT4(ifx * ify, ifx * fy, fx * ify, fx * fy);
             }
         }
     }
 
-
-    HRESULT CalculateAlphaCoverage(
-        const Image& srcImage,
-        float alphaReference,
-        float alphaScale,
-        float& coverage) noexcept
+    // Smallest scale at which sum(weight[j] * saturate(alpha[j] * scale)) > alphaReference,
+    // with alpha sorted in decreasing order
+    float AlphaCoverageThreshold(
+        _In_reads_(4) const float* alpha,
+        _In_reads_(4) const float* weight,
+        float alphaReference) noexcept
     {
-        coverage = 0.0f;
+        if (alphaReference < 0.f)
+            return 0.f;
 
-        auto row0 = make_AlignedArrayXMVECTOR(srcImage.width);
-        if (!row0)
+        float slope = 0.f;
+        for (size_t j = 0; j < 4 && alpha[j] > 0.f; ++j)
         {
-            return E_OUTOFMEMORY;
+            slope += weight[j] * alpha[j];
         }
 
-        auto row1 = make_AlignedArrayXMVECTOR(srcImage.width);
-        if (!row1)
+        // Below 1/alpha[j] the sample is a plain bilinear filter of alpha scaled
+        float saturated = 0.f;
+        for (size_t j = 0; j < 4 && alpha[j] > 0.f && slope > 0.f; ++j)
         {
-            return E_OUTOFMEMORY;
+            const float t = (alphaReference - saturated) / slope;
+            if (t * alpha[j] < 1.f)
+                return t;
+
+            saturated += weight[j];
+            slope -= weight[j] * alpha[j];
         }
 
-        const XMVECTOR scale = XMVectorReplicate(alphaScale);
+        return FLT_MAX;
+    }
+
+    inline size_t GetCoverageBin(float threshold) noexcept
+    {
+        return (threshold < COVERAGE_MAX_SCALE) ? static_cast<size_t>(std::max(threshold, 0.f) * COVERAGE_BIN_SCALE) : COVERAGE_BINS;
+    }
+
+    // Adds the samples of the quads between rows of the image
+    HRESULT AccumulateAlphaCoverage(
+        const Image& srcImage,
+        float alphaReference,
+        _Inout_ AlphaCoverageHistogram& histogram) noexcept
+    {
+        if (srcImage.width < 2 || srcImage.height < 2)
+            return S_OK;
+
+        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(srcImage.width) * 2);
+        if (!scanline)
+            return E_OUTOFMEMORY;
+
+        XMVECTOR* row0 = scanline.get();
+        XMVECTOR* row1 = row0 + srcImage.width;
 
-        const uint8_t *pSrcRow0 = srcImage.pixels;
-        if (!pSrcRow0)
+        constexpr size_t N = COVERAGE_SAMPLES;
+        XMFLOAT4 weights[N * N];
+        GenerateAlphaCoverageWeights(N, weights);
+
+        // Corner weights of four samples at a time
+        XMVECTOR sampleWeights[N * N];
+        for (size_t s = 0; s < N * N; s += 4)
         {
-            return E_POINTER;
+            sampleWeights[s] = XMVectorSet(weights[s].x, weights[s + 1].x, weights[s + 2].x, weights[s + 3].x);
+            sampleWeights[s + 1] = XMVectorSet(weights[s].y, weights[s + 1].y, weights[s + 2].y, weights[s + 3].y);
+            sampleWeights[s + 2] = XMVectorSet(weights[s].z, weights[s + 1].z, weights[s + 2].z, weights[s + 3].z);
+            sampleWeights[s + 3] = XMVectorSet(weights[s].w, weights[s + 1].w, weights[s + 2].w, weights[s + 3].w);
         }
 
-        constexpr size_t N = 8;
-        XMVECTOR convolution[N * N];
-        GenerateAlphaCoverageConvolutionVectors(N, convolution);
+        const XMVECTOR vref = XMVectorReplicate(alphaReference);
+
+        const uint8_t *pSrc = srcImage.pixels;
+        if (!LoadScanlineLinear(row1, srcImage.width, pSrc, srcImage.rowPitch, srcImage.format, TEX_FILTER_DEFAULT))
+            return E_FAIL;
 
-        size_t coverageCount = 0;
         for (size_t y = 0; y < srcImage.height - 1; ++y)
         {
-            if (!LoadScanlineLinear(row0.get(), srcImage.width, pSrcRow0, srcImage.rowPitch, srcImage.format, TEX_FILTER_DEFAULT))
-            {
-                return E_FAIL;
-            }
+            std::swap(row0, row1);
 
-            const uint8_t *pSrcRow1 = pSrcRow0 + srcImage.rowPitch;
-            if (!LoadScanlineLinear(row1.get(), srcImage.width, pSrcRow1, srcImage.rowPitch, srcImage.format, TEX_FILTER_DEFAULT))
-            {
+            pSrc += srcImage.rowPitch;
+            if (!LoadScanlineLinear(row1, srcImage.width, pSrc, srcImage.rowPitch, srcImage.format, TEX_FILTER_DEFAULT))
                 return E_FAIL;
-            }
 
-            const XMVECTOR* pRow0 = row0.get();
-            const XMVECTOR* pRow1 = row1.get();
             for (size_t x = 0; x < srcImage.width - 1; ++x)
             {
                 // [0]=(x+0, y+0), [1]=(x+0, y+1), [2]=(x+1, y+0), [3]=(x+1, y+1)
-                XMVECTOR r0 = XMVectorSplatW(*pRow0);
-                XMVECTOR r1 = XMVectorSplatW(*pRow1);
+                const float corners[4] = { XMVectorGetW(row0[x]), XMVectorGetW(row1[x]), XMVectorGetW(row0[x + 1]), XMVectorGetW(row1[x + 1]) };
 
-                XMVECTOR v1 = XMVectorSaturate(XMVectorMultiply(r0, scale));
-                const XMVECTOR v2 = XMVectorSaturate(XMVectorMultiply(r1, scale));
+                const float amin = std::min(std::min(corners[0], corners[1]), std::min(corners[2], corners[3]));
+                const float amax = std::max(std::max(corners[0], corners[1]), std::max(corners[2], corners[3]));
 
-                r0 = XMVectorSplatW(*(++pRow0));
-                r1 = XMVectorSplatW(*(++pRow1));
+                if (amin == amax)
+                {
+                    // Every sample of a flat quad has the same threshold
+                    static const float s_flat[4] = { 1.f, 0.f, 0.f, 0.f };
+                    histogram.bins[GetCoverageBin(AlphaCoverageThreshold(corners, s_flat, alphaReference))] += N * N;
+                    continue;
+                }
+
+                if (std::min(amax * COVERAGE_MAX_SCALE, 1.f) <= alphaReference)
+                {
+                    // No sample can pass within the scale range
+                    histogram.bins[COVERAGE_BINS] += N * N;
+                    continue;
+                }
 
-                XMVECTOR v3 = XMVectorSaturate(XMVectorMultiply(XMVectorSplatW(r0), scale));
-                const XMVECTOR v4 = XMVectorSaturate(XMVectorMultiply(XMVectorSplatW(r1), scale));
+                // Until the largest corner saturates, a sample passes above alphaReference / (bilinear filter of alpha)
+                const bool linear = (amin >= 0.f) && (alphaReference >= 0.f);
 
-                v1 = XMVectorMergeXY(v1, v2); // [v1.x v2.x --- ---]
-                v3 = XMVectorMergeXY(v3, v4); // [v3.x v4.x --- ---]
+                const XMVECTOR c0 = XMVectorReplicate(corners[0]);
+                const XMVECTOR c1 = XMVectorReplicate(corners[1]);
+                const XMVECTOR c2 = XMVectorReplicate(corners[2]);
+                const XMVECTOR c3 = XMVectorReplicate(corners[3]);
 
-                XMVECTOR v = XMVectorPermute<0, 1, 4, 5>(v1, v3); // [v1.x v2.x v3.x v4.x]
+                size_t order[4] = {};
+                float alpha[4] = {};
+                bool sorted = false;
 
-                for (size_t sy = 0; sy < N; ++sy)
+                for (size_t s = 0; s < N * N; s += 4)
                 {
-                    const size_t ry = sy * N;
-                    for (size_t sx = 0; sx < N; ++sx)
+                    XMVECTOR v = XMVectorMultiply(sampleWeights[s], c0);
+                    v = XMVectorMultiplyAdd(sampleWeights[s + 1], c1, v);
+                    v = XMVectorMultiplyAdd(sampleWeights[s + 2], c2, v);
+                    v = XMVectorMultiplyAdd(sampleWeights[s + 3], c3, v);
+
+                    XMFLOAT4A thresholds;
+                    XMStoreFloat4A(&thresholds, XMVectorDivide(vref, v));
+
+                    for (size_t k = 0; k < 4; ++k)
                     {
-                        v = VectorSum(XMVectorMultiply(v, convolution[ry + sx]));
-                        if (XMVectorGetX(v) > alphaReference)
+                        float t = (&thresholds.x)[k];
+                        if (!linear || !(t * amax < 1.f))
                         {
-                            ++coverageCount;
+                            if (!sorted)
+                            {
+                                for (size_t j = 0; j < 4; ++j)
+                                {
+                                    order[j] = j;
+                                }
+                                std::sort(order, order + 4, [&](size_t a, size_t b) { return corners[a] > corners[b]; });
+
+                                for (size_t j = 0; j < 4; ++j)
+                                {
+                                    alpha[j] = corners[order[j]];
+                                }
+                                sorted = true;
+                            }
+
+                            const float* w = &weights[s + k].x;
+                            const float weight[4] = { w[order[0]], w[order[1]], w[order[2]], w[order[3]] };
+                            t = AlphaCoverageThreshold(alpha, weight, alphaReference);
                         }
+
+                        ++histogram.bins[GetCoverageBin(t)];
                     }
                 }
             }
-
-            pSrcRow0 = pSrcRow1;
         }
 
-        float cscale = static_cast<float>((srcImage.width - 1) * (srcImage.height - 1) * N * N);
-        if (cscale > 0.f)
-        {
-            coverage = static_cast<float>(coverageCount) / cscale;
-        }
+        histogram.total += uint64_t(srcImage.width - 1) * uint64_t(srcImage.height - 1) * N * N;
 
         return S_OK;
     }
 
-
-    HRESULT EstimateAlphaScaleForCoverage(
-        const Image& srcImage,
-        float alphaReference,
-        float targetCoverage,
-        float& alphaScale) noexcept
+    // Scale closest to 1 at which the coverage reaches the target, within [0, COVERAGE_MAX_SCALE]
+    float EstimateAlphaScaleForCoverage(
+        const AlphaCoverageHistogram& histogram,
+        float targetCoverage) noexcept
     {
-        float minAlphaScale = 0.0f;
-        float maxAlphaScale = 4.0f;
-        float bestError = FLT_MAX;
+        constexpr size_t one = static_cast<size_t>(COVERAGE_BIN_SCALE);
 
-        // Determine desired scale using a binary search. Hardcoded to 10 steps max.
-        alphaScale = 1.0f;
-        constexpr size_t N = 10;
-        for (size_t i = 0; i < N; ++i)
+        float coverage = histogram.GetCoverage(one);
+        if (coverage == targetCoverage)
+            return 1.f;
+
+        uint64_t count = 0;
+        for (size_t j = 0; j < one; ++j)
         {
-            float currentCoverage = 0.0f;
-            HRESULT hr = CalculateAlphaCoverage(srcImage, alphaReference, alphaScale, currentCoverage);
-            if (FAILED(hr))
-            {
-                return hr;
-            }
+            count += histogram.bins[j];
+        }
 
-            const float error = fabsf(currentCoverage - targetCoverage);
-            if (error < bestError)
-            {
-                bestError = error;
-            }
+        const float total = static_cast<float>(histogram.total);
 
-            if (currentCoverage < targetCoverage)
-            {
-                minAlphaScale = alphaScale;
-            }
-            else if (currentCoverage > targetCoverage)
-            {
-                maxAlphaScale = alphaScale;
-            }
-            else
+        if (coverage < targetCoverage)
+        {
+            for (size_t edge = one + 1; edge <= COVERAGE_BINS; ++edge)
             {
-                break;
+                count += histogram.bins[edge - 1];
+                if (static_cast<float>(count) / total >= targetCoverage)
+                    return static_cast<float>(edge) / COVERAGE_BIN_SCALE;
             }
 
-            alphaScale = (minAlphaScale + maxAlphaScale) * 0.5f;
+            return COVERAGE_MAX_SCALE;
         }
 
-        return S_OK;
+        for (size_t edge = one; edge > 0; --edge)
+        {
+            count -= histogram.bins[edge - 1];
+            if (static_cast<float>(count) / total <= targetCoverage)
+                return static_cast<float>(edge - 1) / COVERAGE_BIN_SCALE;
+        }
+
+        return 0.f;
     }
 }
 
@@ -687,7 +762,9 @@ namespace
             break;
 
         case TEX_FILTER_TRIANGLE:
-            // WIC does not implement this filter
+        case TEX_FILTER_LANCZOS:
+        case TEX_FILTER_KAISER:
+            // WIC does not implement these filters
             return false;
 
         default:
@@ -849,6 +926,53 @@ namespace
 #endif // WIN32
 
 
+    //-------------------------------------------------------------------------------------
+    // Multithreading for custom filtering (TEX_FILTER_PARALLEL)
+    //
+    // Each task writes a disjoint part of a level and only reads levels that are already
+    // complete, so the result is the same for any thread count.
+    //-------------------------------------------------------------------------------------
+    constexpr size_t MIP_BAND_PIXELS = 16384;
+
+    inline size_t GetMipThreads(TEX_FILTER_FLAGS filter, size_t maxThreads) noexcept
+    {
+        return (filter & TEX_FILTER_PARALLEL) ? maxThreads : 1;
+    }
+
+    // Rows per task when splitting a level of the given width and height
+    inline size_t GetMipBandRows(TEX_FILTER_FLAGS filter, size_t width, size_t height) noexcept
+    {
+        if (!(filter & TEX_FILTER_PARALLEL))
+            return std::max<size_t>(height, 1);
+
+        return std::max<size_t>(MIP_BAND_PIXELS / std::max<size_t>(width, 1), 1);
+    }
+
+    // Runs gen(item, filter) for each array item. Items run in parallel when there are enough of
+    // them to occupy every thread, otherwise one at a time so each can split its own levels.
+    template<class Fn>
+    HRESULT Generate2DMipsItems(size_t items, TEX_FILTER_FLAGS filter, size_t maxThreads, Fn gen) noexcept
+    {
+        if ((filter & TEX_FILTER_PARALLEL) && items > 1 && items >= GetWorkerThreadCount(maxThreads, UINT32_MAX))
+        {
+            const TEX_FILTER_FLAGS itemFilter = filter & ~TEX_FILTER_PARALLEL;
+            return ParallelFor(items, maxThreads,
+                [&](size_t item) -> HRESULT
+                {
+                    return gen(item, itemFilter);
+                });
+        }
+
+        for (size_t item = 0; item < items; ++item)
+        {
+            const HRESULT hr = gen(item, filter);
+            if (FAILED(hr))
+                return hr;
+        }
+
+        return S_OK;
+    }
+
     //-------------------------------------------------------------------------------------
     // Generate (1D/2D) mip-map helpers (custom filtering)
     //-------------------------------------------------------------------------------------
@@ -991,204 +1115,810 @@ namespace
     }
 
 
-    //--- 2D Box Filter ---
-    HRESULT Generate2DMipsBoxFilter(size_t levels, TEX_FILTER_FLAGS filter, const ScratchImage& mipChain, size_t item) noexcept
-    {
-        using namespace DirectX::Filters;
-
-        if (!mipChain.GetImages())
-            return E_INVALIDARG;
+    //--- 2D Box Filter (tiled) ---
+    // With power-of-two sizes each destination texel of a box filter depends on exactly one 2x2
+    // source block, so a TxT tile of one level determines the matching tiles of the next log2(T)
+    // levels. Each tile is loaded once and reduced in float; every level is stored from the tile,
+    // and the last level of each pass is kept in float as the source of the next pass. This reads
+    // the base image once and avoids re-quantizing the intermediate levels.
+    constexpr size_t MIP_TILE_SIZE = 64;
+    constexpr size_t MIP_TILE_LEVELS = 6;
+    static_assert((size_t(1) << MIP_TILE_LEVELS) == MIP_TILE_SIZE, "Mip tile size mismatch");
 
-        // This assumes that the base image is already placed into the mipChain at the top level... (see _Setup2DMips)
+    bool IsTiledBoxFormat(DXGI_FORMAT format) noexcept
+    {
+        // Tiles are read and written at arbitrary pixel offsets within a row
+        return !IsPacked(format) && (BitsPerPixel(format) % 8) == 0;
+    }
 
-        assert(levels > 1);
+    template<class T>
+    struct BoxTileSource
+    {
+        const Image*    image;  // Source level in the mip chain, or...
+        const T*        pixels; // ...pixels left by the previous pass
+        size_t          width;
+        size_t          height;
+    };
+
+    // Stores a tile that is k levels below the tile at (tx, ty) of the source level
+    HRESULT StoreBoxTile(
+        _Inout_updates_all_(width * height) XMVECTOR* tile,
+        size_t width,
+        size_t height,
+        size_t tx,
+        size_t ty,
+        size_t level,
+        size_t k,
+        TEX_FILTER_FLAGS filter,
+        const ScratchImage& mipChain,
+        size_t item) noexcept
+    {
+        const Image* dest = mipChain.GetImage(level, item, 0);
+        if (!dest)
+            return E_POINTER;
 
-        size_t width = mipChain.GetMetadata().width;
-        size_t height = mipChain.GetMetadata().height;
+        const size_t bpp = BitsPerPixel(dest->format) / 8;
 
-        if (!ispow2(width) || !ispow2(height))
-            return E_FAIL;
+        uint8_t* pDest = dest->pixels + (ty >> k) * dest->rowPitch + (tx >> k) * bpp;
+        for (size_t y = 0; y < height; ++y)
+        {
+            if (!StoreScanlineLinear(pDest, width * bpp, dest->format, tile + y * width, width, filter))
+                return E_FAIL;
+            pDest += dest->rowPitch;
+        }
 
-        // Allocate temporary space (3 scanlines)
-        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 3);
-        if (!scanline)
-            return E_OUTOFMEMORY;
+        return S_OK;
+    }
 
-        XMVECTOR* target = scanline.get();
+    // Generates levels [level + 1, level + tileLevels] for the tile at (tx, ty) of the source level
+    HRESULT GenerateBoxTile(
+        _In_ const BoxTileSource<XMVECTOR>& src,
+        size_t tx,
+        size_t ty,
+        size_t level,
+        size_t tileLevels,
+        TEX_FILTER_FLAGS filter,
+        const ScratchImage& mipChain,
+        size_t item,
+        _Out_writes_opt_(carryWidth * carryHeight) XMVECTOR* carry,
+        size_t carryWidth,
+        _Inout_updates_all_(MIP_TILE_SIZE * MIP_TILE_SIZE * 2) XMVECTOR* scratch) noexcept
+    {
+        using namespace DirectX::Filters;
 
-        XMVECTOR* urow0 = target + width;
-        XMVECTOR* urow1 = target + width * 2;
+        size_t width = std::min(MIP_TILE_SIZE, src.width);
+        size_t height = std::min(MIP_TILE_SIZE, src.height);
 
-        const XMVECTOR* urow2 = urow0 + 1;
-        const XMVECTOR* urow3 = urow1 + 1;
+        XMVECTOR* tile = scratch;
+        XMVECTOR* target = scratch + MIP_TILE_SIZE * MIP_TILE_SIZE;
 
-        // Resize base image to each target mip level
-        for (size_t level = 1; level < levels; ++level)
+        // Load tile
+        if (src.image)
         {
-            if (height <= 1)
+            const size_t bpp = BitsPerPixel(src.image->format) / 8;
+            const uint8_t* pSrc = src.image->pixels + ty * src.image->rowPitch + tx * bpp;
+            for (size_t y = 0; y < height; ++y)
             {
-                urow1 = urow0;
+                if (!LoadScanlineLinear(tile + y * width, width, pSrc, width * bpp, src.image->format, filter))
+                    return E_FAIL;
+                pSrc += src.image->rowPitch;
             }
-
-            if (width <= 1)
+        }
+        else
+        {
+            for (size_t y = 0; y < height; ++y)
             {
-                urow2 = urow0;
-                urow3 = urow1;
+                memcpy(tile + y * width, src.pixels + (ty + y) * src.width + tx, sizeof(XMVECTOR) * width);
             }
+        }
 
-            // 2D box filter
-            const Image* src = mipChain.GetImage(level - 1, item, 0);
-            const Image* dest = mipChain.GetImage(level, item, 0);
-
-            if (!src || !dest)
-                return E_POINTER;
-
-            const uint8_t* pSrc = src->pixels;
-            uint8_t* pDest = dest->pixels;
-
-            const size_t rowPitch = src->rowPitch;
-
+        for (size_t k = 1; k <= tileLevels; ++k)
+        {
             const size_t nwidth = (width > 1) ? (width >> 1) : 1;
             const size_t nheight = (height > 1) ? (height >> 1) : 1;
 
+            // 2D box filter (same operand order as Generate2DMipsBoxFilter)
             for (size_t y = 0; y < nheight; ++y)
             {
-                if (!LoadScanlineLinear(urow0, width, pSrc, rowPitch, src->format, filter))
-                    return E_FAIL;
-                pSrc += rowPitch;
-
-                if (urow0 != urow1)
-                {
-                    if (!LoadScanlineLinear(urow1, width, pSrc, rowPitch, src->format, filter))
-                        return E_FAIL;
-                    pSrc += rowPitch;
-                }
+                const XMVECTOR* urow0 = tile + (y << 1) * width;
+                const XMVECTOR* urow1 = (height > 1) ? (urow0 + width) : urow0;
+                const XMVECTOR* urow2 = (width > 1) ? (urow0 + 1) : urow0;
+                const XMVECTOR* urow3 = (width > 1) ? (urow1 + 1) : urow1;
 
+                XMVECTOR* dest = target + y * nwidth;
                 for (size_t x = 0; x < nwidth; ++x)
                 {
                     const size_t x2 = x << 1;
 
-                    AVERAGE4(target[x], urow0[x2], urow1[x2], urow2[x2], urow3[x2])
+                    AVERAGE4(dest[x], urow0[x2], urow1[x2], urow2[x2], urow3[x2])
                 }
+            }
 
-                if (!StoreScanlineLinear(pDest, dest->rowPitch, dest->format, target, nwidth, filter))
-                    return E_FAIL;
-                pDest += dest->rowPitch;
+            // StoreScanlineLinear may modify its source, so a level is stored once the next one is done
+            if (k > 1)
+            {
+                const HRESULT hr = StoreBoxTile(tile, width, height, tx, ty, level + k - 1, k - 1, filter, mipChain, item);
+                if (FAILED(hr))
+                    return hr;
             }
 
-            if (height > 1)
-                height >>= 1;
+            std::swap(tile, target);
+            width = nwidth;
+            height = nheight;
+        }
 
-            if (width > 1)
-                width >>= 1;
+        if (carry)
+        {
+            const size_t dx = tx >> tileLevels;
+            const size_t dy = ty >> tileLevels;
+            for (size_t y = 0; y < height; ++y)
+            {
+                memcpy(carry + (dy + y) * carryWidth + dx, tile + y * width, sizeof(XMVECTOR) * width);
+            }
         }
 
-        return S_OK;
+        return StoreBoxTile(tile, width, height, tx, ty, level + tileLevels, tileLevels, filter, mipChain, item);
     }
 
-
-    //--- 2D Linear Filter ---
-    HRESULT Generate2DMipsLinearFilter(size_t levels, TEX_FILTER_FLAGS filter, const ScratchImage& mipChain, size_t item) noexcept
+    struct FloatBoxTiler
     {
-        using namespace DirectX::Filters;
+        using value_type = XMVECTOR;
+        using buffer_type = ScopedAlignedArrayXMVECTOR;
 
-        if (!mipChain.GetImages())
-            return E_INVALIDARG;
+        TEX_FILTER_FLAGS filter;
 
-        // This assumes that the base image is already placed into the mipChain at the top level... (see _Setup2DMips)
+        buffer_type Allocate(uint64_t pixels) const noexcept
+        {
+            return make_AlignedArrayXMVECTOR(pixels);
+        }
 
-        assert(levels > 1);
+        HRESULT operator()(const BoxTileSource<XMVECTOR>& src, size_t tx, size_t ty, size_t level, size_t tileLevels,
+            const ScratchImage& mipChain, size_t item, XMVECTOR* carry, size_t carryWidth, XMVECTOR* scratch) const noexcept
+        {
+            return GenerateBoxTile(src, tx, ty, level, tileLevels, filter, mipChain, item, carry, carryWidth, scratch);
+        }
+    };
+
+    //--- 2D Box Filter (tiled, integer) ---
+    // 8-bit and 16-bit UNORM channels are expanded to 16-bit fixed point (0..65535) and the tile is
+    // reduced with integer sums: level k of a pass is the rounded sum of 4^k texels shifted down by 2k,
+    // which fits 32 bits for the MIP_TILE_LEVELS levels of a pass. sRGB values are linearized through
+    // a table on load and re-encoded with exact rounding thresholds on store. The result is within one
+    // unit of the float path. Every format rounds to nearest; this intentionally differs from the float
+    // path for R8, R8G8 and A8, whose StoreScanline truncates, so those levels can come out one unit higher.
+    struct IntBoxFormat
+    {
+        size_t  channels;   // 1, 2, or 4
+        size_t  bytes;      // 1 or 2 bytes per channel
+        bool    srgbIn;     // RGB channels are sRGB on load (4 x 8-bit only)
+        bool    srgbOut;    // RGB channels are sRGB on store (4 x 8-bit only)
+    };
 
-        size_t width = mipChain.GetMetadata().width;
-        size_t height = mipChain.GetMetadata().height;
+    bool GetIntBoxFormat(DXGI_FORMAT format, TEX_FILTER_FLAGS filter, IntBoxFormat& info) noexcept
+    {
+        info = {};
 
-        // Allocate temporary space (3 scanlines, plus X and Y filters)
-        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 3);
-        if (!scanline)
-            return E_OUTOFMEMORY;
+        switch (format)
+        {
+        case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+        case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+            filter |= TEX_FILTER_SRGB;
+            info.channels = 4;
+            info.bytes = 1;
+            break;
 
-        std::unique_ptr<LinearFilter[]> lf(new (std::nothrow) LinearFilter[width + height]);
-        if (!lf)
-            return E_OUTOFMEMORY;
+        case DXGI_FORMAT_R8G8B8A8_UNORM:
+        case DXGI_FORMAT_B8G8R8A8_UNORM:
+            info.channels = 4;
+            info.bytes = 1;
+            break;
 
-        LinearFilter* lfX = lf.get();
-        LinearFilter* lfY = lf.get() + width;
+        case DXGI_FORMAT_R8G8_UNORM:
+            info.channels = 2;
+            info.bytes = 1;
+            break;
 
-        XMVECTOR* target = scanline.get();
+        case DXGI_FORMAT_R8_UNORM:
+            info.channels = 1;
+            info.bytes = 1;
+            break;
 
-        XMVECTOR* row0 = target + width;
-        XMVECTOR* row1 = target + width * 2;
+        case DXGI_FORMAT_A8_UNORM:
+            // Never treated as sRGB
+            filter &= ~TEX_FILTER_SRGB;
+            info.channels = 1;
+            info.bytes = 1;
+            break;
 
-        // Resize base image to each target mip level
-        for (size_t level = 1; level < levels; ++level)
-        {
-            // 2D linear filter
-            const Image* src = mipChain.GetImage(level - 1, item, 0);
-            const Image* dest = mipChain.GetImage(level, item, 0);
+        case DXGI_FORMAT_R16G16B16A16_UNORM:
+            info.channels = 4;
+            info.bytes = 2;
+            break;
 
-            if (!src || !dest)
-                return E_POINTER;
+        case DXGI_FORMAT_R16G16_UNORM:
+            info.channels = 2;
+            info.bytes = 2;
+            break;
 
-            const uint8_t* pSrc = src->pixels;
-            uint8_t* pDest = dest->pixels;
+        case DXGI_FORMAT_R16_UNORM:
+            info.channels = 1;
+            info.bytes = 2;
+            break;
 
-            const size_t rowPitch = src->rowPitch;
+        default:
+            return false;
+        }
 
-            const size_t nwidth = (width > 1) ? (width >> 1) : 1;
-            CreateLinearFilter(width, nwidth, (filter & TEX_FILTER_WRAP_U) != 0, lfX);
+        info.srgbIn = (filter & TEX_FILTER_SRGB_IN) != 0;
+        info.srgbOut = (filter & TEX_FILTER_SRGB_OUT) != 0;
 
-            const size_t nheight = (height > 1) ? (height >> 1) : 1;
-            CreateLinearFilter(height, nheight, (filter & TEX_FILTER_WRAP_V) != 0, lfY);
+        // Other formats with sRGB flags use the float path
+        if ((info.srgbIn || info.srgbOut) && (info.channels != 4 || info.bytes != 1))
+            return false;
 
-        #ifdef _DEBUG
-            memset(row0, 0xCD, sizeof(XMVECTOR)*width);
-            memset(row1, 0xDD, sizeof(XMVECTOR)*width);
-        #endif
+        return true;
+    }
 
-            size_t u0 = size_t(-1);
-            size_t u1 = size_t(-1);
+    struct SRGBBoxTables
+    {
+        uint16_t    toLinear[256];  // sRGB byte to linear 16-bit fixed point
+        uint16_t    threshold[256]; // Smallest linear value that rounds to each sRGB byte
+        uint8_t     coarse[4096];   // sRGB byte for (linear >> 4) << 4
+
+        SRGBBoxTables() noexcept
+        {
+            // Same transfer function as XMColorSRGBToRGB
+            auto decode = [](double s) -> double
+                {
+                    return (s <= 0.04045) ? (s / 12.92) : pow((s + 0.055) / 1.055, 2.4);
+                };
+
+            threshold[0] = 0;
+            for (size_t j = 0; j < 256; ++j)
+            {
+                toLinear[j] = static_cast<uint16_t>(decode(double(j) / 255.0) * 65535.0 + 0.5);
+                if (j > 0)
+                {
+                    threshold[j] = static_cast<uint16_t>(ceil(decode((double(j) - 0.5) / 255.0) * 65535.0));
+                }
+            }
+
+            size_t v = 0;
+            for (size_t j = 0; j < 4096; ++j)
+            {
+                while (v < 255 && threshold[v + 1] <= (j << 4))
+                    ++v;
+                coarse[j] = static_cast<uint8_t>(v);
+            }
+        }
+
+        uint8_t Encode(uint32_t u) const noexcept
+        {
+            uint32_t v = coarse[u >> 4];
+            while (v < 255 && u >= threshold[v + 1])
+                ++v;
+            return static_cast<uint8_t>(v);
+        }
+    };
+
+    const SRGBBoxTables& GetSRGBBoxTables() noexcept
+    {
+        static const SRGBBoxTables s_tables;
+        return s_tables;
+    }
+
+    template<size_t C>
+    void LoadIntBoxRow(
+        const IntBoxFormat& fmt,
+        _Out_writes_(count) uint32_t* __restrict pDestination,
+        _In_reads_bytes_(count * fmt.bytes) const uint8_t* __restrict pSource,
+        size_t count) noexcept
+    {
+        if (fmt.bytes == 2)
+        {
+            auto sPtr = reinterpret_cast<const uint16_t * __restrict>(pSource);
+            for (size_t i = 0; i < count; ++i)
+            {
+                pDestination[i] = sPtr[i];
+            }
+        }
+        else if (C == 4 && fmt.srgbIn)
+        {
+            const uint16_t* toLinear = GetSRGBBoxTables().toLinear;
+            for (size_t i = 0; i < count; i += 4)
+            {
+                pDestination[i] = toLinear[pSource[i]];
+                pDestination[i + 1] = toLinear[pSource[i + 1]];
+                pDestination[i + 2] = toLinear[pSource[i + 2]];
+                pDestination[i + 3] = uint32_t(pSource[i + 3]) * 257;
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                pDestination[i] = uint32_t(pSource[i]) * 257;
+            }
+        }
+    }
+
+    template<size_t C>
+    void StoreIntBoxRow(
+        const IntBoxFormat& fmt,
+        _Out_writes_bytes_(count * fmt.bytes) uint8_t* __restrict pDestination,
+        _In_reads_(count) const uint32_t* __restrict pSource,
+        size_t count,
+        uint32_t shift) noexcept
+    {
+        const uint32_t bias = 1u << (shift - 1);
+
+        if (fmt.bytes == 2)
+        {
+            auto dPtr = reinterpret_cast<uint16_t * __restrict>(pDestination);
+            for (size_t i = 0; i < count; ++i)
+            {
+                dPtr[i] = static_cast<uint16_t>((pSource[i] + bias) >> shift);
+            }
+        }
+        else if (C == 4 && fmt.srgbOut)
+        {
+            const SRGBBoxTables& tables = GetSRGBBoxTables();
+            for (size_t i = 0; i < count; i += 4)
+            {
+                pDestination[i] = tables.Encode((pSource[i] + bias) >> shift);
+                pDestination[i + 1] = tables.Encode((pSource[i + 1] + bias) >> shift);
+                pDestination[i + 2] = tables.Encode((pSource[i + 2] + bias) >> shift);
+                pDestination[i + 3] = static_cast<uint8_t>((((pSource[i + 3] + bias) >> shift) * 255 + 32767) / 65535);
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                pDestination[i] = static_cast<uint8_t>((((pSource[i] + bias) >> shift) * 255 + 32767) / 65535);
+            }
+        }
+    }
+
+    // Integer counterpart of GenerateBoxTile; tiles hold C values per pixel
+    template<size_t C>
+    HRESULT GenerateIntBoxTile(
+        const IntBoxFormat& fmt,
+        _In_ const BoxTileSource<uint32_t>& src,
+        size_t tx,
+        size_t ty,
+        size_t level,
+        size_t tileLevels,
+        const ScratchImage& mipChain,
+        size_t item,
+        _Out_writes_opt_(carryWidth * carryHeight * C) uint32_t* carry,
+        size_t carryWidth,
+        _Inout_updates_all_(MIP_TILE_SIZE * MIP_TILE_SIZE * 2 * C) uint32_t* scratch) noexcept
+    {
+        assert(tileLevels > 0 && tileLevels <= MIP_TILE_LEVELS);
+
+        size_t width = std::min(MIP_TILE_SIZE, src.width);
+        size_t height = std::min(MIP_TILE_SIZE, src.height);
+
+        uint32_t* tile = scratch;
+        uint32_t* target = scratch + MIP_TILE_SIZE * MIP_TILE_SIZE * C;
+
+        // Load tile
+        if (src.image)
+        {
+            const uint8_t* pSrc = src.image->pixels + ty * src.image->rowPitch + tx * C * fmt.bytes;
+            for (size_t y = 0; y < height; ++y)
+            {
+                LoadIntBoxRow<C>(fmt, tile + y * width * C, pSrc, width * C);
+                pSrc += src.image->rowPitch;
+            }
+        }
+        else
+        {
+            for (size_t y = 0; y < height; ++y)
+            {
+                memcpy(tile + y * width * C, src.pixels + ((ty + y) * src.width + tx) * C, sizeof(uint32_t) * width * C);
+            }
+        }
+
+        for (size_t k = 1; k <= tileLevels; ++k)
+        {
+            const size_t nwidth = (width > 1) ? (width >> 1) : 1;
+            const size_t nheight = (height > 1) ? (height >> 1) : 1;
+
+            // Unnormalized 2x2 sums; 1-wide dimensions count their texels twice like AVERAGE4
+            for (size_t y = 0; y < nheight; ++y)
+            {
+                const uint32_t* urow0 = tile + (y << 1) * width * C;
+                const uint32_t* urow1 = (height > 1) ? (urow0 + width * C) : urow0;
+
+                uint32_t* dest = target + y * nwidth * C;
+                if (width > 1)
+                {
+                    for (size_t x = 0; x < nwidth; ++x, dest += C, urow0 += 2 * C, urow1 += 2 * C)
+                    {
+                        for (size_t c = 0; c < C; ++c)
+                        {
+                            dest[c] = urow0[c] + urow0[C + c] + urow1[c] + urow1[C + c];
+                        }
+                    }
+                }
+                else
+                {
+                    for (size_t c = 0; c < C; ++c)
+                    {
+                        dest[c] = (urow0[c] + urow1[c]) * 2;
+                    }
+                }
+            }
+
+            std::swap(tile, target);
+            width = nwidth;
+            height = nheight;
+
+            const Image* dest = mipChain.GetImage(level + k, item, 0);
+            if (!dest)
+                return E_POINTER;
+
+            uint8_t* pDest = dest->pixels + (ty >> k) * dest->rowPitch + (tx >> k) * C * fmt.bytes;
+            for (size_t y = 0; y < height; ++y)
+            {
+                StoreIntBoxRow<C>(fmt, pDest, tile + y * width * C, width * C, static_cast<uint32_t>(k * 2));
+                pDest += dest->rowPitch;
+            }
+        }
+
+        if (carry)
+        {
+            const uint32_t shift = static_cast<uint32_t>(tileLevels * 2);
+            const uint32_t bias = 1u << (shift - 1);
+            const size_t dx = tx >> tileLevels;
+            const size_t dy = ty >> tileLevels;
+            for (size_t y = 0; y < height; ++y)
+            {
+                const uint32_t* sPtr = tile + y * width * C;
+                uint32_t* dPtr = carry + ((dy + y) * carryWidth + dx) * C;
+                for (size_t i = 0; i < width * C; ++i)
+                {
+                    dPtr[i] = (sPtr[i] + bias) >> shift;
+                }
+            }
+        }
+
+        return S_OK;
+    }
+
+    struct IntBoxTiler
+    {
+        using value_type = uint32_t;
+        using buffer_type = std::unique_ptr<uint32_t[]>;
+
+        IntBoxFormat fmt;
+
+        buffer_type Allocate(uint64_t pixels) const noexcept
+        {
+            const uint64_t count = pixels * fmt.channels;
+            if (count > SIZE_MAX)
+                return nullptr;
+
+            return buffer_type(new (std::nothrow) uint32_t[static_cast<size_t>(count)]);
+        }
+
+        HRESULT operator()(const BoxTileSource<uint32_t>& src, size_t tx, size_t ty, size_t level, size_t tileLevels,
+            const ScratchImage& mipChain, size_t item, uint32_t* carry, size_t carryWidth, uint32_t* scratch) const noexcept
+        {
+            switch (fmt.channels)
+            {
+            case 1: return GenerateIntBoxTile<1>(fmt, src, tx, ty, level, tileLevels, mipChain, item, carry, carryWidth, scratch);
+            case 2: return GenerateIntBoxTile<2>(fmt, src, tx, ty, level, tileLevels, mipChain, item, carry, carryWidth, scratch);
+            case 4: return GenerateIntBoxTile<4>(fmt, src, tx, ty, level, tileLevels, mipChain, item, carry, carryWidth, scratch);
+            default: return E_UNEXPECTED;
+            }
+        }
+    };
+
+    // Drives a tiler (FloatBoxTiler or IntBoxTiler) over the chain in passes of up to MIP_TILE_LEVELS levels
+    template<class Tiler>
+    HRESULT Generate2DMipsBoxFilterTiled(size_t levels, const Tiler& tiler, TEX_FILTER_FLAGS filter, size_t maxThreads, const ScratchImage& mipChain, size_t item) noexcept
+    {
+        using value_type = typename Tiler::value_type;
+
+        assert(levels > 1);
+
+        size_t width = mipChain.GetMetadata().width;
+        size_t height = mipChain.GetMetadata().height;
+
+        if (!ispow2(width) || !ispow2(height))
+            return E_FAIL;
+
+        const size_t threads = GetMipThreads(filter, maxThreads);
+
+        BoxTileSource<value_type> src = {};
+        src.image = mipChain.GetImage(0, item, 0);
+        if (!src.image)
+            return E_POINTER;
+
+        typename Tiler::buffer_type pixels;
+
+        for (size_t level = 0; level + 1 < levels; )
+        {
+            src.width = width;
+            src.height = height;
+
+            // Once the level fits in one tile, the rest of the chain is done in a single pass
+            size_t tileLevels = levels - 1 - level;
+            if (width > MIP_TILE_SIZE || height > MIP_TILE_SIZE)
+            {
+                tileLevels = std::min(tileLevels, MIP_TILE_LEVELS);
+            }
+
+            const size_t nwidth = std::max<size_t>(width >> tileLevels, 1);
+            const size_t nheight = std::max<size_t>(height >> tileLevels, 1);
+
+            typename Tiler::buffer_type carry;
+            if (level + tileLevels + 1 < levels)
+            {
+                carry = tiler.Allocate(uint64_t(nwidth) * uint64_t(nheight));
+                if (!carry)
+                    return E_OUTOFMEMORY;
+            }
+
+            // Tiles are independent; each task does one row of them
+            const HRESULT hr = ParallelFor((height + MIP_TILE_SIZE - 1) / MIP_TILE_SIZE, threads,
+                [&](size_t j) -> HRESULT
+                {
+                    auto scratch = tiler.Allocate(MIP_TILE_SIZE * MIP_TILE_SIZE * 2);
+                    if (!scratch)
+                        return E_OUTOFMEMORY;
+
+                    for (size_t tx = 0; tx < width; tx += MIP_TILE_SIZE)
+                    {
+                        const HRESULT hrt = tiler(src, tx, j * MIP_TILE_SIZE, level, tileLevels, mipChain, item,
+                            carry.get(), nwidth, scratch.get());
+                        if (FAILED(hrt))
+                            return hrt;
+                    }
+
+                    return S_OK;
+                });
+            if (FAILED(hr))
+                return hr;
+
+            pixels = std::move(carry);
+            src.image = nullptr;
+            src.pixels = pixels.get();
+
+            level += tileLevels;
+            width = nwidth;
+            height = nheight;
+        }
+
+        return S_OK;
+    }
+
+    //--- 2D Box Filter ---
+    HRESULT Generate2DMipsBoxFilter(size_t levels, TEX_FILTER_FLAGS filter, size_t maxThreads, const ScratchImage& mipChain, size_t item) noexcept
+    {
+        using namespace DirectX::Filters;
+
+        if (!mipChain.GetImages())
+            return E_INVALIDARG;
+
+        IntBoxFormat intFormat;
+        if (GetIntBoxFormat(mipChain.GetMetadata().format, filter, intFormat))
+            return Generate2DMipsBoxFilterTiled(levels, IntBoxTiler{ intFormat }, filter, maxThreads, mipChain, item);
+
+        if (IsTiledBoxFormat(mipChain.GetMetadata().format))
+            return Generate2DMipsBoxFilterTiled(levels, FloatBoxTiler{ filter }, filter, maxThreads, mipChain, item);
+
+        // This assumes that the base image is already placed into the mipChain at the top level... (see _Setup2DMips)
+
+        assert(levels > 1);
+
+        size_t width = mipChain.GetMetadata().width;
+        size_t height = mipChain.GetMetadata().height;
+
+        if (!ispow2(width) || !ispow2(height))
+            return E_FAIL;
+
+        // Allocate temporary space (3 scanlines)
+        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 3);
+        if (!scanline)
+            return E_OUTOFMEMORY;
+
+        XMVECTOR* target = scanline.get();
+
+        XMVECTOR* urow0 = target + width;
+        XMVECTOR* urow1 = target + width * 2;
+
+        const XMVECTOR* urow2 = urow0 + 1;
+        const XMVECTOR* urow3 = urow1 + 1;
+
+        // Resize base image to each target mip level
+        for (size_t level = 1; level < levels; ++level)
+        {
+            if (height <= 1)
+            {
+                urow1 = urow0;
+                urow3 = urow1 + 1;
+            }
+
+            if (width <= 1)
+            {
+                urow2 = urow0;
+                urow3 = urow1;
+            }
+
+            // 2D box filter
+            const Image* src = mipChain.GetImage(level - 1, item, 0);
+            const Image* dest = mipChain.GetImage(level, item, 0);
+
+            if (!src || !dest)
+                return E_POINTER;
+
+            const uint8_t* pSrc = src->pixels;
+            uint8_t* pDest = dest->pixels;
+
+            const size_t rowPitch = src->rowPitch;
+
+            const size_t nwidth = (width > 1) ? (width >> 1) : 1;
+            const size_t nheight = (height > 1) ? (height >> 1) : 1;
 
             for (size_t y = 0; y < nheight; ++y)
             {
-                auto const& toY = lfY[y];
+                if (!LoadScanlineLinear(urow0, width, pSrc, rowPitch, src->format, filter))
+                    return E_FAIL;
+                pSrc += rowPitch;
+
+                if (urow0 != urow1)
+                {
+                    if (!LoadScanlineLinear(urow1, width, pSrc, rowPitch, src->format, filter))
+                        return E_FAIL;
+                    pSrc += rowPitch;
+                }
+
+                for (size_t x = 0; x < nwidth; ++x)
+                {
+                    const size_t x2 = x << 1;
+
+                    AVERAGE4(target[x], urow0[x2], urow1[x2], urow2[x2], urow3[x2])
+                }
+
+                if (!StoreScanlineLinear(pDest, dest->rowPitch, dest->format, target, nwidth, filter))
+                    return E_FAIL;
+                pDest += dest->rowPitch;
+            }
+
+            if (height > 1)
+                height >>= 1;
+
+            if (width > 1)
+                width >>= 1;
+        }
+
+        return S_OK;
+    }
+
+
+    //--- 2D Linear Filter ---
+    HRESULT Generate2DMipsLinearFilter(size_t levels, TEX_FILTER_FLAGS filter, size_t maxThreads, const ScratchImage& mipChain, size_t item) noexcept
+    {
+        using namespace DirectX::Filters;
+
+        if (!mipChain.GetImages())
+            return E_INVALIDARG;
+
+        // This assumes that the base image is already placed into the mipChain at the top level... (see _Setup2DMips)
+
+        assert(levels > 1);
+
+        size_t width = mipChain.GetMetadata().width;
+        size_t height = mipChain.GetMetadata().height;
+
+        // Allocate X and Y filters (each task allocates its own scanlines)
+        std::unique_ptr<LinearFilter[]> lf(new (std::nothrow) LinearFilter[width + height]);
+        if (!lf)
+            return E_OUTOFMEMORY;
+
+        LinearFilter* lfX = lf.get();
+        LinearFilter* lfY = lf.get() + width;
+
+        const size_t threads = GetMipThreads(filter, maxThreads);
+
+        // Resize base image to each target mip level
+        for (size_t level = 1; level < levels; ++level)
+        {
+            // 2D linear filter
+            const Image* src = mipChain.GetImage(level - 1, item, 0);
+            const Image* dest = mipChain.GetImage(level, item, 0);
+
+            if (!src || !dest)
+                return E_POINTER;
+
+            const size_t rowPitch = src->rowPitch;
+
+            const size_t nwidth = (width > 1) ? (width >> 1) : 1;
+            CreateLinearFilter(width, nwidth, (filter & TEX_FILTER_WRAP_U) != 0, lfX);
+
+            const size_t nheight = (height > 1) ? (height >> 1) : 1;
+            CreateLinearFilter(height, nheight, (filter & TEX_FILTER_WRAP_V) != 0, lfY);
+
+            const size_t bandRows = GetMipBandRows(filter, nwidth, nheight);
+
+            const HRESULT hr = ParallelFor((nheight + bandRows - 1) / bandRows, threads,
+                [&](size_t band) -> HRESULT
+                {
+                    // Allocate temporary space (3 scanlines)
+                    auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 3);
+                    if (!scanline)
+                        return E_OUTOFMEMORY;
+
+                    XMVECTOR* target = scanline.get();
+
+                    XMVECTOR* row0 = target + width;
+                    XMVECTOR* row1 = target + width * 2;
+
+                #ifdef _DEBUG
+                    memset(row0, 0xCD, sizeof(XMVECTOR)*width);
+                    memset(row1, 0xDD, sizeof(XMVECTOR)*width);
+                #endif
+
+                    const uint8_t* pSrc = src->pixels;
+
+                    const size_t y0 = band * bandRows;
+                    const size_t y1 = std::min(y0 + bandRows, nheight);
+
+                    uint8_t* pDest = dest->pixels + dest->rowPitch * y0;
+
+                    size_t u0 = size_t(-1);
+                    size_t u1 = size_t(-1);
 
-                if (toY.u0 != u0)
-                {
-                    if (toY.u0 != u1)
+                    for (size_t y = y0; y < y1; ++y)
                     {
-                        u0 = toY.u0;
+                        auto const& toY = lfY[y];
 
-                        if (!LoadScanlineLinear(row0, width, pSrc + (rowPitch * u0), rowPitch, src->format, filter))
-                            return E_FAIL;
-                    }
-                    else
-                    {
-                        u0 = u1;
-                        u1 = size_t(-1);
+                        if (toY.u0 != u0)
+                        {
+                            if (toY.u0 != u1)
+                            {
+                                u0 = toY.u0;
 
-                        std::swap(row0, row1);
-                    }
-                }
+                                if (!LoadScanlineLinear(row0, width, pSrc + (rowPitch * u0), rowPitch, src->format, filter))
+                                    return E_FAIL;
+                            }
+                            else
+                            {
+                                u0 = u1;
+                                u1 = size_t(-1);
 
-                if (toY.u1 != u1)
-                {
-                    u1 = toY.u1;
+                                std::swap(row0, row1);
+                            }
+                        }
 
-                    if (!LoadScanlineLinear(row1, width, pSrc + (rowPitch * u1), rowPitch, src->format, filter))
-                        return E_FAIL;
-                }
+                        if (toY.u1 != u1)
+                        {
+                            u1 = toY.u1;
 
-                for (size_t x = 0; x < nwidth; ++x)
-                {
-                    auto const& toX = lfX[x];
+                            if (!LoadScanlineLinear(row1, width, pSrc + (rowPitch * u1), rowPitch, src->format, filter))
+                                return E_FAIL;
+                        }
 
-                    BILINEAR_INTERPOLATE(target[x], toX, toY, row0, row1)
-                }
+                        for (size_t x = 0; x < nwidth; ++x)
+                        {
+                            auto const& toX = lfX[x];
 
-                if (!StoreScanlineLinear(pDest, dest->rowPitch, dest->format, target, nwidth, filter))
-                    return E_FAIL;
-                pDest += dest->rowPitch;
-            }
+                            BILINEAR_INTERPOLATE(target[x], toX, toY, row0, row1)
+                        }
+
+                        if (!StoreScanlineLinear(pDest, dest->rowPitch, dest->format, target, nwidth, filter))
+                            return E_FAIL;
+                        pDest += dest->rowPitch;
+                    }
+
+                    return S_OK;
+                });
+            if (FAILED(hr))
+                return hr;
 
             if (height > 1)
                 height >>= 1;
@@ -1606,6 +2336,32 @@ namespace
     }
 
 
+    //--- 2D Lanczos/Kaiser Filter ---
+    HRESULT Generate2DMipsSeparable(size_t levels, TEX_FILTER_FLAGS filter, size_t maxThreads, const ScratchImage& mipChain, size_t item) noexcept
+    {
+        if (!mipChain.GetImages())
+            return E_INVALIDARG;
+
+        // This assumes that the base image is already placed into the mipChain at the top level... (see _Setup2DMips)
+
+        assert(levels > 1);
+
+        for (size_t level = 1; level < levels; ++level)
+        {
+            const Image* src = mipChain.GetImage(level - 1, item, 0);
+            const Image* dest = mipChain.GetImage(level, item, 0);
+            if (!src || !dest)
+                return E_POINTER;
+
+            const HRESULT hr = ResizeSeparableFilter(*src, filter, *dest, maxThreads);
+            if (FAILED(hr))
+                return hr;
+        }
+
+        return S_OK;
+    }
+
+
     //-------------------------------------------------------------------------------------
     // Generate volume mip-map helpers
     //-------------------------------------------------------------------------------------
@@ -1816,7 +2572,7 @@ namespace
 
 
     //--- 3D Box Filter ---
-    HRESULT Generate3DMipsBoxFilter(size_t depth, size_t levels, TEX_FILTER_FLAGS filter, const ScratchImage& mipChain) noexcept
+    HRESULT Generate3DMipsBoxFilter(size_t depth, size_t levels, TEX_FILTER_FLAGS filter, size_t maxThreads, const ScratchImage& mipChain) noexcept
     {
         using namespace DirectX::Filters;
 
@@ -1836,147 +2592,138 @@ namespace
         if (!ispow2(width) || !ispow2(height) || !ispow2(depth))
             return E_FAIL;
 
-        // Allocate temporary space (5 scanlines)
-        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 5);
-        if (!scanline)
-            return E_OUTOFMEMORY;
-
-        XMVECTOR* target = scanline.get();
-
-        XMVECTOR* urow0 = target + width;
-        XMVECTOR* urow1 = target + width * 2;
-        XMVECTOR* vrow0 = target + width * 3;
-        XMVECTOR* vrow1 = target + width * 4;
-
-        const XMVECTOR* urow2 = urow0 + 1;
-        const XMVECTOR* urow3 = urow1 + 1;
-        const XMVECTOR* vrow2 = vrow0 + 1;
-        const XMVECTOR* vrow3 = vrow1 + 1;
+        const size_t threads = GetMipThreads(filter, maxThreads);
 
         // Resize base image to each target mip level
         for (size_t level = 1; level < levels; ++level)
         {
-            if (height <= 1)
-            {
-                urow1 = urow0;
-                vrow1 = vrow0;
-            }
-
-            if (width <= 1)
-            {
-                urow2 = urow0;
-                urow3 = urow1;
-                vrow2 = vrow0;
-                vrow3 = vrow1;
-            }
+            const size_t nwidth = (width > 1) ? (width >> 1) : 1;
+            const size_t nheight = (height > 1) ? (height >> 1) : 1;
 
-            if (depth > 1)
-            {
-                // 3D box filter
-                const size_t ndepth = depth >> 1;
+            // Slices of a level are independent; each task does one
+            const size_t ndepth = (depth > 1) ? (depth >> 1) : 1;
 
-                for (size_t slice = 0; slice < ndepth; ++slice)
+            const HRESULT hr = ParallelFor(ndepth, threads,
+                [&](size_t slice) -> HRESULT
                 {
-                    const size_t slicea = std::min<size_t>(slice * 2, depth - 1);
-                    const size_t sliceb = std::min<size_t>(slicea + 1, depth - 1);
+                    // Allocate temporary space (5 scanlines)
+                    auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 5);
+                    if (!scanline)
+                        return E_OUTOFMEMORY;
 
-                    const Image* srca = mipChain.GetImage(level - 1, 0, slicea);
-                    const Image* srcb = mipChain.GetImage(level - 1, 0, sliceb);
-                    const Image* dest = mipChain.GetImage(level, 0, slice);
+                    XMVECTOR* target = scanline.get();
 
-                    if (!srca || !srcb || !dest)
-                        return E_POINTER;
+                    XMVECTOR* urow0 = target + width;
+                    XMVECTOR* urow1 = (height > 1) ? (target + width * 2) : urow0;
+                    XMVECTOR* vrow0 = target + width * 3;
+                    XMVECTOR* vrow1 = (height > 1) ? (target + width * 4) : vrow0;
 
-                    const uint8_t* pSrc1 = srca->pixels;
-                    const uint8_t* pSrc2 = srcb->pixels;
-                    uint8_t* pDest = dest->pixels;
+                    const XMVECTOR* urow2 = (width > 1) ? (urow0 + 1) : urow0;
+                    const XMVECTOR* urow3 = (width > 1) ? (urow1 + 1) : urow1;
+                    const XMVECTOR* vrow2 = (width > 1) ? (vrow0 + 1) : vrow0;
+                    const XMVECTOR* vrow3 = (width > 1) ? (vrow1 + 1) : vrow1;
+
+                    if (depth > 1)
+                    {
+                        // 3D box filter
+                        const size_t slicea = std::min<size_t>(slice * 2, depth - 1);
+                        const size_t sliceb = std::min<size_t>(slicea + 1, depth - 1);
 
-                    const size_t aRowPitch = srca->rowPitch;
-                    const size_t bRowPitch = srcb->rowPitch;
+                        const Image* srca = mipChain.GetImage(level - 1, 0, slicea);
+                        const Image* srcb = mipChain.GetImage(level - 1, 0, sliceb);
+                        const Image* dest = mipChain.GetImage(level, 0, slice);
 
-                    const size_t nwidth = (width > 1) ? (width >> 1) : 1;
-                    const size_t nheight = (height > 1) ? (height >> 1) : 1;
+                        if (!srca || !srcb || !dest)
+                            return E_POINTER;
 
-                    for (size_t y = 0; y < nheight; ++y)
-                    {
-                        if (!LoadScanlineLinear(urow0, width, pSrc1, aRowPitch, srca->format, filter))
-                            return E_FAIL;
-                        pSrc1 += aRowPitch;
+                        const uint8_t* pSrc1 = srca->pixels;
+                        const uint8_t* pSrc2 = srcb->pixels;
+                        uint8_t* pDest = dest->pixels;
 
-                        if (urow0 != urow1)
+                        const size_t aRowPitch = srca->rowPitch;
+                        const size_t bRowPitch = srcb->rowPitch;
+
+                        for (size_t y = 0; y < nheight; ++y)
                         {
-                            if (!LoadScanlineLinear(urow1, width, pSrc1, aRowPitch, srca->format, filter))
+                            if (!LoadScanlineLinear(urow0, width, pSrc1, aRowPitch, srca->format, filter))
                                 return E_FAIL;
                             pSrc1 += aRowPitch;
-                        }
 
-                        if (!LoadScanlineLinear(vrow0, width, pSrc2, bRowPitch, srcb->format, filter))
-                            return E_FAIL;
-                        pSrc2 += bRowPitch;
+                            if (urow0 != urow1)
+                            {
+                                if (!LoadScanlineLinear(urow1, width, pSrc1, aRowPitch, srca->format, filter))
+                                    return E_FAIL;
+                                pSrc1 += aRowPitch;
+                            }
 
-                        if (vrow0 != vrow1)
-                        {
-                            if (!LoadScanlineLinear(vrow1, width, pSrc2, bRowPitch, srcb->format, filter))
+                            if (!LoadScanlineLinear(vrow0, width, pSrc2, bRowPitch, srcb->format, filter))
                                 return E_FAIL;
                             pSrc2 += bRowPitch;
-                        }
 
-                        for (size_t x = 0; x < nwidth; ++x)
-                        {
-                            const size_t x2 = x << 1;
+                            if (vrow0 != vrow1)
+                            {
+                                if (!LoadScanlineLinear(vrow1, width, pSrc2, bRowPitch, srcb->format, filter))
+                                    return E_FAIL;
+                                pSrc2 += bRowPitch;
+                            }
 
-                            AVERAGE8(target[x], urow0[x2], urow1[x2], urow2[x2], urow3[x2],
-                                vrow0[x2], vrow1[x2], vrow2[x2], vrow3[x2])
-                        }
+                            for (size_t x = 0; x < nwidth; ++x)
+                            {
+                                const size_t x2 = x << 1;
 
-                        if (!StoreScanlineLinear(pDest, dest->rowPitch, dest->format, target, nwidth, filter))
-                            return E_FAIL;
-                        pDest += dest->rowPitch;
+                                AVERAGE8(target[x], urow0[x2], urow1[x2], urow2[x2], urow3[x2],
+                                    vrow0[x2], vrow1[x2], vrow2[x2], vrow3[x2])
+                            }
+
+                            if (!StoreScanlineLinear(pDest, dest->rowPitch, dest->format, target, nwidth, filter))
+                                return E_FAIL;
+                            pDest += dest->rowPitch;
+                        }
                     }
-                }
-            }
-            else
-            {
-                // 2D box filter
-                const Image* src = mipChain.GetImage(level - 1, 0, 0);
-                const Image* dest = mipChain.GetImage(level, 0, 0);
+                    else
+                    {
+                        // 2D box filter
+                        const Image* src = mipChain.GetImage(level - 1, 0, 0);
+                        const Image* dest = mipChain.GetImage(level, 0, 0);
 
-                if (!src || !dest)
-                    return E_POINTER;
+                        if (!src || !dest)
+                            return E_POINTER;
 
-                const uint8_t* pSrc = src->pixels;
-                uint8_t* pDest = dest->pixels;
+                        const uint8_t* pSrc = src->pixels;
+                        uint8_t* pDest = dest->pixels;
 
-                const size_t rowPitch = src->rowPitch;
+                        const size_t rowPitch = src->rowPitch;
 
-                const size_t nwidth = (width > 1) ? (width >> 1) : 1;
-                const size_t nheight = (height > 1) ? (height >> 1) : 1;
+                        for (size_t y = 0; y < nheight; ++y)
+                        {
+                            if (!LoadScanlineLinear(urow0, width, pSrc, rowPitch, src->format, filter))
+                                return E_FAIL;
+                            pSrc += rowPitch;
 
-                for (size_t y = 0; y < nheight; ++y)
-                {
-                    if (!LoadScanlineLinear(urow0, width, pSrc, rowPitch, src->format, filter))
-                        return E_FAIL;
-                    pSrc += rowPitch;
+                            if (urow0 != urow1)
+                            {
+                                if (!LoadScanlineLinear(urow1, width, pSrc, rowPitch, src->format, filter))
+                                    return E_FAIL;
+                                pSrc += rowPitch;
+                            }
 
-                    if (urow0 != urow1)
-                    {
-                        if (!LoadScanlineLinear(urow1, width, pSrc, rowPitch, src->format, filter))
-                            return E_FAIL;
-                        pSrc += rowPitch;
-                    }
+                            for (size_t x = 0; x < nwidth; ++x)
+                            {
+                                const size_t x2 = x << 1;
 
-                    for (size_t x = 0; x < nwidth; ++x)
-                    {
-                        const size_t x2 = x << 1;
+                                AVERAGE4(target[x], urow0[x2], urow1[x2], urow2[x2], urow3[x2])
+                            }
 
-                        AVERAGE4(target[x], urow0[x2], urow1[x2], urow2[x2], urow3[x2])
+                            if (!StoreScanlineLinear(pDest, dest->rowPitch, dest->format, target, nwidth, filter))
+                                return E_FAIL;
+                            pDest += dest->rowPitch;
+                        }
                     }
 
-                    if (!StoreScanlineLinear(pDest, dest->rowPitch, dest->format, target, nwidth, filter))
-                        return E_FAIL;
-                    pDest += dest->rowPitch;
-                }
-            }
+                    return S_OK;
+                });
+            if (FAILED(hr))
+                return hr;
 
             if (height > 1)
                 height >>= 1;
@@ -1993,7 +2740,7 @@ namespace
 
 
     //--- 3D Linear Filter ---
-    HRESULT Generate3DMipsLinearFilter(size_t depth, size_t levels, TEX_FILTER_FLAGS filter, const ScratchImage& mipChain) noexcept
+    HRESULT Generate3DMipsLinearFilter(size_t depth, size_t levels, TEX_FILTER_FLAGS filter, size_t maxThreads, const ScratchImage& mipChain) noexcept
     {
         using namespace DirectX::Filters;
 
@@ -2010,11 +2757,7 @@ namespace
         size_t width = mipChain.GetMetadata().width;
         size_t height = mipChain.GetMetadata().height;
 
-        // Allocate temporary space (5 scanlines, plus X/Y/Z filters)
-        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 5);
-        if (!scanline)
-            return E_OUTOFMEMORY;
-
+        // Allocate X/Y/Z filters (each task allocates its own scanlines)
         std::unique_ptr<LinearFilter[]> lf(new (std::nothrow) LinearFilter[width + height + depth]);
         if (!lf)
             return E_OUTOFMEMORY;
@@ -2023,12 +2766,7 @@ namespace
         LinearFilter* lfY = lf.get() + width;
         LinearFilter* lfZ = lf.get() + width + height;
 
-        XMVECTOR* target = scanline.get();
-
-        XMVECTOR* urow0 = target + width;
-        XMVECTOR* urow1 = target + width * 2;
-        XMVECTOR* vrow0 = target + width * 3;
-        XMVECTOR* vrow1 = target + width * 4;
+        const size_t threads = GetMipThreads(filter, maxThreads);
 
         // Resize base image to each target mip level
         for (size_t level = 1; level < levels; ++level)
@@ -2039,142 +2777,163 @@ namespace
             const size_t nheight = (height > 1) ? (height >> 1) : 1;
             CreateLinearFilter(height, nheight, (filter & TEX_FILTER_WRAP_V) != 0, lfY);
 
-        #ifdef _DEBUG
-            memset(urow0, 0xCD, sizeof(XMVECTOR)*width);
-            memset(urow1, 0xDD, sizeof(XMVECTOR)*width);
-            memset(vrow0, 0xED, sizeof(XMVECTOR)*width);
-            memset(vrow1, 0xFD, sizeof(XMVECTOR)*width);
-        #endif
-
+            // Slices of a level are independent; each task does one
+            const size_t ndepth = (depth > 1) ? (depth >> 1) : 1;
             if (depth > 1)
             {
-                // 3D linear filter
-                const size_t ndepth = depth >> 1;
                 CreateLinearFilter(depth, ndepth, (filter & TEX_FILTER_WRAP_W) != 0, lfZ);
+            }
 
-                for (size_t slice = 0; slice < ndepth; ++slice)
+            const HRESULT hr = ParallelFor(ndepth, threads,
+                [&](size_t slice) -> HRESULT
                 {
-                    auto const& toZ = lfZ[slice];
-
-                    const Image* srca = mipChain.GetImage(level - 1, 0, toZ.u0);
-                    const Image* srcb = mipChain.GetImage(level - 1, 0, toZ.u1);
-                    if (!srca || !srcb)
-                        return E_POINTER;
-
-                    size_t u0 = size_t(-1);
-                    size_t u1 = size_t(-1);
-
-                    const Image* dest = mipChain.GetImage(level, 0, slice);
-                    if (!dest)
-                        return E_POINTER;
-
-                    uint8_t* pDest = dest->pixels;
-
-                    for (size_t y = 0; y < nheight; ++y)
+                    // Allocate temporary space (5 scanlines)
+                    auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 5);
+                    if (!scanline)
+                        return E_OUTOFMEMORY;
+
+                    XMVECTOR* target = scanline.get();
+
+                    XMVECTOR* urow0 = target + width;
+                    XMVECTOR* urow1 = target + width * 2;
+                    XMVECTOR* vrow0 = target + width * 3;
+                    XMVECTOR* vrow1 = target + width * 4;
+
+                #ifdef _DEBUG
+                    memset(urow0, 0xCD, sizeof(XMVECTOR)*width);
+                    memset(urow1, 0xDD, sizeof(XMVECTOR)*width);
+                    memset(vrow0, 0xED, sizeof(XMVECTOR)*width);
+                    memset(vrow1, 0xFD, sizeof(XMVECTOR)*width);
+                #endif
+
+                    if (depth > 1)
                     {
-                        auto const& toY = lfY[y];
-
-                        if (toY.u0 != u0)
-                        {
-                            if (toY.u0 != u1)
-                            {
-                                u0 = toY.u0;
+                        // 3D linear filter
+                        auto const& toZ = lfZ[slice];
 
-                                if (!LoadScanlineLinear(urow0, width, srca->pixels + (srca->rowPitch * u0), srca->rowPitch, srca->format, filter)
-                                    || !LoadScanlineLinear(vrow0, width, srcb->pixels + (srcb->rowPitch * u0), srcb->rowPitch, srcb->format, filter))
-                                    return E_FAIL;
-                            }
-                            else
-                            {
-                                u0 = u1;
-                                u1 = size_t(-1);
+                        const Image* srca = mipChain.GetImage(level - 1, 0, toZ.u0);
+                        const Image* srcb = mipChain.GetImage(level - 1, 0, toZ.u1);
+                        if (!srca || !srcb)
+                            return E_POINTER;
 
-                                std::swap(urow0, urow1);
-                                std::swap(vrow0, vrow1);
-                            }
-                        }
+                        size_t u0 = size_t(-1);
+                        size_t u1 = size_t(-1);
 
-                        if (toY.u1 != u1)
-                        {
-                            u1 = toY.u1;
+                        const Image* dest = mipChain.GetImage(level, 0, slice);
+                        if (!dest)
+                            return E_POINTER;
 
-                            if (!LoadScanlineLinear(urow1, width, srca->pixels + (srca->rowPitch * u1), srca->rowPitch, srca->format, filter)
-                                || !LoadScanlineLinear(vrow1, width, srcb->pixels + (srcb->rowPitch * u1), srcb->rowPitch, srcb->format, filter))
-                                return E_FAIL;
-                        }
+                        uint8_t* pDest = dest->pixels;
 
-                        for (size_t x = 0; x < nwidth; ++x)
+                        for (size_t y = 0; y < nheight; ++y)
                         {
-                            auto const& toX = lfX[x];
-
-                            TRILINEAR_INTERPOLATE(target[x], toX, toY, toZ, urow0, urow1, vrow0, vrow1)
-                        }
+                            auto const& toY = lfY[y];
 
-                        if (!StoreScanlineLinear(pDest, dest->rowPitch, dest->format, target, nwidth, filter))
-                            return E_FAIL;
-                        pDest += dest->rowPitch;
-                    }
-                }
-            }
-            else
-            {
-                // 2D linear filter
-                const Image* src = mipChain.GetImage(level - 1, 0, 0);
-                const Image* dest = mipChain.GetImage(level, 0, 0);
+                            if (toY.u0 != u0)
+                            {
+                                if (toY.u0 != u1)
+                                {
+                                    u0 = toY.u0;
 
-                if (!src || !dest)
-                    return E_POINTER;
+                                    if (!LoadScanlineLinear(urow0, width, srca->pixels + (srca->rowPitch * u0), srca->rowPitch, srca->format, filter)
+                                        || !LoadScanlineLinear(vrow0, width, srcb->pixels + (srcb->rowPitch * u0), srcb->rowPitch, srcb->format, filter))
+                                        return E_FAIL;
+                                }
+                                else
+                                {
+                                    u0 = u1;
+                                    u1 = size_t(-1);
 
-                const uint8_t* pSrc = src->pixels;
-                uint8_t* pDest = dest->pixels;
+                                    std::swap(urow0, urow1);
+                                    std::swap(vrow0, vrow1);
+                                }
+                            }
 
-                const size_t rowPitch = src->rowPitch;
+                            if (toY.u1 != u1)
+                            {
+                                u1 = toY.u1;
 
-                size_t u0 = size_t(-1);
-                size_t u1 = size_t(-1);
+                                if (!LoadScanlineLinear(urow1, width, srca->pixels + (srca->rowPitch * u1), srca->rowPitch, srca->format, filter)
+                                    || !LoadScanlineLinear(vrow1, width, srcb->pixels + (srcb->rowPitch * u1), srcb->rowPitch, srcb->format, filter))
+                                    return E_FAIL;
+                            }
 
-                for (size_t y = 0; y < nheight; ++y)
-                {
-                    auto const& toY = lfY[y];
+                            for (size_t x = 0; x < nwidth; ++x)
+                            {
+                                auto const& toX = lfX[x];
 
-                    if (toY.u0 != u0)
-                    {
-                        if (toY.u0 != u1)
-                        {
-                            u0 = toY.u0;
+                                TRILINEAR_INTERPOLATE(target[x], toX, toY, toZ, urow0, urow1, vrow0, vrow1)
+                            }
 
-                            if (!LoadScanlineLinear(urow0, width, pSrc + (rowPitch * u0), rowPitch, src->format, filter))
+                            if (!StoreScanlineLinear(pDest, dest->rowPitch, dest->format, target, nwidth, filter))
                                 return E_FAIL;
+                            pDest += dest->rowPitch;
                         }
-                        else
+                    }
+                    else
+                    {
+                        // 2D linear filter
+                        const Image* src = mipChain.GetImage(level - 1, 0, 0);
+                        const Image* dest = mipChain.GetImage(level, 0, 0);
+
+                        if (!src || !dest)
+                            return E_POINTER;
+
+                        const uint8_t* pSrc = src->pixels;
+                        uint8_t* pDest = dest->pixels;
+
+                        const size_t rowPitch = src->rowPitch;
+
+                        size_t u0 = size_t(-1);
+                        size_t u1 = size_t(-1);
+
+                        for (size_t y = 0; y < nheight; ++y)
                         {
-                            u0 = u1;
-                            u1 = size_t(-1);
+                            auto const& toY = lfY[y];
 
-                            std::swap(urow0, urow1);
-                        }
-                    }
+                            if (toY.u0 != u0)
+                            {
+                                if (toY.u0 != u1)
+                                {
+                                    u0 = toY.u0;
 
-                    if (toY.u1 != u1)
-                    {
-                        u1 = toY.u1;
+                                    if (!LoadScanlineLinear(urow0, width, pSrc + (rowPitch * u0), rowPitch, src->format, filter))
+                                        return E_FAIL;
+                                }
+                                else
+                                {
+                                    u0 = u1;
+                                    u1 = size_t(-1);
 
-                        if (!LoadScanlineLinear(urow1, width, pSrc + (rowPitch * u1), rowPitch, src->format, filter))
-                            return E_FAIL;
-                    }
+                                    std::swap(urow0, urow1);
+                                }
+                            }
 
-                    for (size_t x = 0; x < nwidth; ++x)
-                    {
-                        auto const& toX = lfX[x];
+                            if (toY.u1 != u1)
+                            {
+                                u1 = toY.u1;
+
+                                if (!LoadScanlineLinear(urow1, width, pSrc + (rowPitch * u1), rowPitch, src->format, filter))
+                                    return E_FAIL;
+                            }
+
+                            for (size_t x = 0; x < nwidth; ++x)
+                            {
+                                auto const& toX = lfX[x];
+
+                                BILINEAR_INTERPOLATE(target[x], toX, toY, urow0, urow1)
+                            }
 
-                        BILINEAR_INTERPOLATE(target[x], toX, toY, urow0, urow1)
+                            if (!StoreScanlineLinear(pDest, dest->rowPitch, dest->format, target, nwidth, filter))
+                                return E_FAIL;
+                            pDest += dest->rowPitch;
+                        }
                     }
 
-                    if (!StoreScanlineLinear(pDest, dest->rowPitch, dest->format, target, nwidth, filter))
-                        return E_FAIL;
-                    pDest += dest->rowPitch;
-                }
-            }
+                    return S_OK;
+                });
+            if (FAILED(hr))
+                return hr;
 
             if (height > 1)
                 height >>= 1;
@@ -2818,6 +3577,88 @@ namespace
 
         return S_OK;
     }
+
+
+    //--- 3D Lanczos/Kaiser Filter ---
+    // Two passes of ResizeSeparableFilter per level: each slice is resized to the new width and height
+    // into a linear float volume, then each row of that volume, seen as an image whose rows are the
+    // slices, is resized to the new depth
+    HRESULT Generate3DMipsSeparable(size_t depth, size_t levels, TEX_FILTER_FLAGS filter, size_t maxThreads, const ScratchImage& mipChain) noexcept
+    {
+        if (!depth || !mipChain.GetImages())
+            return E_INVALIDARG;
+
+        if (depth > INT16_MAX)
+            return E_INVALIDARG;
+
+        // This assumes that the base images are already placed into the mipChain at the top level... (see _Setup3DMips)
+
+        assert(levels > 1);
+
+        const size_t threads = GetMipThreads(filter, maxThreads);
+        filter &= ~TEX_FILTER_PARALLEL;
+
+        size_t width = mipChain.GetMetadata().width;
+        size_t height = mipChain.GetMetadata().height;
+
+        for (size_t level = 1; level < levels; ++level)
+        {
+            const size_t nwidth = (width > 1) ? (width >> 1) : 1;
+            const size_t nheight = (height > 1) ? (height >> 1) : 1;
+            const size_t ndepth = (depth > 1) ? (depth >> 1) : 1;
+
+            ScratchImage temp;
+            HRESULT hr = temp.Initialize3D(DXGI_FORMAT_R32G32B32A32_FLOAT, nwidth, nheight, depth, 1);
+            if (FAILED(hr))
+                return hr;
+
+            hr = ParallelFor(depth, threads,
+                [&](size_t slice) -> HRESULT
+                {
+                    const Image* src = mipChain.GetImage(level - 1, 0, slice);
+                    if (!src)
+                        return E_POINTER;
+
+                    return ResizeSeparableFilter(*src, filter & ~TEX_FILTER_SRGB_OUT, *temp.GetImage(0, 0, slice), 1);
+                });
+            if (FAILED(hr))
+                return hr;
+
+            const Image* tsrc = temp.GetImage(0, 0, 0);
+            const Image* dest = mipChain.GetImage(level, 0, 0);
+            if (!dest)
+                return E_POINTER;
+
+            // Slices of a level are consecutive in a ScratchImage
+            assert(ndepth == 1 || mipChain.GetImage(level, 0, 1)->pixels == dest->pixels + dest->slicePitch);
+
+            hr = ParallelFor(nheight, threads,
+                [&](size_t y) -> HRESULT
+                {
+                    Image src = *tsrc;
+                    src.height = depth;
+                    src.rowPitch = tsrc->slicePitch;
+                    src.slicePitch = tsrc->slicePitch * depth;
+                    src.pixels = tsrc->pixels + y * tsrc->rowPitch;
+
+                    Image target = *dest;
+                    target.height = ndepth;
+                    target.rowPitch = dest->slicePitch;
+                    target.slicePitch = dest->slicePitch * ndepth;
+                    target.pixels = dest->pixels + y * dest->rowPitch;
+
+                    return ResizeSeparableFilter(src, filter & ~TEX_FILTER_SRGB_IN, target, 1);
+                });
+            if (FAILED(hr))
+                return hr;
+
+            width = nwidth;
+            height = nheight;
+            depth = ndepth;
+        }
+
+        return S_OK;
+    }
 }
 
 
@@ -2835,6 +3676,18 @@ HRESULT DirectX::GenerateMipMaps(
     size_t levels,
     ScratchImage& mipChain,
     bool allow1D) noexcept
+{
+    return GenerateMipMaps(baseImage, filter, levels, 0, mipChain, allow1D);
+}
+
+_Use_decl_annotations_
+HRESULT DirectX::GenerateMipMaps(
+    const Image& baseImage,
+    TEX_FILTER_FLAGS filter,
+    size_t levels,
+    size_t maxThreads,
+    ScratchImage& mipChain,
+    bool allow1D) noexcept
 {
     if (!IsValid(baseImage.format))
         return E_INVALIDARG;
@@ -2969,7 +3822,7 @@ HRESULT DirectX::GenerateMipMaps(
             if (FAILED(hr))
                 return hr;
 
-            hr = Generate2DMipsBoxFilter(levels, filter, mipChain, 0);
+            hr = Generate2DMipsBoxFilter(levels, filter, maxThreads, mipChain, 0);
             if (FAILED(hr))
                 mipChain.Release();
             return hr;
@@ -2989,7 +3842,7 @@ HRESULT DirectX::GenerateMipMaps(
             if (FAILED(hr))
                 return hr;
 
-            hr = Generate2DMipsLinearFilter(levels, filter, mipChain, 0);
+            hr = Generate2DMipsLinearFilter(levels, filter, maxThreads, mipChain, 0);
             if (FAILED(hr))
                 mipChain.Release();
             return hr;
@@ -3014,6 +3867,17 @@ HRESULT DirectX::GenerateMipMaps(
                 mipChain.Release();
             return hr;
 
+        case TEX_FILTER_LANCZOS:
+        case TEX_FILTER_KAISER:
+            hr = Setup2DMips(&baseImage, 1, mdata, mipChain);
+            if (FAILED(hr))
+                return hr;
+
+            hr = Generate2DMipsSeparable(levels, filter, maxThreads, mipChain, 0);
+            if (FAILED(hr))
+                mipChain.Release();
+            return hr;
+
         default:
             return HRESULT_E_NOT_SUPPORTED;
         }
@@ -3028,6 +3892,19 @@ HRESULT DirectX::GenerateMipMaps(
     TEX_FILTER_FLAGS filter,
     size_t levels,
     ScratchImage& mipChain)
+{
+    return GenerateMipMaps(srcImages, nimages, metadata, filter, levels, 0, mipChain);
+}
+
+_Use_decl_annotations_
+HRESULT DirectX::GenerateMipMaps(
+    const Image* srcImages,
+    size_t nimages,
+    const TexMetadata& metadata,
+    TEX_FILTER_FLAGS filter,
+    size_t levels,
+    size_t maxThreads,
+    ScratchImage& mipChain)
 {
     if (!srcImages || !nimages || !IsValid(metadata.format))
         return E_INVALIDARG;
@@ -3184,12 +4061,13 @@ HRESULT DirectX::GenerateMipMaps(
             if (FAILED(hr))
                 return hr;
 
-            for (size_t item = 0; item < metadata.arraySize; ++item)
-            {
-                hr = Generate2DMipsBoxFilter(levels, filter, mipChain, item);
-                if (FAILED(hr))
-                    mipChain.Release();
-            }
+            hr = Generate2DMipsItems(metadata.arraySize, filter, maxThreads,
+                [&](size_t item, TEX_FILTER_FLAGS itemFilter) -> HRESULT
+                {
+                    return Generate2DMipsBoxFilter(levels, itemFilter, maxThreads, mipChain, item);
+                });
+            if (FAILED(hr))
+                mipChain.Release();
             return hr;
 
         case TEX_FILTER_POINT:
@@ -3197,12 +4075,13 @@ HRESULT DirectX::GenerateMipMaps(
             if (FAILED(hr))
                 return hr;
 
-            for (size_t item = 0; item < metadata.arraySize; ++item)
-            {
-                hr = Generate2DMipsPointFilter(levels, mipChain, item);
-                if (FAILED(hr))
-                    mipChain.Release();
-            }
+            hr = Generate2DMipsItems(metadata.arraySize, filter, maxThreads,
+                [&](size_t item, TEX_FILTER_FLAGS) -> HRESULT
+                {
+                    return Generate2DMipsPointFilter(levels, mipChain, item);
+                });
+            if (FAILED(hr))
+                mipChain.Release();
             return hr;
 
         case TEX_FILTER_LINEAR:
@@ -3210,12 +4089,13 @@ HRESULT DirectX::GenerateMipMaps(
             if (FAILED(hr))
                 return hr;
 
-            for (size_t item = 0; item < metadata.arraySize; ++item)
-            {
-                hr = Generate2DMipsLinearFilter(levels, filter, mipChain, item);
-                if (FAILED(hr))
-                    mipChain.Release();
-            }
+            hr = Generate2DMipsItems(metadata.arraySize, filter, maxThreads,
+                [&](size_t item, TEX_FILTER_FLAGS itemFilter) -> HRESULT
+                {
+                    return Generate2DMipsLinearFilter(levels, itemFilter, maxThreads, mipChain, item);
+                });
+            if (FAILED(hr))
+                mipChain.Release();
             return hr;
 
         case TEX_FILTER_CUBIC:
@@ -3223,12 +4103,13 @@ HRESULT DirectX::GenerateMipMaps(
             if (FAILED(hr))
                 return hr;
 
-            for (size_t item = 0; item < metadata.arraySize; ++item)
-            {
-                hr = Generate2DMipsCubicFilter(levels, filter, mipChain, item);
-                if (FAILED(hr))
-                    mipChain.Release();
-            }
+            hr = Generate2DMipsItems(metadata.arraySize, filter, maxThreads,
+                [&](size_t item, TEX_FILTER_FLAGS itemFilter) -> HRESULT
+                {
+                    return Generate2DMipsCubicFilter(levels, itemFilter, mipChain, item);
+                });
+            if (FAILED(hr))
+                mipChain.Release();
             return hr;
 
         case TEX_FILTER_TRIANGLE:
@@ -3236,12 +4117,28 @@ HRESULT DirectX::GenerateMipMaps(
             if (FAILED(hr))
                 return hr;
 
-            for (size_t item = 0; item < metadata.arraySize; ++item)
-            {
-                hr = Generate2DMipsTriangleFilter(levels, filter, mipChain, item);
-                if (FAILED(hr))
-                    mipChain.Release();
-            }
+            hr = Generate2DMipsItems(metadata.arraySize, filter, maxThreads,
+                [&](size_t item, TEX_FILTER_FLAGS itemFilter) -> HRESULT
+                {
+                    return Generate2DMipsTriangleFilter(levels, itemFilter, mipChain, item);
+                });
+            if (FAILED(hr))
+                mipChain.Release();
+            return hr;
+
+        case TEX_FILTER_LANCZOS:
+        case TEX_FILTER_KAISER:
+            hr = Setup2DMips(&baseImages[0], metadata.arraySize, mdata2, mipChain);
+            if (FAILED(hr))
+                return hr;
+
+            hr = Generate2DMipsItems(metadata.arraySize, filter, maxThreads,
+                [&](size_t item, TEX_FILTER_FLAGS itemFilter) -> HRESULT
+                {
+                    return Generate2DMipsSeparable(levels, itemFilter, maxThreads, mipChain, item);
+                });
+            if (FAILED(hr))
+                mipChain.Release();
             return hr;
 
         default:
@@ -3261,6 +4158,18 @@ HRESULT DirectX::GenerateMipMaps3D(
     TEX_FILTER_FLAGS filter,
     size_t levels,
     ScratchImage& mipChain) noexcept
+{
+    return GenerateMipMaps3D(baseImages, depth, filter, levels, 0, mipChain);
+}
+
+_Use_decl_annotations_
+HRESULT DirectX::GenerateMipMaps3D(
+    const Image* baseImages,
+    size_t depth,
+    TEX_FILTER_FLAGS filter,
+    size_t levels,
+    size_t maxThreads,
+    ScratchImage& mipChain) noexcept
 {
     if (!baseImages || !depth)
         return E_INVALIDARG;
@@ -3314,7 +4223,7 @@ HRESULT DirectX::GenerateMipMaps3D(
         if (FAILED(hr))
             return hr;
 
-        hr = Generate3DMipsBoxFilter(depth, levels, filter, mipChain);
+        hr = Generate3DMipsBoxFilter(depth, levels, filter, maxThreads, mipChain);
         if (FAILED(hr))
             mipChain.Release();
         return hr;
@@ -3334,7 +4243,7 @@ HRESULT DirectX::GenerateMipMaps3D(
         if (FAILED(hr))
             return hr;
 
-        hr = Generate3DMipsLinearFilter(depth, levels, filter, mipChain);
+        hr = Generate3DMipsLinearFilter(depth, levels, filter, maxThreads, mipChain);
         if (FAILED(hr))
             mipChain.Release();
         return hr;
@@ -3359,6 +4268,17 @@ HRESULT DirectX::GenerateMipMaps3D(
             mipChain.Release();
         return hr;
 
+    case TEX_FILTER_LANCZOS:
+    case TEX_FILTER_KAISER:
+        hr = Setup3DMips(baseImages, depth, levels, mipChain);
+        if (FAILED(hr))
+            return hr;
+
+        hr = Generate3DMipsSeparable(depth, levels, filter, maxThreads, mipChain);
+        if (FAILED(hr))
+            mipChain.Release();
+        return hr;
+
     default:
         return HRESULT_E_NOT_SUPPORTED;
     }
@@ -3372,6 +4292,19 @@ HRESULT DirectX::GenerateMipMaps3D(
     TEX_FILTER_FLAGS filter,
     size_t levels,
     ScratchImage& mipChain)
+{
+    return GenerateMipMaps3D(srcImages, nimages, metadata, filter, levels, 0, mipChain);
+}
+
+_Use_decl_annotations_
+HRESULT DirectX::GenerateMipMaps3D(
+    const Image* srcImages,
+    size_t nimages,
+    const TexMetadata& metadata,
+    TEX_FILTER_FLAGS filter,
+    size_t levels,
+    size_t maxThreads,
+    ScratchImage& mipChain)
 {
     if (!srcImages || !nimages || !IsValid(metadata.format))
         return E_INVALIDARG;
@@ -3433,7 +4366,7 @@ HRESULT DirectX::GenerateMipMaps3D(
         if (FAILED(hr))
             return hr;
 
-        hr = Generate3DMipsBoxFilter(metadata.depth, levels, filter, mipChain);
+        hr = Generate3DMipsBoxFilter(metadata.depth, levels, filter, maxThreads, mipChain);
         if (FAILED(hr))
             mipChain.Release();
         return hr;
@@ -3453,7 +4386,7 @@ HRESULT DirectX::GenerateMipMaps3D(
         if (FAILED(hr))
             return hr;
 
-        hr = Generate3DMipsLinearFilter(metadata.depth, levels, filter, mipChain);
+        hr = Generate3DMipsLinearFilter(metadata.depth, levels, filter, maxThreads, mipChain);
         if (FAILED(hr))
             mipChain.Release();
         return hr;
@@ -3478,6 +4411,17 @@ HRESULT DirectX::GenerateMipMaps3D(
             mipChain.Release();
         return hr;
 
+    case TEX_FILTER_LANCZOS:
+    case TEX_FILTER_KAISER:
+        hr = Setup3DMips(&baseImages[0], metadata.depth, levels, mipChain);
+        if (FAILED(hr))
+            return hr;
+
+        hr = Generate3DMipsSeparable(metadata.depth, levels, filter, maxThreads, mipChain);
+        if (FAILED(hr))
+            mipChain.Release();
+        return hr;
+
     default:
         return HRESULT_E_NOT_SUPPORTED;
     }
@@ -3490,6 +4434,7 @@ HRESULT DirectX::ScaleMipMapsAlphaForCoverage(
     const TexMetadata& metadata,
     size_t item,
     float alphaReference,
+    TEX_FILTER_FLAGS filter,
     ScratchImage& mipChain) noexcept
 {
     if (!srcImages || !nimages || !IsValid(metadata.format) || nimages > metadata.mipLevels || !mipChain.GetImages())
@@ -3505,11 +4450,71 @@ HRESULT DirectX::ScaleMipMapsAlphaForCoverage(
         return E_FAIL;
     }
 
-    float targetCoverage = 0.0f;
-    HRESULT hr = CalculateAlphaCoverage(srcImages[0], alphaReference, 1.0f, targetCoverage);
+    if (metadata.mipLevels > nimages)
+        return E_FAIL;
+
+    const size_t maxThreads = (filter & TEX_FILTER_PARALLEL) ? 0 : 1;
+
+    // Bands of each level (levels are split the same way for the histograms and for scaling)
+    std::unique_ptr<size_t[]> firstBand(new (std::nothrow) size_t[metadata.mipLevels + 1]);
+    std::unique_ptr<AlphaCoverageHistogram[]> histograms(new (std::nothrow) AlphaCoverageHistogram[metadata.mipLevels]);
+    if (!firstBand || !histograms)
+        return E_OUTOFMEMORY;
+
+    memset(histograms.get(), 0, sizeof(AlphaCoverageHistogram) * metadata.mipLevels);
+
+    firstBand[0] = 0;
+    for (size_t level = 0; level < metadata.mipLevels; ++level)
+    {
+        firstBand[level + 1] = firstBand[level] + (srcImages[level].height + COVERAGE_BAND_ROWS - 1) / COVERAGE_BAND_ROWS;
+    }
+
+    auto getBand = [&](size_t band, size_t& level) -> size_t
+        {
+            level = 0;
+            while (band >= firstBand[level + 1])
+                ++level;
+            return (band - firstBand[level]) * COVERAGE_BAND_ROWS;
+        };
+
+    // Threshold histograms for every level at once; the quads of a band reach one row into the next band
+    std::mutex mutex;
+    HRESULT hr = ParallelFor(firstBand[metadata.mipLevels], maxThreads,
+        [&](size_t band) -> HRESULT
+        {
+            size_t level;
+            const size_t y = getBand(band, level);
+
+            Image rows = srcImages[level];
+            rows.pixels += y * rows.rowPitch;
+            rows.height = std::min(rows.height - y, COVERAGE_BAND_ROWS + 1);
+
+            std::unique_ptr<AlphaCoverageHistogram> local(new (std::nothrow) AlphaCoverageHistogram);
+            if (!local)
+                return E_OUTOFMEMORY;
+
+            memset(local.get(), 0, sizeof(AlphaCoverageHistogram));
+
+            const HRESULT hrb = AccumulateAlphaCoverage(rows, alphaReference, *local);
+            if (FAILED(hrb))
+                return hrb;
+
+            const std::lock_guard<std::mutex> lock(mutex);
+
+            AlphaCoverageHistogram& histogram = histograms[level];
+            for (size_t j = 0; j <= COVERAGE_BINS; ++j)
+            {
+                histogram.bins[j] += local->bins[j];
+            }
+            histogram.total += local->total;
+
+            return S_OK;
+        });
     if (FAILED(hr))
         return hr;
 
+    const float targetCoverage = histograms[0].GetCoverage(static_cast<size_t>(COVERAGE_BIN_SCALE));
+
     // Copy base image
     {
         const Image& src = srcImages[0];
@@ -3533,24 +4538,36 @@ HRESULT DirectX::ScaleMipMapsAlphaForCoverage(
         }
     }
 
+    std::unique_ptr<float[]> alphaScales(new (std::nothrow) float[metadata.mipLevels]);
+    if (!alphaScales)
+        return E_OUTOFMEMORY;
+
     for (size_t level = 1; level < metadata.mipLevels; ++level)
     {
-        if (level >= nimages)
-            return E_FAIL;
-
-        float alphaScale = 0.0f;
-        hr = EstimateAlphaScaleForCoverage(srcImages[level], alphaReference, targetCoverage, alphaScale);
-        if (FAILED(hr))
-            return hr;
-
         const Image* mipImage = mipChain.GetImage(level, item, 0);
         if (!mipImage)
             return E_POINTER;
 
-        hr = ScaleAlpha(srcImages[level], alphaScale, *mipImage);
-        if (FAILED(hr))
-            return hr;
+        if (mipImage->width != srcImages[level].width || mipImage->height != srcImages[level].height)
+            return E_FAIL;
+
+        alphaScales[level] = EstimateAlphaScaleForCoverage(histograms[level], targetCoverage);
     }
 
-    return S_OK;
+    return ParallelFor(firstBand[metadata.mipLevels] - firstBand[1], maxThreads,
+        [&](size_t band) -> HRESULT
+        {
+            size_t level;
+            const size_t y = getBand(band + firstBand[1], level);
+
+            Image src = srcImages[level];
+            src.pixels += y * src.rowPitch;
+            src.height = std::min(src.height - y, COVERAGE_BAND_ROWS);
+
+            Image dest = *mipChain.GetImage(level, item, 0);
+            dest.pixels += y * dest.rowPitch;
+            dest.height = src.height;
+
+            return ScaleAlpha(src, alphaScales[level], dest);
+        });
 }
@@ -141,20 +141,24 @@
 #endif
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cctype>
+#include <cmath>
+#include <condition_variable>
 #include <cstdlib>
 #include <ctime>
 #include <cstring>
 #include <iterator>
 #include <memory>
+#include <mutex>
 #include <new>
+#include <thread>
 #include <tuple>
 
 #ifndef _WIN32
 #include <fstream>
 #include <filesystem>
-#include <thread>
 #endif
 
 #define _XM_NO_XMVECTOR_OVERLOADS_
@@ -438,6 +442,14 @@ namespace DirectX
             _Inout_updates_all_(count) XMVECTOR* pBuffer, _In_ size_t count,
             _In_ DXGI_FORMAT outFormat, _In_ DXGI_FORMAT inFormat, _In_ TEX_FILTER_FLAGS flags) noexcept;
 
+        //---------------------------------------------------------------------------------
+        // Resize helper functions
+        HRESULT __cdecl ResizeSeparableFilter(
+            _In_ const Image& srcImage, _In_ TEX_FILTER_FLAGS filter, _In_ const Image& destImage,
+            _In_ size_t maxThreads) noexcept;
+            // Custom filter resize for BOX, LINEAR, CUBIC, TRIANGLE, LANCZOS and KAISER modes; formats must match
+            // maxThreads limits the thread count for TEX_FILTER_PARALLEL; 0 uses all hardware threads
+
         //---------------------------------------------------------------------------------
         // Misc helper functions
         bool __cdecl IsAlphaAllOpaqueBC(_In_ const Image& cImage) noexcept;
@@ -445,6 +457,17 @@ namespace DirectX
         bool __cdecl CalculateMipLevels3D(_In_ size_t width, _In_ size_t height, _In_ size_t depth,
             _Inout_ size_t& mipLevels) noexcept;
 
+        //---------------------------------------------------------------------------------
+        // Task scheduler
+        size_t __cdecl GetWorkerThreadCount(_In_ size_t maxThreads, _In_ size_t taskCount) noexcept;
+            // maxThreads of 0 uses all hardware threads
+
+        HRESULT __cdecl ParallelFor(_In_ size_t count, _In_ size_t maxThreads,
+            _In_ const std::function<HRESULT __cdecl(size_t)>& task) noexcept;
+            // Runs task(0..count-1) on a work-stealing pool of up to maxThreads threads (including the caller);
+            // the first failing HRESULT stops further tasks from starting and is returned. Worker threads are
+            // kept alive between calls; calls made from inside a task run serially on the calling thread.
+
     #ifdef _WIN32
         HRESULT __cdecl ResizeSeparateColorAndAlpha(_In_ IWICImagingFactory* pWIC,
             _In_ bool iswic2,
@@ -231,7 +231,9 @@ namespace
             break;
 
         case TEX_FILTER_TRIANGLE:
-            // WIC does not implement this filter
+        case TEX_FILTER_LANCZOS:
+        case TEX_FILTER_KAISER:
+            // WIC does not implement these filters
             return false;
 
         default:
@@ -252,11 +254,57 @@ namespace
     //-------------------------------------------------------------------------------------
 
     //--- Point Filter ---
+    // Texels are copied as they are when each pixel is a whole number of bytes, which matches the WIC
+    // scaler; other formats go through LoadScanline/StoreScanline
+
+    // Bytes per pixel for a direct copy, or 0
+    size_t GetPointCopySize(DXGI_FORMAT format) noexcept
+    {
+        if (IsCompressed(format) || IsPacked(format) || IsPlanar(format))
+            return 0;
+
+        const size_t bpp = BitsPerPixel(format);
+        return (bpp % 8) ? 0 : (bpp / 8);
+    }
+
+    void CopyPointRow(
+        _In_ const uint8_t* pSource,
+        _Out_writes_bytes_(width * texelSize) uint8_t* pDestination,
+        size_t width,
+        size_t xinc,
+        size_t texelSize) noexcept
+    {
+        size_t sx = 0;
+        for (size_t x = 0; x < width; ++x)
+        {
+            memcpy(pDestination, pSource + (sx >> 16) * texelSize, texelSize);
+            pDestination += texelSize;
+            sx += xinc;
+        }
+    }
+
     HRESULT ResizePointFilter(const Image& srcImage, const Image& destImage) noexcept
     {
         assert(srcImage.pixels && destImage.pixels);
         assert(srcImage.format == destImage.format);
 
+        const size_t xinc = (srcImage.width << 16) / destImage.width;
+        const size_t yinc = (srcImage.height << 16) / destImage.height;
+
+        const size_t texelSize = GetPointCopySize(srcImage.format);
+        if (texelSize)
+        {
+            size_t sy = 0;
+            for (size_t y = 0; y < destImage.height; ++y)
+            {
+                CopyPointRow(srcImage.pixels + srcImage.rowPitch * (sy >> 16), destImage.pixels + destImage.rowPitch * y,
+                    destImage.width, xinc, texelSize);
+                sy += yinc;
+            }
+
+            return S_OK;
+        }
+
         // Allocate temporary space (2 scanlines)
         auto scanline = make_AlignedArrayXMVECTOR(uint64_t(srcImage.width) + destImage.width);
         if (!scanline)
@@ -275,9 +323,6 @@ namespace
 
         const size_t rowPitch = srcImage.rowPitch;
 
-        const size_t xinc = (srcImage.width << 16) / destImage.width;
-        const size_t yinc = (srcImage.height << 16) / destImage.height;
-
         size_t lasty = size_t(-1);
 
         size_t sy = 0;
@@ -308,495 +353,878 @@ namespace
     }
 
 
-    //--- Box Filter ---
-    HRESULT ResizeBoxFilter(const Image& srcImage, TEX_FILTER_FLAGS filter, const Image& destImage) noexcept
+    //-------------------------------------------------------------------------------------
+    // Separable resampler
+    //
+    // Each axis is reduced to a table with the source taps and weights of every destination
+    // sample. Source rows are filtered horizontally once, as they are loaded, into a small
+    // cache keyed by source row; each destination row is then a weighted sum of cached rows.
+    // Bands of destination rows share nothing but the tables, so they can run in parallel.
+    //-------------------------------------------------------------------------------------
+    constexpr double LANCZOS_RADIUS = 3.0;
+    constexpr double KAISER_RADIUS = 3.0;
+    constexpr double KAISER_ALPHA = 4.0;
+
+    constexpr size_t RESIZE_MIN_BAND_ROWS = 16;
+
+    double Sinc(double x) noexcept
     {
-        using namespace DirectX::Filters;
+        if (fabs(x) < 1e-9)
+            return 1.0;
 
-        assert(srcImage.pixels && destImage.pixels);
-        assert(srcImage.format == destImage.format);
+        const double px = 3.14159265358979323846 * x;
+        return sin(px) / px;
+    }
 
-        if (((destImage.width << 1) != srcImage.width) || ((destImage.height << 1) != srcImage.height))
-            return E_FAIL;
+    // Zeroth order modified Bessel function of the first kind
+    double BesselI0(double x) noexcept
+    {
+        double sum = 1.0;
+        double term = 1.0;
+        const double q = x * x * 0.25;
+        for (int k = 1; k < 64 && term > sum * 1e-12; ++k)
+        {
+            term *= q / (double(k) * double(k));
+            sum += term;
+        }
+        return sum;
+    }
 
-        // Allocate temporary space (3 scanlines)
-        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(srcImage.width) * 2 + destImage.width);
-        if (!scanline)
-            return E_OUTOFMEMORY;
+    double LanczosKernel(double x) noexcept
+    {
+        return (fabs(x) < LANCZOS_RADIUS) ? Sinc(x) * Sinc(x / LANCZOS_RADIUS) : 0.0;
+    }
 
-        XMVECTOR* target = scanline.get();
+    double KaiserKernel(double x) noexcept
+    {
+        if (fabs(x) >= KAISER_RADIUS)
+            return 0.0;
 
-        XMVECTOR* urow0 = target + destImage.width;
-        XMVECTOR* urow1 = urow0 + srcImage.width;
+        const double t = x / KAISER_RADIUS;
+        return Sinc(x) * BesselI0(KAISER_ALPHA * sqrt(1.0 - t * t)) / BesselI0(KAISER_ALPHA);
+    }
 
-    #ifdef _DEBUG
-        memset(urow0, 0xCD, sizeof(XMVECTOR)*srcImage.width);
-        memset(urow1, 0xDD, sizeof(XMVECTOR)*srcImage.width);
-    #endif
+    struct ResampleTap
+    {
+        uint32_t    u;
+        float       weight;
+    };
 
-        const XMVECTOR* urow2 = urow0 + 1;
-        const XMVECTOR* urow3 = urow1 + 1;
+    // LINEAR and CUBIC are evaluated with the arithmetic of BILINEAR_INTERPOLATE and CUBIC_INTERPOLATE,
+    // so they produce the same floats as the dedicated filters they replaced
+    enum RESAMPLE_KERNEL
+    {
+        RESAMPLE_GENERIC,   // Weighted sum of the taps
+        RESAMPLE_LINEAR,    // Always two taps
+        RESAMPLE_CUBIC,     // Always four taps (weights unused), interpolated at GetCubicX()
+    };
 
-        const uint8_t* pSrc = srcImage.pixels;
-        uint8_t* pDest = destImage.pixels;
+    class ResampleAxis
+    {
+    public:
+        ResampleAxis() noexcept : m_kernel(RESAMPLE_GENERIC), m_stride(0) {}
 
-        const size_t rowPitch = srcImage.rowPitch;
+        HRESULT Initialize(size_t source, size_t dest, unsigned long mode, bool wrap, bool mirror) noexcept;
 
-        for (size_t y = 0; y < destImage.height; ++y)
+        RESAMPLE_KERNEL GetKernel() const noexcept { return m_kernel; }
+
+        size_t GetMaxTaps() const noexcept { return m_stride; }
+
+        const ResampleTap* GetTaps(size_t u, size_t& count) const noexcept
         {
-            if (!LoadScanlineLinear(urow0, srcImage.width, pSrc, rowPitch, srcImage.format, filter))
-                return E_FAIL;
-            pSrc += rowPitch;
+            count = m_counts[u];
+            return m_taps.get() + u * m_stride;
+        }
 
-            if (urow0 != urow1)
-            {
-                if (!LoadScanlineLinear(urow1, srcImage.width, pSrc, rowPitch, srcImage.format, filter))
-                    return E_FAIL;
-                pSrc += rowPitch;
-            }
+        float GetCubicX(size_t u) const noexcept
+        {
+            assert(m_kernel == RESAMPLE_CUBIC);
+            return m_cubicX[u];
+        }
 
-            for (size_t x = 0; x < destImage.width; ++x)
-            {
-                const size_t x2 = x << 1;
+    private:
+        RESAMPLE_KERNEL                 m_kernel;
+        size_t                          m_stride;
+        std::unique_ptr<uint32_t[]>     m_counts;
+        std::unique_ptr<ResampleTap[]>  m_taps;
+        std::unique_ptr<float[]>        m_cubicX;
 
-                AVERAGE4(target[x], urow0[x2], urow1[x2], urow2[x2], urow3[x2])
+        HRESULT Allocate(size_t dest, size_t stride) noexcept
+        {
+            const uint64_t total = uint64_t(dest) * uint64_t(stride);
+            if (!stride || total > SIZE_MAX / sizeof(ResampleTap))
+                return E_OUTOFMEMORY;
+
+            m_counts.reset(new (std::nothrow) uint32_t[dest]);
+            m_taps.reset(new (std::nothrow) ResampleTap[static_cast<size_t>(total)]);
+            if (!m_counts || !m_taps)
+                return E_OUTOFMEMORY;
+
+            memset(m_counts.get(), 0, sizeof(uint32_t) * dest);
+            m_stride = stride;
+            return S_OK;
+        }
+
+        // Taps that were remapped by wrap/mirror/clamp may repeat an earlier source sample
+        void AddTap(size_t u, size_t src, float weight, bool merge) noexcept
+        {
+            if (weight == 0.f)
+                return;
+
+            ResampleTap* taps = m_taps.get() + u * m_stride;
+            uint32_t& count = m_counts[u];
+
+            if (merge)
+            {
+                for (size_t k = 0; k < count; ++k)
+                {
+                    if (taps[k].u == src)
+                    {
+                        taps[k].weight += weight;
+                        return;
+                    }
+                }
             }
 
-            if (!StoreScanlineLinear(pDest, destImage.rowPitch, destImage.format, target, destImage.width, filter))
-                return E_FAIL;
-            pDest += destImage.rowPitch;
+            assert(count < m_stride);
+            taps[count].u = static_cast<uint32_t>(src);
+            taps[count].weight = weight;
+            ++count;
         }
 
-        return S_OK;
-    }
+        // Fixed tap slot k, kept even when it repeats a source sample or has no weight
+        void SetTap(size_t u, size_t k, size_t src, float weight) noexcept
+        {
+            assert(k < m_stride);
+            ResampleTap* taps = m_taps.get() + u * m_stride;
+            taps[k].u = static_cast<uint32_t>(src);
+            taps[k].weight = weight;
+            m_counts[u] = std::max(m_counts[u], static_cast<uint32_t>(k + 1));
+        }
 
+        HRESULT InitializeKernel(size_t source, size_t dest, unsigned long mode, bool wrap, bool mirror) noexcept;
+        HRESULT InitializeTriangle(size_t source, size_t dest, bool wrap) noexcept;
+    };
 
-    //--- Linear Filter ---
-    HRESULT ResizeLinearFilter(const Image& srcImage, TEX_FILTER_FLAGS filter, const Image& destImage) noexcept
+    _Use_decl_annotations_
+    HRESULT ResampleAxis::Initialize(size_t source, size_t dest, unsigned long mode, bool wrap, bool mirror) noexcept
     {
         using namespace DirectX::Filters;
 
-        assert(srcImage.pixels && destImage.pixels);
-        assert(srcImage.format == destImage.format);
+        assert(source > 0 && dest > 0);
 
-        // Allocate temporary space (3 scanlines, plus X and Y filters)
-        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(srcImage.width) * 2 + destImage.width);
-        if (!scanline)
-            return E_OUTOFMEMORY;
+        m_kernel = RESAMPLE_GENERIC;
 
-        std::unique_ptr<LinearFilter[]> lf(new (std::nothrow) LinearFilter[destImage.width + destImage.height]);
-        if (!lf)
-            return E_OUTOFMEMORY;
+        switch (mode)
+        {
+        case TEX_FILTER_POINT:
+            {
+                // Same sample positions as ResizePointFilter
+                const HRESULT hr = Allocate(dest, 1);
+                if (FAILED(hr))
+                    return hr;
 
-        LinearFilter* lfX = lf.get();
-        LinearFilter* lfY = lf.get() + destImage.width;
+                const size_t inc = (source << 16) / dest;
+                for (size_t u = 0; u < dest; ++u)
+                {
+                    AddTap(u, (u * inc) >> 16, 1.f, false);
+                }
+            }
+            return S_OK;
 
-        CreateLinearFilter(srcImage.width, destImage.width, (filter & TEX_FILTER_WRAP_U) != 0, lfX);
-        CreateLinearFilter(srcImage.height, destImage.height, (filter & TEX_FILTER_WRAP_V) != 0, lfY);
+        case TEX_FILTER_LINEAR:
+            {
+                // Same sample positions and weights as Generate2DMipsLinearFilter
+                std::unique_ptr<LinearFilter[]> lf(new (std::nothrow) LinearFilter[dest]);
+                if (!lf)
+                    return E_OUTOFMEMORY;
 
-        XMVECTOR* target = scanline.get();
+                CreateLinearFilter(source, dest, wrap, lf.get());
 
-        XMVECTOR* row0 = target + destImage.width;
-        XMVECTOR* row1 = row0 + srcImage.width;
+                const HRESULT hr = Allocate(dest, 2);
+                if (FAILED(hr))
+                    return hr;
 
-    #ifdef _DEBUG
-        memset(row0, 0xCD, sizeof(XMVECTOR)*srcImage.width);
-        memset(row1, 0xDD, sizeof(XMVECTOR)*srcImage.width);
-    #endif
+                for (size_t u = 0; u < dest; ++u)
+                {
+                    SetTap(u, 0, lf[u].u0, lf[u].weight0);
+                    SetTap(u, 1, lf[u].u1, lf[u].weight1);
+                }
 
-        const uint8_t* pSrc = srcImage.pixels;
-        uint8_t* pDest = destImage.pixels;
+                m_kernel = RESAMPLE_LINEAR;
+            }
+            return S_OK;
 
-        const size_t rowPitch = srcImage.rowPitch;
+        case TEX_FILTER_CUBIC:
+            {
+                // Same sample positions as Generate2DMipsCubicFilter
+                std::unique_ptr<CubicFilter[]> cf(new (std::nothrow) CubicFilter[dest]);
+                if (!cf)
+                    return E_OUTOFMEMORY;
 
-        size_t u0 = size_t(-1);
-        size_t u1 = size_t(-1);
+                CreateCubicFilter(source, dest, wrap, mirror, cf.get());
 
-        for (size_t y = 0; y < destImage.height; ++y)
+                HRESULT hr = Allocate(dest, 4);
+                if (FAILED(hr))
+                    return hr;
+
+                m_cubicX.reset(new (std::nothrow) float[dest]);
+                if (!m_cubicX)
+                    return E_OUTOFMEMORY;
+
+                for (size_t u = 0; u < dest; ++u)
+                {
+                    SetTap(u, 0, cf[u].u0, 0.f);
+                    SetTap(u, 1, cf[u].u1, 0.f);
+                    SetTap(u, 2, cf[u].u2, 0.f);
+                    SetTap(u, 3, cf[u].u3, 0.f);
+                    m_cubicX[u] = cf[u].x;
+                }
+
+                m_kernel = RESAMPLE_CUBIC;
+            }
+            return S_OK;
+
+        case TEX_FILTER_TRIANGLE:
+            return InitializeTriangle(source, dest, wrap);
+
+        case TEX_FILTER_BOX:
+        case TEX_FILTER_LANCZOS:
+        case TEX_FILTER_KAISER:
+            return InitializeKernel(source, dest, mode, wrap, mirror);
+
+        default:
+            return HRESULT_E_NOT_SUPPORTED;
+        }
+    }
+
+    _Use_decl_annotations_
+    HRESULT ResampleAxis::InitializeKernel(size_t source, size_t dest, unsigned long mode, bool wrap, bool mirror) noexcept
+    {
+        using namespace DirectX::Filters;
+
+        if (source == dest)
         {
-            auto const& toY = lfY[y];
+            // Every kernel here is 1 at 0 and 0 at the other integers, but sin() isn't exact
+            const HRESULT hr = Allocate(dest, 1);
+            if (FAILED(hr))
+                return hr;
 
-            if (toY.u0 != u0)
+            for (size_t u = 0; u < dest; ++u)
             {
-                if (toY.u0 != u1)
-                {
-                    u0 = toY.u0;
+                AddTap(u, u, 1.f, false);
+            }
 
-                    if (!LoadScanlineLinear(row0, srcImage.width, pSrc + (rowPitch * u0), rowPitch, srcImage.format, filter))
-                        return E_FAIL;
-                }
-                else
-                {
-                    u0 = u1;
-                    u1 = size_t(-1);
+            return S_OK;
+        }
+
+        const double scale = double(source) / double(dest);
 
-                    std::swap(row0, row1);
+        if (mode == TEX_FILTER_BOX)
+        {
+            // Area average of the source span covered by each destination sample
+            const HRESULT hr = Allocate(dest, static_cast<size_t>(ceil(scale)) + 1);
+            if (FAILED(hr))
+                return hr;
+
+            for (size_t u = 0; u < dest; ++u)
+            {
+                const double a = double(u) * scale;
+                const double b = std::min(double(u + 1) * scale, double(source));
+                for (auto i = static_cast<size_t>(a); double(i) < b && i < source; ++i)
+                {
+                    const double overlap = std::min(b, double(i + 1)) - std::max(a, double(i));
+                    AddTap(u, i, static_cast<float>(overlap / scale), false);
                 }
             }
 
-            if (toY.u1 != u1)
+            return S_OK;
+        }
+
+        // Windowed sinc, stretched by the downscale factor
+        const double fscale = std::max(scale, 1.0);
+        const double radius = ((mode == TEX_FILTER_KAISER) ? KAISER_RADIUS : LANCZOS_RADIUS) * fscale;
+
+        const HRESULT hr = Allocate(dest, static_cast<size_t>(ceil(radius)) * 2 + 1);
+        if (FAILED(hr))
+            return hr;
+
+        for (size_t u = 0; u < dest; ++u)
+        {
+            const double center = (double(u) + 0.5) * scale - 0.5;
+            const auto first = static_cast<ptrdiff_t>(ceil(center - radius));
+            const auto last = static_cast<ptrdiff_t>(floor(center + radius));
+
+            double total = 0.0;
+            for (ptrdiff_t i = first; i <= last; ++i)
             {
-                u1 = toY.u1;
+                const double x = (double(i) - center) / fscale;
+                total += (mode == TEX_FILTER_KAISER) ? KaiserKernel(x) : LanczosKernel(x);
+            }
 
-                if (!LoadScanlineLinear(row1, srcImage.width, pSrc + (rowPitch * u1), rowPitch, srcImage.format, filter))
-                    return E_FAIL;
+            for (ptrdiff_t i = first; i <= last; ++i)
+            {
+                const double x = (double(i) - center) / fscale;
+                const double w = (mode == TEX_FILTER_KAISER) ? KaiserKernel(x) : LanczosKernel(x);
+                const ptrdiff_t src = bounduvw(i, ptrdiff_t(source) - 1, wrap, mirror);
+                AddTap(u, size_t(src), static_cast<float>(w / total), src != i);
             }
+        }
 
-            for (size_t x = 0; x < destImage.width; ++x)
+        return S_OK;
+    }
+
+    _Use_decl_annotations_
+    HRESULT ResampleAxis::InitializeTriangle(size_t source, size_t dest, bool wrap) noexcept
+    {
+        using namespace DirectX::Filters;
+
+        // CreateTriangleFilter lists the destination samples each source sample contributes to
+        std::unique_ptr<Filter> tf;
+        HRESULT hr = CreateTriangleFilter(source, dest, wrap, tf);
+        if (FAILED(hr))
+            return hr;
+
+        auto fromEnd = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(tf.get()) + tf->sizeInBytes);
+
+        std::unique_ptr<uint32_t[]> counts(new (std::nothrow) uint32_t[dest]);
+        if (!counts)
+            return E_OUTOFMEMORY;
+
+        memset(counts.get(), 0, sizeof(uint32_t) * dest);
+
+        for (const FilterFrom* from = tf->from; from < fromEnd; )
+        {
+            for (size_t j = 0; j < from->count; ++j)
             {
-                auto const& toX = lfX[x];
+                assert(from->to[j].u < dest);
+                ++counts[from->to[j].u];
+            }
 
-                BILINEAR_INTERPOLATE(target[x], toX, toY, row0, row1)
+            from = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(from) + from->sizeInBytes);
+        }
+
+        hr = Allocate(dest, *std::max_element(counts.get(), counts.get() + dest));
+        if (FAILED(hr))
+            return hr;
+
+        size_t u = 0;
+        for (const FilterFrom* from = tf->from; from < fromEnd; ++u)
+        {
+            for (size_t j = 0; j < from->count; ++j)
+            {
+                AddTap(from->to[j].u, u, from->to[j].weight, false);
             }
 
-            if (!StoreScanlineLinear(pDest, destImage.rowPitch, destImage.format, target, destImage.width, filter))
-                return E_FAIL;
-            pDest += destImage.rowPitch;
+            from = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(from) + from->sizeInBytes);
         }
 
         return S_OK;
     }
 
-
-    //--- Cubic Filter ---
 #ifdef __clang__
 #pragma clang diagnostic ignored "-Wextra-semi-stmt"
 #endif
 
-    HRESULT ResizeCubicFilter(const Image& srcImage, TEX_FILTER_FLAGS filter, const Image& destImage) noexcept
+    void ResampleRow(
+        _In_reads_(srcWidth) const XMVECTOR* pSource,
+        size_t srcWidth,
+        _Out_writes_(destWidth) XMVECTOR* pDestination,
+        size_t destWidth,
+        const ResampleAxis& axis) noexcept
     {
         using namespace DirectX::Filters;
 
-        assert(srcImage.pixels && destImage.pixels);
-        assert(srcImage.format == destImage.format);
+        UNREFERENCED_PARAMETER(srcWidth);
 
-        // Allocate temporary space (5 scanlines, plus X and Y filters)
-        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(srcImage.width) * 4 + destImage.width);
-        if (!scanline)
-            return E_OUTOFMEMORY;
+        switch (axis.GetKernel())
+        {
+        case RESAMPLE_LINEAR:
+            for (size_t x = 0; x < destWidth; ++x)
+            {
+                size_t count;
+                const ResampleTap* taps = axis.GetTaps(x, count);
 
-        std::unique_ptr<CubicFilter[]> cf(new (std::nothrow) CubicFilter[destImage.width + destImage.height]);
-        if (!cf)
-            return E_OUTOFMEMORY;
+                assert(count == 2 && taps[0].u < srcWidth && taps[1].u < srcWidth);
+                pDestination[x] = XMVectorAdd(XMVectorScale(pSource[taps[0].u], taps[0].weight),
+                    XMVectorScale(pSource[taps[1].u], taps[1].weight));
+            }
+            break;
 
-        CubicFilter* cfX = cf.get();
-        CubicFilter* cfY = cf.get() + destImage.width;
+        case RESAMPLE_CUBIC:
+            for (size_t x = 0; x < destWidth; ++x)
+            {
+                size_t count;
+                const ResampleTap* taps = axis.GetTaps(x, count);
 
-        CreateCubicFilter(srcImage.width, destImage.width, (filter & TEX_FILTER_WRAP_U) != 0, (filter & TEX_FILTER_MIRROR_U) != 0, cfX);
-        CreateCubicFilter(srcImage.height, destImage.height, (filter & TEX_FILTER_WRAP_V) != 0, (filter & TEX_FILTER_MIRROR_V) != 0, cfY);
+                assert(count == 4);
+                CUBIC_INTERPOLATE(pDestination[x], axis.GetCubicX(x),
+                    pSource[taps[0].u], pSource[taps[1].u], pSource[taps[2].u], pSource[taps[3].u]);
+            }
+            break;
 
-        XMVECTOR* target = scanline.get();
+        default:
+            for (size_t x = 0; x < destWidth; ++x)
+            {
+                size_t count;
+                const ResampleTap* taps = axis.GetTaps(x, count);
 
-        XMVECTOR* row0 = target + destImage.width;
-        XMVECTOR* row1 = row0 + srcImage.width;
-        XMVECTOR* row2 = row0 + srcImage.width * 2;
-        XMVECTOR* row3 = row0 + srcImage.width * 3;
+                assert(count > 0 && taps[0].u < srcWidth);
+                XMVECTOR v = XMVectorScale(pSource[taps[0].u], taps[0].weight);
+                for (size_t k = 1; k < count; ++k)
+                {
+                    assert(taps[k].u < srcWidth);
+                    v = XMVectorMultiplyAdd(pSource[taps[k].u], XMVectorReplicate(taps[k].weight), v);
+                }
 
-    #ifdef _DEBUG
-        memset(row0, 0xCD, sizeof(XMVECTOR)*srcImage.width);
-        memset(row1, 0xDD, sizeof(XMVECTOR)*srcImage.width);
-        memset(row2, 0xED, sizeof(XMVECTOR)*srcImage.width);
-        memset(row3, 0xFD, sizeof(XMVECTOR)*srcImage.width);
-    #endif
+                pDestination[x] = v;
+            }
+            break;
+        }
+    }
 
-        const uint8_t* pSrc = srcImage.pixels;
-        uint8_t* pDest = destImage.pixels;
+    // Need to slightly bias results for floating-point error accumulation which can
+    // be visible with harshly quantized values
+    bool UseResampleBias(TEX_FILTER_FLAGS filter, DXGI_FORMAT format) noexcept
+    {
+        return ((filter & TEX_FILTER_MODE_MASK) == TEX_FILTER_TRIANGLE)
+            && (format == DXGI_FORMAT_R10G10B10A2_UNORM || format == DXGI_FORMAT_R10G10B10A2_UINT);
+    }
 
-        const size_t rowPitch = srcImage.rowPitch;
+    // Filters destination row y vertically from the horizontally filtered rows of its taps
+    void ResampleColumns(
+        _In_ const XMVECTOR* const* rows,
+        const ResampleAxis& axis,
+        size_t y,
+        _Out_writes_(width) XMVECTOR* pDestination,
+        size_t width,
+        bool bias) noexcept
+    {
+        using namespace DirectX::Filters;
 
-        size_t u0 = size_t(-1);
-        size_t u1 = size_t(-1);
-        size_t u2 = size_t(-1);
-        size_t u3 = size_t(-1);
+        size_t count;
+        const ResampleTap* taps = axis.GetTaps(y, count);
+        assert(count > 0);
 
-        for (size_t y = 0; y < destImage.height; ++y)
+        switch (axis.GetKernel())
         {
-            auto const& toY = cfY[y];
+        case RESAMPLE_LINEAR:
+            for (size_t x = 0; x < width; ++x)
+            {
+                pDestination[x] = XMVectorAdd(XMVectorScale(rows[0][x], taps[0].weight),
+                    XMVectorScale(rows[1][x], taps[1].weight));
+            }
+            break;
 
-            // Scanline 1
-            if (toY.u0 != u0)
+        case RESAMPLE_CUBIC:
             {
-                if (toY.u0 != u1 && toY.u0 != u2 && toY.u0 != u3)
+                const float dy = axis.GetCubicX(y);
+                for (size_t x = 0; x < width; ++x)
                 {
-                    u0 = toY.u0;
-
-                    if (!LoadScanlineLinear(row0, srcImage.width, pSrc + (rowPitch * u0), rowPitch, srcImage.format, filter))
-                        return E_FAIL;
+                    CUBIC_INTERPOLATE(pDestination[x], dy, rows[0][x], rows[1][x], rows[2][x], rows[3][x]);
                 }
-                else if (toY.u0 == u1)
-                {
-                    u0 = u1;
-                    u1 = size_t(-1);
+            }
+            break;
 
-                    std::swap(row0, row1);
-                }
-                else if (toY.u0 == u2)
+        default:
+            for (size_t x = 0; x < width; ++x)
+            {
+                XMVECTOR v = XMVectorScale(rows[0][x], taps[0].weight);
+                for (size_t k = 1; k < count; ++k)
                 {
-                    u0 = u2;
-                    u2 = size_t(-1);
-
-                    std::swap(row0, row2);
+                    v = XMVectorMultiplyAdd(rows[k][x], XMVectorReplicate(taps[k].weight), v);
                 }
-                else if (toY.u0 == u3)
-                {
-                    u0 = u3;
-                    u3 = size_t(-1);
 
-                    std::swap(row0, row3);
-                }
+                pDestination[x] = v;
             }
+            break;
+        }
+
+        if (bias)
+        {
+            static const XMVECTORF32 Bias = { { { 0.f, 0.f, 0.f, 0.1f } } };
 
-            // Scanline 2
-            if (toY.u1 != u1)
+            for (size_t x = 0; x < width; ++x)
             {
-                if (toY.u1 != u2 && toY.u1 != u3)
-                {
-                    u1 = toY.u1;
+                pDestination[x] = XMVectorAdd(pDestination[x], Bias);
+            }
+        }
+    }
 
-                    if (!LoadScanlineLinear(row1, srcImage.width, pSrc + (rowPitch * u1), rowPitch, srcImage.format, filter))
-                        return E_FAIL;
-                }
-                else if (toY.u1 == u2)
-                {
-                    u1 = u2;
-                    u2 = size_t(-1);
+    // Resamples destination rows [y0, y1)
+    HRESULT ResampleRows(
+        const Image& srcImage,
+        TEX_FILTER_FLAGS filter,
+        const Image& destImage,
+        const ResampleAxis& axisX,
+        const ResampleAxis& axisY,
+        size_t y0,
+        size_t y1) noexcept
+    {
+        const size_t slots = axisY.GetMaxTaps();
+        const size_t width = destImage.width;
 
-                    std::swap(row1, row2);
-                }
-                else if (toY.u1 == u3)
-                {
-                    u1 = u3;
-                    u3 = size_t(-1);
+        // Temporary space (source scanline, target scanline, and one filtered row per tap)
+        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(srcImage.width) + uint64_t(width) * (uint64_t(slots) + 1));
+        if (!scanline)
+            return E_OUTOFMEMORY;
+
+        std::unique_ptr<size_t[]> slotInfo(new (std::nothrow) size_t[slots * 2]);
+        std::unique_ptr<const XMVECTOR*[]> rows(new (std::nothrow) const XMVECTOR*[slots]);
+        if (!slotInfo || !rows)
+            return E_OUTOFMEMORY;
+
+        XMVECTOR* row = scanline.get();
+        XMVECTOR* target = row + srcImage.width;
+        XMVECTOR* cache = target + width;
+
+        // Source row held by each slot, and the last destination row (plus one) that used it
+        size_t* tags = slotInfo.get();
+        size_t* stamps = tags + slots;
+        for (size_t s = 0; s < slots; ++s)
+        {
+            tags[s] = size_t(-1);
+            stamps[s] = 0;
+        }
+
+        const bool bias = UseResampleBias(filter, destImage.format);
+
+        for (size_t y = y0; y < y1; ++y)
+        {
+            size_t count;
+            const ResampleTap* taps = axisY.GetTaps(y, count);
+            const size_t stamp = y + 1;
 
-                    std::swap(row1, row3);
+            // Rows already in the cache, then load the rest into slots this row doesn't use
+            for (size_t k = 0; k < count; ++k)
+            {
+                rows[k] = nullptr;
+                for (size_t s = 0; s < slots; ++s)
+                {
+                    if (tags[s] == taps[k].u)
+                    {
+                        stamps[s] = stamp;
+                        rows[k] = cache + s * width;
+                        break;
+                    }
                 }
             }
 
-            // Scanline 3
-            if (toY.u2 != u2)
+            size_t slot = 0;
+            for (size_t k = 0; k < count; ++k)
             {
-                if (toY.u2 != u3)
+                // Edge taps of LINEAR and CUBIC can repeat a row this destination row also uses
+                for (size_t j = 0; j < k && !rows[k]; ++j)
                 {
-                    u2 = toY.u2;
-
-                    if (!LoadScanlineLinear(row2, srcImage.width, pSrc + (rowPitch * u2), rowPitch, srcImage.format, filter))
-                        return E_FAIL;
+                    if (taps[j].u == taps[k].u)
+                        rows[k] = rows[j];
                 }
-                else
-                {
-                    u2 = u3;
-                    u3 = size_t(-1);
 
-                    std::swap(row2, row3);
-                }
-            }
+                if (rows[k])
+                    continue;
 
-            // Scanline 4
-            if (toY.u3 != u3)
-            {
-                u3 = toY.u3;
+                while (slot < slots && stamps[slot] == stamp)
+                    ++slot;
 
-                if (!LoadScanlineLinear(row3, srcImage.width, pSrc + (rowPitch * u3), rowPitch, srcImage.format, filter))
-                    return E_FAIL;
-            }
+                if (slot >= slots)
+                    return E_UNEXPECTED;
 
-            for (size_t x = 0; x < destImage.width; ++x)
-            {
-                auto const& toX = cfX[x];
+                const size_t u = taps[k].u;
+                if (u >= srcImage.height)
+                    return E_FAIL;
 
-                XMVECTOR C0, C1, C2, C3;
+                if (!LoadScanlineLinear(row, srcImage.width, srcImage.pixels + srcImage.rowPitch * u, srcImage.rowPitch, srcImage.format, filter))
+                    return E_FAIL;
 
-                CUBIC_INTERPOLATE(C0, toX.x, row0[toX.u0], row0[toX.u1], row0[toX.u2], row0[toX.u3]);
-                CUBIC_INTERPOLATE(C1, toX.x, row1[toX.u0], row1[toX.u1], row1[toX.u2], row1[toX.u3]);
-                CUBIC_INTERPOLATE(C2, toX.x, row2[toX.u0], row2[toX.u1], row2[toX.u2], row2[toX.u3]);
-                CUBIC_INTERPOLATE(C3, toX.x, row3[toX.u0], row3[toX.u1], row3[toX.u2], row3[toX.u3]);
+                XMVECTOR* dest = cache + slot * width;
+                ResampleRow(row, srcImage.width, dest, width, axisX);
 
-                CUBIC_INTERPOLATE(target[x], toY.x, C0, C1, C2, C3);
+                tags[slot] = u;
+                stamps[slot] = stamp;
+                rows[k] = dest;
             }
 
-            if (!StoreScanlineLinear(pDest, destImage.rowPitch, destImage.format, target, destImage.width, filter))
+            ResampleColumns(rows.get(), axisY, y, target, width, bias);
+
+            if (!StoreScanlineLinear(destImage.pixels + destImage.rowPitch * y, destImage.rowPitch, destImage.format, target, width, filter))
                 return E_FAIL;
-            pDest += destImage.rowPitch;
         }
 
         return S_OK;
     }
 
 
-    //--- Triangle Filter ---
-    HRESULT ResizeTriangleFilter(const Image& srcImage, TEX_FILTER_FLAGS filter, const Image& destImage) noexcept
+    //--- Streaming resize ---
+    constexpr bool ispow2(_In_ size_t x) noexcept
     {
-        using namespace DirectX::Filters;
-
-        assert(srcImage.pixels && destImage.pixels);
-        assert(srcImage.format == destImage.format);
+        return ((x != 0) && !(x & (x - 1)));
+    }
 
-        // Allocate initial temporary space (1 scanline, accumulation rows, plus X and Y filters)
-        auto scanline = make_AlignedArrayXMVECTOR(srcImage.width);
-        if (!scanline)
-            return E_OUTOFMEMORY;
+    // Resamples an image whose rows arrive one at a time, top to bottom. Each destination row is
+    // produced as soon as the last source row it needs has arrived, so only the filtered rows that
+    // can still be used are kept: a ring sized to the vertical filter support.
+    class ResampleStream
+    {
+    public:
+        ResampleStream() noexcept :
+            m_format(DXGI_FORMAT_UNKNOWN),
+            m_filter(TEX_FILTER_DEFAULT),
+            m_srcWidth(0),
+            m_srcHeight(0),
+            m_destWidth(0),
+            m_destHeight(0),
+            m_destPitch(0),
+            m_ringRows(0),
+            m_srcRow(0),
+            m_destRow(0),
+            m_texelSize(0),
+            m_xinc(0),
+            m_row(nullptr),
+            m_target(nullptr),
+            m_ring(nullptr),
+            m_bias(false) {}
+
+        HRESULT Initialize(
+            DXGI_FORMAT format,
+            size_t srcWidth, size_t srcHeight,
+            size_t destWidth, size_t destHeight,
+            TEX_FILTER_FLAGS filter) noexcept;
+
+        size_t GetRowPitch() const noexcept { return m_destPitch; }
+
+        // Adds the next source row; emit(pixels, y) is called for each destination row it completes
+        template<class Fn>
+        HRESULT Push(_In_ const uint8_t* pixels, size_t rowPitch, Fn&& emit)
+        {
+            const size_t u = m_srcRow;
+            if (u >= m_srcHeight)
+                return E_UNEXPECTED;
 
-        std::unique_ptr<TriangleRow[]> rowActive(new (std::nothrow) TriangleRow[destImage.height]);
-        if (!rowActive)
-            return E_OUTOFMEMORY;
+            ++m_srcRow;
 
-        TriangleRow * rowFree = nullptr;
+            if (m_texelSize)
+            {
+                // POINT copies texels straight from the source row, like ResizePointFilter
+                while (m_destRow < m_destHeight)
+                {
+                    size_t count;
+                    const ResampleTap* taps = m_axisY.GetTaps(m_destRow, count);
+                    if (taps[0].u > u)
+                        return S_OK;
 
-        std::unique_ptr<Filter> tfX;
-        HRESULT hr = CreateTriangleFilter(srcImage.width, destImage.width, (filter & TEX_FILTER_WRAP_U) != 0, tfX);
-        if (FAILED(hr))
-            return hr;
+                    CopyPointRow(pixels, m_dest.get(), m_destWidth, m_xinc, m_texelSize);
 
-        std::unique_ptr<Filter> tfY;
-        hr = CreateTriangleFilter(srcImage.height, destImage.height, (filter & TEX_FILTER_WRAP_V) != 0, tfY);
-        if (FAILED(hr))
-            return hr;
+                    const HRESULT hr = emit(static_cast<const uint8_t*>(m_dest.get()), m_destRow);
+                    if (FAILED(hr))
+                        return hr;
 
-        XMVECTOR* row = scanline.get();
+                    ++m_destRow;
+                }
 
-    #ifdef _DEBUG
-        memset(row, 0xCD, sizeof(XMVECTOR)*srcImage.width);
-    #endif
+                return S_OK;
+            }
 
-        auto xFromEnd = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(tfX.get()) + tfX->sizeInBytes);
-        auto yFromEnd = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(tfY.get()) + tfY->sizeInBytes);
+            const bool point = (m_filter & TEX_FILTER_MODE_MASK) == TEX_FILTER_POINT;
 
-        // Count times rows get written
-        for (FilterFrom* yFrom = tfY->from; yFrom < yFromEnd; )
-        {
-            for (size_t j = 0; j < yFrom->count; ++j)
+            if (m_needed[u])
             {
-                const size_t v = yFrom->to[j].u;
-                assert(v < destImage.height);
-                ++rowActive[v].remaining;
+                if (point)
+                {
+                    if (!LoadScanline(m_row, m_srcWidth, pixels, rowPitch, m_format))
+                        return E_FAIL;
+                }
+                else if (!LoadScanlineLinear(m_row, m_srcWidth, pixels, rowPitch, m_format, m_filter))
+                    return E_FAIL;
+
+                ResampleRow(m_row, m_srcWidth, m_ring + (u % m_ringRows) * m_destWidth, m_destWidth, m_axisX);
             }
 
-            yFrom = reinterpret_cast<FilterFrom*>(reinterpret_cast<uint8_t*>(yFrom) + yFrom->sizeInBytes);
-        }
+            while (m_destRow < m_destHeight)
+            {
+                size_t count;
+                const ResampleTap* taps = m_axisY.GetTaps(m_destRow, count);
 
-        // Filter image
-        const uint8_t* pSrc = srcImage.pixels;
-        const size_t rowPitch = srcImage.rowPitch;
-        const uint8_t* pEndSrc = pSrc + rowPitch * srcImage.height;
+                for (size_t k = 0; k < count; ++k)
+                {
+                    if (taps[k].u > u)
+                        return S_OK;
 
-        uint8_t* pDest = destImage.pixels;
+                    m_rows[k] = m_ring + (taps[k].u % m_ringRows) * m_destWidth;
+                }
 
-        for (FilterFrom* yFrom = tfY->from; yFrom < yFromEnd; )
-        {
-            // Create accumulation rows as needed
-            for (size_t j = 0; j < yFrom->count; ++j)
-            {
-                const size_t v = yFrom->to[j].u;
-                assert(v < destImage.height);
-                TriangleRow* rowAcc = &rowActive[v];
+                ResampleColumns(m_rows.get(), m_axisY, m_destRow, m_target, m_destWidth, m_bias);
 
-                if (!rowAcc->scanline)
+                if (point)
                 {
-                    if (rowFree)
-                    {
-                        // Steal and reuse scanline from 'free row' list
-                        assert(rowFree->scanline != nullptr);
-                        rowAcc->scanline.reset(rowFree->scanline.release());
-                        rowFree = rowFree->next;
-                    }
-                    else
-                    {
-                        auto nscanline = make_AlignedArrayXMVECTOR(destImage.width);
-                        if (!nscanline)
-                            return E_OUTOFMEMORY;
-                        rowAcc->scanline.swap(nscanline);
-                    }
-
-                    memset(rowAcc->scanline.get(), 0, sizeof(XMVECTOR) * destImage.width);
+                    if (!StoreScanline(m_dest.get(), m_destPitch, m_format, m_target, m_destWidth))
+                        return E_FAIL;
                 }
+                else if (!StoreScanlineLinear(m_dest.get(), m_destPitch, m_format, m_target, m_destWidth, m_filter))
+                    return E_FAIL;
+
+                const HRESULT hr = emit(static_cast<const uint8_t*>(m_dest.get()), m_destRow);
+                if (FAILED(hr))
+                    return hr;
+
+                ++m_destRow;
             }
 
-            // Load source scanline
-            if ((pSrc + rowPitch) > pEndSrc)
-                return E_FAIL;
+            return S_OK;
+        }
 
-            if (!LoadScanlineLinear(row, srcImage.width, pSrc, rowPitch, srcImage.format, filter))
-                return E_FAIL;
+    private:
+        DXGI_FORMAT                         m_format;
+        TEX_FILTER_FLAGS                    m_filter;
+        size_t                              m_srcWidth;
+        size_t                              m_srcHeight;
+        size_t                              m_destWidth;
+        size_t                              m_destHeight;
+        size_t                              m_destPitch;
+        size_t                              m_ringRows;
+        size_t                              m_srcRow;
+        size_t                              m_destRow;
+        size_t                              m_texelSize;    // Non-zero when POINT copies texels directly
+        size_t                              m_xinc;
+        ResampleAxis                        m_axisX;
+        ResampleAxis                        m_axisY;
+        ScopedAlignedArrayXMVECTOR          m_scanline;
+        XMVECTOR*                           m_row;
+        XMVECTOR*                           m_target;
+        XMVECTOR*                           m_ring;
+        std::unique_ptr<const XMVECTOR*[]>  m_rows;
+        std::unique_ptr<uint8_t[]>          m_needed;
+        std::unique_ptr<uint8_t[]>          m_dest;
+        bool                                m_bias;
+    };
+
+    _Use_decl_annotations_
+    HRESULT ResampleStream::Initialize(
+        DXGI_FORMAT format,
+        size_t srcWidth, size_t srcHeight,
+        size_t destWidth, size_t destHeight,
+        TEX_FILTER_FLAGS filter) noexcept
+    {
+        const unsigned long mode = filter & TEX_FILTER_MODE_MASK;
 
-            pSrc += rowPitch;
+        HRESULT hr = m_axisX.Initialize(srcWidth, destWidth, mode,
+            (filter & TEX_FILTER_WRAP_U) != 0, (filter & TEX_FILTER_MIRROR_U) != 0);
+        if (FAILED(hr))
+            return hr;
 
-            // Process row
-            size_t x = 0;
-            for (FilterFrom* xFrom = tfX->from; xFrom < xFromEnd; ++x)
-            {
-                for (size_t j = 0; j < yFrom->count; ++j)
-                {
-                    const size_t v = yFrom->to[j].u;
-                    assert(v < destImage.height);
-                    const float yweight = yFrom->to[j].weight;
+        hr = m_axisY.Initialize(srcHeight, destHeight, mode, false, (filter & TEX_FILTER_MIRROR_V) != 0);
+        if (FAILED(hr))
+            return hr;
 
-                    XMVECTOR* accPtr = rowActive[v].scanline.get();
-                    if (!accPtr)
-                        return E_POINTER;
+        size_t slicePitch;
+        hr = ComputePitch(format, destWidth, 1, m_destPitch, slicePitch, CP_FLAGS_NONE);
+        if (FAILED(hr))
+            return hr;
 
-                    for (size_t k = 0; k < xFrom->count; ++k)
-                    {
-                        size_t u = xFrom->to[k].u;
-                        assert(u < destImage.width);
+        m_needed.reset(new (std::nothrow) uint8_t[srcHeight]);
+        m_dest.reset(new (std::nothrow) uint8_t[m_destPitch]);
+        m_rows.reset(new (std::nothrow) const XMVECTOR*[m_axisY.GetMaxTaps()]);
+        if (!m_needed || !m_dest || !m_rows)
+            return E_OUTOFMEMORY;
 
-                        const XMVECTOR weight = XMVectorReplicate(yweight * xFrom->to[k].weight);
+        memset(m_needed.get(), 0, srcHeight);
 
-                        assert(x < srcImage.width);
-                        accPtr[u] = XMVectorMultiplyAdd(row[x], weight, accPtr[u]);
-                    }
-                }
+        // A destination row is produced once its last source row has arrived (rows are produced
+        // in order), so the ring has to reach back from there to the first row it uses
+        size_t ringRows = 1;
+        size_t last = 0;
+        for (size_t y = 0; y < destHeight; ++y)
+        {
+            size_t count;
+            const ResampleTap* taps = m_axisY.GetTaps(y, count);
 
-                xFrom = reinterpret_cast<FilterFrom*>(reinterpret_cast<uint8_t*>(xFrom) + xFrom->sizeInBytes);
+            size_t first = srcHeight;
+            for (size_t k = 0; k < count; ++k)
+            {
+                m_needed[taps[k].u] = 1;
+                first = std::min<size_t>(first, taps[k].u);
+                last = std::max<size_t>(last, taps[k].u);
             }
 
-            // Write completed accumulation rows
-            for (size_t j = 0; j < yFrom->count; ++j)
-            {
-                size_t v = yFrom->to[j].u;
-                assert(v < destImage.height);
-                TriangleRow* rowAcc = &rowActive[v];
+            ringRows = std::max(ringRows, last - first + 1);
+        }
+
+        m_scanline = make_AlignedArrayXMVECTOR(uint64_t(srcWidth) + uint64_t(destWidth) * (uint64_t(ringRows) + 1));
+        if (!m_scanline)
+            return E_OUTOFMEMORY;
+
+        m_row = m_scanline.get();
+        m_target = m_row + srcWidth;
+        m_ring = m_target + destWidth;
+
+        m_format = format;
+        m_filter = filter;
+        m_srcWidth = srcWidth;
+        m_srcHeight = srcHeight;
+        m_destWidth = destWidth;
+        m_destHeight = destHeight;
+        m_ringRows = ringRows;
+        m_srcRow = m_destRow = 0;
+        m_texelSize = ((filter & TEX_FILTER_MODE_MASK) == TEX_FILTER_POINT) ? GetPointCopySize(format) : 0;
+        m_xinc = (srcWidth << 16) / destWidth;
+        m_bias = UseResampleBias(filter, format);
+
+        return S_OK;
+    }
 
-                assert(rowAcc->remaining > 0);
-                --rowAcc->remaining;
+    // Feeds a pyramid of ResampleStreams, each level producing the next one from its rows
+    struct MipStream
+    {
+        ResampleStream*     stages;
+        size_t              levels;
+        std::function<HRESULT __cdecl(_In_reads_bytes_(rowPitch) const uint8_t* pixels, size_t rowPitch, size_t level, size_t y)>& sinkFunc;
+
+        HRESULT Push(size_t level, _In_ const uint8_t* pixels, size_t rowPitch, size_t y)
+        {
+            HRESULT hr = sinkFunc(pixels, rowPitch, level, y);
+            if (FAILED(hr) || level + 1 >= levels)
+                return hr;
 
-                if (!rowAcc->remaining)
+            ResampleStream& stage = stages[level];
+            return stage.Push(pixels, rowPitch,
+                [&](const uint8_t* destPixels, size_t destY) -> HRESULT
                 {
-                    XMVECTOR* pAccSrc = rowAcc->scanline.get();
-                    if (!pAccSrc)
-                        return E_POINTER;
+                    return Push(level + 1, destPixels, stage.GetRowPitch(), destY);
+                });
+        }
+    };
 
-                    switch (destImage.format)
-                    {
-                    case DXGI_FORMAT_R10G10B10A2_UNORM:
-                    case DXGI_FORMAT_R10G10B10A2_UINT:
-                        {
-                            // Need to slightly bias results for floating-point error accumulation which can
-                            // be visible with harshly quantized values
-                            static const XMVECTORF32 Bias = { { { 0.f, 0.f, 0.f, 0.1f } } };
-
-                            XMVECTOR* ptr = pAccSrc;
-                            for (size_t i = 0; i < destImage.width; ++i, ++ptr)
-                            {
-                                *ptr = XMVectorAdd(*ptr, Bias);
-                            }
-                        }
-                        break;
+    bool IsStreamingFormat(DXGI_FORMAT format) noexcept
+    {
+        return IsValid(format) && !IsCompressed(format) && !IsPlanar(format) && !IsPalettized(format) && !IsTypeless(format);
+    }
 
-                    default:
-                        break;
-                    }
+    // Pulls each source row in order and hands it to push(pixels, rowPitch, y)
+    template<class Fn>
+    HRESULT PullScanlines(
+        DXGI_FORMAT format,
+        size_t width,
+        size_t height,
+        std::function<HRESULT __cdecl(_Out_writes_bytes_(rowPitch) uint8_t* pixels, size_t rowPitch, size_t y)>& sourceFunc,
+        Fn&& push)
+    {
+        size_t rowPitch, slicePitch;
+        HRESULT hr = ComputePitch(format, width, 1, rowPitch, slicePitch, CP_FLAGS_NONE);
+        if (FAILED(hr))
+            return hr;
 
-                    // This performs any required clamping
-                    if (!StoreScanlineLinear(pDest + (destImage.rowPitch * v), destImage.rowPitch, destImage.format, pAccSrc, destImage.width, filter))
-                        return E_FAIL;
+        std::unique_ptr<uint8_t[]> row(new (std::nothrow) uint8_t[rowPitch]);
+        if (!row)
+            return E_OUTOFMEMORY;
 
-                    // Put row on freelist to reuse it's allocated scanline
-                    rowAcc->next = rowFree;
-                    rowFree = rowAcc;
-                }
-            }
+        for (size_t y = 0; y < height; ++y)
+        {
+            hr = sourceFunc(row.get(), rowPitch, y);
+            if (FAILED(hr))
+                return hr;
 
-            yFrom = reinterpret_cast<FilterFrom*>(reinterpret_cast<uint8_t*>(yFrom) + yFrom->sizeInBytes);
+            hr = push(static_cast<const uint8_t*>(row.get()), rowPitch, y);
+            if (FAILED(hr))
+                return hr;
         }
 
         return S_OK;
@@ -804,7 +1232,7 @@ namespace
 
 
     //--- Custom filter resize ---
-    HRESULT PerformResizeUsingCustomFilters(const Image& srcImage, TEX_FILTER_FLAGS filter, const Image& destImage) noexcept
+    HRESULT PerformResizeUsingCustomFilters(const Image& srcImage, TEX_FILTER_FLAGS filter, size_t maxThreads, const Image& destImage) noexcept
     {
         if (!srcImage.pixels || !destImage.pixels)
             return E_POINTER;
@@ -825,16 +1253,13 @@ namespace
             return ResizePointFilter(srcImage, destImage);
 
         case TEX_FILTER_BOX:
-            return ResizeBoxFilter(srcImage, filter, destImage);
-
         case TEX_FILTER_LINEAR:
-            return ResizeLinearFilter(srcImage, filter, destImage);
-
         case TEX_FILTER_CUBIC:
-            return ResizeCubicFilter(srcImage, filter, destImage);
-
         case TEX_FILTER_TRIANGLE:
-            return ResizeTriangleFilter(srcImage, filter, destImage);
+        case TEX_FILTER_LANCZOS:
+        case TEX_FILTER_KAISER:
+            return ResizeSeparableFilter(srcImage,
+                static_cast<TEX_FILTER_FLAGS>((filter & ~TEX_FILTER_MODE_MASK) | filter_select), destImage, maxThreads);
 
         default:
             return HRESULT_E_NOT_SUPPORTED;
@@ -843,6 +1268,54 @@ namespace
 }
 
 
+//-------------------------------------------------------------------------------------
+// Separable resize using the filter mode in filter (BOX, LINEAR, CUBIC, TRIANGLE,
+// LANCZOS, or KAISER); with TEX_FILTER_PARALLEL, bands of rows run concurrently on up
+// to maxThreads threads
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+HRESULT DirectX::Internal::ResizeSeparableFilter(
+    const Image& srcImage,
+    TEX_FILTER_FLAGS filter,
+    const Image& destImage,
+    size_t maxThreads) noexcept
+{
+    if (!srcImage.pixels || !destImage.pixels)
+        return E_POINTER;
+
+    if (!srcImage.width || !srcImage.height || !destImage.width || !destImage.height)
+        return E_INVALIDARG;
+
+    const unsigned long mode = filter & TEX_FILTER_MODE_MASK;
+
+    ResampleAxis axisX;
+    HRESULT hr = axisX.Initialize(srcImage.width, destImage.width, mode,
+        (filter & TEX_FILTER_WRAP_U) != 0, (filter & TEX_FILTER_MIRROR_U) != 0);
+    if (FAILED(hr))
+        return hr;
+
+    ResampleAxis axisY;
+    hr = axisY.Initialize(srcImage.height, destImage.height, mode,
+        (filter & TEX_FILTER_WRAP_V) != 0, (filter & TEX_FILTER_MIRROR_V) != 0);
+    if (FAILED(hr))
+        return hr;
+
+    if (!(filter & TEX_FILTER_PARALLEL))
+        return ResampleRows(srcImage, filter, destImage, axisX, axisY, 0, destImage.height);
+
+    // Several bands per thread to balance the load; each band reloads the rows shared with its neighbors
+    const size_t threads = GetWorkerThreadCount(maxThreads, destImage.height);
+    const size_t bandRows = std::max<size_t>((destImage.height + threads * 4 - 1) / (threads * 4), RESIZE_MIN_BAND_ROWS);
+
+    return ParallelFor((destImage.height + bandRows - 1) / bandRows, maxThreads,
+        [&](size_t band) -> HRESULT
+        {
+            const size_t y0 = band * bandRows;
+            return ResampleRows(srcImage, filter, destImage, axisX, axisY, y0, std::min(y0 + bandRows, destImage.height));
+        });
+}
+
+
 //=====================================================================================
 // Entry-points
 //=====================================================================================
@@ -857,6 +1330,18 @@ HRESULT DirectX::Resize(
     size_t height,
     TEX_FILTER_FLAGS filter,
     ScratchImage& image) noexcept
+{
+    return Resize(srcImage, width, height, filter, 0, image);
+}
+
+_Use_decl_annotations_
+HRESULT DirectX::Resize(
+    const Image& srcImage,
+    size_t width,
+    size_t height,
+    TEX_FILTER_FLAGS filter,
+    size_t maxThreads,
+    ScratchImage& image) noexcept
 {
     if (width == 0 || height == 0)
         return E_INVALIDARG;
@@ -923,7 +1408,7 @@ HRESULT DirectX::Resize(
     #endif
     {
         // Case 3: not using WIC resizing
-        hr = PerformResizeUsingCustomFilters(srcImage, filter, *rimage);
+        hr = PerformResizeUsingCustomFilters(srcImage, filter, maxThreads, *rimage);
     }
 
     if (FAILED(hr))
@@ -948,6 +1433,20 @@ HRESULT DirectX::Resize(
     size_t height,
     TEX_FILTER_FLAGS filter,
     ScratchImage& result) noexcept
+{
+    return Resize(srcImages, nimages, metadata, width, height, filter, 0, result);
+}
+
+_Use_decl_annotations_
+HRESULT DirectX::Resize(
+    const Image* srcImages,
+    size_t nimages,
+    const TexMetadata& metadata,
+    size_t width,
+    size_t height,
+    TEX_FILTER_FLAGS filter,
+    size_t maxThreads,
+    ScratchImage& result) noexcept
 {
     if (!srcImages || !nimages || width == 0 || height == 0)
         return E_INVALIDARG;
@@ -1037,7 +1536,7 @@ HRESULT DirectX::Resize(
             #endif
             {
                 // Case 3: not using WIC resizing
-                hr = PerformResizeUsingCustomFilters(*srcimg, filter, *destimg);
+                hr = PerformResizeUsingCustomFilters(*srcimg, filter, maxThreads, *destimg);
             }
 
             if (FAILED(hr))
@@ -1098,7 +1597,7 @@ HRESULT DirectX::Resize(
             #endif
             {
                 // Case 3: not using WIC resizing
-                hr = PerformResizeUsingCustomFilters(*srcimg, filter, *destimg);
+                hr = PerformResizeUsingCustomFilters(*srcimg, filter, maxThreads, *destimg);
             }
 
             if (FAILED(hr))
@@ -1116,3 +1615,127 @@ HRESULT DirectX::Resize(
 
     return S_OK;
 }
+
+
+//-------------------------------------------------------------------------------------
+// Streaming resize
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+HRESULT DirectX::ResizeStreaming(
+    DXGI_FORMAT format,
+    size_t srcWidth,
+    size_t srcHeight,
+    std::function<HRESULT __cdecl(_Out_writes_bytes_(rowPitch) uint8_t* pixels, size_t rowPitch, size_t y)> sourceFunc,
+    size_t width,
+    size_t height,
+    TEX_FILTER_FLAGS filter,
+    std::function<HRESULT __cdecl(_In_reads_bytes_(rowPitch) const uint8_t* pixels, size_t rowPitch, size_t y)> sinkFunc)
+{
+    if (!sourceFunc || !sinkFunc)
+        return E_INVALIDARG;
+
+    if (!srcWidth || !srcHeight || !width || !height)
+        return E_INVALIDARG;
+
+    if ((srcWidth > UINT32_MAX) || (srcHeight > UINT32_MAX) || (width > UINT32_MAX) || (height > UINT32_MAX))
+        return E_INVALIDARG;
+
+    if (!IsStreamingFormat(format))
+        return HRESULT_E_NOT_SUPPORTED;
+
+    // Wrapping vertically would need the last rows before the first ones can be produced
+    if (filter & TEX_FILTER_WRAP_V)
+        return HRESULT_E_NOT_SUPPORTED;
+
+    unsigned long filter_select = filter & TEX_FILTER_MODE_MASK;
+    if (!filter_select)
+    {
+        // Default filter choice
+        filter_select = (((width << 1) == srcWidth) && ((height << 1) == srcHeight)) ? TEX_FILTER_BOX : TEX_FILTER_LINEAR;
+    }
+
+    ResampleStream stream;
+    HRESULT hr = stream.Initialize(format, srcWidth, srcHeight, width, height,
+        static_cast<TEX_FILTER_FLAGS>((filter & ~TEX_FILTER_MODE_MASK) | filter_select));
+    if (FAILED(hr))
+        return hr;
+
+    return PullScanlines(format, srcWidth, srcHeight, sourceFunc,
+        [&](const uint8_t* pixels, size_t rowPitch, size_t) -> HRESULT
+        {
+            return stream.Push(pixels, rowPitch,
+                [&](const uint8_t* destPixels, size_t y) -> HRESULT
+                {
+                    return sinkFunc(destPixels, stream.GetRowPitch(), y);
+                });
+        });
+}
+
+
+//-------------------------------------------------------------------------------------
+// Streaming mipmap generation
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+HRESULT DirectX::GenerateMipMapsStreaming(
+    DXGI_FORMAT format,
+    size_t width,
+    size_t height,
+    std::function<HRESULT __cdecl(_Out_writes_bytes_(rowPitch) uint8_t* pixels, size_t rowPitch, size_t y)> sourceFunc,
+    TEX_FILTER_FLAGS filter,
+    size_t levels,
+    std::function<HRESULT __cdecl(_In_reads_bytes_(rowPitch) const uint8_t* pixels, size_t rowPitch, size_t level, size_t y)> sinkFunc)
+{
+    if (!sourceFunc || !sinkFunc)
+        return E_INVALIDARG;
+
+    if ((width > UINT32_MAX) || (height > UINT32_MAX))
+        return E_INVALIDARG;
+
+    if (!IsStreamingFormat(format))
+        return HRESULT_E_NOT_SUPPORTED;
+
+    if (filter & TEX_FILTER_WRAP_V)
+        return HRESULT_E_NOT_SUPPORTED;
+
+    if (!CalculateMipLevels(width, height, levels))
+        return E_INVALIDARG;
+
+    if (levels <= 1)
+        return E_INVALIDARG;
+
+    unsigned long filter_select = filter & TEX_FILTER_MODE_MASK;
+    if (!filter_select)
+    {
+        // Default filter choice
+        filter_select = (ispow2(width) && ispow2(height)) ? TEX_FILTER_BOX : TEX_FILTER_LINEAR;
+    }
+
+    const auto stageFilter = static_cast<TEX_FILTER_FLAGS>((filter & ~TEX_FILTER_MODE_MASK) | filter_select);
+
+    std::unique_ptr<ResampleStream[]> stages(new (std::nothrow) ResampleStream[levels - 1]);
+    if (!stages)
+        return E_OUTOFMEMORY;
+
+    size_t mipWidth = width;
+    size_t mipHeight = height;
+    for (size_t level = 0; level + 1 < levels; ++level)
+    {
+        const size_t nwidth = (mipWidth > 1) ? (mipWidth >> 1) : 1;
+        const size_t nheight = (mipHeight > 1) ? (mipHeight >> 1) : 1;
+
+        const HRESULT hr = stages[level].Initialize(format, mipWidth, mipHeight, nwidth, nheight, stageFilter);
+        if (FAILED(hr))
+            return hr;
+
+        mipWidth = nwidth;
+        mipHeight = nheight;
+    }
+
+    MipStream pyramid = { stages.get(), levels, sinkFunc };
+
+    return PullScanlines(format, width, height, sourceFunc,
+        [&](const uint8_t* pixels, size_t rowPitch, size_t y) -> HRESULT
+        {
+            return pyramid.Push(0, pixels, rowPitch, y);
+        });
+}
@@ -17,7 +17,7 @@
 //      * Interleaved files are not supported (deprecated aspect of TGA format)
 //      * Only supports 8-bit grayscale; 16-, 24-, and 32-bit truecolor images RLE or uncompressed
 //        plus 24-bit color-mapped uncompressed images
-//      * Always writes uncompressed files (i.e. can read RLE compression, but does not write it)
+//      * Writes uncompressed files unless TGA_FLAGS_RLE is given
 //
 
 using namespace DirectX;
@@ -27,6 +27,12 @@ namespace
 {
     constexpr float GAMMA_EPSILON = 0.01f;
 
+    constexpr size_t TGA_BAND_ROWS = 16;
+        // Scanlines RLE encoded per parallel task
+
+    constexpr size_t TGA_WRITE_CHUNK = 16 * 1024 * 1024;
+        // Bytes of uncompressed scanlines RLE encoded per file write
+
     const char g_Signature[] = "TRUEVISION-XFILE.";
         // This is the official footer signature for the TGA 2.0 file format.
 
@@ -390,6 +396,49 @@ namespace
     }
 
 
+    //-------------------------------------------------------------------------------------
+    // Writes the pixels of a repeat packet, returning the next destination pixel
+    //-------------------------------------------------------------------------------------
+    template<typename T>
+    T* FillRun(_In_ T* dPtr, T value, size_t count, bool invertX) noexcept
+    {
+        static_assert((16 % sizeof(T)) == 0, "Pixel size must evenly divide a vector");
+
+        T* start = invertX ? (dPtr - count + 1) : dPtr;
+
+        size_t bytes = count * sizeof(T);
+        if (bytes >= 16)
+        {
+            // Long runs are stored a vector at a time
+            uint32_t pattern[4];
+            auto pPattern = reinterpret_cast<T*>(pattern);
+            for (size_t i = 0; i < 16 / sizeof(T); ++i)
+            {
+                pPattern[i] = value;
+            }
+
+            const XMVECTOR v = XMLoadInt4(pattern);
+
+            auto pBytes = reinterpret_cast<uint8_t*>(start);
+            for (; bytes >= 16; bytes -= 16, pBytes += 16)
+            {
+                XMStoreInt4(reinterpret_cast<uint32_t*>(pBytes), v);
+            }
+
+            memcpy(pBytes, pattern, bytes);
+        }
+        else
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                start[i] = value;
+            }
+        }
+
+        return invertX ? (start - 1) : (start + count);
+    }
+
+
     //-------------------------------------------------------------------------------------
     // Uncompress pixel data from a TGA into the target image
     //-------------------------------------------------------------------------------------
@@ -442,18 +491,11 @@ namespace
                         if (++sPtr >= endPtr)
                             return E_FAIL;
 
-                        for (; j > 0; --j, ++x)
-                        {
-                            if (x >= image->width)
-                                return E_FAIL;
+                        if (j > image->width - x)
+                            return E_FAIL;
 
-                            *dPtr = *sPtr;
-
-                            if (convFlags & CONV_FLAGS_INVERTX)
-                                --dPtr;
-                            else
-                                ++dPtr;
-                        }
+                        dPtr = FillRun(dPtr, *sPtr, j, (convFlags & CONV_FLAGS_INVERTX) != 0);
+                        x += j;
 
                         ++sPtr;
                     }
@@ -520,18 +562,11 @@ namespace
 
                             sPtr += 2;
 
-                            for (; j > 0; --j, ++x)
-                            {
-                                if (x >= image->width)
-                                    return E_FAIL;
-
-                                *dPtr = t;
+                            if (j > image->width - x)
+                                return E_FAIL;
 
-                                if (convFlags & CONV_FLAGS_INVERTX)
-                                    --dPtr;
-                                else
-                                    ++dPtr;
-                            }
+                            dPtr = FillRun(dPtr, t, j, (convFlags & CONV_FLAGS_INVERTX) != 0);
+                            x += j;
                         }
                         else
                         {
@@ -636,18 +671,11 @@ namespace
                                 sPtr += 4;
                             }
 
-                            for (; j > 0; --j, ++x)
-                            {
-                                if (x >= image->width)
-                                    return E_FAIL;
-
-                                *dPtr = t;
+                            if (j > image->width - x)
+                                return E_FAIL;
 
-                                if (convFlags & CONV_FLAGS_INVERTX)
-                                    --dPtr;
-                                else
-                                    ++dPtr;
-                            }
+                            dPtr = FillRun(dPtr, t, j, (convFlags & CONV_FLAGS_INVERTX) != 0);
+                            x += j;
                         }
                         else
                         {
@@ -766,18 +794,11 @@ namespace
 
                             sPtr += 4;
 
-                            for (; j > 0; --j, ++x)
-                            {
-                                if (x >= image->width)
-                                    return E_FAIL;
-
-                                *dPtr = t;
+                            if (j > image->width - x)
+                                return E_FAIL;
 
-                                if (convFlags & CONV_FLAGS_INVERTX)
-                                    --dPtr;
-                                else
-                                    ++dPtr;
-                            }
+                            dPtr = FillRun(dPtr, t, j, (convFlags & CONV_FLAGS_INVERTX) != 0);
+                            x += j;
                         }
                         else
                         {
@@ -862,18 +883,11 @@ namespace
                             uint32_t t = uint32_t(*sPtr) | uint32_t(*(sPtr + 1) << 8) | uint32_t(*(sPtr + 2) << 16);
                             sPtr += 3;
 
-                            for (; j > 0; --j, ++x)
-                            {
-                                if (x >= image->width)
-                                    return E_FAIL;
-
-                                *dPtr = t;
+                            if (j > image->width - x)
+                                return E_FAIL;
 
-                                if (convFlags & CONV_FLAGS_INVERTX)
-                                    --dPtr;
-                                else
-                                    ++dPtr;
-                            }
+                            dPtr = FillRun(dPtr, t, j, (convFlags & CONV_FLAGS_INVERTX) != 0);
+                            x += j;
                         }
                         else
                         {
@@ -1222,7 +1236,7 @@ namespace
     //-------------------------------------------------------------------------------------
     // Encodes TGA file header
     //-------------------------------------------------------------------------------------
-    HRESULT EncodeTGAHeader(_In_ const Image& image, _Out_ TGA_HEADER& header, _Inout_ uint32_t& convFlags) noexcept
+    HRESULT EncodeTGAHeader(_In_ const Image& image, TGA_FLAGS flags, _Out_ TGA_HEADER& header, _Inout_ uint32_t& convFlags) noexcept
     {
         memset(&header, 0, TGA_HEADER_LEN);
 
@@ -1277,6 +1291,11 @@ namespace
             return HRESULT_E_NOT_SUPPORTED;
         }
 
+        if (flags & TGA_FLAGS_RLE)
+        {
+            header.bImageType = (header.bImageType == TGA_BLACK_AND_WHITE) ? TGA_BLACK_AND_WHITE_RLE : TGA_TRUECOLOR_RLE;
+        }
+
         return S_OK;
     }
 
@@ -1317,6 +1336,188 @@ namespace
         }
     }
 
+    //-------------------------------------------------------------------------------------
+    // Converts a scanline of the image to TGA pixel data
+    //-------------------------------------------------------------------------------------
+    void ConvertTGAScanline(
+        _Out_writes_bytes_(outSize) void* pDestination,
+        _In_ size_t outSize,
+        _In_reads_bytes_(inSize) const void* pSource,
+        _In_ size_t inSize,
+        _In_ DXGI_FORMAT format,
+        uint32_t convFlags) noexcept
+    {
+        if (convFlags & CONV_FLAGS_888)
+        {
+            Copy24bppScanline(pDestination, outSize, pSource, inSize);
+        }
+        else if (convFlags & CONV_FLAGS_SWIZZLE)
+        {
+            SwizzleScanline(pDestination, outSize, pSource, inSize, format, TEXP_SCANLINE_NONE);
+        }
+        else
+        {
+            CopyScanline(pDestination, outSize, pSource, inSize, format, TEXP_SCANLINE_NONE);
+        }
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Encodes a scanline of TGA pixel data as RLE packets
+    //-------------------------------------------------------------------------------------
+    constexpr size_t GetMaxRLEScanlineSize(size_t width, size_t bpp) noexcept
+    {
+        // Each packet header is paid for by the packet before it, except for literal packets cut at 128 pixels
+        return width * bpp + (width + 127) / 128;
+    }
+
+    template<size_t bpp>
+    inline uint32_t LoadTGAPixel(_In_reads_bytes_(bpp) const uint8_t* pSource) noexcept
+    {
+        uint32_t t = 0;
+        memcpy(&t, pSource, bpp);
+        return t;
+    }
+
+    template<size_t bpp>
+    size_t EncodeTGAScanline(
+        _Out_writes_(GetMaxRLEScanlineSize(width, bpp)) uint8_t* pDestination,
+        _In_reads_(width * bpp) const uint8_t* pSource,
+        size_t width) noexcept
+    {
+        // Shorter runs of identical pixels are no smaller as repeat packets
+        constexpr size_t minRun = (bpp == 1) ? 3 : 2;
+
+        uint8_t* dPtr = pDestination;
+        for (size_t x = 0; x < width; )
+        {
+            const size_t maxLen = std::min<size_t>(width - x, 128);
+            const uint8_t* sPtr = pSource + x * bpp;
+
+            const uint32_t t = LoadTGAPixel<bpp>(sPtr);
+
+            size_t len = 1;
+            while (len < maxLen && LoadTGAPixel<bpp>(sPtr + len * bpp) == t)
+            {
+                ++len;
+            }
+
+            if (len >= minRun)
+            {
+                // Repeat
+                *dPtr++ = static_cast<uint8_t>(0x80 | (len - 1));
+                memcpy(dPtr, sPtr, bpp);
+                dPtr += bpp;
+            }
+            else
+            {
+                // Literal, up to where the next run starts
+                len = 1;
+                size_t same = 1;
+                uint32_t prev = t;
+                while (len < maxLen)
+                {
+                    const uint32_t cur = LoadTGAPixel<bpp>(sPtr + len * bpp);
+                    if (cur == prev)
+                    {
+                        if (++same >= minRun)
+                        {
+                            len -= same - 1;
+                            break;
+                        }
+                    }
+                    else
+                    {
+                        same = 1;
+                        prev = cur;
+                    }
+                    ++len;
+                }
+
+                *dPtr++ = static_cast<uint8_t>(len - 1);
+                memcpy(dPtr, sPtr, len * bpp);
+                dPtr += len * bpp;
+            }
+
+            x += len;
+        }
+
+        return size_t(dPtr - pDestination);
+    }
+
+    //-------------------------------------------------------------------------------------
+    // RLE encodes rows [firstRow, firstRow + rowCount) of the image to pDestination,
+    // which must hold rowCount scanlines of GetMaxRLEScanlineSize
+    //-------------------------------------------------------------------------------------
+    HRESULT EncodeTGARows(
+        _In_ const Image& image,
+        uint32_t convFlags,
+        size_t bpp,
+        size_t firstRow,
+        size_t rowCount,
+        _Out_writes_(rowCount * GetMaxRLEScanlineSize(image.width, bpp)) uint8_t* pDestination,
+        size_t maxThreads,
+        _Out_ size_t& encodedSize) noexcept
+    {
+        encodedSize = 0;
+
+        const size_t rowPitch = image.width * bpp;
+        const size_t maxRowSize = GetMaxRLEScanlineSize(image.width, bpp);
+        const size_t bandCount = (rowCount + TGA_BAND_ROWS - 1) / TGA_BAND_ROWS;
+
+        std::unique_ptr<size_t[]> bandSizes(new (std::nothrow) size_t[bandCount]);
+        if (!bandSizes)
+            return E_OUTOFMEMORY;
+
+        // Each band is written at its worst case offset, so bands never overlap
+        HRESULT hr = ParallelFor(bandCount, maxThreads,
+            [&](size_t band) -> HRESULT
+            {
+                std::unique_ptr<uint8_t[]> temp(new (std::nothrow) uint8_t[rowPitch]);
+                if (!temp)
+                    return E_OUTOFMEMORY;
+
+                const size_t startRow = band * TGA_BAND_ROWS;
+                const size_t endRow = std::min(rowCount, startRow + TGA_BAND_ROWS);
+
+                uint8_t* bandPtr = pDestination + startRow * maxRowSize;
+                uint8_t* dPtr = bandPtr;
+                const uint8_t* sPtr = image.pixels + (firstRow + startRow) * image.rowPitch;
+                for (size_t y = startRow; y < endRow; ++y)
+                {
+                    ConvertTGAScanline(temp.get(), rowPitch, sPtr, image.rowPitch, image.format, convFlags);
+                    sPtr += image.rowPitch;
+
+                    switch (bpp)
+                    {
+                    case 1: dPtr += EncodeTGAScanline<1>(dPtr, temp.get(), image.width); break;
+                    case 2: dPtr += EncodeTGAScanline<2>(dPtr, temp.get(), image.width); break;
+                    case 3: dPtr += EncodeTGAScanline<3>(dPtr, temp.get(), image.width); break;
+                    case 4: dPtr += EncodeTGAScanline<4>(dPtr, temp.get(), image.width); break;
+                    default: return E_UNEXPECTED;
+                    }
+                }
+
+                bandSizes[band] = size_t(dPtr - bandPtr);
+
+                return S_OK;
+            });
+        if (FAILED(hr))
+            return hr;
+
+        // Close the gaps between the encoded bands
+        for (size_t band = 0; band < bandCount; ++band)
+        {
+            const uint8_t* bandPtr = pDestination + band * TGA_BAND_ROWS * maxRowSize;
+            if (bandPtr != pDestination + encodedSize)
+            {
+                memmove(pDestination + encodedSize, bandPtr, bandSizes[band]);
+            }
+            encodedSize += bandSizes[band];
+        }
+
+        return S_OK;
+    }
+
     //-------------------------------------------------------------------------------------
     // TGA 2.0 Extension helpers
     //-------------------------------------------------------------------------------------
@@ -2258,7 +2459,7 @@ HRESULT DirectX::SaveToTGAMemory(
 
     TGA_HEADER tga_header = {};
     uint32_t convFlags = 0;
-    HRESULT hr = EncodeTGAHeader(image, tga_header, convFlags);
+    HRESULT hr = EncodeTGAHeader(image, flags, tga_header, convFlags);
     if (FAILED(hr))
         return hr;
 
@@ -2271,6 +2472,13 @@ HRESULT DirectX::SaveToTGAMemory(
     if (FAILED(hr))
         return hr;
 
+    const size_t bpp = tga_header.bBitsPerPixel / 8u;
+    if (flags & TGA_FLAGS_RLE)
+    {
+        // Worst case; trimmed once the pixels are encoded
+        slicePitch = image.height * GetMaxRLEScanlineSize(image.width, bpp);
+    }
+
     hr = blob.Initialize(TGA_HEADER_LEN
         + slicePitch
         + (metadata ? sizeof(TGA_EXTENSION) : 0)
@@ -2286,27 +2494,32 @@ HRESULT DirectX::SaveToTGAMemory(
     memcpy(dPtr, &tga_header, TGA_HEADER_LEN);
     dPtr += TGA_HEADER_LEN;
 
-    const uint8_t* pPixels = image.pixels;
-    assert(pPixels);
-
-    for (size_t y = 0; y < image.height; ++y)
+    if (flags & TGA_FLAGS_RLE)
     {
-        // Copy pixels
-        if (convFlags & CONV_FLAGS_888)
-        {
-            Copy24bppScanline(dPtr, rowPitch, pPixels, image.rowPitch);
-        }
-        else if (convFlags & CONV_FLAGS_SWIZZLE)
+        size_t encodedSize = 0;
+        hr = EncodeTGARows(image, convFlags, bpp, 0, image.height, dPtr,
+            (flags & TGA_FLAGS_PARALLEL) ? 0u : 1u, encodedSize);
+        if (FAILED(hr))
         {
-            SwizzleScanline(dPtr, rowPitch, pPixels, image.rowPitch, image.format, TEXP_SCANLINE_NONE);
+            blob.Release();
+            return hr;
         }
-        else
+
+        dPtr += encodedSize;
+    }
+    else
+    {
+        const uint8_t* pPixels = image.pixels;
+        assert(pPixels);
+
+        for (size_t y = 0; y < image.height; ++y)
         {
-            CopyScanline(dPtr, rowPitch, pPixels, image.rowPitch, image.format, TEXP_SCANLINE_NONE);
-        }
+            // Copy pixels
+            ConvertTGAScanline(dPtr, rowPitch, pPixels, image.rowPitch, image.format, convFlags);
 
-        dPtr += rowPitch;
-        pPixels += image.rowPitch;
+            dPtr += rowPitch;
+            pPixels += image.rowPitch;
+        }
     }
 
     uint32_t extOffset = 0;
@@ -2325,6 +2538,14 @@ HRESULT DirectX::SaveToTGAMemory(
     footer->dwDeveloperOffset = 0;
     footer->dwExtensionOffset = extOffset;
     memcpy(footer->Signature, g_Signature, sizeof(g_Signature));
+    dPtr += sizeof(TGA_FOOTER);
+
+    hr = blob.Trim(size_t(dPtr - destPtr));
+    if (FAILED(hr))
+    {
+        blob.Release();
+        return hr;
+    }
 
     return S_OK;
 }
@@ -2351,7 +2572,7 @@ HRESULT DirectX::SaveToTGAFile(
 
     TGA_HEADER tga_header = {};
     uint32_t convFlags = 0;
-    HRESULT hr = EncodeTGAHeader(image, tga_header, convFlags);
+    HRESULT hr = EncodeTGAHeader(image, flags, tga_header, convFlags);
     if (FAILED(hr))
         return hr;
 
@@ -2415,8 +2636,14 @@ HRESULT DirectX::SaveToTGAFile(
     }
     else
     {
-        // Otherwise, write the image one scanline at a time...
-        std::unique_ptr<uint8_t[]> temp(new (std::nothrow) uint8_t[rowPitch]);
+        // Otherwise, write the image one scanline (or one chunk of RLE scanlines) at a time...
+        const size_t bpp = tga_header.bBitsPerPixel / 8u;
+        const size_t maxRowSize = GetMaxRLEScanlineSize(image.width, bpp);
+        const size_t chunkRows = (flags & TGA_FLAGS_RLE)
+            ? std::min<size_t>(image.height, std::max<size_t>(TGA_WRITE_CHUNK / rowPitch, 1))
+            : 1;
+
+        std::unique_ptr<uint8_t[]> temp(new (std::nothrow) uint8_t[(flags & TGA_FLAGS_RLE) ? (chunkRows * maxRowSize) : rowPitch]);
         if (!temp)
             return E_OUTOFMEMORY;
 
@@ -2441,35 +2668,38 @@ HRESULT DirectX::SaveToTGAFile(
 
         // Write pixels
         const uint8_t* pPixels = image.pixels;
+        const size_t maxThreads = (flags & TGA_FLAGS_PARALLEL) ? 0u : 1u;
 
-        for (size_t y = 0; y < image.height; ++y)
+        for (size_t y = 0; y < image.height; y += chunkRows)
         {
-            // Copy pixels
-            if (convFlags & CONV_FLAGS_888)
+            size_t bytesToWrite = rowPitch;
+            if (flags & TGA_FLAGS_RLE)
             {
-                Copy24bppScanline(temp.get(), rowPitch, pPixels, image.rowPitch);
-            }
-            else if (convFlags & CONV_FLAGS_SWIZZLE)
-            {
-                SwizzleScanline(temp.get(), rowPitch, pPixels, image.rowPitch, image.format, TEXP_SCANLINE_NONE);
+                hr = EncodeTGARows(image, convFlags, bpp, y, std::min(chunkRows, image.height - y), temp.get(), maxThreads, bytesToWrite);
+                if (FAILED(hr))
+                    return hr;
+
+                if (bytesToWrite > UINT32_MAX)
+                    return HRESULT_E_ARITHMETIC_OVERFLOW;
             }
             else
             {
-                CopyScanline(temp.get(), rowPitch, pPixels, image.rowPitch, image.format, TEXP_SCANLINE_NONE);
-            }
+                // Copy pixels
+                ConvertTGAScanline(temp.get(), rowPitch, pPixels, image.rowPitch, image.format, convFlags);
 
-            pPixels += image.rowPitch;
+                pPixels += image.rowPitch;
+            }
 
         #ifdef _WIN32
-            if (!WriteFile(hFile.get(), temp.get(), static_cast<DWORD>(rowPitch), &bytesWritten, nullptr))
+            if (!WriteFile(hFile.get(), temp.get(), static_cast<DWORD>(bytesToWrite), &bytesWritten, nullptr))
             {
                 return HRESULT_FROM_WIN32(GetLastError());
             }
 
-            if (bytesWritten != rowPitch)
+            if (bytesWritten != bytesToWrite)
                 return E_FAIL;
         #else
-            outFile.write(reinterpret_cast<char*>(temp.get()), rowPitch);
+            outFile.write(reinterpret_cast<char*>(temp.get()), static_cast<std::streamsize>(bytesToWrite));
             if (!outFile)
                 return E_FAIL;
         #endif
@@ -1737,3 +1737,310 @@ HRESULT Blob::Resize(size_t size) noexcept
 
     return S_OK;
 }
+
+
+//=====================================================================================
+// Task scheduler
+//=====================================================================================
+
+namespace
+{
+    // Range of task indices owned by a worker, packed as (end << 32) | begin so that the owner
+    // popping from the front and a thief splitting off the back can both use a single CAS.
+    // Each range gets its own cache line; arrays of them come from _aligned_malloc since
+    // over-aligned operator new needs C++17.
+    class alignas(64) TaskRange
+    {
+    public:
+        void Set(uint32_t begin, uint32_t end) noexcept
+        {
+            m_range.store((uint64_t(end) << 32) | begin, std::memory_order_release);
+        }
+
+        bool Pop(uint32_t& index) noexcept
+        {
+            uint64_t range = m_range.load(std::memory_order_acquire);
+            for (;;)
+            {
+                const auto begin = static_cast<uint32_t>(range);
+                const auto end = static_cast<uint32_t>(range >> 32);
+                if (begin >= end)
+                    return false;
+
+                if (m_range.compare_exchange_weak(range, (uint64_t(end) << 32) | (begin + 1), std::memory_order_acq_rel))
+                {
+                    index = begin;
+                    return true;
+                }
+            }
+        }
+
+        // Takes the upper half of the remaining tasks
+        bool Steal(uint32_t& stolenBegin, uint32_t& stolenEnd) noexcept
+        {
+            uint64_t range = m_range.load(std::memory_order_acquire);
+            for (;;)
+            {
+                const auto begin = static_cast<uint32_t>(range);
+                const auto end = static_cast<uint32_t>(range >> 32);
+                if (begin >= end)
+                    return false;
+
+                const uint32_t split = begin + (end - begin) / 2;
+                if (m_range.compare_exchange_weak(range, (uint64_t(split) << 32) | begin, std::memory_order_acq_rel))
+                {
+                    stolenBegin = split;
+                    stolenEnd = end;
+                    return true;
+                }
+            }
+        }
+
+    private:
+        std::atomic<uint64_t> m_range{ 0 };
+    };
+
+    struct TaskState
+    {
+        const std::function<HRESULT __cdecl(size_t)>& task;
+        TaskRange* ranges;
+        size_t nranges;
+        std::atomic<HRESULT> result;
+
+        TaskState(const std::function<HRESULT __cdecl(size_t)>& t, TaskRange* r, size_t n) noexcept :
+            task(t), ranges(r), nranges(n), result(S_OK) {}
+    };
+
+    void RunWorker(TaskState& state, size_t self) noexcept
+    {
+        TaskRange& own = state.ranges[self];
+
+        for (;;)
+        {
+            uint32_t index;
+            while (own.Pop(index))
+            {
+                if (state.result.load(std::memory_order_relaxed) != S_OK)
+                    return;
+
+                const HRESULT hr = state.task(index);
+                if (FAILED(hr))
+                {
+                    HRESULT expected = S_OK;
+                    state.result.compare_exchange_strong(expected, hr);
+                    return;
+                }
+            }
+
+            // Out of local work, so split a range off another worker
+            bool stolen = false;
+            for (size_t j = 1; j < state.nranges && !stolen; ++j)
+            {
+                uint32_t begin, end;
+                if (state.ranges[(self + j) % state.nranges].Steal(begin, end))
+                {
+                    own.Set(begin, end);
+                    stolen = true;
+                }
+            }
+
+            if (!stolen)
+                return;
+        }
+    }
+
+    // Set while a thread is running ParallelFor tasks
+    thread_local bool t_inParallelFor = false;
+
+    void RunPooledWorker(TaskState& state, size_t self) noexcept
+    {
+        t_inParallelFor = true;
+        RunWorker(state, self);
+        t_inParallelFor = false;
+    }
+
+    // Persistent worker threads shared by all ParallelFor calls, so that repeated calls on small
+    // images don't pay for thread creation each time. Threads are started on first use and sleep
+    // between jobs. The pool is intentionally never destroyed: joining threads from a static
+    // destructor can deadlock when the library is linked into a DLL.
+    class TaskPool
+    {
+    public:
+        static TaskPool* Get() noexcept
+        {
+            static TaskPool* s_pool = new (std::nothrow) TaskPool;
+            return s_pool;
+        }
+
+        // Runs the job with the caller as worker 0 and up to 'helpers' pool threads as workers 1..helpers.
+        // Returns false without running anything if another caller currently owns the pool.
+        bool TryRun(TaskState& state, size_t helpers) noexcept
+        {
+            std::unique_lock<std::mutex> owner(m_owner, std::try_to_lock);
+            if (!owner.owns_lock())
+                return false;
+
+            Grow(helpers);
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_job = &state;
+                m_jobHelpers = std::min(helpers, m_threadCount);
+                m_pending = m_jobHelpers;
+                ++m_generation;
+            }
+            m_wake.notify_all();
+
+            RunWorker(state, 0);
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_done.wait(lock, [this] { return m_pending == 0; });
+            m_job = nullptr;
+
+            return true;
+        }
+
+    private:
+        std::mutex m_owner;
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::condition_variable m_done;
+        TaskState* m_job = nullptr;
+        size_t m_jobHelpers = 0;
+        size_t m_pending = 0;
+        size_t m_threadCount = 0;
+        uint64_t m_generation = 0;
+
+        // Called with m_owner held, so no job is in flight
+        void Grow(size_t helpers) noexcept
+        {
+            while (m_threadCount < helpers)
+            {
+                try
+                {
+                    std::thread(&TaskPool::ThreadMain, this, m_threadCount + 1, m_generation).detach();
+                }
+                catch (...)
+                {
+                    return;
+                }
+                ++m_threadCount;
+            }
+        }
+
+        void ThreadMain(size_t self, uint64_t seen) noexcept
+        {
+            t_inParallelFor = true;
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            for (;;)
+            {
+                m_wake.wait(lock, [&] { return m_generation != seen; });
+                seen = m_generation;
+
+                if (self > m_jobHelpers)
+                    continue;
+
+                TaskState* job = m_job;
+                lock.unlock();
+                RunWorker(*job, self);
+                lock.lock();
+
+                if (--m_pending == 0)
+                    m_done.notify_one();
+            }
+        }
+    };
+}
+
+_Use_decl_annotations_
+size_t DirectX::Internal::GetWorkerThreadCount(size_t maxThreads, size_t taskCount) noexcept
+{
+    size_t count = maxThreads;
+    if (!count)
+    {
+        count = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+
+    return std::max<size_t>(1, std::min(count, taskCount));
+}
+
+_Use_decl_annotations_
+HRESULT DirectX::Internal::ParallelFor(
+    size_t count,
+    size_t maxThreads,
+    const std::function<HRESULT __cdecl(size_t)>& task) noexcept
+{
+    if (!count)
+        return S_OK;
+
+    if (count > UINT32_MAX)
+        return HRESULT_E_ARITHMETIC_OVERFLOW;
+
+    // Nested calls from inside a task run inline rather than oversubscribing the machine
+    const size_t nthreads = t_inParallelFor ? 1 : GetWorkerThreadCount(maxThreads, count);
+
+    if (nthreads == 1)
+    {
+        for (size_t j = 0; j < count; ++j)
+        {
+            const HRESULT hr = task(j);
+            if (FAILED(hr))
+                return hr;
+        }
+        return S_OK;
+    }
+
+    if (nthreads > SIZE_MAX / sizeof(TaskRange))
+        return HRESULT_E_ARITHMETIC_OVERFLOW;
+
+    std::unique_ptr<TaskRange[], aligned_deleter> ranges(
+        static_cast<TaskRange*>(_aligned_malloc(sizeof(TaskRange) * nthreads, alignof(TaskRange))));
+    if (!ranges)
+        return E_OUTOFMEMORY;
+
+    // TaskRange is trivially destructible, so the deleter only has to free the memory
+    for (size_t j = 0; j < nthreads; ++j)
+    {
+        new (&ranges[j]) TaskRange;
+        ranges[j].Set(static_cast<uint32_t>(j * count / nthreads), static_cast<uint32_t>((j + 1) * count / nthreads));
+    }
+
+    TaskState state(task, ranges.get(), nthreads);
+
+    t_inParallelFor = true;
+
+    // The calling thread acts as worker 0 and the rest come from the shared pool. If the pool is
+    // already serving another caller, fall back to short-lived threads. Any range whose worker
+    // can't be started is stolen by the others.
+    TaskPool* pool = TaskPool::Get();
+    if (pool && pool->TryRun(state, nthreads - 1))
+    {
+        t_inParallelFor = false;
+        return state.result.load();
+    }
+
+    std::vector<std::thread> workers;
+    try
+    {
+        workers.reserve(nthreads - 1);
+        for (size_t j = 1; j < nthreads; ++j)
+        {
+            workers.emplace_back(RunPooledWorker, std::ref(state), j);
+        }
+    }
+    catch (...)
+    {
+    }
+
+    RunWorker(state, 0);
+
+    for (auto& t : workers)
+    {
+        t.join();
+    }
+
+    t_inParallelFor = false;
+
+    return state.result.load();
+}
@@ -0,0 +1,191 @@
+//--------------------------------------------------------------------------------------
+// File: alphacoverage.cpp
+//
+// Checks the alpha scale ScaleMipMapsAlphaForCoverage picks for a mip whose quads alternate
+// between high and low alpha. A reference that measures all 8x8 bilinear samples of every quad
+// must agree with the library; the first sample of each quad alone, as earlier releases
+// measured, is biased towards one corner and picks a clearly different scale
+//
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+//
+// http://go.microsoft.com/fwlink/?LinkId=248926
+//--------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+
+#include "DirectXTex.h"
+#include "testutil.h"
+
+using namespace DirectX;
+using namespace TestUtil;
+
+namespace
+{
+    constexpr size_t c_Size = 64;
+    constexpr size_t c_Samples = 8;
+    constexpr float c_AlphaReference = 0.5f;
+    constexpr float c_MaxScale = 4.f;
+
+    inline float GetAlpha(const Image& image, size_t x, size_t y) noexcept
+    {
+        return reinterpret_cast<const float*>(image.pixels + y * image.rowPitch)[x * 4 + 3];
+    }
+
+    // Fraction of the bilinear samples of saturate(alpha * scale) above c_AlphaReference, over
+    // every 2x2 quad; with firstOnly, only the sample nearest the top-left corner of each quad
+    double MeasureCoverage(const Image& image, float scale, bool firstOnly) noexcept
+    {
+        const size_t n = firstOnly ? 1 : c_Samples;
+
+        uint64_t passed = 0;
+        uint64_t total = 0;
+        for (size_t y = 0; y + 1 < image.height; ++y)
+        {
+            for (size_t x = 0; x + 1 < image.width; ++x)
+            {
+                const float a00 = std::min(GetAlpha(image, x, y) * scale, 1.f);
+                const float a01 = std::min(GetAlpha(image, x, y + 1) * scale, 1.f);
+                const float a10 = std::min(GetAlpha(image, x + 1, y) * scale, 1.f);
+                const float a11 = std::min(GetAlpha(image, x + 1, y + 1) * scale, 1.f);
+
+                for (size_t sy = 0; sy < n; ++sy)
+                {
+                    const float fy = (float(sy) + 0.5f) / float(c_Samples);
+                    for (size_t sx = 0; sx < n; ++sx)
+                    {
+                        const float fx = (float(sx) + 0.5f) / float(c_Samples);
+                        const float v = (1.f - fx) * (1.f - fy) * a00 + (1.f - fx) * fy * a01 + fx * (1.f - fy) * a10 + fx * fy * a11;
+                        if (v > c_AlphaReference)
+                            ++passed;
+                        ++total;
+                    }
+                }
+            }
+        }
+
+        return total ? double(passed) / double(total) : 0.0;
+    }
+
+    // Smallest scale in [0, c_MaxScale] at which the coverage reaches the target
+    float ReferenceScale(const Image& image, double targetCoverage, bool firstOnly) noexcept
+    {
+        float lo = 0.f;
+        float hi = c_MaxScale;
+        if (MeasureCoverage(image, hi, firstOnly) < targetCoverage)
+            return hi;
+
+        for (int j = 0; j < 24; ++j)
+        {
+            const float mid = 0.5f * (lo + hi);
+            if (MeasureCoverage(image, mid, firstOnly) >= targetCoverage)
+                hi = mid;
+            else
+                lo = mid;
+        }
+
+        return hi;
+    }
+
+    // Base level of uniform random alpha; the mip alternates high and low alpha like a checkerboard,
+    // so the top-left sample of a quad sees mostly high alpha on half of the quads
+    HRESULT CreateMipChain(ScratchImage& image)
+    {
+        HRESULT hr = image.Initialize2D(DXGI_FORMAT_R32G32B32A32_FLOAT, c_Size, c_Size, 1, 2);
+        if (FAILED(hr))
+            return hr;
+
+        Random random(0xA1FAC0DEu);
+        for (size_t level = 0; level < 2; ++level)
+        {
+            const Image* img = image.GetImage(level, 0, 0);
+            for (size_t y = 0; y < img->height; ++y)
+            {
+                auto row = reinterpret_cast<float*>(img->pixels + y * img->rowPitch);
+                for (size_t x = 0; x < img->width; ++x)
+                {
+                    const float v = random.NextFloat();
+                    row[x * 4 + 0] = 0.5f;
+                    row[x * 4 + 1] = 0.5f;
+                    row[x * 4 + 2] = 0.5f;
+                    if (!level)
+                        row[x * 4 + 3] = v;
+                    else
+                        row[x * 4 + 3] = ((x + y) & 1) ? (0.2f * v) : (0.3f + 0.4f * v);
+                }
+            }
+        }
+
+        return S_OK;
+    }
+}
+
+int main()
+{
+    ScratchImage source;
+    HRESULT hr = CreateMipChain(source);
+    if (FAILED(hr))
+    {
+        printf("ERROR: failed creating mip chain (%08X)\n", static_cast<unsigned int>(hr));
+        return 1;
+    }
+
+    ScratchImage scaled;
+    hr = scaled.Initialize(source.GetMetadata());
+    if (SUCCEEDED(hr))
+    {
+        hr = ScaleMipMapsAlphaForCoverage(source.GetImages(), source.GetImageCount(), source.GetMetadata(), 0,
+            c_AlphaReference, scaled);
+    }
+
+    if (FAILED(hr))
+    {
+        printf("ERROR: ScaleMipMapsAlphaForCoverage failed (%08X)\n", static_cast<unsigned int>(hr));
+        return 1;
+    }
+
+    // The float format keeps alpha * scale unclamped, so any texel with alpha gives the scale
+    const Image& base = *source.GetImage(0, 0, 0);
+    const Image& mip = *source.GetImage(1, 0, 0);
+    const Image& result = *scaled.GetImage(1, 0, 0);
+
+    float scale = 0.f;
+    for (size_t x = 0; x < mip.width; ++x)
+    {
+        const float alpha = GetAlpha(mip, x, 0);
+        if (alpha > 0.f)
+        {
+            scale = GetAlpha(result, x, 0) / alpha;
+            break;
+        }
+    }
+
+    const double target = MeasureCoverage(base, 1.f, false);
+    const float expected = ReferenceScale(mip, target, false);
+
+    const double firstTarget = MeasureCoverage(base, 1.f, true);
+    const float firstSample = ReferenceScale(mip, firstTarget, true);
+
+    printf("target coverage %.4f\n", target);
+    printf("scale %.4f, all samples reference %.4f (coverage %.4f)\n", double(scale), double(expected),
+        MeasureCoverage(mip, scale, false));
+    printf("first sample reference %.4f (coverage %.4f)\n", double(firstSample), MeasureCoverage(mip, firstSample, false));
+
+    int failures = 0;
+    if (fabsf(scale - expected) > 0.01f)
+    {
+        printf("FAILED: scale %.4f does not match the all samples reference %.4f\n", double(scale), double(expected));
+        ++failures;
+    }
+
+    if (fabsf(scale - firstSample) < 0.1f)
+    {
+        printf("FAILED: scale %.4f is not distinguishable from the first sample reference %.4f\n", double(scale), double(firstSample));
+        ++failures;
+    }
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,230 @@
+//--------------------------------------------------------------------------------------
+// File: bcdeterminism.cpp
+//
+// Checks that BC compression output only depends on the input and the options: every
+// thread count and every encoder dispatch path must produce byte-identical results
+//
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+//
+// http://go.microsoft.com/fwlink/?LinkId=248926
+//--------------------------------------------------------------------------------------
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+
+#include "DirectXTex.h"
+#include "testutil.h"
+
+using namespace DirectX;
+using namespace TestUtil;
+
+namespace
+{
+    uint64_t HashPixels(const ScratchImage& image) noexcept
+    {
+        // FNV-1a
+        uint64_t h = 14695981039346656037ull;
+        const uint8_t* pixels = image.GetPixels();
+        for (size_t i = 0; i < image.GetPixelsSize(); ++i)
+        {
+            h = (h ^ pixels[i]) * 1099511628211ull;
+        }
+        return h;
+    }
+
+    // 70x45 (not a multiple of 4), 3 mips, 2 array slices: value noise plus flat tiles so the
+    // single-color paths, the duplicate-block cache and RDO all get exercised
+    HRESULT CreateCorpus(ScratchImage& image)
+    {
+        ScratchImage base;
+        HRESULT hr = base.Initialize2D(DXGI_FORMAT_R32G32B32A32_FLOAT, 70, 45, 2, 1);
+        if (FAILED(hr))
+            return hr;
+
+        Random random(0x12345678u);
+        for (size_t item = 0; item < 2; ++item)
+        {
+            const Image* img = base.GetImage(0, item, 0);
+            for (size_t y = 0; y < img->height; ++y)
+            {
+                auto row = reinterpret_cast<float*>(img->pixels + y * img->rowPitch);
+                for (size_t x = 0; x < img->width; ++x)
+                {
+                    for (size_t c = 0; c < 4; ++c)
+                    {
+                        const float noise = random.NextFloat();
+
+                        float v;
+                        if (((x / 8) + (y / 8)) % 3 == 0)
+                        {
+                            // Flat tile, repeated across the image
+                            v = (c == 3) ? 1.f : 0.25f * float(c + 1);
+                        }
+                        else
+                        {
+                            v = 0.5f * noise + 0.5f * float((x + y * 3 + c * 17 + item * 5) % 64) / 63.f;
+                        }
+
+                        row[x * 4 + c] = v;
+                    }
+                }
+            }
+        }
+
+        return GenerateMipMaps(base.GetImages(), base.GetImageCount(), base.GetMetadata(), TEX_FILTER_BOX, 3, image);
+    }
+
+    struct Variant
+    {
+        const char* name;
+        TEX_COMPRESS_FLAGS flags;
+        float rdoLambda;
+    };
+
+    const Variant g_Variants[] =
+    {
+        { "default",    TEX_COMPRESS_DEFAULT,   0.f },
+        { "scalar",     TEX_COMPRESS_SCALAR,    0.f },
+        { "dither",     TEX_COMPRESS_DITHER,    0.f },
+        { "rdo",        TEX_COMPRESS_DEFAULT,   8.f },
+        { "scalar+rdo", TEX_COMPRESS_SCALAR,    8.f },
+    };
+
+    const DXGI_FORMAT g_Formats[] =
+    {
+        DXGI_FORMAT_BC1_UNORM,
+        DXGI_FORMAT_BC2_UNORM,
+        DXGI_FORMAT_BC3_UNORM_SRGB,
+        DXGI_FORMAT_BC4_UNORM,
+        DXGI_FORMAT_BC5_SNORM,
+        DXGI_FORMAT_BC6H_UF16,
+        DXGI_FORMAT_BC7_UNORM,
+    };
+
+    // 0 is "serial" (no TEX_COMPRESS_PARALLEL); the rest are maxThreads with TEX_COMPRESS_PARALLEL,
+    // where a limit of 0 means every hardware thread
+    constexpr uint32_t SERIAL = UINT32_MAX;
+    const uint32_t g_Threads[] = { SERIAL, 1, 2, 3, 8, 0 };
+
+    bool IsBC1to3(DXGI_FORMAT format) noexcept
+    {
+        switch (format)
+        {
+        case DXGI_FORMAT_BC1_UNORM:
+        case DXGI_FORMAT_BC2_UNORM:
+        case DXGI_FORMAT_BC3_UNORM_SRGB:
+            return true;
+
+        default:
+            return false;
+        }
+    }
+}
+
+int main()
+{
+    ScratchImage corpus;
+    HRESULT hr = CreateCorpus(corpus);
+    if (FAILED(hr))
+    {
+        printf("ERROR: failed creating test corpus (%08X)\n", static_cast<unsigned int>(hr));
+        return 1;
+    }
+
+    int failures = 0;
+
+    for (const DXGI_FORMAT format : g_Formats)
+    {
+        uint64_t defaultHash = 0;
+
+        for (const Variant& variant : g_Variants)
+        {
+            uint64_t baseline = 0;
+
+            for (const uint32_t threads : g_Threads)
+            {
+                CompressOptions options = {};
+                options.flags = variant.flags;
+                options.threshold = TEX_THRESHOLD_DEFAULT;
+                options.alphaWeight = TEX_ALPHA_WEIGHT_DEFAULT;
+                options.bc7Level = 3;
+                options.rdoLambda = variant.rdoLambda;
+                if (threads != SERIAL)
+                {
+                    options.flags |= TEX_COMPRESS_PARALLEL;
+                    options.maxThreads = threads;
+                }
+
+                ScratchImage result;
+                hr = CompressEx(corpus.GetImages(), corpus.GetImageCount(), corpus.GetMetadata(), format, options, result);
+                if (FAILED(hr))
+                {
+                    printf("ERROR: format %d %s threads %d failed (%08X)\n",
+                        int(format), variant.name, (threads == SERIAL) ? -1 : int(threads), static_cast<unsigned int>(hr));
+                    ++failures;
+                    continue;
+                }
+
+                const uint64_t hash = HashPixels(result);
+                if (threads == SERIAL)
+                {
+                    baseline = hash;
+                }
+                else if (hash != baseline)
+                {
+                    printf("FAILED: format %d %s output with %u threads differs from serial\n",
+                        int(format), variant.name, threads);
+                    ++failures;
+                }
+
+                // Check decompression is just as independent of threading
+                if (threads == SERIAL || threads == 2)
+                {
+                    ScratchImage serial;
+                    ScratchImage parallel;
+                    hr = Decompress(result.GetImages(), result.GetImageCount(), result.GetMetadata(), DXGI_FORMAT_UNKNOWN, serial);
+                    if (SUCCEEDED(hr))
+                    {
+                        hr = Decompress(result.GetImages(), result.GetImageCount(), result.GetMetadata(), DXGI_FORMAT_UNKNOWN,
+                            TEX_DECOMPRESS_PARALLEL, (threads == SERIAL) ? 0 : threads, parallel);
+                    }
+
+                    if (FAILED(hr))
+                    {
+                        printf("ERROR: format %d %s decompress failed (%08X)\n", int(format), variant.name, static_cast<unsigned int>(hr));
+                        ++failures;
+                    }
+                    else if (HashPixels(serial) != HashPixels(parallel))
+                    {
+                        printf("FAILED: format %d %s parallel decompress differs from serial\n", int(format), variant.name);
+                        ++failures;
+                    }
+                }
+            }
+
+            // The scalar and multi-block BC1-3 encoders must agree
+            if (!strcmp(variant.name, "default"))
+            {
+                defaultHash = baseline;
+            }
+            else if (!strcmp(variant.name, "scalar") && IsBC1to3(format) && baseline != defaultHash)
+            {
+                printf("FAILED: format %d scalar and multi-block encoders differ\n", int(format));
+                ++failures;
+            }
+        }
+    }
+
+    if (failures)
+    {
+        printf("%d failures\n", failures);
+        return 1;
+    }
+
+    printf("bcdeterminism: %zu formats x %zu variants x %zu thread counts matched\n",
+        std::size(g_Formats), std::size(g_Variants), std::size(g_Threads));
+    return 0;
+}
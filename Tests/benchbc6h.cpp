@@ -0,0 +1,200 @@
+//--------------------------------------------------------------------------------------
+// File: benchbc6h.cpp
+//
+// Speed and error of the exhaustive BC6H mode search against TEX_COMPRESS_BC6H_QUICK on
+// a synthetic corpus of four 128x128 HDR images (sky gradient, sun highlight, lightmap
+// checker, wide-range exponential), single threaded
+//
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+//
+// http://go.microsoft.com/fwlink/?LinkId=248926
+//--------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+
+#include "DirectXTex.h"
+#include "testutil.h"
+
+using namespace DirectX;
+using namespace TestUtil;
+
+namespace
+{
+    constexpr size_t c_Size = 128;
+    constexpr size_t c_Images = 4;
+
+    HRESULT CreateCorpus(ScratchImage& image)
+    {
+        HRESULT hr = image.Initialize2D(DXGI_FORMAT_R32G32B32A32_FLOAT, c_Size, c_Size, c_Images, 1);
+        if (FAILED(hr))
+            return hr;
+
+        Random random(0x5EED6B6Bu);
+        for (size_t item = 0; item < c_Images; ++item)
+        {
+            const Image* img = image.GetImage(0, item, 0);
+            for (size_t y = 0; y < c_Size; ++y)
+            {
+                auto row = reinterpret_cast<float*>(img->pixels + y * img->rowPitch);
+                for (size_t x = 0; x < c_Size; ++x)
+                {
+                    const float u = float(x) / float(c_Size - 1);
+                    const float v = float(y) / float(c_Size - 1);
+                    const float noise = random.NextFloat();
+
+                    float rgb[3] = {};
+                    switch (item)
+                    {
+                    case 0: // Sky gradient
+                        rgb[0] = 0.2f + 0.6f * v;
+                        rgb[1] = 0.4f + 0.5f * v;
+                        rgb[2] = 1.0f + 0.5f * u;
+                        break;
+
+                    case 1: // Sun highlight over a dim background
+                        {
+                            const float dx = u - 0.6f;
+                            const float dy = v - 0.3f;
+                            const float sun = 200.f * expf(-(dx * dx + dy * dy) * 400.f);
+                            rgb[0] = 0.3f + sun;
+                            rgb[1] = 0.25f + 0.9f * sun;
+                            rgb[2] = 0.2f + 0.7f * sun;
+                        }
+                        break;
+
+                    case 2: // Lightmap checker with a little noise
+                        {
+                            const float light = (((x / 8) + (y / 8)) % 2) ? 4.f : 0.05f;
+                            rgb[0] = light * (1.f + 0.1f * noise);
+                            rgb[1] = light * 0.9f;
+                            rgb[2] = light * 0.7f;
+                        }
+                        break;
+
+                    default: // Exponential ramp over a wide range
+                        rgb[0] = exp2f(-8.f + 20.f * u);
+                        rgb[1] = exp2f(-8.f + 20.f * v);
+                        rgb[2] = exp2f(-8.f + 20.f * noise);
+                        break;
+                    }
+
+                    row[x * 4 + 0] = rgb[0];
+                    row[x * 4 + 1] = rgb[1];
+                    row[x * 4 + 2] = rgb[2];
+                    row[x * 4 + 3] = 1.f;
+                }
+            }
+        }
+
+        return S_OK;
+    }
+
+    // RMSE of the RGB channels, and of their log2 so dark and bright texels weigh the same
+    void Error(const ScratchImage& a, const ScratchImage& b, double& rmse, double& logRmse) noexcept
+    {
+        double sum = 0.0;
+        double logSum = 0.0;
+        uint64_t count = 0;
+        for (size_t item = 0; item < c_Images; ++item)
+        {
+            const Image* ia = a.GetImage(0, item, 0);
+            const Image* ib = b.GetImage(0, item, 0);
+            for (size_t y = 0; y < c_Size; ++y)
+            {
+                auto ra = reinterpret_cast<const float*>(ia->pixels + y * ia->rowPitch);
+                auto rb = reinterpret_cast<const float*>(ib->pixels + y * ib->rowPitch);
+                for (size_t x = 0; x < c_Size; ++x)
+                {
+                    for (size_t c = 0; c < 3; ++c)
+                    {
+                        const double va = ra[x * 4 + c];
+                        const double vb = rb[x * 4 + c];
+                        sum += (va - vb) * (va - vb);
+
+                        const double d = log2(std::max(va, 1e-6)) - log2(std::max(vb, 1e-6));
+                        logSum += d * d;
+                        ++count;
+                    }
+                }
+            }
+        }
+
+        rmse = sqrt(sum / double(count));
+        logRmse = sqrt(logSum / double(count));
+    }
+
+    struct Path
+    {
+        const char*         name;
+        TEX_COMPRESS_FLAGS  flags;
+    };
+
+    const Path g_Paths[] =
+    {
+        { "exhaustive", TEX_COMPRESS_DEFAULT },
+        { "BC6H_QUICK", TEX_COMPRESS_BC6H_QUICK },
+    };
+}
+
+int main()
+{
+    ScratchImage corpus;
+    HRESULT hr = CreateCorpus(corpus);
+    if (FAILED(hr))
+    {
+        printf("ERROR: failed creating test corpus (%08X)\n", static_cast<unsigned int>(hr));
+        return 1;
+    }
+
+    constexpr size_t blocks = c_Images * (c_Size / 4) * (c_Size / 4);
+
+    printf("%zu x %zux%zu HDR, %zu BC6H_UF16 blocks, single thread\n", c_Images, c_Size, c_Size, blocks);
+    printf("%-12s %10s %10s %10s %10s\n", "path", "time", "blocks/s", "RMSE", "log2 RMSE");
+
+    double exhaustiveTime = 0.0;
+    for (const Path& path : g_Paths)
+    {
+        CompressOptions options = {};
+        options.flags = path.flags;
+        options.threshold = TEX_THRESHOLD_DEFAULT;
+        options.alphaWeight = TEX_ALPHA_WEIGHT_DEFAULT;
+
+        ScratchImage compressed;
+        const double t = BestOf(1, hr, [&]()
+            {
+                return CompressEx(corpus.GetImages(), corpus.GetImageCount(), corpus.GetMetadata(), DXGI_FORMAT_BC6H_UF16, options, compressed);
+            });
+
+        ScratchImage decompressed;
+        if (SUCCEEDED(hr))
+        {
+            hr = Decompress(compressed.GetImages(), compressed.GetImageCount(), compressed.GetMetadata(), DXGI_FORMAT_R32G32B32A32_FLOAT, decompressed);
+        }
+
+        if (FAILED(hr))
+        {
+            printf("ERROR: %s failed (%08X)\n", path.name, static_cast<unsigned int>(hr));
+            return 1;
+        }
+
+        double rmse, logRmse;
+        Error(corpus, decompressed, rmse, logRmse);
+
+        printf("%-12s %9.2fs %10.0f %10.5f %10.5f\n", path.name, t, double(blocks) / t, rmse, logRmse);
+
+        if (path.flags == TEX_COMPRESS_DEFAULT)
+        {
+            exhaustiveTime = t;
+        }
+        else
+        {
+            printf("speedup %.1fx\n", exhaustiveTime / t);
+        }
+    }
+
+    return 0;
+}
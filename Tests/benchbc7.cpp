@@ -0,0 +1,153 @@
+//--------------------------------------------------------------------------------------
+// File: benchbc7.cpp
+//
+// Speed and quality of each CompressOptions::bc7Level on a synthetic corpus of four
+// 256x256 RGBA images (gradient, periodic, hard-edged, varying alpha), single threaded
+//
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+//
+// http://go.microsoft.com/fwlink/?LinkId=248926
+//--------------------------------------------------------------------------------------
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+
+#include "DirectXTex.h"
+#include "testutil.h"
+
+using namespace DirectX;
+using namespace TestUtil;
+
+namespace
+{
+    constexpr size_t c_Size = 256;
+    constexpr size_t c_Images = 4;
+
+    HRESULT CreateCorpus(ScratchImage& image)
+    {
+        HRESULT hr = image.Initialize2D(DXGI_FORMAT_R8G8B8A8_UNORM, c_Size, c_Size, c_Images, 1);
+        if (FAILED(hr))
+            return hr;
+
+        Random random(0xC0FFEE11u);
+        for (size_t item = 0; item < c_Images; ++item)
+        {
+            const Image* img = image.GetImage(0, item, 0);
+            for (size_t y = 0; y < c_Size; ++y)
+            {
+                uint8_t* row = img->pixels + y * img->rowPitch;
+                for (size_t x = 0; x < c_Size; ++x)
+                {
+                    const uint32_t noise = (random.Next() >> 24) & 0xF;
+
+                    uint32_t rgba[4] = {};
+                    switch (item)
+                    {
+                    case 0: // Gradient with a little noise
+                        rgba[0] = uint32_t(x);
+                        rgba[1] = uint32_t(y);
+                        rgba[2] = uint32_t((x + y) / 2) ^ noise;
+                        rgba[3] = 255;
+                        break;
+
+                    case 1: // Periodic
+                        rgba[0] = uint32_t(127.5 + 127.5 * sin(double(x) * 0.2));
+                        rgba[1] = uint32_t(127.5 + 127.5 * cos(double(y) * 0.13));
+                        rgba[2] = uint32_t(127.5 + 127.5 * sin(double(x + y) * 0.07));
+                        rgba[3] = 255;
+                        break;
+
+                    case 2: // Hard edges between flat regions
+                        rgba[0] = ((x / 13 + y / 7) % 3) * 120;
+                        rgba[1] = ((x / 5) % 2) ? 240 : 16;
+                        rgba[2] = ((y / 9) % 2) ? 200 : 40;
+                        rgba[3] = 255;
+                        break;
+
+                    default: // Varying alpha
+                        rgba[0] = uint32_t(x) ^ noise;
+                        rgba[1] = 255 - uint32_t(y);
+                        rgba[2] = 128;
+                        rgba[3] = uint32_t((x * 3 + y * 5) / 8) & 0xFF;
+                        break;
+                    }
+
+                    for (size_t c = 0; c < 4; ++c)
+                    {
+                        row[x * 4 + c] = static_cast<uint8_t>(rgba[c] > 255 ? 255 : rgba[c]);
+                    }
+                }
+            }
+        }
+
+        return S_OK;
+    }
+
+    struct Level
+    {
+        const char*         name;
+        uint32_t            level;
+        TEX_COMPRESS_FLAGS  flags;
+    };
+
+    const Level g_Levels[] =
+    {
+        { "1",              1,                      TEX_COMPRESS_DEFAULT },
+        { "2",              2,                      TEX_COMPRESS_DEFAULT },
+        { "3",              3,                      TEX_COMPRESS_DEFAULT },
+        { "4",              4,                      TEX_COMPRESS_DEFAULT },
+        { "5",              5,                      TEX_COMPRESS_DEFAULT },
+        { "6",              6,                      TEX_COMPRESS_DEFAULT },
+        { "7",              7,                      TEX_COMPRESS_DEFAULT },
+        { "default+QUICK",  TEX_BC7_LEVEL_DEFAULT,  TEX_COMPRESS_BC7_QUICK },
+        { "default",        TEX_BC7_LEVEL_DEFAULT,  TEX_COMPRESS_DEFAULT },
+    };
+}
+
+int main()
+{
+    ScratchImage corpus;
+    HRESULT hr = CreateCorpus(corpus);
+    if (FAILED(hr))
+    {
+        printf("ERROR: failed creating test corpus (%08X)\n", static_cast<unsigned int>(hr));
+        return 1;
+    }
+
+    printf("%zu x %zux%zu RGBA, single thread\n", c_Images, c_Size, c_Size);
+    printf("%-14s %10s %10s %9s\n", "level", "time", "Mtexel/s", "PSNR");
+
+    for (const Level& level : g_Levels)
+    {
+        CompressOptions options = {};
+        options.flags = level.flags;
+        options.threshold = TEX_THRESHOLD_DEFAULT;
+        options.alphaWeight = TEX_ALPHA_WEIGHT_DEFAULT;
+        options.bc7Level = level.level;
+
+        ScratchImage compressed;
+        const double t = BestOf(1, hr, [&]()
+            {
+                return CompressEx(corpus.GetImages(), corpus.GetImageCount(), corpus.GetMetadata(), DXGI_FORMAT_BC7_UNORM, options, compressed);
+            });
+
+        ScratchImage decompressed;
+        if (SUCCEEDED(hr))
+        {
+            hr = Decompress(compressed.GetImages(), compressed.GetImageCount(), compressed.GetMetadata(), DXGI_FORMAT_R8G8B8A8_UNORM, decompressed);
+        }
+
+        if (FAILED(hr))
+        {
+            printf("ERROR: level %s failed (%08X)\n", level.name, static_cast<unsigned int>(hr));
+            return 1;
+        }
+
+        printf("%-14s %9.2fs %10.3f %6.2f dB\n", level.name, t,
+            double(c_Size * c_Size * c_Images) / t / 1e6, PSNR8(corpus, decompressed));
+    }
+
+    return 0;
+}
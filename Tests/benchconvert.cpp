@@ -0,0 +1,168 @@
+//--------------------------------------------------------------------------------------
+// File: benchconvert.cpp
+//
+// Compares Convert on the packed format pairs against the float scanline path it used
+// before (LoadScanline -> ConvertScanline -> StoreScanline), single threaded
+//
+//   benchconvert [width height]
+//
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+//
+// http://go.microsoft.com/fwlink/?LinkId=248926
+//--------------------------------------------------------------------------------------
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// The float reference path uses the library's internal scanline helpers
+#include "DirectXTexP.h"
+#include "testutil.h"
+
+using namespace DirectX;
+using namespace DirectX::Internal;
+using namespace TestUtil;
+
+namespace
+{
+    constexpr int c_Runs = 5;
+
+    struct Pair
+    {
+        DXGI_FORMAT source;
+        DXGI_FORMAT target;
+        const char* name;
+    };
+
+    const Pair g_Pairs[] =
+    {
+        { DXGI_FORMAT_R8G8B8A8_UNORM,       DXGI_FORMAT_B8G8R8A8_UNORM,         "RGBA8 -> BGRA8" },
+        { DXGI_FORMAT_B8G8R8A8_UNORM,       DXGI_FORMAT_R8G8B8A8_UNORM_SRGB,    "BGRA8 -> RGBA8_SRGB" },
+        { DXGI_FORMAT_R8G8B8A8_UNORM,       DXGI_FORMAT_R16G16B16A16_FLOAT,     "RGBA8 -> RGBA16F" },
+        { DXGI_FORMAT_R8G8B8A8_UNORM_SRGB,  DXGI_FORMAT_R10G10B10A2_UNORM,      "RGBA8_SRGB -> RGB10A2" },
+        { DXGI_FORMAT_R10G10B10A2_UNORM,    DXGI_FORMAT_R16G16B16A16_UNORM,     "RGB10A2 -> RGBA16" },
+        { DXGI_FORMAT_R10G10B10A2_UNORM,    DXGI_FORMAT_R16G16B16A16_FLOAT,     "RGB10A2 -> RGBA16F" },
+        { DXGI_FORMAT_R16G16B16A16_FLOAT,   DXGI_FORMAT_R8G8B8A8_UNORM,         "RGBA16F -> RGBA8" },
+        { DXGI_FORMAT_R16G16B16A16_FLOAT,   DXGI_FORMAT_R10G10B10A2_UNORM,      "RGBA16F -> RGB10A2" },
+    };
+
+    // WIC is bypassed so both sides measure the library's own code
+    constexpr TEX_FILTER_FLAGS c_Filter = TEX_FILTER_FORCE_NON_WIC;
+
+    HRESULT CreateSource(DXGI_FORMAT format, size_t width, size_t height, ScratchImage& image)
+    {
+        ScratchImage noise;
+        HRESULT hr = noise.Initialize2D(DXGI_FORMAT_R32G32B32A32_FLOAT, width, height, 1, 1);
+        if (FAILED(hr))
+            return hr;
+
+        Random random(0x13579BDFu);
+        auto pixels = reinterpret_cast<float*>(noise.GetPixels());
+        for (size_t i = 0; i < width * height * 4; ++i)
+        {
+            pixels[i] = random.NextFloat();
+        }
+
+        return Convert(*noise.GetImage(0, 0, 0), format, c_Filter, TEX_THRESHOLD_DEFAULT, image);
+    }
+
+    HRESULT ConvertFloat(const Image& src, const Image& dest, XMVECTOR* scanline) noexcept
+    {
+        const uint8_t* pSrc = src.pixels;
+        uint8_t* pDest = dest.pixels;
+        for (size_t y = 0; y < src.height; ++y)
+        {
+            if (!LoadScanline(scanline, src.width, pSrc, src.rowPitch, src.format))
+                return E_FAIL;
+
+            ConvertScanline(scanline, src.width, dest.format, src.format, c_Filter);
+
+            if (!StoreScanline(pDest, dest.rowPitch, dest.format, scanline, src.width, TEX_THRESHOLD_DEFAULT))
+                return E_FAIL;
+
+            pSrc += src.rowPitch;
+            pDest += dest.rowPitch;
+        }
+        return S_OK;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    size_t width = 2048;
+    size_t height = 2048;
+    if (argc >= 3)
+    {
+        width = strtoul(argv[1], nullptr, 10);
+        height = strtoul(argv[2], nullptr, 10);
+        if (!width || !height)
+        {
+            printf("usage: benchconvert [width height]\n");
+            return 1;
+        }
+    }
+
+    auto scanline = make_AlignedArrayXMVECTOR(width);
+    if (!scanline)
+        return 1;
+
+    printf("%zux%zu, single thread, best of %d runs, GB/s of source data\n", width, height, c_Runs);
+    printf("%-24s %10s %10s %8s  %s\n", "pair", "float", "Convert", "speedup", "output");
+
+    int failures = 0;
+    for (const Pair& pair : g_Pairs)
+    {
+        ScratchImage source;
+        ScratchImage reference;
+        HRESULT hr = CreateSource(pair.source, width, height, source);
+        if (SUCCEEDED(hr))
+        {
+            hr = reference.Initialize2D(pair.target, width, height, 1, 1);
+        }
+        if (FAILED(hr))
+        {
+            printf("ERROR: %s setup failed (%08X)\n", pair.name, static_cast<unsigned int>(hr));
+            ++failures;
+            continue;
+        }
+
+        const Image& src = *source.GetImage(0, 0, 0);
+
+        const double floatTime = BestOf(c_Runs, hr, [&]()
+            {
+                return ConvertFloat(src, *reference.GetImage(0, 0, 0), scanline.get());
+            });
+
+        ScratchImage result;
+        double packedTime = 0.0;
+        if (SUCCEEDED(hr))
+        {
+            packedTime = BestOf(c_Runs, hr, [&]()
+                {
+                    return Convert(src, pair.target, c_Filter, TEX_THRESHOLD_DEFAULT, result);
+                });
+        }
+
+        if (FAILED(hr))
+        {
+            printf("ERROR: %s conversion failed (%08X)\n", pair.name, static_cast<unsigned int>(hr));
+            ++failures;
+            continue;
+        }
+
+        const bool identical = (result.GetPixelsSize() == reference.GetPixelsSize())
+            && !memcmp(result.GetPixels(), reference.GetPixels(), reference.GetPixelsSize());
+        if (!identical)
+        {
+            ++failures;
+        }
+
+        const double gb = double(source.GetPixelsSize()) / 1e9;
+        printf("%-24s %10.2f %10.2f %7.1fx  %s\n", pair.name,
+            gb / floatTime, gb / packedTime, floatTime / packedTime, identical ? "identical" : "DIFFERS");
+    }
+
+    return failures ? 1 : 0;
+}
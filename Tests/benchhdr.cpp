@@ -0,0 +1,145 @@
+//--------------------------------------------------------------------------------------
+// File: benchhdr.cpp
+//
+// Times LoadFromHDRMemory serially and with HDR_FLAGS_PARALLEL for each output format
+//
+//   benchhdr [width height]
+//
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+//
+// http://go.microsoft.com/fwlink/?LinkId=248926
+//--------------------------------------------------------------------------------------
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "DirectXTex.h"
+#include "testutil.h"
+
+using namespace DirectX;
+using namespace TestUtil;
+
+namespace
+{
+    constexpr int c_Runs = 5;
+
+    // Smooth gradients (long RLE runs) mixed with noisy bands (mostly literals)
+    HRESULT CreateSource(size_t width, size_t height, Blob& blob)
+    {
+        ScratchImage image;
+        HRESULT hr = image.Initialize2D(DXGI_FORMAT_R32G32B32A32_FLOAT, width, height, 1, 1);
+        if (FAILED(hr))
+            return hr;
+
+        Random random(0x2468ACE1u);
+        const Image* img = image.GetImage(0, 0, 0);
+        for (size_t y = 0; y < img->height; ++y)
+        {
+            auto row = reinterpret_cast<float*>(img->pixels + y * img->rowPitch);
+            const bool noisy = ((y / 64) % 2) != 0;
+            for (size_t x = 0; x < img->width; ++x)
+            {
+                for (size_t c = 0; c < 3; ++c)
+                {
+                    float v = 4.f * float(x / 16) / float(width) + float(c) * 0.25f;
+                    if (noisy)
+                    {
+                        v += 16.f * random.NextFloat();
+                    }
+                    row[x * 4 + c] = v;
+                }
+                row[x * 4 + 3] = 1.f;
+            }
+        }
+
+        return SaveToHDRMemory(*img, blob);
+    }
+
+    struct Variant
+    {
+        const char* name;
+        HDR_FLAGS flags;
+    };
+
+    const Variant g_Variants[] =
+    {
+        { "R32G32B32A32_FLOAT", HDR_FLAGS_NONE },
+        { "R16G16B16A16_FLOAT", HDR_FLAGS_FORMAT_HALF },
+        { "R9G9B9E5_SHAREDEXP", HDR_FLAGS_FORMAT_SHAREDEXP },
+    };
+
+    // Best of c_Runs, in seconds
+    double TimeLoad(const Blob& blob, HDR_FLAGS flags, ScratchImage& result)
+    {
+        HRESULT hr;
+        const double best = BestOf(c_Runs, hr, [&]()
+            {
+                return LoadFromHDRMemory(blob.GetBufferPointer(), blob.GetBufferSize(), flags, nullptr, result);
+            });
+        if (FAILED(hr))
+        {
+            printf("ERROR: LoadFromHDRMemory failed (%08X)\n", static_cast<unsigned int>(hr));
+            return -1.0;
+        }
+        return best;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    size_t width = 4096;
+    size_t height = 2048;
+    if (argc >= 3)
+    {
+        width = strtoul(argv[1], nullptr, 10);
+        height = strtoul(argv[2], nullptr, 10);
+        if (!width || !height)
+        {
+            printf("usage: benchhdr [width height]\n");
+            return 1;
+        }
+    }
+
+    Blob blob;
+    HRESULT hr = CreateSource(width, height, blob);
+    if (FAILED(hr))
+    {
+        printf("ERROR: failed creating source image (%08X)\n", static_cast<unsigned int>(hr));
+        return 1;
+    }
+
+    printf("%zux%zu, %.1f MB .hdr, %u hardware threads, best of %d runs\n",
+        width, height, double(blob.GetBufferSize()) / 1e6, std::thread::hardware_concurrency(), c_Runs);
+    printf("%-20s %10s %10s %8s\n", "output", "serial", "parallel", "speedup");
+
+    int failures = 0;
+    for (const Variant& variant : g_Variants)
+    {
+        ScratchImage serial;
+        ScratchImage parallel;
+        const double serialTime = TimeLoad(blob, variant.flags, serial);
+        const double parallelTime = TimeLoad(blob, variant.flags | HDR_FLAGS_PARALLEL, parallel);
+        if (serialTime < 0 || parallelTime < 0)
+        {
+            ++failures;
+            continue;
+        }
+
+        if (serial.GetPixelsSize() != parallel.GetPixelsSize()
+            || memcmp(serial.GetPixels(), parallel.GetPixels(), serial.GetPixelsSize()) != 0)
+        {
+            printf("FAILED: %s parallel output differs from serial\n", variant.name);
+            ++failures;
+        }
+
+        printf("%-20s %8.1fms %8.1fms %7.2fx\n", variant.name,
+            serialTime * 1000.0, parallelTime * 1000.0, serialTime / parallelTime);
+    }
+
+    return failures ? 1 : 0;
+}
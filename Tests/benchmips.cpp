@@ -0,0 +1,209 @@
+//--------------------------------------------------------------------------------------
+// File: benchmips.cpp
+//
+// Times box-filtered GenerateMipMaps on the formats that take the integer path, and
+// measures how far it lands from a float reference: the same chain generated from a
+// R32G32B32A32_FLOAT copy of the base and converted back level by level
+//
+//   benchmips [size]
+//
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+//
+// http://go.microsoft.com/fwlink/?LinkId=248926
+//--------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "DirectXTex.h"
+#include "testutil.h"
+
+using namespace DirectX;
+using namespace TestUtil;
+
+namespace
+{
+    constexpr int c_Runs = 3;
+
+    struct Format
+    {
+        DXGI_FORMAT format;
+        const char* name;
+        size_t      channelBytes;
+    };
+
+    const Format g_Formats[] =
+    {
+        { DXGI_FORMAT_R8G8B8A8_UNORM,       "R8G8B8A8_UNORM",       1 },
+        { DXGI_FORMAT_R8G8B8A8_UNORM_SRGB,  "R8G8B8A8_UNORM_SRGB",  1 },
+        { DXGI_FORMAT_B8G8R8A8_UNORM_SRGB,  "B8G8R8A8_UNORM_SRGB",  1 },
+        { DXGI_FORMAT_R8G8_UNORM,           "R8G8_UNORM",           1 },
+        { DXGI_FORMAT_R8_UNORM,             "R8_UNORM",             1 },
+        { DXGI_FORMAT_R16G16B16A16_UNORM,   "R16G16B16A16_UNORM",   2 },
+        { DXGI_FORMAT_R16_UNORM,            "R16_UNORM",            2 },
+    };
+
+    // Noise over a gradient, so neighbouring texels differ and rounding matters
+    HRESULT CreateBase(DXGI_FORMAT format, size_t size, ScratchImage& image)
+    {
+        ScratchImage base;
+        HRESULT hr = base.Initialize2D(DXGI_FORMAT_R32G32B32A32_FLOAT, size, size, 1, 1);
+        if (FAILED(hr))
+            return hr;
+
+        Random random(0x0BADF00Du);
+        const Image* img = base.GetImage(0, 0, 0);
+        for (size_t y = 0; y < size; ++y)
+        {
+            auto row = reinterpret_cast<float*>(img->pixels + y * img->rowPitch);
+            for (size_t x = 0; x < size * 4; ++x)
+            {
+                const float noise = random.NextFloat();
+                row[x] = 0.75f * float(x / 4 + y) / float(2 * size) + 0.25f * noise;
+            }
+        }
+
+        return Convert(*img, format, TEX_FILTER_DEFAULT, TEX_THRESHOLD_DEFAULT, image);
+    }
+
+    // Best of c_Runs, in seconds
+    double TimeMips(const Image& base, TEX_FILTER_FLAGS filter, ScratchImage& mipChain)
+    {
+        HRESULT hr;
+        const double best = BestOf(c_Runs, hr, [&]() { return GenerateMipMaps(base, filter, 0, mipChain); });
+        if (FAILED(hr))
+        {
+            printf("ERROR: GenerateMipMaps failed (%08X)\n", static_cast<unsigned int>(hr));
+            return -1.0;
+        }
+        return best;
+    }
+
+    // Largest per-channel difference in units of the last place, and the number of texels
+    // with any difference, over every level below the base
+    void Compare(const ScratchImage& a, const ScratchImage& b, size_t channelBytes, uint32_t& maxDelta, uint64_t& differing, uint64_t& total)
+    {
+        maxDelta = 0;
+        differing = 0;
+        total = 0;
+
+        const size_t bpp = BitsPerPixel(a.GetMetadata().format) / 8;
+        for (size_t level = 1; level < a.GetMetadata().mipLevels; ++level)
+        {
+            const Image* ia = a.GetImage(level, 0, 0);
+            const Image* ib = b.GetImage(level, 0, 0);
+            for (size_t y = 0; y < ia->height; ++y)
+            {
+                const uint8_t* ra = ia->pixels + y * ia->rowPitch;
+                const uint8_t* rb = ib->pixels + y * ib->rowPitch;
+                for (size_t x = 0; x < ia->width; ++x)
+                {
+                    bool differs = false;
+                    for (size_t c = 0; c < bpp; c += channelBytes)
+                    {
+                        uint32_t va = ra[x * bpp + c];
+                        uint32_t vb = rb[x * bpp + c];
+                        if (channelBytes == 2)
+                        {
+                            va |= uint32_t(ra[x * bpp + c + 1]) << 8;
+                            vb |= uint32_t(rb[x * bpp + c + 1]) << 8;
+                        }
+
+                        const uint32_t delta = (va > vb) ? (va - vb) : (vb - va);
+                        maxDelta = std::max(maxDelta, delta);
+                        differs |= (delta != 0);
+                    }
+
+                    if (differs)
+                        ++differing;
+                    ++total;
+                }
+            }
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    size_t size = 4096;
+    if (argc >= 2)
+    {
+        size = strtoul(argv[1], nullptr, 10);
+        if (size < 2)
+        {
+            printf("usage: benchmips [size]\n");
+            return 1;
+        }
+    }
+
+    printf("%zux%zu full chain, TEX_FILTER_BOX, best of %d runs\n", size, size, c_Runs);
+    printf("%-20s %10s %10s %10s %6s %9s\n", "format", "integer", "parallel", "float", "max", "differ");
+
+    int failures = 0;
+    for (const Format& fmt : g_Formats)
+    {
+        ScratchImage base;
+        ScratchImage baseFloat;
+        HRESULT hr = CreateBase(fmt.format, size, base);
+        if (SUCCEEDED(hr))
+        {
+            hr = Convert(*base.GetImage(0, 0, 0), DXGI_FORMAT_R32G32B32A32_FLOAT, TEX_FILTER_DEFAULT, TEX_THRESHOLD_DEFAULT, baseFloat);
+        }
+        if (FAILED(hr))
+        {
+            printf("ERROR: %s setup failed (%08X)\n", fmt.name, static_cast<unsigned int>(hr));
+            ++failures;
+            continue;
+        }
+
+        ScratchImage serial;
+        ScratchImage parallel;
+        ScratchImage floatChain;
+        const double serialTime = TimeMips(*base.GetImage(0, 0, 0), TEX_FILTER_BOX, serial);
+        const double parallelTime = TimeMips(*base.GetImage(0, 0, 0), TEX_FILTER_BOX | TEX_FILTER_PARALLEL, parallel);
+        const double floatTime = TimeMips(*baseFloat.GetImage(0, 0, 0), TEX_FILTER_BOX, floatChain);
+        if (serialTime < 0 || parallelTime < 0 || floatTime < 0)
+        {
+            ++failures;
+            continue;
+        }
+
+        if (serial.GetPixelsSize() != parallel.GetPixelsSize()
+            || memcmp(serial.GetPixels(), parallel.GetPixels(), serial.GetPixelsSize()) != 0)
+        {
+            printf("FAILED: %s parallel output differs from serial\n", fmt.name);
+            ++failures;
+        }
+
+        ScratchImage reference;
+        hr = Convert(floatChain.GetImages(), floatChain.GetImageCount(), floatChain.GetMetadata(),
+            fmt.format, TEX_FILTER_DEFAULT, TEX_THRESHOLD_DEFAULT, reference);
+        if (FAILED(hr))
+        {
+            printf("ERROR: %s reference conversion failed (%08X)\n", fmt.name, static_cast<unsigned int>(hr));
+            ++failures;
+            continue;
+        }
+
+        uint32_t maxDelta;
+        uint64_t differing, total;
+        Compare(serial, reference, fmt.channelBytes, maxDelta, differing, total);
+        if (maxDelta > 1)
+        {
+            printf("FAILED: %s deviates from the float reference by %u\n", fmt.name, maxDelta);
+            ++failures;
+        }
+
+        printf("%-20s %8.1fms %8.1fms %8.1fms %6u %8.3f%%\n", fmt.name,
+            serialTime * 1000.0, parallelTime * 1000.0, floatTime * 1000.0,
+            maxDelta, 100.0 * double(differing) / double(total));
+    }
+
+    printf("float: the R32G32B32A32_FLOAT chain alone, without the conversions to and from it\n");
+
+    return failures ? 1 : 0;
+}
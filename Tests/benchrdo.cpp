@@ -0,0 +1,186 @@
+//--------------------------------------------------------------------------------------
+// File: benchrdo.cpp
+//
+// Size after zlib compression against PSNR for each CompressOptions::rdoLambda, on a
+// 512x512 synthetic image of fractal noise with flat patches, for BC1 and BC7
+//
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+//
+// http://go.microsoft.com/fwlink/?LinkId=248926
+//--------------------------------------------------------------------------------------
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include <zlib.h>
+
+#include "DirectXTex.h"
+#include "testutil.h"
+
+using namespace DirectX;
+using namespace TestUtil;
+
+namespace
+{
+    constexpr size_t c_Size = 512;
+
+    HRESULT CreateCorpus(ScratchImage& image)
+    {
+        HRESULT hr = image.Initialize2D(DXGI_FORMAT_R8G8B8A8_UNORM, c_Size, c_Size, 1, 1);
+        if (FAILED(hr))
+            return hr;
+
+        // Value noise on a 5-octave lattice, with a fixed random table per octave
+        constexpr size_t c_Octaves = 5;
+        constexpr size_t c_Lattice = 64;
+        Random random(0xFEEDBEEFu);
+        std::vector<float> lattice(c_Octaves * c_Lattice * c_Lattice * 3);
+        for (auto& v : lattice)
+        {
+            v = random.NextFloat();
+        }
+
+        const Image* img = image.GetImage(0, 0, 0);
+        for (size_t y = 0; y < c_Size; ++y)
+        {
+            uint8_t* row = img->pixels + y * img->rowPitch;
+            for (size_t x = 0; x < c_Size; ++x)
+            {
+                float rgb[3] = {};
+
+                // Flat patches cover a quarter of the image
+                if (((x / 96) + (y / 80)) % 4 == 0)
+                {
+                    rgb[0] = 0.8f;
+                    rgb[1] = 0.3f;
+                    rgb[2] = 0.1f;
+                }
+                else
+                {
+                    float amplitude = 0.5f;
+                    for (size_t octave = 0; octave < c_Octaves; ++octave)
+                    {
+                        const size_t period = c_Size >> (octave + 2);
+                        const float fx = float(x % period) / float(period);
+                        const float fy = float(y % period) / float(period);
+                        const size_t lx = (x / period) % c_Lattice;
+                        const size_t ly = (y / period) % c_Lattice;
+                        const size_t lx1 = (lx + 1) % c_Lattice;
+                        const size_t ly1 = (ly + 1) % c_Lattice;
+                        const float* table = &lattice[octave * c_Lattice * c_Lattice * 3];
+                        for (size_t c = 0; c < 3; ++c)
+                        {
+                            const float v00 = table[(ly * c_Lattice + lx) * 3 + c];
+                            const float v10 = table[(ly * c_Lattice + lx1) * 3 + c];
+                            const float v01 = table[(ly1 * c_Lattice + lx) * 3 + c];
+                            const float v11 = table[(ly1 * c_Lattice + lx1) * 3 + c];
+                            const float top = v00 + (v10 - v00) * fx;
+                            const float bottom = v01 + (v11 - v01) * fx;
+                            rgb[c] += amplitude * (top + (bottom - top) * fy);
+                        }
+                        amplitude *= 0.5f;
+                    }
+                }
+
+                for (size_t c = 0; c < 3; ++c)
+                {
+                    const float v = rgb[c] * 255.f + 0.5f;
+                    row[x * 4 + c] = static_cast<uint8_t>(v > 255.f ? 255.f : v);
+                }
+                row[x * 4 + 3] = 255;
+            }
+        }
+
+        return S_OK;
+    }
+
+    // Bits per texel after zlib at its best compression level, or a negative value on failure
+    double CompressedBitsPerTexel(const ScratchImage& image)
+    {
+        uLongf size = compressBound(static_cast<uLong>(image.GetPixelsSize()));
+        std::vector<Bytef> buffer(size);
+        if (compress2(buffer.data(), &size, image.GetPixels(), static_cast<uLong>(image.GetPixelsSize()), Z_BEST_COMPRESSION) != Z_OK)
+            return -1.0;
+
+        return double(size) * 8.0 / double(c_Size * c_Size);
+    }
+
+    struct Target
+    {
+        DXGI_FORMAT format;
+        const char* name;
+        uint32_t    bc7Level;
+    };
+
+    const Target g_Targets[] =
+    {
+        { DXGI_FORMAT_BC1_UNORM, "BC1", TEX_BC7_LEVEL_DEFAULT },
+        { DXGI_FORMAT_BC7_UNORM, "BC7 (level 3)", 3 },
+    };
+
+    const float g_Lambdas[] = { 0.f, 2.f, 8.f, 16.f };
+}
+
+int main()
+{
+    ScratchImage corpus;
+    HRESULT hr = CreateCorpus(corpus);
+    if (FAILED(hr))
+    {
+        printf("ERROR: failed creating test corpus (%08X)\n", static_cast<unsigned int>(hr));
+        return 1;
+    }
+
+    printf("%zux%zu fractal noise with flat patches, sizes in bits per texel after zlib -9\n", c_Size, c_Size);
+
+    for (const Target& target : g_Targets)
+    {
+        printf("\n%s\n%8s %9s %9s %8s\n", target.name, "lambda", "PSNR", "bpt", "change");
+
+        double baseline = 0.0;
+        for (const float lambda : g_Lambdas)
+        {
+            CompressOptions options = {};
+            options.flags = TEX_COMPRESS_DEFAULT;
+            options.threshold = TEX_THRESHOLD_DEFAULT;
+            options.alphaWeight = TEX_ALPHA_WEIGHT_DEFAULT;
+            options.bc7Level = target.bc7Level;
+            options.rdoLambda = lambda;
+
+            ScratchImage compressed;
+            hr = CompressEx(*corpus.GetImage(0, 0, 0), target.format, options, compressed);
+
+            ScratchImage decompressed;
+            if (SUCCEEDED(hr))
+            {
+                hr = Decompress(*compressed.GetImage(0, 0, 0), DXGI_FORMAT_R8G8B8A8_UNORM, decompressed);
+            }
+
+            if (FAILED(hr))
+            {
+                printf("ERROR: %s at lambda %g failed (%08X)\n", target.name, double(lambda), static_cast<unsigned int>(hr));
+                return 1;
+            }
+
+            const double bpt = CompressedBitsPerTexel(compressed);
+            if (bpt < 0)
+            {
+                printf("ERROR: zlib failed\n");
+                return 1;
+            }
+
+            if (lambda == 0.f)
+            {
+                baseline = bpt;
+            }
+
+            printf("%8g %6.2f dB %9.3f %7.1f%%\n", double(lambda), PSNR8(corpus, decompressed), bpt,
+                100.0 * (bpt - baseline) / baseline);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,190 @@
+//--------------------------------------------------------------------------------------
+// File: benchresize.cpp
+//
+// Times the non-WIC Resize for each custom filter, serial and with TEX_FILTER_PARALLEL,
+// and checks that the parallel output matches the serial one. A 2:1 LINEAR Resize is also
+// timed against one GenerateMipMaps LINEAR level, which still uses the filter code Resize
+// had before the separable resampler
+//
+//   benchresize [source size [destination size]]
+//
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+//
+// http://go.microsoft.com/fwlink/?LinkId=248926
+//--------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+#include "DirectXTex.h"
+#include "testutil.h"
+
+using namespace DirectX;
+using namespace TestUtil;
+
+namespace
+{
+    constexpr int c_Runs = 3;
+
+    struct Filter
+    {
+        TEX_FILTER_FLAGS filter;
+        const char*      name;
+    };
+
+    const Filter g_Filters[] =
+    {
+        { TEX_FILTER_POINT,    "POINT" },
+        { TEX_FILTER_BOX,      "BOX" },
+        { TEX_FILTER_LINEAR,   "LINEAR" },
+        { TEX_FILTER_CUBIC,    "CUBIC" },
+        { TEX_FILTER_TRIANGLE, "TRIANGLE" },
+        { TEX_FILTER_LANCZOS,  "LANCZOS" },
+        { TEX_FILTER_KAISER,   "KAISER" },
+    };
+
+    struct Format
+    {
+        DXGI_FORMAT format;
+        const char* name;
+    };
+
+    const Format g_Formats[] =
+    {
+        { DXGI_FORMAT_R8G8B8A8_UNORM,       "R8G8B8A8_UNORM" },
+        { DXGI_FORMAT_R10G10B10A2_UNORM,    "R10G10B10A2_UNORM" },
+        { DXGI_FORMAT_R32G32B32A32_FLOAT,   "R32G32B32A32_FLOAT" },
+    };
+
+    // Noise over a gradient, so neighbouring texels differ and every tap matters
+    HRESULT CreateSource(DXGI_FORMAT format, size_t size, ScratchImage& image)
+    {
+        ScratchImage base;
+        HRESULT hr = base.Initialize2D(DXGI_FORMAT_R32G32B32A32_FLOAT, size, size, 1, 1);
+        if (FAILED(hr))
+            return hr;
+
+        Random random(0x7E57AB1Eu);
+        const Image* img = base.GetImage(0, 0, 0);
+        for (size_t y = 0; y < size; ++y)
+        {
+            auto row = reinterpret_cast<float*>(img->pixels + y * img->rowPitch);
+            for (size_t x = 0; x < size * 4; ++x)
+            {
+                const float noise = random.NextFloat();
+                row[x] = 0.75f * float(x / 4 + y) / float(2 * size) + 0.25f * noise;
+            }
+        }
+
+        if (format == DXGI_FORMAT_R32G32B32A32_FLOAT)
+        {
+            image = std::move(base);
+            return S_OK;
+        }
+
+        return Convert(*img, format, TEX_FILTER_DEFAULT, TEX_THRESHOLD_DEFAULT, image);
+    }
+
+    // Best of c_Runs, in seconds
+    double TimeResize(const Image& src, size_t size, TEX_FILTER_FLAGS filter, ScratchImage& result)
+    {
+        HRESULT hr;
+        const double best = BestOf(c_Runs, hr, [&]() { return Resize(src, size, size, filter, result); });
+        if (FAILED(hr))
+        {
+            printf("ERROR: Resize failed (%08X)\n", static_cast<unsigned int>(hr));
+            return -1.0;
+        }
+        return best;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    size_t srcSize = 8192;
+    size_t destSize = 2048;
+    if (argc >= 2)
+    {
+        srcSize = strtoul(argv[1], nullptr, 10);
+        destSize = (argc >= 3) ? strtoul(argv[2], nullptr, 10) : std::max<size_t>(srcSize / 4, 1);
+        if (!srcSize || !destSize)
+        {
+            printf("usage: benchresize [source size [destination size]]\n");
+            return 1;
+        }
+    }
+
+    printf("%zux%zu -> %zux%zu, non-WIC, best of %d runs\n", srcSize, srcSize, destSize, destSize, c_Runs);
+    printf("%-20s %-10s %10s %10s\n", "format", "filter", "serial", "parallel");
+
+    int failures = 0;
+    for (const Format& fmt : g_Formats)
+    {
+        ScratchImage source;
+        HRESULT hr = CreateSource(fmt.format, srcSize, source);
+        if (FAILED(hr))
+        {
+            printf("ERROR: %s setup failed (%08X)\n", fmt.name, static_cast<unsigned int>(hr));
+            ++failures;
+            continue;
+        }
+
+        const Image& src = *source.GetImage(0, 0, 0);
+
+        for (const Filter& f : g_Filters)
+        {
+            const TEX_FILTER_FLAGS filter = f.filter | TEX_FILTER_FORCE_NON_WIC;
+
+            ScratchImage serial;
+            ScratchImage parallel;
+            const double serialTime = TimeResize(src, destSize, filter, serial);
+            const double parallelTime = TimeResize(src, destSize, filter | TEX_FILTER_PARALLEL, parallel);
+            if (serialTime < 0 || parallelTime < 0)
+            {
+                ++failures;
+                continue;
+            }
+
+            if (serial.GetPixelsSize() != parallel.GetPixelsSize()
+                || memcmp(serial.GetPixels(), parallel.GetPixels(), serial.GetPixelsSize()) != 0)
+            {
+                printf("FAILED: %s %s parallel output differs from serial\n", fmt.name, f.name);
+                ++failures;
+            }
+
+            printf("%-20s %-10s %8.1fms %8.1fms\n", fmt.name, f.name, serialTime * 1000.0, parallelTime * 1000.0);
+        }
+
+        // GenerateMipMaps still has the LINEAR filter that Resize used before the separable
+        // resampler, so one 2:1 mip level is the reference for a 2:1 LINEAR Resize
+        if (srcSize >= 2)
+        {
+            const TEX_FILTER_FLAGS filter = TEX_FILTER_LINEAR | TEX_FILTER_FORCE_NON_WIC;
+
+            ScratchImage half;
+            ScratchImage mips;
+            const double resizeTime = TimeResize(src, srcSize / 2, filter, half);
+            const double mipTime = BestOf(c_Runs, hr, [&]() { return GenerateMipMaps(src, filter, 2, mips); });
+            if (resizeTime < 0 || FAILED(hr))
+            {
+                printf("ERROR: %s LINEAR 2:1 failed\n", fmt.name);
+                ++failures;
+                continue;
+            }
+
+            const Image* level1 = mips.GetImage(1, 0, 0);
+            const bool identical = level1 && (level1->slicePitch == half.GetPixelsSize())
+                && !memcmp(level1->pixels, half.GetPixels(), half.GetPixelsSize());
+
+            printf("%-20s %-10s %8.1fms %8.1fms  (Resize vs GenerateMipMaps, %s)\n", fmt.name, "LINEAR 2:1",
+                resizeTime * 1000.0, mipTime * 1000.0, identical ? "identical" : "differs");
+        }
+    }
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,271 @@
+//--------------------------------------------------------------------------------------
+// File: pngroundtrip.cpp
+//
+// Checks the libpng reader and writer on row layout and 16-bit byte order: 16-bit RGBA and
+// gray PNGs written with libpng directly must load as the same little-endian UNORM values
+// on every row, and an 8-bit image with padded rows saved with SaveToPNGMemory must decode
+// to the same rows with libpng directly
+//
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+//
+// http://go.microsoft.com/fwlink/?LinkId=248926
+//--------------------------------------------------------------------------------------
+
+#include <csetjmp>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <png.h>
+
+#include "DirectXTex.h"
+#include "DirectXTexPNG.h"
+
+using namespace DirectX;
+
+namespace
+{
+    // Odd width so rows laid out at the wrong stride overlap or leave gaps
+    constexpr size_t c_Width = 37;
+    constexpr size_t c_Height = 9;
+
+    // High and low bytes differ, so a missing byte swap changes every value. Alpha is opaque,
+    // since the reader premultiplies the color channels
+    inline uint16_t Value(size_t x, size_t y, size_t c) noexcept
+    {
+        if (c == 3)
+            return 0xFFFFu;
+        return static_cast<uint16_t>((x * 2731u + y * 40503u + c * 7919u + 0x1234u) & 0xFFFFu);
+    }
+
+    void OnWrite(png_structp st, png_bytep data, png_size_t length)
+    {
+        auto out = static_cast<std::vector<uint8_t>*>(png_get_io_ptr(st));
+        out->insert(out->end(), data, data + length);
+    }
+
+    void OnFlush(png_structp) {}
+
+    struct MemorySource
+    {
+        const uint8_t* data;
+        size_t         size;
+        size_t         offset;
+    };
+
+    void OnRead(png_structp st, png_bytep data, png_size_t length)
+    {
+        auto src = static_cast<MemorySource*>(png_get_io_ptr(st));
+        if (length > src->size - src->offset)
+            png_error(st, "read past the end of the PNG");
+        memcpy(data, src->data + src->offset, length);
+        src->offset += length;
+    }
+
+    // Encodes a 16-bit PNG with libpng from big-endian rows, as the PNG specification stores them.
+    // The file is marked linear, since the reader converts other files to linear light
+    bool Write16BitPNG(int colorType, size_t channels, std::vector<uint8_t>* out)
+    {
+        std::vector<uint8_t> pixels(c_Width * c_Height * channels * 2);
+        std::vector<png_bytep> rows(c_Height);
+        for (size_t y = 0; y < c_Height; ++y)
+        {
+            uint8_t* row = &pixels[y * c_Width * channels * 2];
+            rows[y] = row;
+            for (size_t x = 0; x < c_Width; ++x)
+            {
+                for (size_t c = 0; c < channels; ++c)
+                {
+                    const uint16_t v = Value(x, y, c);
+                    row[(x * channels + c) * 2] = static_cast<uint8_t>(v >> 8);
+                    row[(x * channels + c) * 2 + 1] = static_cast<uint8_t>(v & 0xFF);
+                }
+            }
+        }
+
+        png_structp st = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+        if (!st)
+            return false;
+
+        png_infop info = png_create_info_struct(st);
+        if (!info || setjmp(png_jmpbuf(st)))
+        {
+            png_destroy_write_struct(&st, &info);
+            return false;
+        }
+
+        png_set_write_fn(st, out, &OnWrite, &OnFlush);
+        png_set_IHDR(st, info, static_cast<uint32_t>(c_Width), static_cast<uint32_t>(c_Height), 16, colorType,
+            PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+        png_set_gAMA(st, info, 1.0);
+        png_write_info(st, info);
+        png_write_image(st, rows.data());
+        png_write_end(st, info);
+        png_destroy_write_struct(&st, &info);
+        return true;
+    }
+
+    struct Case16
+    {
+        int         colorType;
+        size_t      channels;
+        DXGI_FORMAT format;
+        const char* name;
+    };
+
+    const Case16 g_Cases16[] =
+    {
+        { PNG_COLOR_TYPE_RGB_ALPHA, 4, DXGI_FORMAT_R16G16B16A16_UNORM, "16-bit RGBA" },
+        { PNG_COLOR_TYPE_GRAY,      1, DXGI_FORMAT_R16_UNORM,          "16-bit gray" },
+    };
+
+    int Check16Bit(const Case16& test)
+    {
+        std::vector<uint8_t> png;
+        if (!Write16BitPNG(test.colorType, test.channels, &png))
+        {
+            printf("ERROR: libpng failed writing the %s image\n", test.name);
+            return 1;
+        }
+
+        TexMetadata metadata = {};
+        ScratchImage image;
+        const HRESULT hr = LoadFromPNGMemory(png.data(), png.size(), &metadata, image);
+        if (FAILED(hr))
+        {
+            printf("FAILED: LoadFromPNGMemory of the %s image (%08X)\n", test.name, static_cast<unsigned int>(hr));
+            return 1;
+        }
+
+        if (metadata.format != test.format || metadata.width != c_Width || metadata.height != c_Height)
+        {
+            printf("FAILED: %s image loaded as format %d, %zux%zu\n", test.name, int(metadata.format), metadata.width, metadata.height);
+            return 1;
+        }
+
+        // DXGI UNORM formats are little-endian
+        const Image* img = image.GetImage(0, 0, 0);
+        size_t mismatches = 0;
+        for (size_t y = 0; y < c_Height; ++y)
+        {
+            const uint8_t* row = img->pixels + y * img->rowPitch;
+            for (size_t x = 0; x < c_Width; ++x)
+            {
+                for (size_t c = 0; c < test.channels; ++c)
+                {
+                    const uint8_t* p = row + (x * test.channels + c) * 2;
+                    const uint16_t v = static_cast<uint16_t>(p[0] | (p[1] << 8));
+                    if (v != Value(x, y, c) && !mismatches++)
+                    {
+                        printf("FAILED: %s texel (%zu, %zu) channel %zu is %04X, expected %04X\n", test.name, x, y, c,
+                            static_cast<unsigned int>(v), static_cast<unsigned int>(Value(x, y, c)));
+                    }
+                }
+            }
+        }
+
+        printf("%s: %zu mismatched values\n", test.name, mismatches);
+        return mismatches ? 1 : 0;
+    }
+
+    // Decodes an 8-bit RGBA PNG with libpng and no transforms into tightly packed rows
+    bool ReadRGBA8PNG(const Blob& blob, std::vector<uint8_t>* pixels)
+    {
+        pixels->resize(c_Width * 4 * c_Height);
+        std::vector<png_bytep> rows(c_Height);
+        for (size_t y = 0; y < c_Height; ++y)
+        {
+            rows[y] = pixels->data() + y * c_Width * 4;
+        }
+
+        png_structp st = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+        if (!st)
+            return false;
+
+        png_infop info = png_create_info_struct(st);
+        if (!info || setjmp(png_jmpbuf(st)))
+        {
+            png_destroy_read_struct(&st, &info, nullptr);
+            return false;
+        }
+
+        MemorySource src = { static_cast<const uint8_t*>(blob.GetBufferPointer()), blob.GetBufferSize(), 0 };
+        png_set_read_fn(st, &src, &OnRead);
+        png_read_info(st, info);
+
+        const bool valid = png_get_image_width(st, info) == c_Width && png_get_image_height(st, info) == c_Height
+            && png_get_bit_depth(st, info) == 8 && png_get_color_type(st, info) == PNG_COLOR_TYPE_RGB_ALPHA;
+        if (valid)
+        {
+            png_read_image(st, rows.data());
+            png_read_end(st, info);
+        }
+
+        png_destroy_read_struct(&st, &info, nullptr);
+        return valid;
+    }
+
+    // The writer has to step by rowPitch, not by width * channels
+    int CheckPaddedRows()
+    {
+        constexpr size_t rowPitch = c_Width * 4 + 12;
+        std::vector<uint8_t> pixels(rowPitch * c_Height, 0xCD);
+        for (size_t y = 0; y < c_Height; ++y)
+        {
+            for (size_t x = 0; x < c_Width * 4; ++x)
+            {
+                pixels[y * rowPitch + x] = static_cast<uint8_t>(Value(x, y, 0));
+            }
+        }
+
+        Image src = {};
+        src.width = c_Width;
+        src.height = c_Height;
+        src.format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        src.rowPitch = rowPitch;
+        src.slicePitch = rowPitch * c_Height;
+        src.pixels = pixels.data();
+
+        Blob blob;
+        const HRESULT hr = SaveToPNGMemory(src, PNG_FLAGS_NONE, PNG_DEFAULT_COMPRESSION, blob);
+        if (FAILED(hr))
+        {
+            printf("FAILED: SaveToPNGMemory of the padded 8-bit image (%08X)\n", static_cast<unsigned int>(hr));
+            return 1;
+        }
+
+        std::vector<uint8_t> decoded;
+        if (!ReadRGBA8PNG(blob, &decoded))
+        {
+            printf("FAILED: libpng could not decode the padded 8-bit image as %zux%zu RGBA\n", c_Width, c_Height);
+            return 1;
+        }
+
+        for (size_t y = 0; y < c_Height; ++y)
+        {
+            if (memcmp(&decoded[y * c_Width * 4], &pixels[y * rowPitch], c_Width * 4) != 0)
+            {
+                printf("FAILED: padded 8-bit image differs on row %zu\n", y);
+                return 1;
+            }
+        }
+
+        printf("padded 8-bit: identical\n");
+        return 0;
+    }
+}
+
+int main()
+{
+    int failures = 0;
+    for (const Case16& test : g_Cases16)
+    {
+        failures += Check16Bit(test);
+    }
+
+    failures += CheckPaddedRows();
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,285 @@
+//--------------------------------------------------------------------------------------
+// File: srgbtables.cpp
+//
+// Checks the table-driven 8-bit sRGB paths of LoadScanlineLinear/StoreScanlineLinear:
+// decode error for every code, encode against exact rounding around every decision
+// threshold, and the load/store round trip of all 256 codes
+//
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+//
+// http://go.microsoft.com/fwlink/?LinkId=248926
+//--------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+// The sRGB tables are only reachable through the library's internal scanline helpers
+#include "DirectXTexP.h"
+#include "testutil.h"
+
+using namespace DirectX;
+using namespace DirectX::Internal;
+using namespace TestUtil;
+
+namespace
+{
+    double SRGBToLinear(double s) noexcept
+    {
+        return (s <= 0.04045) ? (s / 12.92) : pow((s + 0.055) / 1.055, 2.4);
+    }
+
+    // Linear value halfway between codes j - 1 and j in sRGB space
+    double Threshold(uint32_t j) noexcept
+    {
+        return SRGBToLinear((double(j) - 0.5) / 255.0);
+    }
+
+    // Exactly rounded encode: the number of thresholds at or below v
+    uint8_t ExpectedCode(float v, const double* thresholds) noexcept
+    {
+        if (!(v > 0.f))
+            return 0;
+
+        uint32_t code = 0;
+        while (code < 255 && double(v) >= thresholds[code + 1])
+            ++code;
+        return static_cast<uint8_t>(code);
+    }
+
+    const DXGI_FORMAT g_Formats[] =
+    {
+        DXGI_FORMAT_R8G8B8A8_UNORM_SRGB,
+        DXGI_FORMAT_B8G8R8A8_UNORM_SRGB,
+        DXGI_FORMAT_B8G8R8X8_UNORM_SRGB,
+    };
+
+    bool IsBGR(DXGI_FORMAT format) noexcept
+    {
+        return format != DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+    }
+}
+
+int main()
+{
+    int failures = 0;
+
+    double thresholds[256] = {};
+    for (uint32_t j = 1; j < 256; ++j)
+    {
+        thresholds[j] = Threshold(j);
+    }
+
+    auto scanlineArray = make_AlignedArrayXMVECTOR(256);
+    if (!scanlineArray)
+        return 1;
+
+    XMVECTOR* scanline = scanlineArray.get();
+
+    for (const DXGI_FORMAT format : g_Formats)
+    {
+        const bool bgr = IsBGR(format);
+
+        // Decode every code: R, G and B carry the code, alpha the reversed code
+        uint8_t codes[256 * 4];
+        for (uint32_t j = 0; j < 256; ++j)
+        {
+            codes[j * 4 + 0] = uint8_t(j);
+            codes[j * 4 + 1] = uint8_t(j);
+            codes[j * 4 + 2] = uint8_t(j);
+            codes[j * 4 + 3] = uint8_t(255 - j);
+        }
+
+        if (!LoadScanlineLinear(scanline, 256, codes, sizeof(codes), format, TEX_FILTER_DEFAULT))
+        {
+            printf("ERROR: LoadScanlineLinear failed for format %d\n", int(format));
+            ++failures;
+            continue;
+        }
+
+        double maxError = 0.0;
+        for (uint32_t j = 0; j < 256; ++j)
+        {
+            XMFLOAT4A v;
+            XMStoreFloat4A(&v, scanline[j]);
+
+            const double expected = SRGBToLinear(double(j) / 255.0);
+            const float components[3] = { v.x, v.y, v.z };
+            for (const float f : components)
+            {
+                const double error = fabs(double(f) - expected);
+                maxError = std::max(maxError, error);
+
+                // Must be the float nearest to the exact value: within half an ulp
+                const double halfUlp = 0.5 * double(nextafterf(float(expected), 2.f) - float(expected));
+                if (error > halfUlp)
+                {
+                    printf("FAILED: format %d decode of %u is %.9g, expected %.9g\n", int(format), j, double(f), expected);
+                    ++failures;
+                    break;
+                }
+            }
+
+            const float alpha = (format == DXGI_FORMAT_B8G8R8X8_UNORM_SRGB) ? 1.f : float(255 - j) / 255.f;
+            if (fabsf(v.w - alpha) > 1e-7f)
+            {
+                printf("FAILED: format %d alpha of %u is %.9g, expected %.9g\n", int(format), 255 - j, double(v.w), double(alpha));
+                ++failures;
+            }
+        }
+
+        printf("format %d: max decode error %.3g\n", int(format), maxError);
+
+        // Round trip: storing the decoded scanline gives back every code
+        uint8_t stored[256 * 4] = {};
+        if (!StoreScanlineLinear(stored, sizeof(stored), format, scanline, 256, TEX_FILTER_DEFAULT, 0.f))
+        {
+            printf("ERROR: StoreScanlineLinear failed for format %d\n", int(format));
+            ++failures;
+            continue;
+        }
+
+        for (uint32_t j = 0; j < 256; ++j)
+        {
+            const uint8_t alpha = (format == DXGI_FORMAT_B8G8R8X8_UNORM_SRGB) ? 255 : uint8_t(255 - j);
+            if (stored[j * 4] != j || stored[j * 4 + 1] != j || stored[j * 4 + 2] != j || stored[j * 4 + 3] != alpha)
+            {
+                printf("FAILED: format %d round trip of %u gave %u %u %u %u\n", int(format), j,
+                    stored[j * 4], stored[j * 4 + 1], stored[j * 4 + 2], stored[j * 4 + 3]);
+                ++failures;
+            }
+        }
+
+        // Encode: every threshold rounded to float and +/- 1 and 2 ulps, plus out-of-range values
+        std::vector<float> values;
+        for (uint32_t j = 1; j < 256; ++j)
+        {
+            const float t = float(thresholds[j]);
+            values.push_back(nextafterf(nextafterf(t, 0.f), 0.f));
+            values.push_back(nextafterf(t, 0.f));
+            values.push_back(t);
+            values.push_back(nextafterf(t, 2.f));
+            values.push_back(nextafterf(nextafterf(t, 2.f), 2.f));
+        }
+        values.push_back(0.f);
+        values.push_back(-0.f);
+        values.push_back(-1.f);
+        values.push_back(1.f);
+        values.push_back(1.5f);
+        values.push_back(std::nanf(""));
+
+        // ...and a sweep over the float bit patterns of [0, 1]
+        for (uint32_t bits = 0; bits <= 0x3F800000u; bits += 251)
+        {
+            float f;
+            memcpy(&f, &bits, sizeof(f));
+            values.push_back(f);
+        }
+
+        size_t mismatches = 0;
+        for (size_t base = 0; base < values.size(); base += 256)
+        {
+            const size_t count = std::min<size_t>(256, values.size() - base);
+            for (size_t i = 0; i < count; ++i)
+            {
+                const float v = values[base + i];
+                scanline[i] = XMVectorSet(v, v, v, 1.f);
+            }
+
+            if (!StoreScanlineLinear(stored, count * 4, format, scanline, count, TEX_FILTER_DEFAULT, 0.f))
+            {
+                printf("ERROR: StoreScanlineLinear failed for format %d\n", int(format));
+                ++failures;
+                break;
+            }
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                const float v = values[base + i];
+                const uint8_t expected = ExpectedCode(v, thresholds);
+                const uint8_t r = stored[i * 4 + (bgr ? 2 : 0)];
+                const uint8_t g = stored[i * 4 + 1];
+                const uint8_t b = stored[i * 4 + (bgr ? 0 : 2)];
+                if (r != expected || g != expected || b != expected)
+                {
+                    if (mismatches++ < 16)
+                    {
+                        printf("FAILED: format %d encode of %.9g gave %u, expected %u\n", int(format), double(v), r, expected);
+                    }
+                }
+            }
+        }
+
+        if (mismatches)
+        {
+            printf("format %d: %zu encode mismatches out of %zu values\n", int(format), mismatches, values.size());
+            ++failures;
+        }
+    }
+
+    // Throughput of the table path against the XMColorRGBToSRGB path it replaced (informational)
+    {
+        constexpr size_t c_width = 256;
+        constexpr size_t c_rows = 4096;
+
+        for (size_t i = 0; i < c_width; ++i)
+        {
+            const float v = float(i) / float(c_width - 1);
+            scanline[i] = XMVectorSet(v, v * v, 1.f - v, v);
+        }
+
+        uint8_t stored[c_width * 4];
+        auto temp = make_AlignedArrayXMVECTOR(c_width);
+        if (!temp)
+            return 1;
+
+        HRESULT hr;
+        const double tableTime = BestOf(1, hr, [&]()
+            {
+                for (size_t y = 0; y < c_rows; ++y)
+                {
+                    memcpy(temp.get(), scanline, sizeof(XMVECTOR) * c_width);
+                    std::ignore = StoreScanlineLinear(stored, sizeof(stored), DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, temp.get(), c_width, TEX_FILTER_DEFAULT, 0.f);
+                }
+                return S_OK;
+            });
+
+        const double mathTime = BestOf(1, hr, [&]()
+            {
+                for (size_t y = 0; y < c_rows; ++y)
+                {
+                    for (size_t i = 0; i < c_width; ++i)
+                    {
+                        PackedVector::XMStoreUByteN4(reinterpret_cast<PackedVector::XMUBYTEN4*>(&stored[i * 4]), XMColorRGBToSRGB(scanline[i]));
+                    }
+                }
+                return S_OK;
+            });
+
+        const double loadTime = BestOf(1, hr, [&]()
+            {
+                for (size_t y = 0; y < c_rows; ++y)
+                {
+                    std::ignore = LoadScanlineLinear(temp.get(), c_width, stored, sizeof(stored), DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, TEX_FILTER_DEFAULT);
+                }
+                return S_OK;
+            });
+
+        const double mpix = double(c_width * c_rows) / 1e6;
+        printf("store: table %.0f Mpix/s, XMColorRGBToSRGB %.0f Mpix/s; load: table %.0f Mpix/s\n",
+            mpix / tableTime, mpix / mathTime, mpix / loadTime);
+    }
+
+    if (failures)
+    {
+        printf("%d failures\n", failures);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,88 @@
+//--------------------------------------------------------------------------------------
+// File: testutil.h
+//
+// Helpers shared by the tests and benchmarks: a fixed pseudo-random sequence for the
+// synthetic corpora, a best-of-N timer and an 8-bit PSNR
+//
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+//
+// http://go.microsoft.com/fwlink/?LinkId=248926
+//--------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+#include "DirectXTex.h"
+
+namespace TestUtil
+{
+    // Linear congruential generator, so every run on every platform sees the same corpus
+    class Random
+    {
+    public:
+        explicit Random(uint32_t seed) noexcept : m_seed(seed) {}
+
+        uint32_t Next() noexcept
+        {
+            m_seed = m_seed * 1664525u + 1013904223u;
+            return m_seed;
+        }
+
+        // Uniform in [0, 1)
+        float NextFloat() noexcept { return float(Next() >> 8) / float(1u << 24); }
+
+    private:
+        uint32_t m_seed;
+    };
+
+    // Seconds taken by the fastest of 'runs' calls to fn, which returns an HRESULT; stops at the
+    // first failure, which is returned in hr
+    template<typename Fn>
+    double BestOf(int runs, HRESULT& hr, Fn&& fn)
+    {
+        double best = 1e30;
+        hr = S_OK;
+        for (int run = 0; run < runs; ++run)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            hr = fn();
+            const double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (FAILED(hr))
+                break;
+            best = std::min(best, t);
+        }
+        return best;
+    }
+
+    // Peak signal-to-noise ratio over every byte of two images with the same 8-bit per channel layout
+    inline double PSNR8(const DirectX::ScratchImage& a, const DirectX::ScratchImage& b) noexcept
+    {
+        double sum = 0.0;
+        uint64_t count = 0;
+        for (size_t i = 0; i < a.GetImageCount(); ++i)
+        {
+            const DirectX::Image& ia = a.GetImages()[i];
+            const DirectX::Image& ib = b.GetImages()[i];
+            const size_t rowBytes = std::min(ia.rowPitch, ib.rowPitch);
+            for (size_t y = 0; y < ia.height; ++y)
+            {
+                const uint8_t* ra = ia.pixels + y * ia.rowPitch;
+                const uint8_t* rb = ib.pixels + y * ib.rowPitch;
+                for (size_t x = 0; x < rowBytes; ++x)
+                {
+                    const double d = double(ra[x]) - double(rb[x]);
+                    sum += d * d;
+                    ++count;
+                }
+            }
+        }
+
+        const double mse = count ? (sum / double(count)) : 0.0;
+        return (mse > 0.0) ? 10.0 * log10(255.0 * 255.0 / mse) : 99.0;
+    }
+}
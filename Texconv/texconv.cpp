@@ -30,6 +30,7 @@
 #endif
 
 #include <algorithm>
+#include <bitset>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
@@ -128,6 +129,7 @@ namespace
         OPT_USE_DX9,
         OPT_TGA20,
         OPT_TGAZEROALPHA,
+        OPT_TGA_RLE,
         OPT_WIC_QUALITY,
         OPT_WIC_LOSSLESS,
         OPT_WIC_MULTIFRAME,
@@ -152,6 +154,8 @@ namespace
         OPT_NORMAL_MAP,
         OPT_NORMAL_MAP_AMPLITUDE,
         OPT_BC_COMPRESS,
+        OPT_BC7_LEVEL,
+        OPT_RDO_LAMBDA,
         OPT_COLORKEY,
         OPT_TONEMAP,
         OPT_X2_BIAS,
@@ -187,7 +191,6 @@ namespace
         FORMAT_DXT5_RXGB,
     };
 
-    static_assert(OPT_MAX <= 64, "dwOptions is a unsigned int bitfield");
 
     const SValue<uint64_t> g_pOptions[] =
     {
@@ -217,6 +220,7 @@ namespace
         { L"dx9",           OPT_USE_DX9 },
         { L"tga20",         OPT_TGA20 },
         { L"tgazeroalpha",  OPT_TGAZEROALPHA },
+        { L"tgarle",        OPT_TGA_RLE },
         { L"wicq",          OPT_WIC_QUALITY },
         { L"wiclossless",   OPT_WIC_LOSSLESS },
         { L"wicmulti",      OPT_WIC_MULTIFRAME },
@@ -242,6 +246,8 @@ namespace
         { L"nmap",          OPT_NORMAL_MAP },
         { L"nmapamp",       OPT_NORMAL_MAP_AMPLITUDE },
         { L"bc",            OPT_BC_COMPRESS },
+        { L"bc7level",      OPT_BC7_LEVEL },
+        { L"rdo",           OPT_RDO_LAMBDA },
         { L"c",             OPT_COLORKEY },
         { L"tonemap",       OPT_TONEMAP },
         { L"x2bias",        OPT_X2_BIAS },
@@ -454,18 +460,24 @@ namespace
         { L"FANT",                      TEX_FILTER_FANT },
         { L"BOX",                       TEX_FILTER_BOX },
         { L"TRIANGLE",                  TEX_FILTER_TRIANGLE },
+        { L"LANCZOS",                   TEX_FILTER_LANCZOS },
+        { L"KAISER",                    TEX_FILTER_KAISER },
         { L"POINT_DITHER",              TEX_FILTER_POINT | TEX_FILTER_DITHER },
         { L"LINEAR_DITHER",             TEX_FILTER_LINEAR | TEX_FILTER_DITHER },
         { L"CUBIC_DITHER",              TEX_FILTER_CUBIC | TEX_FILTER_DITHER },
         { L"FANT_DITHER",               TEX_FILTER_FANT | TEX_FILTER_DITHER },
         { L"BOX_DITHER",                TEX_FILTER_BOX | TEX_FILTER_DITHER },
         { L"TRIANGLE_DITHER",           TEX_FILTER_TRIANGLE | TEX_FILTER_DITHER },
+        { L"LANCZOS_DITHER",            TEX_FILTER_LANCZOS | TEX_FILTER_DITHER },
+        { L"KAISER_DITHER",             TEX_FILTER_KAISER | TEX_FILTER_DITHER },
         { L"POINT_DITHER_DIFFUSION",    TEX_FILTER_POINT | TEX_FILTER_DITHER_DIFFUSION },
         { L"LINEAR_DITHER_DIFFUSION",   TEX_FILTER_LINEAR | TEX_FILTER_DITHER_DIFFUSION },
         { L"CUBIC_DITHER_DIFFUSION",    TEX_FILTER_CUBIC | TEX_FILTER_DITHER_DIFFUSION },
         { L"FANT_DITHER_DIFFUSION",     TEX_FILTER_FANT | TEX_FILTER_DITHER_DIFFUSION },
         { L"BOX_DITHER_DIFFUSION",      TEX_FILTER_BOX | TEX_FILTER_DITHER_DIFFUSION },
         { L"TRIANGLE_DITHER_DIFFUSION", TEX_FILTER_TRIANGLE | TEX_FILTER_DITHER_DIFFUSION },
+        { L"LANCZOS_DITHER_DIFFUSION",  TEX_FILTER_LANCZOS | TEX_FILTER_DITHER_DIFFUSION },
+        { L"KAISER_DITHER_DIFFUSION",   TEX_FILTER_KAISER | TEX_FILTER_DITHER_DIFFUSION },
         { nullptr,                      TEX_FILTER_DEFAULT                              }
     };
 
@@ -754,6 +766,7 @@ namespace
             L"\n"
             L"                       (TGA output only)\n"
             L"   -tga20              Write file including TGA 2.0 extension area\n"
+            L"   -tgarle             Write RLE compressed file\n"
             L"\n"
             L"                       (BMP, PNG, JPG, TIF, WDP output only)\n"
             L"   -wicq <quality>     When writing images with WIC use quality (0.0 to 1.0)\n"
@@ -763,17 +776,19 @@ namespace
             L"   -nologo             suppress copyright message\n"
             L"   -timing             Display elapsed processing time\n"
             L"\n"
-        #ifdef _OPENMP
-            L"   -singleproc         Do not use multi-threaded compression\n"
-        #endif
+            L"   -singleproc         Do not use multi-threaded (de)compression, conversion, resize or mipmaps\n"
             L"   -gpu <adapter>      Select GPU for DirectCompute-based codecs (0 is default)\n"
             L"   -nogpu              Do not use DirectCompute-based codecs\n"
             L"\n"
             L"   -bc <options>       Sets options for BC compression\n"
             L"                       options must be one or more of\n"
-            L"                          d, u, q, x\n"
+            L"                          d, u, q, x, h\n"
             L"   -aw <weight>        BC7 GPU compressor weighting for alpha error metric\n"
             L"                       (defaults to 1.0)\n"
+            L"   -bc7level <level>   BC7 CPU compressor search level from 1 (fastest) to 7\n"
+            L"                       (defaults to 6)\n"
+            L"   -rdo <lambda>       Rate-distortion weight for BC1/BC7 CPU compressor output\n"
+            L"                       (defaults to 0, disabled)\n"
             L"\n"
             L"   -c <hex-RGB>        colorkey (a.k.a. chromakey) transparency\n"
             L"   -rotatecolor <rot>  rotates color primaries and/or applies a curve\n"
@@ -1180,6 +1195,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
     int adapter = -1;
     float alphaThreshold = TEX_THRESHOLD_DEFAULT;
     float alphaWeight = 1.f;
+    uint32_t bc7Level = TEX_BC7_LEVEL_DEFAULT;
+    float rdoLambda = 0.f;
     CNMAP_FLAGS dwNormalMap = CNMAP_DEFAULT;
     float nmapAmplitude = 1.f;
     float wicQuality = -1.f;
@@ -1210,7 +1227,7 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
     }
 
     // Process command line
-    uint64_t dwOptions = 0;
+    std::bitset<OPT_MAX> dwOptions;
     std::list<SConversion> conversion;
     bool allowOpts = true;
 
@@ -1255,13 +1272,13 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
 
             const uint64_t dwOption = LookupByName(pArg, g_pOptions);
 
-            if (!dwOption || (dwOptions & (uint64_t(1) << dwOption)))
+            if (!dwOption || dwOptions[dwOption])
             {
                 PrintUsage();
                 return 1;
             }
 
-            dwOptions |= (uint64_t(1) << dwOption);
+            dwOptions.set(dwOption);
 
             // Handle options with additional value parameter
             switch (dwOption)
@@ -1283,6 +1300,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             case OPT_NORMAL_MAP_AMPLITUDE:
             case OPT_WIC_QUALITY:
             case OPT_BC_COMPRESS:
+            case OPT_BC7_LEVEL:
+            case OPT_RDO_LAMBDA:
             case OPT_COLORKEY:
             case OPT_FILELIST:
             case OPT_ROTATE_COLOR:
@@ -1437,7 +1456,7 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                 break;
 
             case OPT_PREMUL_ALPHA:
-                if (dwOptions & (uint64_t(1) << OPT_DEMUL_ALPHA))
+                if (dwOptions[OPT_DEMUL_ALPHA])
                 {
                     wprintf(L"Can't use -pmalpha and -alpha at same time\n\n");
                     PrintUsage();
@@ -1446,7 +1465,7 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                 break;
 
             case OPT_DEMUL_ALPHA:
-                if (dwOptions & (uint64_t(1) << OPT_PREMUL_ALPHA))
+                if (dwOptions[OPT_PREMUL_ALPHA])
                 {
                     wprintf(L"Can't use -pmalpha and -alpha at same time\n\n");
                     PrintUsage();
@@ -1610,6 +1629,38 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                 }
                 break;
 
+            case OPT_BC7_LEVEL:
+                if (swscanf_s(pValue, L"%u", &bc7Level) != 1)
+                {
+                    wprintf(L"Invalid value specified with -bc7level (%ls)\n", pValue);
+                    wprintf(L"\n");
+                    PrintUsage();
+                    return 1;
+                }
+                else if (bc7Level < TEX_BC7_LEVEL_FASTEST || bc7Level > TEX_BC7_LEVEL_MAX)
+                {
+                    wprintf(L"-bc7level (%ls) parameter must be between %u and %u\n", pValue, TEX_BC7_LEVEL_FASTEST, TEX_BC7_LEVEL_MAX);
+                    wprintf(L"\n");
+                    return 1;
+                }
+                break;
+
+            case OPT_RDO_LAMBDA:
+                if (swscanf_s(pValue, L"%f", &rdoLambda) != 1)
+                {
+                    wprintf(L"Invalid value specified with -rdo (%ls)\n", pValue);
+                    wprintf(L"\n");
+                    PrintUsage();
+                    return 1;
+                }
+                else if (rdoLambda < 0.f)
+                {
+                    wprintf(L"-rdo (%ls) parameter must be positive\n", pValue);
+                    wprintf(L"\n");
+                    return 1;
+                }
+                break;
+
             case OPT_BC_COMPRESS:
                 {
                     dwCompress = TEX_COMPRESS_DEFAULT;
@@ -1639,6 +1690,12 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                         found = true;
                     }
 
+                    if (wcschr(pValue, L'h'))
+                    {
+                        dwCompress |= TEX_COMPRESS_BC6H_QUICK;
+                        found = true;
+                    }
+
                     if ((dwCompress & (TEX_COMPRESS_BC7_QUICK | TEX_COMPRESS_BC7_USE_3SUBSETS)) == (TEX_COMPRESS_BC7_QUICK | TEX_COMPRESS_BC7_USE_3SUBSETS))
                     {
                         wprintf(L"Can't use -bc x (max) and -bc q (quick) at same time\n\n");
@@ -1648,7 +1705,7 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
 
                     if (!found)
                     {
-                        wprintf(L"Invalid value specified for -bc (%ls), missing d, u, q, or x\n\n", pValue);
+                        wprintf(L"Invalid value specified for -bc (%ls), missing d, u, q, x, or h\n\n", pValue);
                         return 1;
                     }
                 }
@@ -1682,7 +1739,7 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                 break;
 
             case OPT_USE_DX10:
-                if (dwOptions & (uint64_t(1) << OPT_USE_DX9))
+                if (dwOptions[OPT_USE_DX9])
                 {
                     wprintf(L"Can't use -dx9 and -dx10 at same time\n\n");
                     PrintUsage();
@@ -1691,7 +1748,7 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                 break;
 
             case OPT_USE_DX9:
-                if (dwOptions & (uint64_t(1) << OPT_USE_DX10))
+                if (dwOptions[OPT_USE_DX10])
                 {
                     wprintf(L"Can't use -dx9 and -dx10 at same time\n\n");
                     PrintUsage();
@@ -1813,7 +1870,7 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
         {
             const size_t count = conversion.size();
             std::filesystem::path path(pArg);
-            SearchForFiles(path.make_preferred(), conversion, (dwOptions & (uint64_t(1) << OPT_RECURSIVE)) != 0, nullptr);
+            SearchForFiles(path.make_preferred(), conversion, dwOptions[OPT_RECURSIVE], nullptr);
             if (conversion.size() <= count)
             {
                 wprintf(L"No matching files found for %ls\n", pArg);
@@ -1835,7 +1892,7 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
         return 0;
     }
 
-    if (~dwOptions & (uint64_t(1) << OPT_NOLOGO))
+    if (!dwOptions[OPT_NOLOGO])
         PrintLogo(false, g_ToolName, g_Description);
 
     auto fileTypeName = LookupByValue(FileType, g_pSaveFileTypes);
@@ -1920,15 +1977,15 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
         #endif // USE_XBOX_EXTS
             {
                 DDS_FLAGS ddsFlags = DDS_FLAGS_ALLOW_LARGE_FILES;
-                if (dwOptions & (uint64_t(1) << OPT_DDS_DWORD_ALIGN))
+                if (dwOptions[OPT_DDS_DWORD_ALIGN])
                     ddsFlags |= DDS_FLAGS_LEGACY_DWORD;
-                if (dwOptions & (uint64_t(1) << OPT_EXPAND_LUMINANCE))
+                if (dwOptions[OPT_EXPAND_LUMINANCE])
                     ddsFlags |= DDS_FLAGS_EXPAND_LUMINANCE;
-                if (dwOptions & (uint64_t(1) << OPT_DDS_BAD_DXTN_TAILS))
+                if (dwOptions[OPT_DDS_BAD_DXTN_TAILS])
                     ddsFlags |= DDS_FLAGS_BAD_DXTN_TAILS;
-                if (dwOptions & (uint64_t(1) << OPT_DDS_PERMISSIVE))
+                if (dwOptions[OPT_DDS_PERMISSIVE])
                     ddsFlags |= DDS_FLAGS_PERMISSIVE;
-                if (dwOptions & (uint64_t(1) << OPT_DDS_IGNORE_MIPS))
+                if (dwOptions[OPT_DDS_IGNORE_MIPS])
                     ddsFlags |= DDS_FLAGS_IGNORE_MIPS;
 
                 hr = LoadFromDDSFile(curpath.c_str(), ddsFlags, &info, *image);
@@ -1942,11 +1999,11 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
 
             if (IsTypeless(info.format))
             {
-                if (dwOptions & (uint64_t(1) << OPT_TYPELESS_UNORM))
+                if (dwOptions[OPT_TYPELESS_UNORM])
                 {
                     info.format = MakeTypelessUNORM(info.format);
                 }
-                else if (dwOptions & (uint64_t(1) << OPT_TYPELESS_FLOAT))
+                else if (dwOptions[OPT_TYPELESS_FLOAT])
                 {
                     info.format = MakeTypelessFLOAT(info.format);
                 }
@@ -1974,7 +2031,7 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
         else if (_wcsicmp(ext.c_str(), L".tga") == 0)
         {
             TGA_FLAGS tgaFlags = (IsBGR(format)) ? TGA_FLAGS_BGR : TGA_FLAGS_NONE;
-            if (dwOptions & (uint64_t(1) << OPT_TGAZEROALPHA))
+            if (dwOptions[OPT_TGAZEROALPHA])
             {
                 tgaFlags |= TGA_FLAGS_ALLOW_ALL_ZERO_ALPHA;
             }
@@ -1989,7 +2046,9 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
         }
         else if (_wcsicmp(ext.c_str(), L".hdr") == 0)
         {
-            hr = LoadFromHDRFile(curpath.c_str(), &info, *image);
+            hr = LoadFromHDRFile(curpath.c_str(),
+                dwOptions[OPT_FORCE_SINGLEPROC] ? HDR_FLAGS_NONE : HDR_FLAGS_PARALLEL,
+                &info, *image);
             if (FAILED(hr))
             {
                 wprintf(L" FAILED (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
@@ -2142,7 +2201,7 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             // Direct3D can only create BC resources with multiple-of-4 top levels
             if ((info.width % 4) != 0 || (info.height % 4) != 0)
             {
-                if (dwOptions & (uint64_t(1) << OPT_BCNONMULT4FIX))
+                if (dwOptions[OPT_BCNONMULT4FIX])
                 {
                     std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
                     if (!timage)
@@ -2213,7 +2272,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                 return 1;
             }
 
-            hr = Decompress(img, nimg, info, DXGI_FORMAT_UNKNOWN /* picks good default */, *timage);
+            hr = Decompress(img, nimg, info, DXGI_FORMAT_UNKNOWN /* picks good default */,
+                dwOptions[OPT_FORCE_SINGLEPROC] ? TEX_DECOMPRESS_DEFAULT : TEX_DECOMPRESS_PARALLEL, 0, *timage);
             if (FAILED(hr))
             {
                 wprintf(L" FAILED [decompress] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
@@ -2246,7 +2306,7 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
         }
 
         // --- Undo Premultiplied Alpha (if requested) ---------------------------------
-        if ((dwOptions & (uint64_t(1) << OPT_DEMUL_ALPHA))
+        if (dwOptions[OPT_DEMUL_ALPHA]
             && HasAlpha(info.format)
             && info.format != DXGI_FORMAT_A8_UNORM)
         {
@@ -2297,7 +2357,7 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
         }
 
         // --- Flip/Rotate -------------------------------------------------------------
-        if (dwOptions & ((uint64_t(1) << OPT_HFLIP) | (uint64_t(1) << OPT_VFLIP)))
+        if (dwOptions[OPT_HFLIP] || dwOptions[OPT_VFLIP])
         {
             std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
             if (!timage)
@@ -2308,10 +2368,10 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
 
             TEX_FR_FLAGS dwFlags = TEX_FR_ROTATE0;
 
-            if (dwOptions & (uint64_t(1) << OPT_HFLIP))
+            if (dwOptions[OPT_HFLIP])
                 dwFlags |= TEX_FR_FLIP_HORIZONTAL;
 
-            if (dwOptions & (uint64_t(1) << OPT_VFLIP))
+            if (dwOptions[OPT_VFLIP])
                 dwFlags |= TEX_FR_FLIP_VERTICAL;
 
             assert(dwFlags != 0);
@@ -2358,7 +2418,7 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                 sizewarn = true;
         }
 
-        if (dwOptions & (uint64_t(1) << OPT_FIT_POWEROF2))
+        if (dwOptions[OPT_FIT_POWEROF2])
         {
             FitPowerOf2(info.width, info.height, twidth, theight, maxSize);
         }
@@ -2372,7 +2432,13 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                 return 1;
             }
 
-            hr = Resize(image->GetImages(), image->GetImageCount(), image->GetMetadata(), twidth, theight, dwFilter | dwFilterOpts, *timage);
+            TEX_FILTER_FLAGS resizeflags = dwFilter | dwFilterOpts;
+            if (!dwOptions[OPT_FORCE_SINGLEPROC])
+            {
+                resizeflags |= TEX_FILTER_PARALLEL;
+            }
+
+            hr = Resize(image->GetImages(), image->GetImageCount(), image->GetMetadata(), twidth, theight, resizeflags, *timage);
             if (FAILED(hr))
             {
                 wprintf(L" FAILED [resize] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
@@ -2730,7 +2796,7 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
         }
 
         // --- Tonemap (if requested) --------------------------------------------------
-        if (dwOptions & uint64_t(1) << OPT_TONEMAP)
+        if (dwOptions[OPT_TONEMAP])
         {
             std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
             if (!timage)
@@ -2810,7 +2876,7 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
         }
 
         // --- Convert -----------------------------------------------------------------
-        if (dwOptions & (uint64_t(1) << OPT_NORMAL_MAP))
+        if (dwOptions[OPT_NORMAL_MAP])
         {
             std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
             if (!timage)
@@ -2872,8 +2938,14 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                 return 1;
             }
 
+            TEX_FILTER_FLAGS cvtflags = dwFilter | dwFilterOpts | dwSRGB | dwConvert;
+            if (!dwOptions[OPT_FORCE_SINGLEPROC])
+            {
+                cvtflags |= TEX_FILTER_PARALLEL;
+            }
+
             hr = Convert(image->GetImages(), image->GetImageCount(), image->GetMetadata(), tformat,
-                dwFilter | dwFilterOpts | dwSRGB | dwConvert, alphaThreshold, *timage);
+                cvtflags, alphaThreshold, *timage);
             if (FAILED(hr))
             {
                 wprintf(L" FAILED [convert] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
@@ -2898,7 +2970,7 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
         }
 
         // --- ColorKey/ChromaKey ------------------------------------------------------
-        if ((dwOptions & (uint64_t(1) << OPT_COLORKEY))
+        if (dwOptions[OPT_COLORKEY]
             && HasAlpha(info.format))
         {
             std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
@@ -2957,7 +3029,7 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
         }
 
         // --- Invert Y Channel --------------------------------------------------------
-        if (dwOptions & (uint64_t(1) << OPT_INVERT_Y))
+        if (dwOptions[OPT_INVERT_Y])
         {
             std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
             if (!timage)
@@ -3006,7 +3078,7 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
         }
 
         // --- Reconstruct Z Channel ---------------------------------------------------
-        if (dwOptions & (uint64_t(1) << OPT_RECONSTRUCT_Z))
+        if (dwOptions[OPT_RECONSTRUCT_Z])
         {
             std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
             if (!timage)
@@ -3191,13 +3263,19 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                 return 1;
             }
 
+            TEX_FILTER_FLAGS mipflags = dwFilterOpts;
+            if (!dwOptions[OPT_FORCE_SINGLEPROC])
+            {
+                mipflags |= TEX_FILTER_PARALLEL;
+            }
+
             if (info.dimension == TEX_DIMENSION_TEXTURE3D)
             {
-                hr = GenerateMipMaps3D(image->GetImages(), image->GetImageCount(), image->GetMetadata(), dwFilter3D | dwFilterOpts, tMips, *timage);
+                hr = GenerateMipMaps3D(image->GetImages(), image->GetImageCount(), image->GetMetadata(), dwFilter3D | mipflags, tMips, *timage);
             }
             else
             {
-                hr = GenerateMipMaps(image->GetImages(), image->GetImageCount(), image->GetMetadata(), dwFilter | dwFilterOpts, tMips, *timage);
+                hr = GenerateMipMaps(image->GetImages(), image->GetImageCount(), image->GetMetadata(), dwFilter | mipflags, tMips, *timage);
             }
             if (FAILED(hr))
             {
@@ -3243,7 +3321,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                 auto img = image->GetImage(0, item, 0);
                 assert(img);
 
-                hr = ScaleMipMapsAlphaForCoverage(img, info.mipLevels, info, item, preserveAlphaCoverageRef, *timage);
+                hr = ScaleMipMapsAlphaForCoverage(img, info.mipLevels, info, item, preserveAlphaCoverageRef,
+                    dwOptions[OPT_FORCE_SINGLEPROC] ? TEX_FILTER_DEFAULT : TEX_FILTER_PARALLEL, *timage);
                 if (FAILED(hr))
                 {
                     wprintf(L" FAILED [keepcoverage] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
@@ -3268,7 +3347,7 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
         }
 
         // --- Premultiplied alpha (if requested) --------------------------------------
-        if ((dwOptions & (uint64_t(1) << OPT_PREMUL_ALPHA))
+        if (dwOptions[OPT_PREMUL_ALPHA]
             && HasAlpha(info.format)
             && info.format != DXGI_FORMAT_A8_UNORM)
         {
@@ -3438,7 +3517,7 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                             {
                                 s_tryonce = true;
 
-                                if (!(dwOptions & (uint64_t(1) << OPT_NOGPU)))
+                                if (!dwOptions[OPT_NOGPU])
                                 {
                                     if (!CreateDevice(adapter, pDevice.GetAddressOf()))
                                         wprintf(L"\nWARNING: DirectCompute is not available, using BC6H / BC7 CPU codec\n");
@@ -3456,12 +3535,10 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                     }
 
                     TEX_COMPRESS_FLAGS cflags = dwCompress;
-                #ifdef _OPENMP
-                    if (!(dwOptions & (uint64_t(1) << OPT_FORCE_SINGLEPROC)))
+                    if (!dwOptions[OPT_FORCE_SINGLEPROC])
                     {
                         cflags |= TEX_COMPRESS_PARALLEL;
                     }
-                #endif
 
                     if ((img->width % 4) != 0 || (img->height % 4) != 0)
                     {
@@ -3474,7 +3551,14 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                     }
                     else
                     {
-                        hr = Compress(img, nimg, info, tformat, cflags | dwSRGB, alphaThreshold, *timage);
+                        CompressOptions options = {};
+                        options.flags = cflags | dwSRGB;
+                        options.threshold = alphaThreshold;
+                        options.alphaWeight = alphaWeight;
+                        options.bc7Level = bc7Level;
+                        options.rdoLambda = rdoLambda;
+
+                        hr = CompressEx(img, nimg, info, tformat, options, *timage);
                     }
                     if (FAILED(hr))
                     {
@@ -3517,7 +3601,7 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             {
                 // Aleady set TEX_ALPHA_MODE_PREMULTIPLIED
             }
-            else if (dwOptions & (uint64_t(1) << OPT_SEPALPHA))
+            else if (dwOptions[OPT_SEPALPHA])
             {
                 info.SetAlphaMode(TEX_ALPHA_MODE_CUSTOM);
             }
@@ -3538,7 +3622,7 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             const size_t nimg = image->GetImageCount();
 
         #ifdef USE_XBOX_EXTS
-            const bool isXboxOut = ((FileType == CODEC_DDS) && (dwOptions & (uint64_t(1) << OPT_USE_XBOX))) != 0;
+            const bool isXboxOut = (FileType == CODEC_DDS) && dwOptions[OPT_USE_XBOX];
         #else
             constexpr bool isXboxOut = false;
         #endif
@@ -3585,7 +3669,7 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             }
 
             std::wstring destName = dest.c_str();
-            if (dwOptions & (uint64_t(1) << OPT_TOLOWER))
+            if (dwOptions[OPT_TOLOWER])
             {
                 std::transform(destName.begin(), destName.end(), destName.begin(), towlower);
             }
@@ -3594,7 +3678,7 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             wprintf(L"writing %ls", destName.c_str());
             fflush(stdout);
 
-            if (~dwOptions & (uint64_t(1) << OPT_OVERWRITE))
+            if (!dwOptions[OPT_OVERWRITE])
             {
                 if (GetFileAttributesW(destName.c_str()) != INVALID_FILE_ATTRIBUTES)
                 {
@@ -3622,11 +3706,11 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             #endif // USE_XBOX_EXTS
                 {
                     DDS_FLAGS ddsFlags = DDS_FLAGS_NONE;
-                    if (dwOptions & (uint64_t(1) << OPT_USE_DX10))
+                    if (dwOptions[OPT_USE_DX10])
                     {
                         ddsFlags |= DDS_FLAGS_FORCE_DX10_EXT | DDS_FLAGS_FORCE_DX10_EXT_MISC2;
                     }
-                    else if (dwOptions & (uint64_t(1) << OPT_USE_DX9))
+                    else if (dwOptions[OPT_USE_DX9])
                     {
                         if (dxt5rxgb)
                         {
@@ -3641,11 +3725,25 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                 break;
 
             case CODEC_TGA:
-                hr = SaveToTGAFile(img[0], TGA_FLAGS_NONE, destName.c_str(), (dwOptions & (uint64_t(1) << OPT_TGA20)) ? &info : nullptr);
+                {
+                    TGA_FLAGS tgaFlags = TGA_FLAGS_NONE;
+                    if (dwOptions[OPT_TGA_RLE])
+                    {
+                        tgaFlags |= TGA_FLAGS_RLE;
+                        if (!dwOptions[OPT_FORCE_SINGLEPROC])
+                        {
+                            tgaFlags |= TGA_FLAGS_PARALLEL;
+                        }
+                    }
+
+                    hr = SaveToTGAFile(img[0], tgaFlags, destName.c_str(), dwOptions[OPT_TGA20] ? &info : nullptr);
+                }
                 break;
 
             case CODEC_HDR:
-                hr = SaveToHDRFile(img[0], destName.c_str());
+                hr = SaveToHDRFile(img[0],
+                    dwOptions[OPT_FORCE_SINGLEPROC] ? HDR_FLAGS_NONE : HDR_FLAGS_PARALLEL,
+                    destName.c_str());
                 break;
 
             case CODEC_PPM:
@@ -3675,11 +3773,11 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             default:
                 {
                     const WICCodecs codec = (FileType == CODEC_HDP || FileType == CODEC_JXR) ? WIC_CODEC_WMP : static_cast<WICCodecs>(FileType);
-                    const size_t nimages = (dwOptions & (uint64_t(1) << OPT_WIC_MULTIFRAME)) ? nimg : 1;
+                    const size_t nimages = dwOptions[OPT_WIC_MULTIFRAME] ? nimg : 1;
                     hr = SaveToWICFile(img, nimages, WIC_FLAGS_NONE, GetWICCodec(codec), destName.c_str(), nullptr,
                         [&](IPropertyBag2* props)
                         {
-                            const bool wicLossless = (dwOptions & (uint64_t(1) << OPT_WIC_LOSSLESS)) != 0;
+                            const bool wicLossless = dwOptions[OPT_WIC_LOSSLESS];
 
                             switch (FileType)
                             {
@@ -3770,7 +3868,7 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
     if (non4bc)
         wprintf(L"\nWARNING: Direct3D requires BC image to be multiple of 4 in width & height\n");
 
-    if (dwOptions & (uint64_t(1) << OPT_TIMING))
+    if (dwOptions[OPT_TIMING])
     {
         LARGE_INTEGER qpcEnd = {};
         std::ignore = QueryPerformanceCounter(&qpcEnd);
@@ -104,8 +104,7 @@ elseif(CMAKE_CXX_COMPILER_ID MATCHES "MSVC")
     endif()
 
     if((CMAKE_CXX_COMPILER_VERSION VERSION_GREATER_EQUAL 19.11)
-       AND (OpenMP_CXX_FOUND
-           OR (XBOX_CONSOLE_TARGET STREQUAL "durango")))
+       AND (XBOX_CONSOLE_TARGET STREQUAL "durango"))
       # OpenMP in MSVC is not compatible with /permissive- unless you disable two-phase lookup
       list(APPEND COMPILER_SWITCHES /Zc:twoPhase-)
     endif()